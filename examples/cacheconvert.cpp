@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <miopengemm/kernelcachefile.hpp>
+#include <miopengemm/timer.hpp>
+
+// Convert kernel caches to a binary kernel cache file, which can be loaded at runtime with
+// set_kernel_cache_path or the MIOPENGEMM_KERNEL_CACHE environment variable.
+//
+// usage : cacheconvert output_file input_1 (input_2 ...)
+//
+// each input is one of
+//   builtin      the cache compiled into the library (and any file already layered on it)
+//   a text file  with kc.add(...) entries, as in cacheN.cachetxt or find output (OutPart::CCH)
+//   a binary kernel cache file
+// Where inputs share a key, the later input wins.
+
+int main(int argc, char* argv[])
+{
+
+  using namespace MIOpenGEMM;
+
+  std::vector<std::string> sargs(argv + 1, argv + argc);
+  if (sargs.size() < 2)
+  {
+    throw miog_error("should be at least 2 arguments in cacheconvert : output_file input_1 ...");
+  }
+
+  KernelCache merged;
+  for (size_t i = 1; i < sargs.size(); ++i)
+  {
+    KernelCache kc;
+    if (sargs[i] == "builtin")
+    {
+      kc = get_kernel_cache();
+    }
+    else
+    {
+      std::ifstream fin(sargs[i], std::ios::in | std::ios::binary);
+      std::string   start(8, ' ');
+      fin.read(&start[0], start.size());
+      kc = start == "MIOGEMMK" ? cachefile::read(sargs[i]) : cachefile::read_text(sargs[i]);
+    }
+    std::cout << sargs[i] << " : " << kc.get_keys().size() << " entries" << std::endl;
+    for (auto& ck : kc.get_keys())
+    {
+      merged.add_or_replace(ck, kc.at(ck));
+    }
+  }
+
+  cachefile::write(merged, sargs[0]);
+
+  // confirm the round trip
+  Timer timer;
+  timer.start();
+  auto   reread  = cachefile::read(sargs[0]);
+  double elapsed = timer.get_elapsed();
+  for (auto& ck : merged.get_keys())
+  {
+    if (reread.check_for(ck).is_present == false || !(reread.at(ck) == merged.at(ck)))
+    {
+      throw miog_error("round trip failed for " + ck.get_string());
+    }
+  }
+
+  std::cout << merged.get_keys().size() << " entries written to " << sargs[0] << ", read back in "
+            << 1000 * elapsed << " [ms]" << std::endl;
+  return 0;
+}
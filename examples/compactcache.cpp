@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <miopengemm/costmodel.hpp>
+#include <miopengemm/geometries.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+#include <miopengemm/kernelcachemerge.hpp>
+#include <miopengemm/timer.hpp>
+
+// Compact a kernel cache : remove entries whose removal does not change the HyPas selected for
+// any geometry in a reference set (see get_compacted), confirm this, and report the reference
+// geometries furthest from the cache, where new tuning would help most. No GPU is required.
+//
+// usage : compactcache output_file (input) (references) (tolerance)
+//   input       "builtin" (default), or a text or binary kernel cache file (see cacheconvert)
+//   references  "cache" (default) : the cached geometries, "deepbench" : these and the
+//               deepbench geometries on each device in the cache, or a file of geometry
+//               strings (one per line) which are added to the cached geometries
+//   tolerance   if set, a removal which changes selected HyPas is accepted when by the
+//               analytic cost model none are slowed down by more than this fraction
+// The output is a text cache, convert it to a binary file with cacheconvert.
+
+int main(int argc, char* argv[])
+{
+
+  using namespace MIOpenGEMM;
+
+  std::vector<std::string> sargs(argv + 1, argv + argc);
+  if (sargs.size() < 1 || sargs.size() > 4)
+  {
+    throw miog_error("usage : compactcache output_file (input) (references) (tolerance)");
+  }
+  std::string input      = sargs.size() > 1 ? sargs[1] : "builtin";
+  std::string ref_source = sargs.size() > 2 ? sargs[2] : "cache";
+
+  KernelCache kc;
+  if (input == "builtin")
+  {
+    kc = get_kernel_cache();
+  }
+  else
+  {
+    std::ifstream fin(input, std::ios::in | std::ios::binary);
+    std::string   start(8, ' ');
+    fin.read(&start[0], start.size());
+    kc = start == "MIOGEMMK" ? cachefile::read(input) : cachefile::read_text(input);
+  }
+
+  auto                  references = kc.get_keys();
+  std::set<std::string> devices;
+  for (auto& ck : references)
+  {
+    devices.insert(ck.dvc);
+  }
+
+  std::vector<Geometry> extra;
+  if (ref_source == "deepbench")
+  {
+    extra = get_deepbench(0);
+  }
+  else if (ref_source != "cache")
+  {
+    std::ifstream fin(ref_source, std::ios::in);
+    if (!fin.good())
+    {
+      throw miog_error("failed to open references file `" + ref_source + "'");
+    }
+    std::string line;
+    while (std::getline(fin, line))
+    {
+      if (line.size() > 0)
+      {
+        extra.emplace_back(line);
+      }
+    }
+  }
+  for (auto& dvc : devices)
+  {
+    for (auto& gg : extra)
+    {
+      references.emplace_back(dvc, Constraints(""), gg);
+    }
+  }
+
+  owrite::Writer mowri(Ver::E::MERGE, "");
+  Timer          timer;
+  timer.start();
+
+  costmodel::Analytic cost(oclutil::get_vega_devinfo());
+  double              tolerance = sargs.size() > 3 ? std::stod(sargs[3]) : 0;
+  KernelCache         compacted = sargs.size() > 3
+                            ? get_compacted(kc, references, cost, tolerance, mowri)
+                            : get_compacted(kc, references, mowri);
+  std::cout << "compaction took " << timer.get_elapsed() << " [s]" << std::endl;
+
+  // confirm that no reference is worse off
+  size_t n_changed = 0;
+  size_t n_failed  = 0;
+  for (auto& ref : references)
+  {
+    CacheKey before = ref;
+    CacheKey after  = ref;
+    HyPas    hp_before;
+    HyPas    hp_after;
+    bool     had = get_selected(kc, ref, before, hp_before);
+    bool     has = get_selected(compacted, ref, after, hp_after);
+    if (had != has)
+    {
+      ++n_failed;
+    }
+    else if (had && !(hp_before == hp_after))
+    {
+      ++n_changed;
+      n_failed += cost.get_gflops(hp_after, ref.gg) <
+                  (1 - tolerance) * cost.get_gflops(hp_before, ref.gg);
+    }
+  }
+  std::cout << references.size() << " references : " << n_changed << " with a changed HyPas, "
+            << n_failed << " worse than the tolerance" << std::endl;
+  if (n_failed != 0)
+  {
+    throw miog_error("compaction lost quality on some references");
+  }
+
+  std::ofstream fout(sargs[0], std::ios::out);
+  for (auto& ck : compacted.get_keys())
+  {
+    fout << '\n' << compacted.get_cache_entry_string(ck);
+  }
+  std::cout << compacted.get_keys().size() << " entries written to " << sargs[0] << std::endl;
+
+  std::cout << "\ncoverage gaps (distance to selected cache entry, reference) :\n";
+  for (auto& gap : get_coverage_gaps(compacted, references, 20))
+  {
+    std::cout << std::get<0>(gap) << "\t" << std::get<1>(gap).dvc << " "
+              << std::get<1>(gap).gg.get_string() << '\n';
+  }
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <miopengemm/costmodel.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/miogemm.hpp>
+#include <miopengemm/predictor.hpp>
+#include <miopengemm/timer.hpp>
+
+// Leave-one-out quality of the fallback for geometries not in the kernel cache. Each kernel
+// cache entry in turn is removed and get_default_soln asked for a Solution for its geometry.
+// The GFLOPs of the returned HyPas relative to the removed (cached optimum) HyPas is recorded,
+// measured on a device or estimated by a cost model, and summarised per device and per
+// transpose case.
+//
+// usage : fallbackbench (device_frag) (loo_stride) (strategy) (cost_model) (platform) (device)
+//   device_frag  entries whose device contains device_frag, "all" (default) for all
+//   loo_stride   evaluate every loo_stride'th entry (default 1)
+//   strategy     "nearest" (default) : get_default_soln as is, or "predictor" : additionally
+//                adjusted by a predictor trained on the other entries of the same device
+//   cost_model   "analytic" (default, no GPU required) or "measured" (on the device given by
+//                platform and device, default 0 0, whose entries only are considered)
+//
+// With "nearest", the predictor should not be set (MIOPENGEMM_PREDICTOR) as it would have been
+// trained on the removed entries.
+
+namespace
+{
+class Summary
+{
+  public:
+  std::vector<double> ratios;
+  size_t              n_same = 0;
+
+  void add(double ratio, bool same)
+  {
+    ratios.push_back(ratio);
+    n_same += same;
+  }
+};
+
+void print_table(const std::string& title, const std::map<std::string, Summary>& summaries)
+{
+  std::cout << '\n'
+            << std::left << std::setw(12) << title << std::right << std::setw(8) << "n"
+            << std::setw(10) << "mean" << std::setw(10) << "median" << std::setw(10) << "min"
+            << std::setw(10) << ">= 0.95" << std::setw(10) << "same" << '\n';
+  for (auto& x : summaries)
+  {
+    auto   ratios = x.second.ratios;
+    double n      = static_cast<double>(ratios.size());
+    std::sort(ratios.begin(), ratios.end());
+    double mean = 0;
+    for (auto r : ratios)
+    {
+      mean += r / n;
+    }
+    auto n_good = ratios.end() - std::lower_bound(ratios.begin(), ratios.end(), 0.95);
+    std::cout << std::left << std::setw(12) << x.first << std::right << std::setw(8)
+              << ratios.size() << std::fixed << std::setprecision(3) << std::setw(10) << mean
+              << std::setw(10) << ratios[ratios.size() / 2] << std::setw(10) << ratios[0]
+              << std::setw(10) << n_good / n << std::setw(10) << x.second.n_same / n << '\n'
+              << std::defaultfloat;
+  }
+}
+}
+
+int main(int argc, char* argv[])
+{
+
+  using namespace MIOpenGEMM;
+
+  std::vector<std::string> sargs(argv + 1, argv + argc);
+  if (sargs.size() > 6)
+  {
+    throw miog_error("usage : fallbackbench (device_frag) (loo_stride) (strategy) (cost_model) "
+                     "(platform) (device)");
+  }
+  std::string device_frag = sargs.size() > 0 ? sargs[0] : "all";
+  size_t      loo_stride  = sargs.size() > 1 ? std::stoul(sargs[1]) : 1;
+  std::string strategy    = sargs.size() > 2 ? sargs[2] : "nearest";
+  std::string model_name  = sargs.size() > 3 ? sargs[3] : "analytic";
+  size_t      platform_id = sargs.size() > 4 ? std::stoul(sargs[4]) : 0;
+  size_t      device_id   = sargs.size() > 5 ? std::stoul(sargs[5]) : 0;
+  if (loo_stride == 0 || (strategy != "nearest" && strategy != "predictor"))
+  {
+    throw miog_error("loo_stride should be positive, strategy one of nearest and predictor");
+  }
+
+  owrite::Writer silent(Ver::E::SILENT, "");
+
+  KernelCache kernel_cache = get_kernel_cache();
+  auto        cache_keys   = kernel_cache.get_keys();
+  if (device_frag != "all")
+  {
+    filter_device(cache_keys, {device_frag});
+  }
+
+  std::unique_ptr<costmodel::CostModel> cost;
+  std::unique_ptr<oclutil::DevInfo>     measured_devinfo;
+  if (model_name == "measured")
+  {
+    CLHint hint(platform_id, device_id);
+    measured_devinfo.reset(new oclutil::DevInfo(hint, silent));
+    filter_device(cache_keys, {measured_devinfo->identifier});
+    cost.reset(new costmodel::Measured(hint, {{{1, 20}}, {{0, 0.2}}}, silent));
+  }
+  else if (model_name == "analytic")
+  {
+    cost.reset(new costmodel::Analytic(oclutil::get_vega_devinfo()));
+  }
+  else
+  {
+    throw miog_error("unrecognised cost model " + model_name + ", analytic or measured");
+  }
+  std::sort(cache_keys.begin(), cache_keys.end(), [](const CacheKey& a, const CacheKey& b) {
+    return a.concatenated < b.concatenated;
+  });
+
+  std::map<std::string, Summary> per_device;
+  std::map<std::string, Summary> per_transpose;
+  std::map<std::string, Summary> overall;
+  size_t                         n_failed = 0;
+
+  Timer timer;
+  timer.start();
+  for (size_t i = 0; i < cache_keys.size(); i += loo_stride)
+  {
+    auto& ck     = cache_keys[i];
+    HyPas cached = kernel_cache.at(ck);
+
+    // the hard-coded DevInfos (as get_vega_devinfo) are what get_default_soln uses of a device
+    oclutil::DevInfo devinfo =
+      measured_devinfo ? *measured_devinfo : oclutil::DevInfo(ck.dvc, ck.dvc, 64);
+
+    kernel_cache.remove(ck);
+    HyPas fallback =
+      get_default_soln(devinfo, ck.gg, ck.constraints, kernel_cache, silent, IfNoCache::GENERIC, 0)
+        .hypas;
+
+    if (strategy == "predictor")
+    {
+      std::vector<Geometry> geometries;
+      std::vector<HyPas>    hps;
+      for (auto& key : kernel_cache.get_keys())
+      {
+        if (key.dvc == ck.dvc)
+        {
+          geometries.push_back(key.gg);
+          hps.push_back(kernel_cache.at(key));
+        }
+      }
+      predictor::Predictor model(ck.dvc, geometries, hps, 6, 4);
+      auto                 graph = get_graph(ck.gg, devinfo, ck.constraints);
+      fallback                   = predictor::get_repaired(model, fallback, ck.gg, *graph);
+    }
+    kernel_cache.add(ck, cached);
+
+    double ratio;
+    try
+    {
+      ratio = cost->get_gflops(fallback, ck.gg) / cost->get_gflops(cached, ck.gg);
+    }
+    catch (const miog_error& e)
+    {
+      std::cout << "failed to evaluate " << ck.get_string() << " : " << e.what() << '\n';
+      ++n_failed;
+      continue;
+    }
+
+    std::string transposes = std::string(ck.gg.tX[Mat::E::A] ? "T" : "N") +
+                             (ck.gg.tX[Mat::E::B] ? "T" : "N") + ck.gg.floattype;
+    bool same = fallback == cached;
+    per_device[ck.dvc].add(ratio, same);
+    per_transpose[transposes].add(ratio, same);
+    overall["all"].add(ratio, same);
+  }
+
+  std::cout << "strategy " << strategy << ", cost model " << cost->get_name() << ", "
+            << overall["all"].ratios.size() << " entries evaluated (" << n_failed
+            << " failed) in " << timer.get_elapsed() << " [s]\n"
+            << "GFLOPs of the fallback relative to the cached optimum :\n";
+  print_table("device", per_device);
+  print_table("transposes", per_transpose);
+  print_table("", overall);
+
+  return 0;
+}
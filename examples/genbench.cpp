@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/timer.hpp>
+
+// Throughput of OpenCL kernel source generation, for all kernel cache entries. No GPU is
+// required. Reported are the generation itself (kerngen::get_kernblobs), and Bundle construction
+// with the KernBlobs not yet memoized (first) and memoized (repeat), as in searches which revisit
+// HyPas.
+
+int main()
+{
+  using namespace MIOpenGEMM;
+
+  auto&& kernel_cache = get_kernel_cache();
+  auto   cache_keys   = kernel_cache.get_keys();
+
+  auto report = [](std::string what, double seconds, size_t n_calls, size_t n_chars) {
+    what.resize(32, ' ');
+    std::cout << what << std::setw(12) << 1e6 * seconds / n_calls << " [us / bundle]"
+              << std::setw(12) << n_chars / (1e6 * seconds) << " [MB / s]  (" << n_calls
+              << " bundles)\n";
+  };
+
+  Timer  timer;
+  size_t n_chars = 0;
+  timer.start();
+  for (auto& ck : cache_keys)
+  {
+    HyPas         hp = kernel_cache.at(ck);
+    DerivedParams dp(hp, ck.gg);
+    for (auto& kblob : kerngen::get_kernblobs(hp, ck.gg, dp))
+    {
+      n_chars += kblob.kernstr.size();
+    }
+  }
+  report("generation", timer.get_elapsed(), cache_keys.size(), n_chars);
+
+  // a working set which fits in the memo
+  if (cache_keys.size() > 256)
+  {
+    cache_keys.erase(cache_keys.begin() + 256, cache_keys.end());
+  }
+  for (std::string call : {"Bundle (first)", "Bundle (repeat)"})
+  {
+    n_chars = 0;
+    timer.start();
+    for (auto& ck : cache_keys)
+    {
+      kerngen::Bundle bundle(kernel_cache.at(ck), ck.gg);
+      for (auto& kblob : bundle.v_tgks)
+      {
+        n_chars += kblob.kernstr.size();
+      }
+    }
+    report(call, timer.get_elapsed(), cache_keys.size(), n_chars);
+  }
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <miopengemm/graph.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/nearest.hpp>
+#include <miopengemm/timer.hpp>
+
+// Benchmark of search graph construction, neighbor generation and kernel cache lookups.
+// No GPU is required : the DevInfo is a hard-coded one.
+
+int main()
+{
+  using namespace MIOpenGEMM;
+
+  auto        devinfo = oclutil::get_vega_devinfo();
+  Constraints constraints("");
+
+  auto&& kernel_cache = get_kernel_cache();
+  auto   cache_keys   = kernel_cache.get_keys();
+  filter_device(cache_keys, {devinfo.device_name});
+  if (cache_keys.size() > 60)
+  {
+    cache_keys.erase(cache_keys.begin() + 60, cache_keys.end());
+  }
+
+  std::vector<HyPas> cache_hps;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    cache_hps.push_back(kernel_cache.at(ck));
+  }
+
+  std::cout << "number of geometries : " << cache_keys.size()
+            << ",  number of cache entries : " << cache_hps.size() << '\n';
+
+  auto report = [](std::string what, double seconds, size_t n_calls) {
+    what.resize(40, ' ');
+    std::cout << what << std::setw(12) << 1e6 * seconds / n_calls << " [us / call]  (" << n_calls
+              << " calls)\n";
+  };
+
+  Timer  timer;
+  size_t n_calls = 0;
+
+  // Graph construction (repeated, as in single_descent_find and get_default_soln)
+  size_t n_repeats = 20;
+  timer.start();
+  for (size_t r = 0; r < n_repeats; ++r)
+  {
+    for (auto& ck : cache_keys)
+    {
+      auto graph = get_graph(ck.gg, devinfo, constraints);
+      (void)graph;
+    }
+  }
+  report("Graph construction", timer.get_elapsed(), n_repeats * cache_keys.size());
+
+  // Graph::contains on every cache entry, as in nearest::get
+  size_t n_contained = 0;
+  n_calls            = 0;
+  timer.start();
+  for (auto& ck : cache_keys)
+  {
+    auto graph = get_graph(ck.gg, devinfo, constraints);
+    for (auto& hp : cache_hps)
+    {
+      n_contained += graph->contains(hp);
+      ++n_calls;
+    }
+  }
+  report("Graph::contains", timer.get_elapsed(), n_calls);
+
+  // Graph::get_neighbors, from the cached solution
+  size_t n_neighbors = 0;
+  n_calls            = 0;
+  timer.start();
+  for (auto& ck : cache_keys)
+  {
+    auto  graph = get_graph(ck.gg, devinfo, constraints);
+    auto& hp    = kernel_cache.at(ck);
+    if (graph->contains(hp))
+    {
+      for (auto prioritize : {true, false})
+      {
+        n_neighbors += graph->get_neighbors(hp, prioritize).size();
+        ++n_calls;
+      }
+    }
+  }
+  report("Graph::get_neighbors", timer.get_elapsed(), n_calls);
+
+  // nearest::Index construction, on the first lookup in the kernel cache
+  timer.start();
+  kernel_cache.get_index();
+  report("nearest::Index construction", timer.get_elapsed(), 1);
+
+  // nearest::get, as in get_default_soln, for geometries not in the cache. The first lookup
+  // checks derivability of candidates until one is found, repeats are memoized.
+  std::vector<CacheKey> uncached_keys;
+  for (auto& ck : cache_keys)
+  {
+    auto&    g = ck.gg;
+    Geometry gg(g.isColMajor,
+                g.tX[Mat::E::A],
+                g.tX[Mat::E::B],
+                g.tX[Mat::E::C],
+                g.ldX[Mat::E::A] + 8,
+                g.ldX[Mat::E::B] + 8,
+                g.ldX[Mat::E::C] + 8,
+                g.m + 1,
+                g.n + 3,
+                g.k + 2,
+                g.wSpaceSize,
+                g.floattype);
+    uncached_keys.emplace_back(ck.dvc, constraints, gg);
+  }
+  for (std::string call : {"(first call)", "(repeat call)"})
+  {
+    n_calls = 0;
+    timer.start();
+    for (auto& ck : uncached_keys)
+    {
+      auto graph = get_graph(ck.gg, devinfo, constraints);
+      if (nearest::is_within(ck, *graph, kernel_cache, std::numeric_limits<double>::max(), 0))
+      {
+        nearest::get(ck, *graph, kernel_cache, 0);
+      }
+      ++n_calls;
+    }
+    report("nearest::is_within + get " + call, timer.get_elapsed(), n_calls);
+  }
+
+  // nearest::get_adapted, as in the warm start stage of find
+  size_t n_adapted = 0;
+  n_calls          = 0;
+  timer.start();
+  for (auto& ck : cache_keys)
+  {
+    auto graph = get_graph(ck.gg, devinfo, constraints);
+    n_adapted += nearest::get_adapted(ck, *graph, kernel_cache, 6).size();
+    ++n_calls;
+  }
+  report("nearest::get_adapted (k = 6)", timer.get_elapsed(), n_calls);
+
+  std::cout << "(adapted : " << n_adapted << ")\n";
+  std::cout << "(contained : " << n_contained << ", neighbors : " << n_neighbors << ")\n";
+
+  return 0;
+}
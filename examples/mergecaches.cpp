@@ -1,39 +1,66 @@
 /*******************************************************************************
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <miopengemm/findparams.hpp>
+#include <miopengemm/kernelcachefile.hpp>
 #include <miopengemm/kernelcachemerge.hpp>
 
-MIOpenGEMM::KernelCache get_kernel_cache2()
+// Merge two kernel caches, benchmarking on the device where they have different HyPas for a key.
+//
+// usage : mergecaches kc1 kc2 output_file (journal_file) (n_compile_threads)
+//   kc1, kc2           builtin, a text cache file or a binary kernel cache file
+//   output_file        the merged cache, as text
+//   journal_file       entries are appended to it as they are resolved, with their provenance. If
+//                      the merge is interrupted, rerunning with the same journal resumes it.
+//   n_compile_threads  kernels compiled ahead of the benchmarking (default 4)
+
+namespace
+{
+MIOpenGEMM::KernelCache get_input(const std::string& name)
 {
-  MIOpenGEMM::KernelCache kc;
-  //#include "/home/james/test48/cacheentries.txt"
-  return kc;
+  using namespace MIOpenGEMM;
+  if (name == "builtin")
+  {
+    return get_kernel_cache();
+  }
+  std::ifstream fin(name, std::ios::in | std::ios::binary);
+  std::string   start(8, ' ');
+  fin.read(&start[0], start.size());
+  return start == "MIOGEMMK" ? cachefile::read(name) : cachefile::read_text(name);
+}
 }
 
-int main()
+int main(int argc, char* argv[])
 {
   using namespace MIOpenGEMM;
 
-  KernelCache kernel_cache2 = get_wSpaceReduced(get_kernel_cache2());
-
-  for (auto ck : kernel_cache2.get_keys())
+  std::vector<std::string> sargs(argv + 1, argv + argc);
+  if (sargs.size() < 3 || sargs.size() > 5)
   {
-    std::cout << ck.gg.get_string() << std::endl;
+    throw miog_error(
+      "usage : mergecaches kc1 kc2 output_file (journal_file) (n_compile_threads)");
   }
+  std::string journal   = sargs.size() > 3 ? sargs[3] : "";
+  size_t      n_threads = sargs.size() > 4 ? std::stoul(sargs[4]) : 4;
+
+  KernelCache kc1 = get_input(sargs[0]);
+  KernelCache kc2 = get_input(sargs[1]);
 
   owrite::Writer mowri(Ver::E::MERGE, "");
 
-  auto&& kernel_cache = get_kernel_cache();
+  Halt halt = {{{0, 5}}, {{0, 0.1}}};
+  auto kcn  = get_merged(kc1, kc2, halt, journal, n_threads, mowri);
 
-  Halt          halt = {{{0, 5}}, {{0, 0.1}}};
-  auto          kcn  = get_merged(kernel_cache, kernel_cache2, halt, mowri);
-  std::ofstream floper("/home/james/test48/merged_cache48.txt", std::ios::out);
+  std::ofstream floper(sargs[2], std::ios::out);
   for (auto& ck : kcn.get_keys())
   {
     floper << '\n' << kcn.get_cache_entry_string(ck);
   }
   floper.close();
+  std::cout << kcn.get_keys().size() << " entries written to " << sargs[2] << std::endl;
   return 0;
 }
@@ -0,0 +1,533 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/redirection.hpp>
+#include <miopengemm/stringutilbase.hpp>
+#include <miopengemm/timer.hpp>
+#include <miopengemm/tinytwo.hpp>
+
+// Multi-geometry find with a pool of worker processes. Like multifind, each find runs in a
+// separate process (compilation gets slower when many finds are done in one process), but here
+// the processes are long-lived, run concurrently, and the results are merged into one cache file.
+//
+// Each worker owns one device (worker w uses device w % n_devices) and creates a fresh OpenCL
+// context per geometry. Geometries are handed out one at a time through a pipe, results come
+// back through a second pipe. Workers which crash, or which take too long on a geometry, are
+// killed and restarted, and the geometry is re-queued (at most max_attempts times). A geometry on
+// which find fails (an error reported by the worker) is retried once, on another worker. Workers
+// are also recycled after max_finds_per_worker finds, to bound any slow-down. The failures of
+// each worker are reported at the end.
+//
+// WARNING : uses fork and pipes, only works on linux/mac.
+//
+// usage : multifindpool geometries_file output_file n_workers
+//                       (seconds_per_find) (platform_id) (n_devices)
+//
+// geometries_file has one geometry string per line, optionally followed by a constraints string.
+// output_file is written in the format of the cacheN.cachetxt files.
+
+namespace
+{
+
+using namespace MIOpenGEMM;
+
+const size_t max_attempts         = 3;
+const size_t max_finds_per_worker = 20;
+// a find which takes longer than this multiple of seconds_per_find (plus compile_slack) is stuck
+const double timeout_factor = 3.0;
+const double compile_slack  = 60.0;
+
+class PoolParams
+{
+  public:
+  double seconds_per_find = 20.0;
+  size_t platform_id      = 0;
+  size_t n_devices        = 1;
+};
+
+// the failed_worker of a task on which find has not failed
+const size_t no_worker = std::numeric_limits<size_t>::max();
+
+class Task
+{
+  public:
+  Geometry    gg;
+  Constraints constraints;
+  size_t      attempts;
+  // the worker on which find failed (no_worker if none), the retry is on another
+  size_t      failed_worker;
+};
+
+class Worker
+{
+  public:
+  size_t      worker_id;
+  pid_t       pid       = -1;
+  int         task_fd   = -1;
+  int         result_fd = -1;
+  bool        busy      = false;
+  size_t      task_index;
+  size_t      n_finds = 0;
+  Timer       timer;
+  std::string buffer;
+
+  // over all the processes of the worker
+  size_t                        n_found = 0;
+  std::map<std::string, size_t> failures;
+};
+
+class PoolResult
+{
+  public:
+  CacheKey    ck;
+  HyPas       hp;
+  double      extime;
+  double      gflops;
+  std::string stats;
+};
+
+std::string get_sanitised(std::string s)
+{
+  for (auto& c : s)
+  {
+    if (c == '\n' || c == '\t')
+    {
+      c = ' ';
+    }
+  }
+  return s;
+}
+
+bool write_all(int fd, const std::string& s)
+{
+  size_t written = 0;
+  while (written < s.size())
+  {
+    auto n = write(fd, s.data() + written, s.size() - written);
+    if (n <= 0)
+    {
+      return false;
+    }
+    written += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// runs in the child process : find for every geometry received, until the task pipe is closed.
+void worker_main(int task_fd, int result_fd, size_t worker_id, const PoolParams& pp)
+{
+  FILE*   tasks = fdopen(task_fd, "r");
+  char*   line  = nullptr;
+  size_t  cap   = 0;
+  CLHint  devhint(pp.platform_id, worker_id % pp.n_devices);
+  Offsets offsets = get_zero_offsets();
+
+  while (getline(&line, &cap, tasks) != -1)
+  {
+    std::string task(line);
+    if (task.size() > 0 && task.back() == '\n')
+    {
+      task.pop_back();
+    }
+    auto              frags = stringutil::split(task, "\t");
+    std::stringstream result;
+    try
+    {
+      Geometry    gg(frags.at(0));
+      Constraints constraints(frags.at(1));
+
+      // fresh context and command queue for every geometry
+      owrite::Writer mowri(Ver::E::SILENT, "");
+      dev::TinyTwo   boa(gg, offsets, mowri, devhint);
+      auto           soln = boa.find2(get_at_least_n_seconds(pp.seconds_per_find), constraints);
+
+      result << "OK\t" << soln.devinfo.identifier << '\t' << soln.constraints.get_string() << '\t'
+             << soln.geometry.get_string();
+      for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+      {
+        result << '\t' << soln.hypas.sus[emat].get_string();
+      }
+      result << '\t' << soln.extime << '\t' << soln.stats.get_string();
+    }
+    catch (const std::exception& e)
+    {
+      result.str("");
+      result << "ERR\t" << get_sanitised(e.what());
+    }
+    result << '\n';
+    if (!write_all(result_fd, result.str()))
+    {
+      break;
+    }
+  }
+  free(line);
+  fclose(tasks);
+  close(result_fd);
+}
+
+class Pool
+{
+  private:
+  PoolParams          pp;
+  std::vector<Task>   tasks;
+  std::deque<size_t>  pending;
+  std::vector<Worker> workers;
+
+  public:
+  std::vector<PoolResult> results;
+  std::vector<size_t>     failed;
+
+  Pool(const PoolParams& pp_, std::vector<Task>&& tasks_, size_t n_workers) : pp(pp_), tasks(tasks_)
+  {
+    for (size_t ti = 0; ti < tasks.size(); ++ti)
+    {
+      pending.push_back(ti);
+    }
+    workers.resize(n_workers);
+    for (size_t wi = 0; wi < n_workers; ++wi)
+    {
+      workers[wi].worker_id = wi;
+    }
+  }
+
+  void spawn(Worker& w)
+  {
+    int task_pipe[2];
+    int result_pipe[2];
+    if (pipe(task_pipe) != 0 || pipe(result_pipe) != 0)
+    {
+      throw miog_error("failed to create pipes for worker");
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      throw miog_error("failed to fork worker");
+    }
+
+    if (pid == 0)
+    {
+      // the child must not hold the pipes of other workers, else their EOFs are never seen
+      for (auto& other : workers)
+      {
+        if (other.pid > 0)
+        {
+          close(other.task_fd);
+          close(other.result_fd);
+        }
+      }
+      close(task_pipe[1]);
+      close(result_pipe[0]);
+      worker_main(task_pipe[0], result_pipe[1], w.worker_id, pp);
+      _exit(0);
+    }
+
+    close(task_pipe[0]);
+    close(result_pipe[1]);
+    w.pid       = pid;
+    w.task_fd   = task_pipe[1];
+    w.result_fd = result_pipe[0];
+    w.busy      = false;
+    w.n_finds   = 0;
+    w.buffer.clear();
+  }
+
+  void retire(Worker& w, bool kill_it)
+  {
+    if (kill_it)
+    {
+      kill(w.pid, SIGKILL);
+    }
+    close(w.task_fd);
+    close(w.result_fd);
+    waitpid(w.pid, nullptr, 0);
+    w.pid = -1;
+  }
+
+  void requeue(Worker& w, const std::string& why)
+  {
+    auto& task = tasks[w.task_index];
+    ++task.attempts;
+    ++w.failures[why];
+    std::cout << "worker " << w.worker_id << " (" << why << ") on " << task.gg.get_string();
+    if (task.attempts < max_attempts)
+    {
+      std::cout << ", re-queued" << std::endl;
+      pending.push_back(w.task_index);
+    }
+    else
+    {
+      std::cout << ", giving up after " << task.attempts << " attempts" << std::endl;
+      failed.push_back(w.task_index);
+    }
+    w.busy = false;
+  }
+
+  void process_line(Worker& w, const std::string& line)
+  {
+    auto  frags = stringutil::split(line, "\t");
+    auto& task  = tasks[w.task_index];
+    w.busy      = false;
+    ++w.n_finds;
+
+    if (frags.size() != 9 || frags[0] != "OK")
+    {
+      ++w.failures["find failed"];
+      std::cout << "worker " << w.worker_id << " failed on " << task.gg.get_string() << " : "
+                << (frags.size() > 1 ? frags[1] : line);
+      if (task.failed_worker == no_worker)
+      {
+        std::cout << ", retrying on another worker" << std::endl;
+        task.failed_worker = w.worker_id;
+        pending.push_front(w.task_index);
+      }
+      else
+      {
+        std::cout << ", failed on worker " << task.failed_worker << " too" << std::endl;
+        failed.push_back(w.task_index);
+      }
+      return;
+    }
+    ++w.n_found;
+
+    Geometry    gg(frags[3]);
+    Constraints constraints(frags[2]);
+    HyPas       hp(HyPas::str_array{{frags[4], frags[5], frags[6]}});
+    double      extime = std::stod(frags[7]);
+
+    // cache entries are stored in canonical form
+    CacheKey ck(frags[1], constraints, gg);
+    results.push_back({ck,
+                       hp.get_reflected(redirection::get_is_not_canonical(gg)),
+                       extime,
+                       gg.get_gflops(extime / 1000.),
+                       frags[8]});
+
+    std::cout << '(' << results.size() + failed.size() << '/' << tasks.size() << ") worker "
+              << w.worker_id << " : " << gg.get_string() << "  " << results.back().gflops
+              << " gflops  [" << w.timer.get_elapsed() << " s]" << std::endl;
+  }
+
+  void run()
+  {
+    std::signal(SIGPIPE, SIG_IGN);
+    for (auto& w : workers)
+    {
+      spawn(w);
+    }
+
+    auto n_busy = [this]() {
+      size_t n = 0;
+      for (auto& w : workers)
+      {
+        n += w.busy;
+      }
+      return n;
+    };
+
+    while (pending.size() > 0 || n_busy() > 0)
+    {
+      for (auto& w : workers)
+      {
+        // the first pending task which did not fail on w (with one worker, any)
+        auto next = std::find_if(pending.begin(), pending.end(), [this, &w](size_t ti) {
+          return tasks[ti].failed_worker != w.worker_id || workers.size() == 1;
+        });
+        if (!w.busy && next != pending.end())
+        {
+          w.task_index = *next;
+          pending.erase(next);
+          auto& task = tasks[w.task_index];
+          w.busy     = true;
+          w.timer.start();
+          if (!write_all(w.task_fd,
+                         task.gg.get_string() + '\t' + task.constraints.get_string() + '\n'))
+          {
+            requeue(w, "broken pipe");
+            retire(w, true);
+            spawn(w);
+          }
+        }
+      }
+
+      std::vector<pollfd> pfds;
+      std::vector<size_t> pfd_workers;
+      for (size_t wi = 0; wi < workers.size(); ++wi)
+      {
+        if (workers[wi].busy)
+        {
+          pfds.push_back({workers[wi].result_fd, POLLIN, 0});
+          pfd_workers.push_back(wi);
+        }
+      }
+      if (pfds.size() > 0)
+      {
+        poll(pfds.data(), pfds.size(), 1000);
+      }
+
+      for (size_t pi = 0; pi < pfds.size(); ++pi)
+      {
+        auto& w = workers[pfd_workers[pi]];
+        if (pfds[pi].revents & (POLLIN | POLLHUP | POLLERR))
+        {
+          char buf[4096];
+          auto n = read(w.result_fd, buf, sizeof(buf));
+          if (n <= 0)
+          {
+            requeue(w, "crashed");
+            retire(w, false);
+            spawn(w);
+            continue;
+          }
+          w.buffer.append(buf, static_cast<size_t>(n));
+          auto newline = w.buffer.find('\n');
+          if (newline != std::string::npos)
+          {
+            process_line(w, w.buffer.substr(0, newline));
+            w.buffer.erase(0, newline + 1);
+            if (w.n_finds >= max_finds_per_worker)
+            {
+              retire(w, false);
+              spawn(w);
+            }
+          }
+        }
+
+        else if (w.timer.get_elapsed() > timeout_factor * pp.seconds_per_find + compile_slack)
+        {
+          requeue(w, "timed out");
+          retire(w, true);
+          spawn(w);
+        }
+      }
+    }
+
+    for (auto& w : workers)
+    {
+      retire(w, false);
+    }
+  }
+
+  void report_workers() const
+  {
+    for (auto& w : workers)
+    {
+      std::cout << "worker " << w.worker_id << " : " << w.n_found << " found, failures :";
+      if (w.failures.size() == 0)
+      {
+        std::cout << " none";
+      }
+      for (auto& x : w.failures)
+      {
+        std::cout << ' ' << x.first << " x" << x.second;
+      }
+      std::cout << std::endl;
+    }
+  }
+};
+
+std::vector<Task> get_tasks(const std::string& fn)
+{
+  std::ifstream     fin(fn);
+  std::vector<Task> tasks;
+  std::string       line;
+  if (!fin.good())
+  {
+    throw miog_error("failed to open geometries file " + fn);
+  }
+  while (std::getline(fin, line))
+  {
+    auto frags = stringutil::split(line);
+    if (frags.size() == 0 || frags[0][0] == '#')
+    {
+      continue;
+    }
+    tasks.push_back(
+      {Geometry(frags[0]), Constraints(frags.size() > 1 ? frags[1] : ""), 0, no_worker});
+  }
+  return tasks;
+}
+}
+
+int main(int argc, char* argv[])
+{
+
+  using namespace MIOpenGEMM;
+
+  std::vector<std::string> sargs(argv + 1, argv + argc);
+  if (sargs.size() < 3 || sargs.size() > 6)
+  {
+    throw miog_error("should be 3 - 6 arguments in multifindpool : geometries_file output_file "
+                     "n_workers (seconds_per_find) (platform_id) (n_devices)");
+  }
+
+  PoolParams pp;
+  size_t     n_workers = std::stoul(sargs[2]);
+  if (sargs.size() > 3)
+  {
+    pp.seconds_per_find = std::stod(sargs[3]);
+  }
+  if (sargs.size() > 4)
+  {
+    pp.platform_id = std::stoul(sargs[4]);
+  }
+  if (sargs.size() > 5)
+  {
+    pp.n_devices = std::stoul(sargs[5]);
+  }
+
+  auto tasks   = get_tasks(sargs[0]);
+  auto n_tasks = tasks.size();
+  std::cout << "n geometries : " << n_tasks << ",  n workers : " << n_workers << std::endl;
+
+  Timer timer;
+  timer.start();
+  Pool pool(pp, std::move(tasks), n_workers);
+  pool.run();
+  pool.report_workers();
+
+  // merge, keeping the fastest where a key was found more than once (e.g. a geometry and its
+  // transpose which share a canonical form)
+  std::map<std::string, size_t> best;
+  for (size_t ri = 0; ri < pool.results.size(); ++ri)
+  {
+    auto& key = pool.results[ri].ck.concatenated;
+    if (best.count(key) == 0 || pool.results[ri].extime < pool.results[best[key]].extime)
+    {
+      best[key] = ri;
+    }
+  }
+
+  KernelCache   kc;
+  std::ofstream fout(sargs[1], std::ios::out);
+  for (auto& x : best)
+  {
+    auto& result = pool.results[x.second];
+    kc.add(result.ck, result.hp);
+    // the run statistics are kept as a comment above the entry
+    fout << '\n' << get_cache_entry_string(result.ck, result.hp, false, result.stats);
+  }
+  fout.close();
+
+  std::cout << "found " << pool.results.size() << " of " << n_tasks << " in " << timer.get_elapsed()
+            << " s, " << pool.failed.size() << " failed, " << kc.get_keys().size()
+            << " cache entries written to " << sargs[1] << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/predictor.hpp>
+#include <miopengemm/timer.hpp>
+
+// Train a predictor (one classification tree per hyper-parameter) on the kernel cache, write it
+// to a file which get_default_soln can use (see set_predictor_path), and score it against the
+// nearest neighbor with a leave-one-out evaluation : each entry in turn is removed, the
+// predictor retrained on the rest, and the prediction for the removed geometry compared with
+// its cached HyPas, as is the HyPas of its nearest neighbor. No GPU is required.
+//
+// usage : trainpredictor output_file (device_frag) (max_depth) (min_leaf) (loo_stride)
+//   device_frag  train on the entries whose device contains device_frag, "all" (default) for all
+//   max_depth    of the trees (default 6)
+//   min_leaf     minimum number of entries per leaf (default 4)
+//   loo_stride   evaluate on every loo_stride'th entry (default 1), 0 to skip the evaluation
+
+int main(int argc, char* argv[])
+{
+
+  using namespace MIOpenGEMM;
+
+  std::vector<std::string> sargs(argv + 1, argv + argc);
+  if (sargs.size() < 1 || sargs.size() > 5)
+  {
+    throw miog_error(
+      "usage : trainpredictor output_file (device_frag) (max_depth) (min_leaf) (loo_stride)");
+  }
+  std::string device_frag = sargs.size() > 1 ? sargs[1] : "all";
+  size_t      max_depth   = sargs.size() > 2 ? std::stoul(sargs[2]) : 6;
+  size_t      min_leaf    = sargs.size() > 3 ? std::stoul(sargs[3]) : 4;
+  size_t      loo_stride  = sargs.size() > 4 ? std::stoul(sargs[4]) : 1;
+
+  auto&& kernel_cache = get_kernel_cache();
+  auto   cache_keys   = kernel_cache.get_keys();
+  if (device_frag != "all")
+  {
+    filter_device(cache_keys, {device_frag});
+  }
+  if (cache_keys.size() < 2)
+  {
+    throw miog_error("too few cache entries to train on");
+  }
+
+  // a device specific predictor if all the entries are from one device
+  std::string dvc = cache_keys[0].dvc;
+  for (auto& ck : cache_keys)
+  {
+    dvc = ck.dvc == dvc ? dvc : "";
+  }
+
+  std::vector<Geometry> geometries;
+  std::vector<HyPas>    hps;
+  for (auto& ck : cache_keys)
+  {
+    geometries.push_back(ck.gg);
+    hps.push_back(kernel_cache.at(ck));
+  }
+
+  Timer timer;
+  timer.start();
+  predictor::Predictor model(dvc, geometries, hps, max_depth, min_leaf);
+  std::cout << "trained on " << hps.size() << " entries in " << timer.get_elapsed() << " [s]"
+            << std::endl;
+  predictor::write(model, sargs[0]);
+  std::cout << "written to " << sargs[0] << std::endl;
+
+  if (loo_stride == 0)
+  {
+    return 0;
+  }
+
+  // per hyper-parameter agreement with the held out HyPas, of the prediction and the neighbor
+  std::array<std::vector<size_t>, Mat::E::N> n_predicted_agree;
+  std::array<std::vector<size_t>, Mat::E::N> n_nearest_agree;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    n_predicted_agree[emat].resize(hps[0].sus[emat].vs.size(), 0);
+    n_nearest_agree[emat].resize(hps[0].sus[emat].vs.size(), 0);
+  }
+  size_t n_evaluated       = 0;
+  size_t n_predicted_exact = 0;
+  size_t n_nearest_exact   = 0;
+
+  timer.start();
+  for (size_t i = 0; i < cache_keys.size(); i += loo_stride)
+  {
+    auto loo_geometries = geometries;
+    auto loo_hps        = hps;
+    loo_geometries.erase(loo_geometries.begin() + i);
+    loo_hps.erase(loo_hps.begin() + i);
+    predictor::Predictor loo_model(dvc, loo_geometries, loo_hps, max_depth, min_leaf);
+    HyPas                predicted = loo_model.predict(geometries[i]);
+
+    size_t nearest          = i;
+    double nearest_distance = std::numeric_limits<double>::max();
+    for (size_t j = 0; j < cache_keys.size(); ++j)
+    {
+      double distance = cache_keys[i].get_distance(cache_keys[j]);
+      if (j != i && distance < nearest_distance)
+      {
+        nearest          = j;
+        nearest_distance = distance;
+      }
+    }
+
+    for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+    {
+      for (size_t p = 0; p < hps[i].sus[emat].vs.size(); ++p)
+      {
+        n_predicted_agree[emat][p] += predicted.sus[emat].vs[p] == hps[i].sus[emat].vs[p];
+        n_nearest_agree[emat][p] += hps[nearest].sus[emat].vs[p] == hps[i].sus[emat].vs[p];
+      }
+    }
+    n_predicted_exact += predicted == hps[i];
+    n_nearest_exact += hps[nearest] == hps[i];
+    ++n_evaluated;
+  }
+
+  std::cout << "\nleave-one-out on " << n_evaluated << " entries, " << timer.get_elapsed()
+            << " [s]. Fraction of held out values reproduced :\n"
+            << "parameter   predictor   nearest neighbor\n";
+  double predicted_total = 0;
+  double nearest_total   = 0;
+  size_t n_params        = 0;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    for (size_t p = 0; p < n_predicted_agree[emat].size(); ++p)
+    {
+      std::string name = std::string(1, Mat::M().name[emat]) + "_" +
+                         (emat == Mat::E::C ? NonChi::M().name[p] : Chi::M().name[p]);
+      double predicted_fraction = n_predicted_agree[emat][p] / static_cast<double>(n_evaluated);
+      double nearest_fraction   = n_nearest_agree[emat][p] / static_cast<double>(n_evaluated);
+      std::cout << std::left << std::setw(12) << name << std::setw(12) << predicted_fraction
+                << nearest_fraction << '\n';
+      predicted_total += predicted_fraction;
+      nearest_total += nearest_fraction;
+      ++n_params;
+    }
+  }
+  std::cout << std::setw(12) << "mean" << std::setw(12) << predicted_total / n_params
+            << nearest_total / n_params << '\n'
+            << std::setw(12) << "all" << std::setw(12)
+            << n_predicted_exact / static_cast<double>(n_evaluated)
+            << n_nearest_exact / static_cast<double>(n_evaluated) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <miopengemm/error.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+
+// Writes the built-in kernel cache (the cacheN.cachetxt files, linked in with
+// MIOPENGEMM_BUILTIN_CACHE_TEXT) as a binary kernel cache file, and that file as the bytes of a C
+// array, which kernelcachebuiltin.cpp compiles into the library. Run at build time.
+//
+// usage : cachegen binary_file inc_file
+
+int main(int argc, char* argv[])
+{
+
+  using namespace MIOpenGEMM;
+
+  if (argc != 3)
+  {
+    throw miog_error("should be 2 arguments in cachegen : binary_file inc_file");
+  }
+  std::string binary_file = argv[1];
+  std::string inc_file    = argv[2];
+
+  KernelCache kc = init_kernel_cache();
+  cachefile::write(kc, binary_file);
+
+  // the library only decodes the file, which should give back every entry
+  auto reread = cachefile::read(binary_file);
+  for (auto& ck : kc.get_keys())
+  {
+    if (reread.check_for(ck).is_present == false || !(reread.at(ck) == kc.at(ck)))
+    {
+      throw miog_error("round trip failed for " + ck.get_string() + " (in cachegen)");
+    }
+  }
+
+  std::ifstream     fin(binary_file, std::ios::in | std::ios::binary);
+  std::stringstream bytes;
+  bytes << fin.rdbuf();
+
+  std::ofstream fout(inc_file, std::ios::out);
+  if (!fout.good())
+  {
+    throw miog_error("failed to open `" + inc_file + "' for writing");
+  }
+  fout << "// generated by cachegen from the cacheN.cachetxt files, do not edit\n";
+  size_t i = 0;
+  for (unsigned char c : bytes.str())
+  {
+    fout << static_cast<unsigned>(c) << (++i % 24 == 0 ? ",\n" : ",");
+  }
+  fout << '\n';
+
+  std::cout << kc.get_keys().size() << " entries, " << i << " bytes written to " << inc_file
+            << std::endl;
+  return 0;
+}
@@ -5,16 +5,22 @@
 #define GUARD_MIOPENGEMM_ALPHAGENERATOR_HPP
 
 #include <miopengemm/derivedparams.hpp>
+#include <miopengemm/epilogue.hpp>
 #include <miopengemm/error.hpp>
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/kernelstring.hpp>
+#include <miopengemm/multigemm.hpp>
 
 namespace MIOpenGEMM
 {
 namespace alphagen
 {
 
-KernBlob get_alpha_kernelstring(const HyPas& hp, const Geometry& gg, const DerivedParams& dp);
+KernBlob get_alpha_kernelstring(const HyPas&         hp,
+                                const Geometry&      gg,
+                                const DerivedParams& dp,
+                                const Epilogue&      epilogue  = Epilogue(),
+                                const MultiGemm&     multigemm = MultiGemm());
 }
 }
 
@@ -4,6 +4,9 @@
 #ifndef GUARD_MIOPENGEMM_BASEGENERATOR_HPP
 #define GUARD_MIOPENGEMM_BASEGENERATOR_HPP
 
+#include <sstream>
+#include <string>
+#include <vector>
 #include <miopengemm/derivedparams.hpp>
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/hyperparams.hpp>
@@ -14,6 +17,31 @@ namespace MIOpenGEMM
 {
 namespace basegen
 {
+
+// A static block of kernel source with parameters, written ${NAME}. It is parsed once (generators
+// keep their Fragments as statics), so generating a kernel only writes the text between the
+// parameters and the values substituted.
+class Fragment
+{
+  public:
+  // names are the parameters, in the order of the values in append. Throws if text has a
+  // parameter which is not in names.
+  Fragment(const std::string& text, const std::vector<std::string>& names);
+
+  // append the block to ss, with values[i] substituted for names[i]
+  void append(std::stringstream& ss, const std::vector<std::string>& values) const;
+
+  // as text without its comment lines (which start with "/*"), for kernels which
+  // are commented once
+  static std::string get_uncommented(const std::string& text);
+
+  private:
+  size_t n_names;
+  // text[i] is followed by the value of names[params[i]], the last text by nothing
+  std::vector<std::string> text;
+  std::vector<size_t>      params;
+};
+
 class BaseGenerator
 {
 
@@ -37,6 +65,7 @@ class BaseGenerator
   bool u_w = false;
   bool u_alpha = false;
   bool u_beta = false;
+  bool u_bias = false;
 
   std::string get_time_string();
   std::string get_what_string();
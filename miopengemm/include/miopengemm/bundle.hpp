@@ -6,6 +6,8 @@
 
 #include <string>
 #include <miopengemm/derivedparams.hpp>
+#include <miopengemm/epilogue.hpp>
+#include <miopengemm/multigemm.hpp>
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/kernelstring.hpp>
 
@@ -15,18 +17,28 @@ namespace MIOpenGEMM
 namespace kerngen
 {
 
-// parameter order rule: {a, oa, b, ob, c, oc, ws, ows}, alpha, beta
+// parameter order rule: {a, oa, b, ob, c, oc, ws, ows}, alpha, beta, {bias, obias}
 std::vector<std::pair<size_t, const void*>>
 get_arg_sizes_values(const KernBlob& kblob,
                      const std::array<cl_mem, Mem::E::N>& cl_mems,
                      const std::array<size_t, Mem::E::N>& offsets,
-                     size_t      float_size_bytes,
-                     const void* alpha,
-                     const void* beta);
+                     size_t        float_size_bytes,
+                     const void*   alpha,
+                     const void*   beta,
+                     const cl_mem* bias        = nullptr,
+                     const size_t* bias_offset = nullptr);
 
 std::vector<std::vector<size_t>> get_v_wait_indices(const std::vector<KernBlob>& v_kblobs,
                                                     owrite::Writer&              mowri);
 
+// generate the kernels of hp for gg (dp of hp and gg), not memoized. The main kernel applies the
+// epilogue (see confirm_epilogue), and computes the products of multigemm (see confirm_multigemm).
+std::vector<KernBlob> get_kernblobs(const HyPas&         hp,
+                                    const Geometry&      gg,
+                                    const DerivedParams& dp,
+                                    const Epilogue&      epilogue  = Epilogue(),
+                                    const MultiGemm&     multigemm = MultiGemm());
+
 class Bundle
 {
   public:
@@ -36,6 +48,8 @@ class Bundle
   DerivedParams         dp;
   std::vector<KernBlob> v_tgks;
 
+  // the kernels are memoized (bounded) by packed HyPas and Geometry, so that repeated
+  // (HyPas, Geometry) pairs in searches are not regenerated.
   Bundle(const HyPas& hp, const Geometry& gg);
 };
 }
@@ -46,9 +46,10 @@ class ByLineGenerator : public prepgen::PrepGenerator
   void append_positioning_x_string(std::stringstream& ss);
   void append_inner_work(std::stringstream& ss);
   void append_work_string(std::stringstream& ss);
-  void append_positioning_w_string(std::stringstream& ss);
 
   protected:
+  // moving w to where this work item works, for kernels using w
+  virtual void append_positioning_w_string(std::stringstream& ss);
   virtual void setup_additional()                                           = 0;
   virtual void append_derived_definitions_additional(std::stringstream& ss) = 0;
 };
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_COSTMODEL_HPP
+#define GUARD_MIOPENGEMM_COSTMODEL_HPP
+
+#include <string>
+#include <miopengemm/findparams.hpp>
+#include <miopengemm/hint.hpp>
+#include <miopengemm/hyperparams.hpp>
+#include <miopengemm/outputwriter.hpp>
+
+namespace MIOpenGEMM
+{
+namespace costmodel
+{
+
+// The GFLOPs of a kernel (HyPas) on a Geometry, for comparing HyPas on the same Geometry.
+class CostModel
+{
+  public:
+  virtual ~CostModel() = default;
+  // hp must be derivable for gg
+  virtual double get_gflops(const HyPas& hp, const Geometry& gg) = 0;
+  virtual std::string get_name() const                            = 0;
+};
+
+// A GPU-free roofline estimate from the DerivedParams : the peak rate is reduced by padding of
+// the macro tiles, by the last partial wave of work groups, by too few work items to fill the
+// device, by the LDS loads per FMA of the micro tile and by split-k (ICE) atomics, and capped
+// by the global memory bandwidth at the arithmetic intensity of the macro tile. Only the
+// relative values of different HyPas on the same Geometry are meaningful.
+class Analytic : public CostModel
+{
+  public:
+  size_t n_compute_units;
+  double clock_mhz;
+  double bandwidth_gbs;
+
+  Analytic(size_t n_compute_units, double clock_mhz, double bandwidth_gbs);
+  // with the compute units and clock of devinfo, where available
+  Analytic(const oclutil::DevInfo& devinfo);
+
+  virtual double get_gflops(const HyPas& hp, const Geometry& gg) override;
+  virtual std::string get_name() const override;
+};
+
+// Measured on a device : the median of the runs (as bounded by halt) of the compiled kernels.
+class Measured : public CostModel
+{
+  public:
+  Measured(const CLHint& hint, const Halt& halt, owrite::Writer& mowri);
+
+  virtual double get_gflops(const HyPas& hp, const Geometry& gg) override;
+  virtual std::string get_name() const override;
+
+  private:
+  CLHint          hint;
+  Halt            halt;
+  owrite::Writer& mowri;
+};
+}
+}
+
+#endif
@@ -14,6 +14,9 @@ namespace MIOpenGEMM
 namespace cpugemm
 {
 
+// A, B and C of TFloat. Half (floattype 'h', and 'n' where only accumulation differs)
+// accumulates in float. For std::complex (floattypes 'c' and 'z'), gg.cX conjugates A and B.
+// With a triangle of C (gg.uplo), as in all the gemms, the other triangle of C is unchanged.
 template <typename TFloat>
 void gemm(Geometry        gg,
           Offsets         toff,
@@ -23,6 +26,36 @@ void gemm(Geometry        gg,
           TFloat          alpha,
           TFloat          beta,
           owrite::Writer& mowri);
+
+// mixed precision floattype 'm' : A and B half, C and accumulation float
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const half*     a,
+          const half*     b,
+          float*          c,
+          float           alpha,
+          float           beta,
+          owrite::Writer& mowri);
+
+// integer floattype 'i' : A and B int8, C and accumulation int32
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const int8_t*   a,
+          const int8_t*   b,
+          int32_t*        c,
+          int32_t         alpha,
+          int32_t         beta,
+          owrite::Writer& mowri);
+
+// integer floattype 'q' : A, B and C int8, C = saturate(round(scale * AB + zero_point))
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const int8_t*   a,
+          const int8_t*   b,
+          int8_t*         c,
+          float           scale,
+          float           zero_point,
+          owrite::Writer& mowri);
 }
 }
 
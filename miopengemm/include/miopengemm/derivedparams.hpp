@@ -18,6 +18,8 @@ namespace MIOpenGEMM
 
 const size_t uninitialised_size_t = std::numeric_limits<size_t>::max();
 
+// Cheap checks reject most non-derivable HyPas before a DerivedParams is constructed, and
+// results are memoized (bounded) by packed HyPas and Geometry.
 class Derivabilty
 {
   public:
@@ -108,20 +110,31 @@ class DerivedParams
 
   size_t main_n_work_items_per_workgroup = uninitialised_size_t;
   size_t main_n_work_groups              = uninitialised_size_t;
+  // (tile, split in k) units of work : one per work group, unless STK persistent work groups
+  size_t main_n_work_units = uninitialised_size_t;
   size_t main_global_work_size           = uninitialised_size_t;
 
   size_t main_split_on_k              = uninitialised_size_t;
   size_t main_does_beta_c_inc         = uninitialised_size_t;
   size_t main_use_edge_trick          = uninitialised_size_t;
   size_t main_final_fractional_unroll = uninitialised_size_t;
+  // split-k writing partial sums to workspace, for the reduction kernel (ICE != 1 and RED = 1)
+  size_t main_writes_partials = uninitialised_size_t;
 
   // specific to scaling kernel, betac
   size_t betac_local_work_size = uninitialised_size_t;
   size_t betac_work_per_thread = uninitialised_size_t;
 
+  // specific to reduction kernel. The partial sums (TFLOAT_ACC) start at red_global_offset
+  // (TFLOAT_AB) in workspace, one C footprint of red_partial_stride per split of k.
+  size_t red_local_work_size = uninitialised_size_t;
+  size_t red_work_per_thread = uninitialised_size_t;
+  size_t red_global_offset   = uninitialised_size_t;
+  size_t red_partial_stride  = uninitialised_size_t;
+
   size_t cw2_n_macro_tiles_pll_unroll = uninitialised_size_t;
 
-  // the int type for atomics
+  // the int type for atomics (for half, of the 32-bit word containing the value)
   std::string infa;
   // the function to use for atomic ints
   std::string fati;
@@ -134,8 +147,18 @@ class DerivedParams
 
   // pragma unroll string : #pragma unroll\n or ""
   std::string pragma_unroll_string;
-  //* currently one of "float" and "double", set from float_size
+  //* currently one of "half", "float" and "double" : of C, alpha and beta
   std::string t_float;
+  // of A, B and workspace (storage)
+  std::string t_float_ab;
+  // of accumulation (compute)
+  std::string t_float_acc;
+  // of alpha and beta
+  std::string t_float_scalar;
+  // enabling the extension if any of these is half : #pragma OPENCL EXTENSION cl_khr_fp16 ... or ""
+  std::string t_float_pragma_string;
+  // the complex product of TFLOATs : #define CMUL(x, y) ... or ""
+  std::string t_float_complex_string;
 
   // GA 3 specific derived parameters
   size_t ga3_super_column_width      = uninitialised_size_t;
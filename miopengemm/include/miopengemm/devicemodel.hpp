@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_DEVICEMODEL_HPP
+#define GUARD_MIOPENGEMM_DEVICEMODEL_HPP
+
+#include <string>
+#include <miopengemm/hyperparams.hpp>
+#include <miopengemm/oclutil.hpp>
+
+namespace MIOpenGEMM
+{
+namespace devicemodel
+{
+
+// The properties of a device which the choice of HyPas depends on. 0 where unknown.
+class Descriptor
+{
+  public:
+  std::string identifier;
+  // architecture family, as gfx8 for gfx803
+  std::string family;
+  size_t      n_compute_units{0};
+  size_t      local_mem_size{0};
+  size_t      max_work_group_size{0};
+  size_t      clock_mhz{0};
+  size_t      wg_atom_size{0};
+
+  Descriptor() = default;
+  // the fields of DevInfo which are 0 (as with get_vega_devinfo) are taken from the built-in
+  // descriptor of its identifier, if there is one
+  Descriptor(const oclutil::DevInfo&);
+
+  bool        is_complete() const;
+  std::string get_string() const;
+};
+
+std::string get_family(const std::string& identifier);
+
+// The Descriptor of a device identifier (CacheKey::dvc) : registered with register_device, else
+// built-in (the devices in the kernel cache, and a few others), else with only the family known.
+Descriptor get_descriptor(const std::string& identifier);
+
+// Make the Descriptor of a device available to get_descriptor. A DevInfo with unknown fields
+// does not replace a Descriptor already available.
+void register_device(const oclutil::DevInfo&);
+
+// In [0, 1] : 0 for the same identifier, else a difference in architecture family counts 0.5,
+// and the mean over the numeric properties of min(1, |log2(ratio)|) counts 0.5, an unknown
+// property counting 0.5. At least 1e-6 for different identifiers.
+double get_distance(const Descriptor&, const Descriptor&);
+
+// get_distance of the Descriptors of identifiers (memoized)
+double get_distance(const std::string& identifier1, const std::string& identifier2);
+
+// can kernels of hp for gg run on the device? see architests::Stat. true if the work group size
+// and LDS limits of the device are unknown.
+bool can_run(const Descriptor&, const HyPas& hp, const Geometry& gg);
+}
+}
+
+#endif
@@ -5,9 +5,11 @@
 #define GUARD_MIOPENGEMM_ALLENUMS_HPP
 
 #include <array>
+#include <complex>
 #include <unordered_map>
 #include <vector>
 #include <miopengemm/error.hpp>
+#include <miopengemm/half.hpp>
 
 namespace MIOpenGEMM
 {
@@ -21,8 +23,12 @@ const double& get_default_beta();
 class MFType
 {
   private:
-  double v_d;
-  float  v_f;
+  double               v_d;
+  float                v_f;
+  half                 v_h;
+  int32_t              v_i;
+  std::complex<float>  v_c;
+  std::complex<double> v_z;
 
   public:
   MFType(double v);
@@ -60,6 +66,19 @@ enum E
 const EnumMapper<std::string>& M();
 }
 
+// how a kernel is judged faster than the current best in find
+namespace BestTest
+{
+enum E
+{
+  RATIO = 0,  // improvement factor on the SummStat
+  WELCH,      // one-sided Welch t-test on the mean, at 95%
+  DISJOINT,   // 95% confidence intervals of the mean do not overlap
+  N
+};
+const EnumMapper<std::string>& M();
+}
+
 namespace Xtr
 {
 enum E
@@ -107,6 +126,8 @@ enum E
   SKW,      // skewness of work-item grid of work group
   AFI,      // do A loops and defs first. outerloops over a dimensions.
   MIA,      // work item allocation within workgroup : % or /
+  RED,      // (if ICE != 1) partial sums to workspace, reduced in a fixed order (deterministic)
+  STK,      // (if not 0) number of persistent work groups, sharing the work units (stream-K)
   N
 };
 const EnumMapper<std::string>& M();
@@ -195,6 +216,56 @@ enum E
 const EnumMapper<std::string>& M();
 }
 
+// the epilogue of the main kernel, see Epilogue
+namespace Bias
+{
+enum E
+{
+  NONE = 0,
+  ROW,  // one value per row of C (m values)
+  COL,  // one value per column of C (n values)
+  N
+};
+const EnumMapper<std::string>& M();
+}
+
+namespace Activation
+{
+enum E
+{
+  NONE = 0,
+  RELU,
+  GELU,  // the tanh approximation
+  N
+};
+const EnumMapper<std::string>& M();
+}
+
+namespace Conversion
+{
+enum E
+{
+  DEFAULT = 0,  // as the type of C converts
+  SATURATE,     // clamped to the finite range of the type of C first
+  N
+};
+const EnumMapper<std::string>& M();
+}
+
+// the triangle of C computed, as by SYRK : all of C, or only the elements on or below (above) the
+// diagonal. The other elements of C are not read or written.
+namespace Uplo
+{
+enum E
+{
+  NONE = 0,
+  LOWER,
+  UPPER,
+  N
+};
+const EnumMapper<std::string>& M();
+}
+
 namespace Scratch
 {
 enum E
@@ -253,6 +324,8 @@ enum E
   WSB,
   BETAC,
   MAIN,
+  REDUCE,
+  ADD,  // the sums of blocks of the Strassen-Winograd layer
   N  // how many KTypes
 };
 const EnumMapper<std::string>& M();
@@ -260,7 +333,7 @@ const EnumMapper<std::string>& M();
 // maps the dependencices of kernels, order of execution
 // For example deps[MAIN] = {WSA, WSB, BETAC},
 // as all of these must first complete
-// before MAIN can execute
+// before MAIN can execute, and deps[REDUCE] = {MAIN}
 const std::array<std::vector<size_t>, KType::N>& get_dependencies();
 }
 }
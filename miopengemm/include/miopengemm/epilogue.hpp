@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_EPILOGUE_HPP
+#define GUARD_MIOPENGEMM_EPILOGUE_HPP
+
+#include <string>
+#include <miopengemm/enums.hpp>
+
+namespace MIOpenGEMM
+{
+
+class Geometry;
+class DerivedParams;
+
+/*! @brief
+ * Applied in registers by the main kernel as it writes C :
+ * \f$ C \leftarrow conversion(activation(\alpha op(A) op(B) + \beta C + bias)) \f$.
+ * It is compiled into the kernel, so the default (identity) Epilogue costs nothing.
+ */
+class Epilogue
+{
+  public:
+  Bias::E       bias       = Bias::E::NONE;
+  Activation::E activation = Activation::E::NONE;
+  Conversion::E conversion = Conversion::E::DEFAULT;
+
+  Epilogue() = default;
+  Epilogue(Bias::E bias, Activation::E activation, Conversion::E conversion);
+
+  bool is_identity() const;
+
+  // empty for the identity, otherwise as BIASROW_ACTRELU_CNVDEFAULT. Part of program cache keys.
+  std::string get_string() const;
+
+  bool operator==(const Epilogue& rhs) const;
+};
+
+// throws if the main kernel of (gg, dp) cannot apply the epilogue : it needs the final value of
+// each element of C (ICE = 1), and a real, not requantised, C. GELU needs a floating point C.
+void confirm_epilogue(const Epilogue& epilogue, const Geometry& gg, const DerivedParams& dp);
+}
+
+#endif
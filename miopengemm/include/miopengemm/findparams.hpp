@@ -40,6 +40,16 @@ class FindParams
 
   SummStat::E sumstat;
 
+  // number of nearest kernel cache entries to quickly benchmark before the first descent.
+  // The fastest seeds the first descent, the next fastest the next warm started one, etc.
+  size_t n_warm_starts{6};
+
+  // how a kernel is judged faster than the current best
+  BestTest::E besttest{BestTest::E::RATIO};
+
+  // re-measure the current best after this many kernels, to detect clock drift (0 : never)
+  size_t remeasure_period{10};
+
   FindParams(std::array<size_t, Xtr::E::N> descents,
              std::array<double, Xtr::E::N> time_outer,
              std::array<size_t, Xtr::E::N> per_kernel,
@@ -5,6 +5,7 @@
 #define GUARD_MIOPENGEMM_FLOATTOSTRING_HPP
 
 #include <string>
+#include <miopengemm/half.hpp>
 
 namespace MIOpenGEMM
 {
@@ -15,10 +16,14 @@ std::string float_string_type(double x);
 
 std::string float_string_type(float x);
 
+std::string float_string_type(half x);
+
 char float_char_type(double x);
 
 char float_char_type(float x);
 
+char float_char_type(half x);
+
 template <typename TFloat>
 char get_float_char()
 {
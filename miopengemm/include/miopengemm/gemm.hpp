@@ -4,6 +4,9 @@
 #ifndef GUARD_MIOPENGEMM_GEMMAPI_HPP
 #define GUARD_MIOPENGEMM_GEMMAPI_HPP
 
+#include <miopengemm/epilogue.hpp>
+#include <miopengemm/half.hpp>
+#include <miopengemm/multigemm.hpp>
 #include <miopengemm/platform.hpp>
 
 namespace MIOpenGEMM
@@ -38,6 +41,7 @@ void free(size_t ID);
  * - \f$ C \leftarrow \alpha op(A) op(B) + \beta C \f$
  * To get started with understanding GEMM parameters
  * isColMajor, tA, tB, m, n, k lda, ldb, ldc, alpha and beta see (TODO).
+ * T is one of float, double and MIOpenGEMM::half (the device should support cl_khr_fp16).
  *
  * @param a
  * memory buffer for matrix A
@@ -112,6 +116,180 @@ GemmStatus xgemm(bool              isColMajor,
                  cl_event*         ptr_event,
                  int               ID);
 
+/*! @brief
+ * GEneral Matric Multiplication with an Epilogue, fused into the main kernel.
+ * - \f$ C \leftarrow conversion(activation(\alpha op(A) op(B) + \beta C + bias)) \f$
+ * The parameters are those of xgemm, and
+ *
+ * @param epilogue
+ * The bias, activation and conversion. Each epilogue is a distinct GEMM geometry for the ID,
+ * with its own kernels, which do not split on k
+ *
+ * @param bias
+ * memory buffer for the bias : m elements of type T (Bias::E::ROW), n elements (Bias::E::COL).
+ * Unused, and may be \b nullptr, for Bias::E::NONE
+ *
+ * @param bias_offset
+ * The number of elements of type T before the first bias element in bias
+ */
+
+template <typename T>
+GemmStatus xgemm(bool              isColMajor,
+                 bool              tA,
+                 bool              tB,
+                 size_t            m,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 cl_mem            b,
+                 size_t            b_offset,
+                 size_t            ldb,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 const Epilogue&   epilogue,
+                 cl_mem            bias,
+                 size_t            bias_offset,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event,
+                 int               ID);
+
+/*! @brief
+ * GEneral Matric Multiplications with one A, in one kernel.
+ * - \f$ C_i \leftarrow \alpha op(A) op(B_i) + \beta C_i \f$ for i = 0 ... n_products - 1
+ * The parameters are those of xgemm, with B_0 (C_0) at b_offset (c_offset) in b (c), and
+ *
+ * @param multigemm
+ * The number of products, and the number of elements of type T from B_i (C_i) to B_{i+1}
+ * (C_{i+1}). Each MultiGemm is a distinct GEMM geometry for the ID, with its own kernels, which
+ * load A once for all the B_i
+ */
+
+template <typename T>
+GemmStatus xgemm(bool              isColMajor,
+                 bool              tA,
+                 bool              tB,
+                 size_t            m,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 cl_mem            b,
+                 size_t            b_offset,
+                 size_t            ldb,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 const MultiGemm&  multigemm,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event,
+                 int               ID);
+
+/*! @brief
+ * GEneral Matric Multiplication with Strassen-Winograd (opt-in), for very large GEMMs.
+ * - \f$ C \leftarrow \alpha op(A) op(B) + \beta C \f$
+ * Each level replaces 8 sub-products of half size by 7, at the cost of add kernels and accuracy.
+ * The parameters are those of xgemm, T is float or double, and
+ *
+ * @param w
+ * workspace memory buffer, for the sums of blocks of A and B and the sub-products. A level is
+ * used only if w_size is at least strassen::get_workspace_size for it
+ *
+ * @param max_levels
+ * The maximum number of levels. The levels used are at most strassen::max_levels, and each
+ * requires m, n and k to be even and at least strassen::min_dim (see strassen.hpp). With no
+ * levels, this is xgemm
+ *
+ * @return
+ * A GemmStatus. Its ID is that of xgemm with no levels, otherwise -1 (the sub-products have theirs)
+ */
+
+template <typename T>
+GemmStatus xgemm_strassen(bool              isColMajor,
+                          bool              tA,
+                          bool              tB,
+                          size_t            m,
+                          size_t            n,
+                          size_t            k,
+                          T                 alpha,
+                          cl_mem            a,
+                          size_t            a_offset,
+                          size_t            lda,
+                          cl_mem            b,
+                          size_t            b_offset,
+                          size_t            ldb,
+                          T                 beta,
+                          cl_mem            c,
+                          size_t            c_offset,
+                          size_t            ldc,
+                          cl_mem            w,
+                          size_t            w_offset,
+                          size_t            w_size,
+                          size_t            max_levels,
+                          cl_command_queue* ptr_queue,
+                          cl_uint           num_events_in_wait_list,
+                          const cl_event*   event_wait_list,
+                          cl_event*         ptr_event);
+
+/*! @brief
+ * SYmmetric Rank-K update, of one triangle of C.
+ * - \f$ C \leftarrow \alpha op(A) op(A)^T + \beta C \f$
+ * This is xgemm with B = A (tB = !tA), m = n and a triangle of C : only the tiles of C on and to
+ * one side of the diagonal are launched, with the elements of the diagonal tiles on the other
+ * side masked. The parameters are those of xgemm, without b, and
+ *
+ * @param uplo
+ * The triangle of C to compute, Uplo::E::LOWER or Uplo::E::UPPER (of C with isColMajor). The
+ * elements of the other triangle are neither read nor written
+ *
+ * @param n
+ * C is n x n, op(A) is n x k
+ *
+ * @param ID
+ * As for xgemm. Each triangle is a distinct GEMM geometry, with its own kernels, which do not
+ * split on k
+ */
+
+template <typename T>
+GemmStatus xsyrk(bool              isColMajor,
+                 Uplo::E           uplo,
+                 bool              tA,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event,
+                 int               ID);
+
 /*! @brief
  * GEneral Matric Multiplication.
  * - \f$ C \leftarrow \alpha op(A) op(B) + \beta C \f$
@@ -4,9 +4,12 @@
 #ifndef GUARD_MIOPENGEMM_PROBLEMGEOMETRY_HPP
 #define GUARD_MIOPENGEMM_PROBLEMGEOMETRY_HPP
 
+#include <array>
+#include <complex>
 #include <string>
 #include <vector>
 #include <miopengemm/enums.hpp>
+#include <miopengemm/half.hpp>
 
 // TODO : namespace should be lower-case
 namespace MIOpenGEMM
@@ -39,27 +42,61 @@ Offsets get_zero_offsets();
 class GeometryDerived
 {
   public:
+  // the types ('h', 'f', 'd', complex 'c' (float2) and 'z' (double2), or for integer GEMM 'b'
+  // (int8) and 'i' (int32)) of C, of A and B (and the workspace), and of accumulation. All the
+  // same, except for the mixed precision floattypes 'm' and 'n' and the integer floattypes 'i'
+  // and 'q'.
+  char floattype_c;
+  char floattype_ab;
+  char floattype_acc;
+  // of alpha and beta : floattype_c, except float for 'q' (scale and zero point)
+  char floattype_scalar;
+
+  // of C
   size_t float_size_bits;
   size_t float_size_bytes;
+
+  size_t float_size_bytes_scalar;
+
+  // of A, B and workspace
+  size_t float_size_bits_ab;
+  size_t float_size_bytes_ab;
+
+  size_t float_size_bits_acc;
+
   void reset(char floattype);
+
+  // float_size_bytes_ab for A, B and W, float_size_bytes for C
+  size_t get_float_size_bytes(Mem::E emem) const;
+
+  bool is_mixed() const;
+
+  // C is int8, requantised from the int32 accumulation (floattype 'q')
+  bool is_requantised() const;
+
+  // values are pairs (real, imaginary) : floattype 'c' or 'z'
+  bool is_complex() const;
 };
 
 class Geometry
 {
 
   private:
-  void initialise(bool   isColMajor_,
-                  bool   tA_,
-                  bool   tB_,
-                  bool   tC_,
-                  size_t lda_,
-                  size_t ldb_,
-                  size_t ldc_,
-                  size_t m_,
-                  size_t n_,
-                  size_t k_,
-                  size_t wSpaceSize_,
-                  char   floattype_);
+  void initialise(bool    isColMajor_,
+                  bool    tA_,
+                  bool    tB_,
+                  bool    tC_,
+                  size_t  lda_,
+                  size_t  ldb_,
+                  size_t  ldc_,
+                  size_t  m_,
+                  size_t  n_,
+                  size_t  k_,
+                  size_t  wSpaceSize_,
+                  char    floattype_,
+                  bool    cA_,
+                  bool    cB_,
+                  Uplo::E uplo_);
 
   private:
   // log k ;  log m - log n ;  log m + log n, 0.2*(log ldx's)
@@ -77,37 +114,66 @@ class Geometry
   /*! leading dimensions, index by Mat::E::A, Mat::E::B, Mat::E::C. */
   std::vector<size_t> ldX;
 
+  /*! conjugate cases, index by Mat::E::A, Mat::E::B (Mat::E::C is always false). Only for the
+   *  complex floattypes, where with tX a conjugate transpose is op(X) = X^H */
+  std::vector<bool> cX;
+
   size_t m;
   size_t n;
   size_t k;
 
+  /*! the triangle of C computed (as by SYRK, where m == n), or all of C (Uplo::E::NONE). The
+   *  elements of C outside the triangle are not read or written. */
+  Uplo::E uplo;
+
   /*! usable amount of workspace, in number of values (i.e. not in bytes). */
   size_t wSpaceSize;
 
-  // TODO : investigate optional half-precision 'h'
-  // TODO : rename from floattype to numerictype, and consider integer matrix multiplication
-  /*! float type of values, currently either 'f' (32-bit single precision)
-   *  or 'd' (64-bit double precision). */
+  // TODO : rename from floattype to numerictype
+  /*! float type of values, currently one of 'h' (16-bit half precision, see half.hpp),
+   *  'f' (32-bit single precision) or 'd' (64-bit double precision), complex : 'c' (pairs of
+   *  single, as std::complex<float>) or 'z' (pairs of double), or mixed precision :
+   *  'm' (A and B half, C and accumulation float) or 'n' (A, B and C half, accumulation float),
+   *  or integer : 'i' (A and B int8, C and accumulation int32) or 'q' (A, B and C int8,
+   *  accumulation int32, C = saturate(round(alpha * AB + beta)) with alpha the scale and beta
+   *  the zero point, both float). */
   char floattype;
 
   public:
   GeometryDerived derived;
 
   template <typename T>
-  Geometry(bool   isColMajor_,
-           bool   tA_,
-           bool   tB_,
-           bool   tC_,
-           T      lda_,
-           T      ldb_,
-           T      ldc_,
-           T      m_,
-           T      n_,
-           T      k_,
-           size_t wSpaceSize_,
-           char   floattype_)
+  Geometry(bool    isColMajor_,
+           bool    tA_,
+           bool    tB_,
+           bool    tC_,
+           T       lda_,
+           T       ldb_,
+           T       ldc_,
+           T       m_,
+           T       n_,
+           T       k_,
+           size_t  wSpaceSize_,
+           char    floattype_,
+           bool    cA_   = false,
+           bool    cB_   = false,
+           Uplo::E uplo_ = Uplo::E::NONE)
   {
-    initialise(isColMajor_, tA_, tB_, tC_, lda_, ldb_, ldc_, m_, n_, k_, wSpaceSize_, floattype_);
+    initialise(isColMajor_,
+               tA_,
+               tB_,
+               tC_,
+               lda_,
+               ldb_,
+               ldc_,
+               m_,
+               n_,
+               k_,
+               wSpaceSize_,
+               floattype_,
+               cA_,
+               cB_,
+               uplo_);
   }
 
   /*! @brief
@@ -124,6 +190,9 @@ class Geometry
 
   bool operator==(const Geometry&) const;
 
+  // the fields defining a Geometry, for keys of memoized results
+  std::array<size_t, 15> get_fields() const;
+
   size_t get_padless_dim(Mat::E M, bool isCoal) const;
 
   size_t get_coal(Mat::E M) const;
@@ -165,6 +234,15 @@ char get_floattype_char<float>();
 template <>
 char get_floattype_char<double>();
 
+template <>
+char get_floattype_char<half>();
+
+template <>
+char get_floattype_char<std::complex<float>>();
+
+template <>
+char get_floattype_char<std::complex<double>>();
+
 template <typename TFloat>
 Geometry get_geometry_from_padding(bool   isColMajor,
                                    bool   tA,
@@ -7,6 +7,7 @@
 #include <array>
 #include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include <miopengemm/error.hpp>
 #include <miopengemm/geometry.hpp>
@@ -25,6 +26,7 @@ class SuGr
   virtual void initialise_edges() = 0;
   void         initialise_range();
   void         initialise_start_range();
+  void         initialise_membership();
   // certain geometries should not start at certain nodes, this function prunes
   virtual void refine_start_range() = 0;
   void         apply_constraint();
@@ -53,6 +55,11 @@ class SuGr
   // example : start_range[Chi::E::MIC] --> {2,8}. It can depend on geometry (from initialisation)
   std::vector<std::vector<size_t>> start_range;
 
+  // precomputed from range and edges, for fast look-up in contains and get_neighbors
+  // example : membership[Chi::E::MIC][v] points to edges[Chi::E::MIC].at(v) iff v is in
+  // range[Chi::E::MIC], else it is nullptr
+  std::vector<std::vector<const std::vector<size_t>*>> membership;
+
   void initialise();
 
   std::string get_string(size_t hpi) const;
@@ -61,6 +68,8 @@ class SuGr
   std::string get_start_range_string(size_t hpi) const;
   bool contains(size_t hpi, size_t val) const;
   bool contains(const SuHy&) const;
+  // the values one edge away from val, which should be in range[hpi]
+  const std::vector<size_t>& get_edges(size_t hpi, size_t val) const;
   SuHy get_random_start() const;
   void checks() const;
   virtual ~SuGr() = default;
@@ -108,11 +117,15 @@ class Graph
 {
 
   public:
-  Graph(const Geometry&, const oclutil::DevInfo&, const Constraints&, owrite::Writer&);
+  Graph(const Geometry&, const oclutil::DevInfo&, const Constraints&);
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
   // any node in the start graph.
-  HyPas              get_random_valid_start() const;
+  HyPas              get_random_valid_start(owrite::Writer&) const;
   std::vector<HyPas> get_neighbors(const HyPas&, bool prioritize) const;
   bool contains(const HyPas&) const;
+  const oclutil::DevInfo& get_devinfo() const { return devinfo; }
+  const Constraints&      get_constraints() const { return constraints; }
 
   private:
   // the number of attempts at finding a
@@ -122,17 +135,17 @@ class Graph
 
   std::vector<std::pair<std::pair<size_t, size_t>, std::pair<size_t, size_t>>> p_coupled;
 
+  // declared before the sub-graphs, which keep pointers to them.
+  Geometry         geometry;
+  oclutil::DevInfo devinfo;
+  Constraints      constraints;
+
   ASuGr       asubg;
   BSuGr       bsubg;
   CSuGr       csubg;
   const SuGr& at(size_t emat) const;
   // if you need a non-const version of above, page 23 of Meyers.
 
-  Geometry         geometry;
-  oclutil::DevInfo devinfo;
-  Constraints      constraints;
-  owrite::Writer&  mowri;  // this makes Graphs difficult to copy.
-
   std::vector<std::tuple<HyPas, int>> get_one_aways(const HyPas&) const;
 
   std::vector<std::tuple<HyPas, int>> get_mic_mac_transformed(const HyPas&) const;
@@ -144,6 +157,12 @@ class Graph
 
   bool contains(Mat::E, size_t hpi, size_t value) const;
 };
+
+// Graphs are memoized by (geometry, DevInfo, constraints), so constructing one is usually only done
+// once (the memo is bounded, and cleared when full).
+// Graphs hold pointers to their own members, so they are shared and never copied.
+std::shared_ptr<const Graph>
+get_graph(const Geometry&, const oclutil::DevInfo&, const Constraints&);
 }
 
 #endif
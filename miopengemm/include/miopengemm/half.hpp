@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_HALF_HPP
+#define GUARD_MIOPENGEMM_HALF_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace MIOpenGEMM
+{
+
+// IEEE 754 binary16, the host type of floattype 'h' (OpenCL half, cl_khr_fp16). Conversion from
+// float rounds to nearest even, arithmetic is performed in float.
+class half
+{
+  public:
+  uint16_t bits{0};
+
+  half() = default;
+
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  half(T x) : bits(get_bits(static_cast<float>(x)))
+  {
+  }
+
+  operator float() const { return get_float(bits); }
+
+  half& operator+=(float x) { return *this = static_cast<float>(*this) + x; }
+  half& operator-=(float x) { return *this = static_cast<float>(*this) - x; }
+  half& operator*=(float x) { return *this = static_cast<float>(*this) * x; }
+  half& operator/=(float x) { return *this = static_cast<float>(*this) / x; }
+
+  static half from_bits(uint16_t bits_)
+  {
+    half h;
+    h.bits = bits_;
+    return h;
+  }
+
+  static uint16_t get_bits(float x);
+  static float get_float(uint16_t bits_);
+};
+
+static_assert(sizeof(half) == 2, "half should be 2 bytes, as OpenCL half");
+}
+
+namespace std
+{
+template <>
+class numeric_limits<MIOpenGEMM::half>
+{
+  public:
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed      = true;
+  static constexpr bool is_integer     = false;
+  static constexpr bool is_exact       = false;
+  static constexpr bool has_infinity   = true;
+  static constexpr bool has_quiet_NaN  = true;
+  static constexpr int  digits         = 11;
+
+  static MIOpenGEMM::half min() { return MIOpenGEMM::half::from_bits(0x0400); }
+  static MIOpenGEMM::half max() { return MIOpenGEMM::half::from_bits(0x7bff); }
+  static MIOpenGEMM::half lowest() { return MIOpenGEMM::half::from_bits(0xfbff); }
+  static MIOpenGEMM::half epsilon() { return MIOpenGEMM::half::from_bits(0x1400); }
+  static MIOpenGEMM::half infinity() { return MIOpenGEMM::half::from_bits(0x7c00); }
+  static MIOpenGEMM::half quiet_NaN() { return MIOpenGEMM::half::from_bits(0x7e00); }
+};
+}
+
+#endif
@@ -5,6 +5,7 @@
 #define GUARD_MIOPENGEMM_HYPERPARAMS_HPP
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <vector>
@@ -49,6 +50,9 @@ class Constraints
   std::string  get_sr_str() const;
   std::string  get_string() const;
   Constraints  get_reflected(bool) const;
+  // from these (requested) constraints to those a cache entry was tuned with. Not symmetric : per
+  // value defined in both and different 0.5, per value defined in only one 0.1.
+  double       get_distance(const Constraints& tuned) const;
 };
 
 class SuHy
@@ -67,6 +71,24 @@ class SuHy
   SuHy(Mat::E, std::vector<size_t>&& vs);
 };
 
+// A canonical 128-bit encoding of a HyPas : A and B in the low and high halves of
+// words[0], C in words[1]. Each hyper-parameter has a fixed bit width (see hyperparams.cpp),
+// packing a HyPas with a value which does not fit throws.
+class PackedHyPas
+{
+  public:
+  std::array<uint64_t, 2> words{{0, 0}};
+  bool operator==(const PackedHyPas& rhs) const;
+  bool operator!=(const PackedHyPas& rhs) const;
+  bool operator<(const PackedHyPas& rhs) const;
+};
+
+class PackedHyPasHash
+{
+  public:
+  size_t operator()(const PackedHyPas& php) const;
+};
+
 class HyPas
 {
   public:
@@ -77,14 +99,19 @@ class HyPas
   HyPas(const str_array&);
   HyPas(const std::string&);
   HyPas(std::array<SuHy, Mat::E::N>&&);
+  HyPas(const PackedHyPas&);
   HyPas(const HyPas&) = default;
   HyPas& operator=(const HyPas&) = default;  // TODO is this ok?
+  // declared, as the copies are : moved, not copied, when neighbors are shuffled and sorted
+  HyPas(HyPas&&) = default;
+  HyPas& operator=(HyPas&&) = default;
 
   void replace_where_defined(const Constraints& constraints);
   std::string get_string() const;
   bool operator==(const HyPas& rhs) const;
   void  checks() const;
   HyPas get_reflected(bool) const;
+  PackedHyPas get_packed() const;
 };
 }
 
@@ -5,6 +5,7 @@
 #define GUARD_MIOPENGEMM_KERNELCACHE_HPP
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
 #include <miopengemm/derivedparams.hpp>
 
@@ -49,10 +50,17 @@ class CacheKeyHash
   size_t operator()(const CacheKey& ck) const;
 };
 
+namespace nearest
+{
+class Index;
+}
+
 class KernelCache
 {
   private:
   std::unordered_map<CacheKey, HyPas, CacheKeyHash> vals;
+  // built on first use, reset when entries are added
+  mutable std::shared_ptr<const nearest::Index> p_index;
 
   public:
   CacheKeyPresence check_for(const CacheKey& ck) const;
@@ -61,18 +69,41 @@ class KernelCache
 
   // hp must be transformed if geometry is.
   void add(const CacheKey& ckey, const HyPas& hp);
+  // as add, but an existing entry is replaced
+  void add_or_replace(const CacheKey& ckey, const HyPas& hp);
+  // throws if there is no entry for ckey
+  void remove(const CacheKey& ckey);
   std::vector<CacheKey> get_keys() const;
 
   std::string get_cache_entry_string(const CacheKey& ck) const;
+
+  // for nearest neighbor lookups, see nearest.hpp. Shared, so that an Index in use outlives
+  // changes to the cache (which reset it)
+  std::shared_ptr<const nearest::Index> get_index() const;
 };
 
 void filter_device(std::vector<CacheKey>&, const std::vector<std::string>& device_frags);
 void filter_geometries(std::vector<CacheKey>&, const std::vector<Geometry>& geometries);
-void filter_floattype(std::vector<CacheKey>&, size_t);
+// keep keys with A, B and C all of size float_size_bytes (not mixed precision, not complex)
+void filter_floattype(std::vector<CacheKey>&, size_t float_size_bytes);
 
+// The built-in cache, with the entries of the binary cache file (see kernelcachefile.hpp) at
+// the path set by set_kernel_cache_path, else at $MIOPENGEMM_KERNEL_CACHE, layered on top.
 const KernelCache& get_kernel_cache();
 
+// Must be called before the first use of the kernel cache, which is when the file is loaded.
+void set_kernel_cache_path(const std::string& path);
+
+// The built-in cache alone, a new copy : the entries of the cacheN.cachetxt files, compiled into
+// the library as a binary kernel cache file (see kernelcachebuiltin.cpp).
+KernelCache init_kernel_cache();
+
 std::string get_cache_entry_string(const CacheKey& ck, const HyPas& hypas, bool swap_ab);
+// as above, preceded by comment (for example the run statistics of hypas)
+std::string get_cache_entry_string(const CacheKey&   ck,
+                                   const HyPas&       hypas,
+                                   bool               swap_ab,
+                                   const std::string& comment);
 std::vector<Geometry> get_geometries(const std::vector<CacheKey>& cks);
 std::vector<std::string> get_devices(const std::vector<CacheKey>& cks);
 }
@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_KERNELCACHEFILE_HPP
+#define GUARD_MIOPENGEMM_KERNELCACHEFILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <miopengemm/kernelcache.hpp>
+
+namespace MIOpenGEMM
+{
+namespace cachefile
+{
+
+// Binary kernel cache files, all integers little endian :
+//   header  : magic "MIOGEMMK", uint32 version, uint32 number of records, uint32 strings size
+//   records : one per entry, geometry fields as integers, HyPas as a PackedHyPas, and
+//             (offset, size) into strings of the device and the constraints string
+//   strings : device names and constraints strings, each stored once
+// Geometries are not parsed from strings when loading, and most constraints are empty.
+// Versions :
+//   1 : 2 bytes of padding after the floattype of each record
+//   2 : the first is the conjugations of A and B (complex floattypes, 'c' and 'z')
+//   3 : the second is the triangle of C (Uplo)
+const uint32_t version = 3;
+// the oldest version which can be read
+const uint32_t min_version = 1;
+
+void write(const KernelCache& kc, const std::string& filename);
+
+// throws if filename is not a binary kernel cache file of a supported version
+KernelCache read(const std::string& filename);
+
+// the n_bytes at data, the contents of a binary kernel cache file, as filename in errors
+KernelCache read(const char* data, size_t n_bytes, const std::string& filename);
+
+// the kc.add(...) entries of a cacheN.cachetxt file, or of find output (OutPart::CCH).
+// Where a key appears more than once the last entry is kept.
+KernelCache read_text(const std::string& filename);
+}
+}
+
+#endif
@@ -4,15 +4,64 @@
 #ifndef GUARD_MIOPENGEMM_KERNELCACHEMERGE_HPP
 #define GUARD_MIOPENGEMM_KERNELCACHEMERGE_HPP
 
+#include <tuple>
+#include <miopengemm/costmodel.hpp>
 #include <miopengemm/findparams.hpp>
 #include <miopengemm/kernelcache.hpp>
 
 namespace MIOpenGEMM
 {
+// Entries in only one of kc1 and kc2 are taken from it. For keys in both with different HyPas,
+// the two HyPas are benchmarked against each other (alternating, Thue-Morse) on the device. The
+// mixed precision, integer and complex floattypes can not be benchmarked : for them the HyPas of
+// kc1 is kept, and the key reported.
 KernelCache
 get_merged(const KernelCache& kc1, const KernelCache& kc2, const Halt& halt, owrite::Writer& mowri);
 
+// As above, with the kernels of contested keys compiled concurrently, up to n_compile_threads
+// keys ahead of the one being benchmarked. Resumable : each entry is appended, with its
+// provenance (source, score and median times) as a comment, to the cache text file
+// journal_filename ("" for none), and entries already in it are taken from it.
+KernelCache get_merged(const KernelCache& kc1,
+                       const KernelCache& kc2,
+                       const Halt&        halt,
+                       const std::string& journal_filename,
+                       size_t             n_compile_threads,
+                       owrite::Writer&    mowri);
+
 KernelCache get_wSpaceReduced(const KernelCache& kc);
+
+// The cache key selected for reference, and the HyPas selected from it (projected onto
+// reference.constraints, repaired by the predictor), as in get_default_soln (see
+// get_nearest_cached). The graph is built with the hard-coded DevInfo of reference.dvc. false if
+// there is none.
+bool get_selected(const KernelCache& kc,
+                  const CacheKey&    reference,
+                  CacheKey&          selected,
+                  HyPas&             hp);
+// as above, without the HyPas
+bool get_selected(const KernelCache& kc, const CacheKey& reference, CacheKey& selected);
+
+// kc with entries removed (greedily, those nearest to an entry with the same HyPas first) when
+// the HyPas selected (as by get_selected) for every reference key is unchanged by the removal.
+// The cached keys should be amongst the references, for their own entries to be replaced only by
+// identical HyPas.
+KernelCache get_compacted(const KernelCache&           kc,
+                          const std::vector<CacheKey>& references,
+                          owrite::Writer&              mowri);
+
+// as above, but a removal is also accepted if the HyPas selected for every reference is
+// different but, by cost, at least (1 - tolerance) times as fast as before.
+KernelCache get_compacted(const KernelCache&           kc,
+                          const std::vector<CacheKey>& references,
+                          costmodel::CostModel&        cost,
+                          double                       tolerance,
+                          owrite::Writer&              mowri);
+
+// the (up to) n references furthest from their selected cache key, furthest first, where new
+// tuning is most likely to help. References with no selected key are at distance <double>::max.
+std::vector<std::tuple<double, CacheKey>>
+get_coverage_gaps(const KernelCache& kc, const std::vector<CacheKey>& references, size_t n);
 }
 
 #endif
@@ -24,10 +24,18 @@ class KernUses
   bool u_w = false;
   bool u_alpha = false;
   bool u_beta = false;
+  // the bias vector of the Epilogue, after alpha and beta
+  bool u_bias = false;
 
   bool at(Mem::E emat_x) const;
 
-  KernUses(bool u_a_, bool u_b_, bool u_c_, bool u_w_, bool u_alpha_, bool u_beta_);
+  KernUses(bool u_a_,
+           bool u_b_,
+           bool u_c_,
+           bool u_w_,
+           bool u_alpha_,
+           bool u_beta_,
+           bool u_bias_ = false);
 
   KernUses() = default;
 };
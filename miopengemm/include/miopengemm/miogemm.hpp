@@ -6,6 +6,8 @@
 
 #include <miopengemm/findparams.hpp>
 #include <miopengemm/geometry.hpp>
+#include <miopengemm/graph.hpp>
+#include <miopengemm/kernelcache.hpp>
 #include <miopengemm/outputwriter.hpp>
 #include <miopengemm/platform.hpp>
 #include <miopengemm/solution.hpp>
@@ -35,7 +37,9 @@ namespace MIOpenGEMM
  * Matric C, memory will be unchanged
  *
  * @param enforce_determinism
- * If true, only kernels which are bitwise consistent are considered. Specifically, ICE=1.
+ * If true, only kernels which are bitwise consistent are considered. Specifically, RED=1 : if k
+ * is split (ICE>1), partial sums are written to workspace and reduced in a fixed order, instead of
+ * atomically added to C. This needs workspace (tgg.wSpaceSize), without it ICE=1.
  * For small m*n, enforce_determinism = false will find faster Solutions.
  *
  * @param tgg
@@ -83,6 +87,21 @@ HyPas get_generic(const Geometry& gg, const Constraints& constraints);
  * If there is no good cached match, a Solution will be returned depending on this parameter.
  * The options are to randomly select a viable Solution, or to use get_generic.
  */
+// The cached HyPas which get_default_soln starts from : that of nearest_ck, the cache key of rank
+// rank (0 for the nearest) whose HyPas, projected onto ck.constraints, is in graph and derivable.
+// ck is the (canonical) cache key of gg and constraints. hp is for gg (reflected if gg is not
+// canonical), projected onto constraints, and repaired by the predictor if nearest_ck is not ck.
+// false if there is no such cache key.
+bool get_nearest_cached(const Geometry&    gg,
+                        const Constraints& constraints,
+                        const CacheKey&    ck,
+                        const Graph&       graph,
+                        const KernelCache& kernel_cache,
+                        size_t             rank,
+                        CacheKey&          nearest_ck,
+                        HyPas&             hp,
+                        owrite::Writer&    mowri);
+
 // try and get a solution from cache, if all else fails get_generic.
 Solution get_default_soln(const oclutil::DevInfo& devinfo,
                           const Geometry&         gg,
@@ -91,6 +110,15 @@ Solution get_default_soln(const oclutil::DevInfo& devinfo,
                           IfNoCache::E            enoc,
                           size_t                  rank);
 
+// as above, with kernel_cache in place of get_kernel_cache()
+Solution get_default_soln(const oclutil::DevInfo& devinfo,
+                          const Geometry&         gg,
+                          const Constraints&      constraints,
+                          const KernelCache&      kernel_cache,
+                          owrite::Writer&         mowri,
+                          IfNoCache::E            enoc,
+                          size_t                  rank);
+
 /*! This function is being phased-out, it is only used by MIOpen (as of 28 August 2017)
  * [ the HIP branch of MIOpen currently calls this function ]
  *
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_MULTIGEMM_HPP
+#define GUARD_MIOPENGEMM_MULTIGEMM_HPP
+
+#include <string>
+#include <miopengemm/hyperparams.hpp>
+#include <miopengemm/oclutil.hpp>
+#include <miopengemm/outputwriter.hpp>
+
+namespace MIOpenGEMM
+{
+
+class Geometry;
+class DerivedParams;
+class Epilogue;
+
+/*! @brief
+ * The products \f$ C_i \leftarrow \alpha op(A) op(B_i) + \beta C_i \f$, i = 0 ... n_products - 1,
+ * with one A. B_i (C_i) is b_stride (c_stride) elements after B_{i-1} (C_{i-1}) in the b (c)
+ * buffer. The main kernel loads each unroll tile of A into LDS once, for all the B_i.
+ * It is compiled into the kernel, so the default (single product) MultiGemm costs nothing.
+ */
+class MultiGemm
+{
+  public:
+  size_t n_products = 1;
+  size_t b_stride   = 0;
+  size_t c_stride   = 0;
+
+  MultiGemm() = default;
+  MultiGemm(size_t n_products, size_t b_stride, size_t c_stride);
+
+  bool is_single() const;
+
+  // empty for a single product, otherwise as NPR3_BST1024_CST4096. Part of program cache keys.
+  std::string get_string() const;
+
+  // the hyper-parameters the main kernel requires : ICE1, STK0, and B used directly (WOS0)
+  Constraints get_constraints() const;
+
+  bool operator==(const MultiGemm& rhs) const;
+};
+
+// throws if the main kernel of (hp, gg, dp) cannot compute the products : it requires the
+// constraints of get_constraints, b_stride a multiple of VEW_B, C_i which do not overlap, and no
+// epilogue.
+void confirm_multigemm(const MultiGemm&     multigemm,
+                       const Epilogue&      epilogue,
+                       const HyPas&         hp,
+                       const Geometry&      gg,
+                       const DerivedParams& dp);
+
+// the LDS used by the main kernel : the unroll tile of A, and one of B for each product
+size_t get_lds_bytes(const MultiGemm& multigemm, const Geometry& gg, const DerivedParams& dp);
+
+// the HyPas of the nearest cache key (lowest rank, see get_nearest_cached) which is derivable with
+// the LDS of get_lds_bytes less than that of devinfo, otherwise the generic HyPas. The nearest
+// lookup alone checks the LDS of a single product.
+HyPas get_nearest_hypas(const MultiGemm&        multigemm,
+                        const oclutil::DevInfo& devinfo,
+                        const Geometry&         gg,
+                        const Constraints&      constraints,
+                        owrite::Writer&         mowri);
+}
+
+#endif
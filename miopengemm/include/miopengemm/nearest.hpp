@@ -4,6 +4,9 @@
 #ifndef GUARD_MIOPENGEMM_NEAREST_HPP
 #define GUARD_MIOPENGEMM_NEAREST_HPP
 
+#include <map>
+#include <mutex>
+#include <queue>
 #include <miopengemm/graph.hpp>
 #include <miopengemm/kernelcache.hpp>
 
@@ -12,15 +15,92 @@ namespace MIOpenGEMM
 namespace nearest
 {
 
-// for all CacheKeys, ck, in the KernelCache, which have
-// (1) at(ck) with ck_in.gg is derivable.
-// (2) at(ck) is in graph,
+// A spatial index over the CacheKeys of a KernelCache, for visiting them in order of increasing
+// distance (CacheKey::get_distance) from a target. Keys are bucketed by transposes (keys with
+// different transposes are at maximum distance) and sorted by log2(m) + log2(n), the L1
+// distance along which bounds the CacheKey distance from below. Keys are visited by expanding
+// outwards from the target until the bound exceeds the nearest unvisited distance.
+class Index
+{
+  public:
+  using dst_tup = std::tuple<double, size_t>;
+
+  std::vector<CacheKey> keys;
+  std::vector<HyPas>    hps;
+
+  Index(const KernelCache&);
+
+  // The keys in order of increasing distance from target (CacheKey::get_distance, plus the
+  // projection distance of their HyPas, see get below). After those with the same transposes
+  // as target, the remaining keys are visited (at distance <double>::max) in index order.
+  class Stream
+  {
+    public:
+    Stream(const Index&, const CacheKey& target);
+    // false when all keys have been visited.
+    bool next(size_t& key_index, double& distance);
+
+    private:
+    const Index*                p_index;
+    CacheKey                    target;
+    const std::vector<dst_tup>* p_bucket;
+    double                      coord;
+    size_t                      lower;
+    size_t                      upper;
+    size_t                      other;
+    std::priority_queue<dst_tup, std::vector<dst_tup>, std::greater<dst_tup>> frontier;
+  };
+
+  // The key index and distance of the {rank} nearest key whose HyPas, projected onto
+  // target.constraints, is in graph, derivable for target and can run on the device of graph
+  // (devicemodel::can_run). These are only
+  // checked on keys visited in distance order, and the result is memoized per target, device
+  // and rank. graph must be the Graph of target. false if none.
+  bool get_ranked(const CacheKey& target,
+                  const Graph&    graph,
+                  size_t          rank,
+                  size_t&         key_index,
+                  double&         distance) const;
+
+  private:
+  std::map<size_t, std::vector<dst_tup>> buckets;
+
+  class Memo
+  {
+    public:
+    Stream              stream;
+    std::vector<size_t> accepted;
+    std::vector<double> distances;
+    bool                exhausted;
+    Memo(const Index& index, const CacheKey& target) : stream(index, target), exhausted(false) {}
+  };
+  mutable std::map<std::string, Memo> memos;
+  mutable std::mutex                  memos_mutex;
+
+  friend class Stream;
+};
+
+// hp projected onto the graph of constraints : the values defined in constraints replace those
+// of hp. A cached HyPas which does not satisfy the constraints of a request is projected.
+HyPas get_projected(const HyPas& hp, const Constraints& constraints);
+
+// CacheKeys are ranked by CacheKey::get_distance from ck_in, plus 0.2 per value defined in
+// ck_in.constraints which at(ck) does not have. For all CacheKeys, ck, in the KernelCache, for
+// which at(ck) projected onto ck_in.constraints
+// (1) with ck_in.gg is derivable.
+// (2) is in graph,
+// (3) passes the architecture tests of the device of graph,
 // is the {rank} closest to ck_in within radius threshold? rank = 0 for closest
 bool is_within(
   const CacheKey& ck_in, const Graph&, const KernelCache&, double threshold, size_t rank);
 
-// of all the CacheKeys in the KernelCache, return the {rank} nearest satisfying (1) and (2) above.
+// of all the CacheKeys in the KernelCache, return the {rank} nearest satisfying (1) - (3) above.
 CacheKey get(const CacheKey&, const Graph&, const KernelCache&, size_t rank);
+
+// the (up to) k nearest distinct HyPas in the KernelCache, nearest first, projected onto
+// ck_in.constraints, for which (1) - (3) above hold. (1) and (3) are only checked until k have
+// been found.
+std::vector<HyPas> get_adapted(const CacheKey& ck_in, const Graph&, const KernelCache&, size_t k);
 }
 }
 
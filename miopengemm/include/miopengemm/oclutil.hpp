@@ -348,6 +348,8 @@ class DevInfo
   size_t device_max_compute_units{0};
   size_t device_max_work_group_size{0};
   size_t wg_atom_size{0};
+  // cl_khr_fp16 is supported (assumed when unknown, as with get_vega_devinfo)
+  bool device_fp16{true};
 
   std::string get_string() const;
   DevInfo(const cl_command_queue& command_queue);
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_PREDICTOR_HPP
+#define GUARD_MIOPENGEMM_PREDICTOR_HPP
+
+#include <string>
+#include <vector>
+#include <miopengemm/graph.hpp>
+#include <miopengemm/hyperparams.hpp>
+
+namespace MIOpenGEMM
+{
+namespace predictor
+{
+
+// features of a (canonical) Geometry : log2 of m, n, k and of m / n, the transposes of A and B,
+// the float size, and for each of A, B, C the log2 of the padding and of the largest power of 2
+// (up to 2^10) dividing the leading dimension.
+std::vector<double> get_features(const Geometry&);
+const std::vector<std::string>& get_feature_names();
+
+// A classification tree. Node 0 is the root, leaves have feature -1.
+class Tree
+{
+  public:
+  class Node
+  {
+    public:
+    int    feature;
+    double threshold;
+    size_t left;
+    size_t right;
+    size_t value;
+  };
+  std::vector<Node> nodes;
+
+  // go left if x[feature] < threshold
+  size_t predict(const std::vector<double>& x) const;
+};
+
+// One classification tree per hyper-parameter, predicting its tuned value from the Geometry.
+class Predictor
+{
+  public:
+  // device the training entries were from, empty if they were from all devices
+  std::string dvc;
+  // trees[emat][Chi::E or NonChi::E], empty for a default constructed (no model) Predictor
+  std::array<std::vector<Tree>, Mat::E::N> trees;
+
+  Predictor() = default;
+
+  // CART fit (Gini impurity) to canonical geometries and their cached HyPas. Trees are at most
+  // max_depth deep, with at least min_leaf entries per leaf.
+  Predictor(const std::string&           dvc,
+            const std::vector<Geometry>& geometries,
+            const std::vector<HyPas>&    hps,
+            size_t                       max_depth,
+            size_t                       min_leaf);
+
+  bool is_empty() const;
+  bool applies_to(const std::string& device) const;
+
+  // the prediction for a canonical geometry, not necessarily derivable
+  HyPas predict(const Geometry& canonical_gg) const;
+
+  // text serialization, see from_string
+  std::string get_string() const;
+};
+
+Predictor from_string(const std::string&);
+
+void write(const Predictor&, const std::string& filename);
+Predictor read(const std::string& filename);
+
+// start (in graph and derivable for gg) with the predicted values substituted one at a time,
+// where the result is still in graph and derivable for gg. gg need not be canonical.
+HyPas get_repaired(const Predictor&, const HyPas& start, const Geometry& gg, const Graph& graph);
+}
+
+// The predictor used by get_default_soln when there is no exact kernel cache match : a file
+// written by predictor::write at the path set by set_predictor_path, else at
+// $MIOPENGEMM_PREDICTOR. Empty (not used) if neither is set.
+const predictor::Predictor& get_predictor();
+
+// Must be called before the first use of the predictor, which is when the file is loaded.
+void set_predictor_path(const std::string& path);
+}
+
+#endif
@@ -9,9 +9,11 @@
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <miopengemm/epilogue.hpp>
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/hyperparams.hpp>
 #include <miopengemm/kernelstring.hpp>
+#include <miopengemm/multigemm.hpp>
 #include <miopengemm/oclutil.hpp>
 #include <miopengemm/outputwriter.hpp>
 #include <miopengemm/platform.hpp>
@@ -61,9 +63,21 @@ class ProgramCacher
              size_t            w_size,
              BetaType          beta_type,
              char              floattype,
-             cl_command_queue* ptr_queue);
+             cl_command_queue* ptr_queue,
+             const Epilogue&   epilogue  = Epilogue(),
+             const MultiGemm&  multigemm = MultiGemm(),
+             Uplo::E           uplo      = Uplo::E::NONE);
 
-  int get_ID_from_geom(const Geometry& gg, BetaType beta, cl_command_queue* ptr_queue);
+  // gg.uplo is passed to get_ID
+  int get_ID_from_geom(const Geometry&   gg,
+                       BetaType          beta,
+                       cl_command_queue* ptr_queue,
+                       const Epilogue&   epilogue  = Epilogue(),
+                       const MultiGemm&  multigemm = MultiGemm());
+
+  // the ID of the Programs of the single kernel kblob (not a GEMM), such as an add kernel of the
+  // Strassen-Winograd layer. Its key is the kernel source and the device.
+  int get_ID_from_kernblob(const KernBlob& kblob, cl_command_queue* ptr_queue);
 };
 
 ProgramCacher& get_cacher();
@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_REDUCEGENERATOR_HPP
+#define GUARD_MIOPENGEMM_REDUCEGENERATOR_HPP
+
+#include <sstream>
+#include <miopengemm/bylinegenerator.hpp>
+
+namespace MIOpenGEMM
+{
+namespace reducegen
+{
+
+// Sums the partial sums of split-k (ICE != 1, RED = 1) in workspace, in a fixed order, and
+// applies alpha and beta. Unlike atomic increments to C, the result is deterministic.
+class ReduceGenerator : public bylinegen::ByLineGenerator
+{
+
+  public:
+  virtual ~ReduceGenerator() = default;
+  ReduceGenerator(const HyPas& hp_, const Geometry& gg_, const DerivedParams& dp_);
+
+  virtual void setup_additional() override final;
+
+  virtual void set_type() override final;
+
+  virtual void set_usage() override final;
+
+  virtual void append_derived_definitions_additional(std::stringstream& ss) override final;
+
+  virtual void append_positioning_w_string(std::stringstream& ss) override final;
+
+  size_t get_local_work_size() override final;
+
+  size_t get_work_per_thread() override final;
+
+  virtual KType::E get_ktype() override final;
+};
+
+KernBlob get_reduce_kernelstring(const HyPas& hp, const Geometry& gg, const DerivedParams& dp);
+}
+}
+
+#endif
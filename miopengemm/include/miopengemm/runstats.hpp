@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_RUNSTATS_HPP
+#define GUARD_MIOPENGEMM_RUNSTATS_HPP
+
+#include <string>
+#include <vector>
+#include <miopengemm/enums.hpp>
+
+namespace MIOpenGEMM
+{
+
+// Summary statistics of repeated runs of a kernel (or kernels), times in [ms].
+// min, median and mean are of all runs, as find has always summarised them. Runs
+// further than outlier_mads scaled median absolute deviations from the median are
+// rejected from the statistics of the statistical BestTests (WELCH, DISJOINT).
+class RunStats
+{
+  public:
+  // the runs kept
+  size_t n_runs{0};
+  size_t n_outliers{0};
+  double min{0};
+  // the upper median, which is always one of the runs
+  double median{0};
+  double mean{0};
+  // of the runs kept
+  double kept_mean{0};
+  double stddev{0};
+  // 95% confidence interval of the mean (Student's t)
+  double ci_lower{0};
+  double ci_upper{0};
+
+  RunStats() = default;
+  RunStats(const std::vector<double>& times, double outlier_mads = 3.5);
+
+  // of all runs. MAX (gflops) is the min time
+  double get(SummStat::E sumstat) const;
+  std::string get_string() const;
+};
+
+// is candidate faster than incumbent according to besttest ?
+// improvement_factor is the ratio candidate / incumbent required by BestTest::E::RATIO, on the
+// sumstat of all runs (RunStats::get). WELCH and DISJOINT are on the runs kept.
+bool is_faster(const RunStats& candidate,
+               const RunStats& incumbent,
+               BestTest::E     besttest,
+               SummStat::E     sumstat,
+               double          improvement_factor);
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <miopengemm/findparams.hpp>
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/kernelstring.hpp>
+#include <miopengemm/runstats.hpp>
 
 namespace MIOpenGEMM
 {
@@ -37,6 +38,9 @@ class Solution
   // Constraints imposed while searching for this solution
   Constraints constraints;
 
+  // Statistics of the runs from which extime was obtained (n_runs = 0 if not benchmarked)
+  RunStats stats;
+
   Solution(const Geometry&,
            double extime,
            const std::vector<KernBlob>&,
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_STRASSEN_HPP
+#define GUARD_MIOPENGEMM_STRASSEN_HPP
+
+#include <array>
+#include <vector>
+#include <miopengemm/geometry.hpp>
+#include <miopengemm/kernelstring.hpp>
+#include <miopengemm/platform.hpp>
+
+namespace MIOpenGEMM
+{
+
+// Strassen-Winograd for very large GEMMs (opt-in, see xgemm_strassen). Each level splits A, B
+// and C into 2 x 2 blocks, forms 4 sums of blocks of A and 4 of B in the workspace (one add
+// kernel each), computes 7 sub-products of half size (with the tuned GEMM, or another level) and
+// combines them into C (one add kernel), instead of the 8 sub-products of classical GEMM.
+namespace strassen
+{
+
+// The accuracy guard. python/strassennumstab.py measures the error of (fp32) Strassen relative
+// to classical GEMM on N(0,1) matrices : the max error grows by a constant factor with each
+// level, so the number of levels is capped, and only fp32 and fp64 are supported.
+constexpr size_t max_levels = 2;
+
+// A level is only used while m, n and k are at least min_dim : the sub-products should still be
+// large enough for the tuned GEMM to be efficient, and the saving to pay for the add kernels.
+constexpr size_t min_dim = 4096;
+
+// A matrix op(X) in buffer mem, its first element offset elements after the buffer's offset.
+// The workspace matrices are not transposed, and have the layout (isColMajor) of the GEMM.
+class View
+{
+  public:
+  Mem::E mem;
+  size_t offset;
+  size_t ld;
+  bool   transposed;
+
+  // the distances between consecutive rows (columns) of op(X)
+  size_t get_row_stride(bool isColMajor) const;
+  size_t get_col_stride(bool isColMajor) const;
+
+  // block (row, col) of op(X), in blocks of n_rows x n_cols
+  View get_block(bool isColMajor, size_t row, size_t col, size_t n_rows, size_t n_cols) const;
+};
+
+// for each element of the n_rows x n_cols matrices, out[o] = sum_i coefs[o][i] * in[i]. With
+// scaled, out[o] = alpha * sum_i coefs[o][i] * in[i] + beta * out[o].
+class Sums
+{
+  public:
+  std::vector<View>             in;
+  std::vector<View>             out;
+  std::vector<std::vector<int>> coefs;
+  size_t                        n_rows;
+  size_t                        n_cols;
+  bool                          scaled;
+};
+
+// c = a b, with the tuned GEMM. With scaled, c = alpha a b + beta c.
+class Product
+{
+  public:
+  View   a;
+  View   b;
+  View   c;
+  size_t m;
+  size_t n;
+  size_t k;
+  bool   scaled;
+};
+
+class Step
+{
+  public:
+  bool    is_product;
+  Sums    sums;
+  Product product;
+};
+
+// the steps, in order of execution, of Strassen-Winograd with levels levels
+class Plan
+{
+  public:
+  Geometry          gg;
+  size_t            levels;
+  size_t            workspace_size;
+  std::vector<Step> steps;
+};
+
+// the number of levels to use for gg, at most max_levels_user : 0 unless gg is fp32 or fp64.
+// Each level requires m, n and k (of the level) to be even and at least min_dim.
+size_t get_levels(const Geometry& gg, size_t max_levels_user);
+
+// the number of elements of workspace used by levels levels
+size_t get_workspace_size(const Geometry& gg, size_t levels);
+
+// throws if levels exceeds max_levels, gg is not fp32 or fp64, or m, n and k are not divisible
+// by 2^levels. It does not require min_dim, so small problems can be tested.
+Plan get_plan(const Geometry& gg, size_t levels);
+
+// the add kernel of sums
+KernBlob get_sums_kernblob(const Plan& plan, const Sums& sums);
+
+// enqueue the steps of plan, in order. Each Sums is an add kernel, compiled once per device
+template <typename T>
+void run(const Plan&                          plan,
+         T                                    alpha,
+         T                                    beta,
+         const std::array<cl_mem, Mem::E::N>& gpu_mems,
+         const std::array<size_t, Mem::E::N>& offsets,
+         cl_command_queue*                    ptr_queue,
+         cl_uint                              num_events_in_wait_list,
+         const cl_event*                      event_wait_list,
+         cl_event*                            ptr_event);
+
+// the steps of plan on the host, with cpugemm for the products. w has at least
+// plan.workspace_size elements. a, b, c and w point to the first element of their matrices.
+template <typename T>
+void cpu_run(const Plan& plan, const T* a, const T* b, T* c, T* w, T alpha, T beta);
+}
+}
+
+#endif
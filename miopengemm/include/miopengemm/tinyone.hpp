@@ -41,6 +41,9 @@ class TinyOne
 
   std::vector<std::vector<double>> benchgemm(const std::vector<HyPas>& hps, const Halt&);
 
+  // compile without running, see TinyZero::prepare
+  void prepare(const HyPas& hp);
+
   Solution find1(const FindParams& find_params, const Constraints& constraints);
 
   void accuracy_test(const HyPas& hp);  //, const TFloat* c_true_for_test);
@@ -24,6 +24,7 @@ class TinyTwo
   private:
   std::unique_ptr<TinyOne<double>> d_moa{nullptr};
   std::unique_ptr<TinyOne<float>>  f_moa{nullptr};
+  std::unique_ptr<TinyOne<half>>   h_moa{nullptr};
   char                             active_type{'?'};
 
   template <typename TFloat>
@@ -73,11 +74,17 @@ std::unique_ptr<TinyOne<float>>& TinyTwo::get_up_moa<float>();
 template <>
 std::unique_ptr<TinyOne<double>>& TinyTwo::get_up_moa<double>();
 
+template <>
+std::unique_ptr<TinyOne<half>>& TinyTwo::get_up_moa<half>();
+
 template <>
 void TinyTwo::set_active_type<float>();
 
 template <>
 void TinyTwo::set_active_type<double>();
+
+template <>
+void TinyTwo::set_active_type<half>();
 }
 }
 
@@ -39,11 +39,20 @@ class FindTracker
   Timer  timer;
   size_t descents{0};
   size_t kernels{0};
+  // (elapsed, gflops) each time the best gflops of the find improves
+  std::vector<std::tuple<double, double>> improvements;
+  // ratios re-measured / original time of incumbents
+  std::vector<double> drifts;
 
   public:
   void        start();
   void        incr_descents();
   void        incr_kernels();
+  void        record_gflops(double gflops);
+  // elapsed time when gflops first came within fraction of the best gflops
+  double get_time_to_within(double fraction) const;
+  void        record_drift(double drift);
+  std::string get_drift_string() const;
   double      get_elapsed() const;
   size_t      get_descents() const;
   std::string get_string() const;
@@ -85,6 +94,9 @@ class TinyZero
            owrite::Writer&  mowri_);
 
   std::vector<double> benchgemm(const HyPas& hp, const Halt& hl);
+  // generate and compile the kernels of hp, without running them. A subsequent benchgemm of hp
+  // does not recompile. Throws if hp is not derivable or fails the architecture tests.
+  void prepare(const HyPas& hp);
   Solution find0(const Constraints& constraint, const FindParams& find_params);
 
   private:
@@ -96,23 +108,39 @@ class TinyZero
   owrite::Writer&        mowri;
 
   Programs    programs;
+  // the compiled kernels of the incumbent in single_descent_find, so that it is re-measured
+  // without recompiling
+  Programs    incumbent_programs;
   KernelTimes kernel_times{};
 
   double get_gflops(double timems);
   std::string get_run_times_heading();
-  std::string get_run_time_string(cl_int status);
+  std::string get_run_time_string(cl_int status, const Programs& progs);
   void address_check_valid();
   void address_check_valid_and_reliable();
 
   Solution single_descent_find(double allotted_time,
                                const Constraints&,
-                               const Halt&  core_hl,
+                               const FindParams&,
                                FindTracker& ftrack,
-                               SummStat::E  sumstat,
                                bool         warmstart,
-                               size_t       warmstart_rank);
+                               const HyPas& warm_start_hp);
 
-  oclutil::Result true_core(std::function<void(std::string)> acton,
+  // the nearest cache entries, adapted to gg and constraints, fastest first
+  std::vector<HyPas> get_warm_starts(const Constraints&, const FindParams&, FindTracker& ftrack);
+
+  // fastest of a few runs of hp [ms], or <double>::max if it fails
+  double get_quick_time(const HyPas& hp, const Halt& hl);
+
+  // statistics of runs of kblobs (n_runs = 0 if they fail), compiled into programs
+  RunStats get_run_stats(const std::vector<KernBlob>& kblobs, const Halt& hl);
+  // as above, with kblobs already compiled in progs
+  RunStats
+  get_run_stats(const Programs& progs, const std::vector<KernBlob>& kblobs, const Halt& hl);
+
+  // runs the kernels compiled in progs until hl halts
+  oclutil::Result true_core(const Programs&                  progs,
+                            std::function<void(std::string)> acton,
                             std::vector<double>&             times,
                             const Halt&,
                             const AllKernArgs&);
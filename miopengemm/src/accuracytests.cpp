@@ -2,6 +2,7 @@
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
 #include <cmath>
+#include <limits>
 #include <vector>
 #include <miopengemm/accuracytests.hpp>
 #include <miopengemm/geometry.hpp>
@@ -30,6 +31,19 @@ bool exactly_equal(T a, T b)
   return ((std::isnan(a) && std::isnan(b)) || (a >= b && a <= b));
 }
 
+// half accumulates in half : rounding errors grow as sqrt(k) units in the last place. The same
+// bound is used when only C is half (floattype 'n'). Integer GEMM is exact.
+double get_threshold(const Geometry& gg)
+{
+  if (gg.derived.floattype_acc == 'i')
+  {
+    return 0;
+  }
+  return gg.derived.floattype_c == 'h'
+           ? std::numeric_limits<half>::epsilon() * (2 + std::sqrt(gg.k))
+           : 1e-6;
+}
+
 template <typename TFloat>
 void elementwise_compare(const Geometry& gg,
                          const Offsets&  toff,
@@ -40,7 +54,7 @@ void elementwise_compare(const Geometry& gg,
                          std::string     info_str,
                          owrite::Writer& mowri)
 {
-  double threshold      = 1e-6;
+  double threshold      = get_threshold(gg);
   size_t nels           = get_mat_size(gg, toff, Mat::E::C);
   size_t n_mat_els      = gg.get_padded_area(Mat::E::C);
   size_t n_errs_printed = 0;
@@ -55,9 +69,10 @@ void elementwise_compare(const Geometry& gg,
   errm << info_str << '\n';
 
   auto get_message = [c_before, c_cpu, c_gpu, c_cpu_abs, &gg, &toff](size_t i) {
+    // (unary + : int8 printed as a number)
     std::stringstream ss;
-    ss << "\nc_before : " << c_before[i] << "   c_cpu : " << c_cpu[i] << "   c_gpu : " << c_gpu[i]
-       << "   c_cpu_abs : " << c_cpu_abs[i] << "\n\n";
+    ss << "\nc_before : " << +c_before[i] << "   c_cpu : " << +c_cpu[i]
+       << "   c_gpu : " << +c_gpu[i] << "   c_cpu_abs : " << +c_cpu_abs[i] << "\n\n";
     return ss.str();
   };
 
@@ -177,5 +192,32 @@ template void elementwise_compare(const Geometry& gg,
                                   const double*   c_cpu_abs,
                                   std::string,
                                   owrite::Writer& mowri);
+
+template void elementwise_compare(const Geometry& gg,
+                                  const Offsets&  toff,
+                                  const int32_t*  c_before,
+                                  const int32_t*  c_cpu,
+                                  const int32_t*  c_gpu,
+                                  const int32_t*  c_cpu_abs,
+                                  std::string,
+                                  owrite::Writer& mowri);
+
+template void elementwise_compare(const Geometry& gg,
+                                  const Offsets&  toff,
+                                  const int8_t*   c_before,
+                                  const int8_t*   c_cpu,
+                                  const int8_t*   c_gpu,
+                                  const int8_t*   c_cpu_abs,
+                                  std::string,
+                                  owrite::Writer& mowri);
+
+template void elementwise_compare(const Geometry& gg,
+                                  const Offsets&  toff,
+                                  const half*     c_before,
+                                  const half*     c_cpu,
+                                  const half*     c_gpu,
+                                  const half*     c_cpu_abs,
+                                  std::string,
+                                  owrite::Writer& mowri);
 }
 }
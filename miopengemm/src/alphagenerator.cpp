@@ -31,6 +31,182 @@ namespace MIOpenGEMM
 namespace alphagen
 {
 
+namespace
+{
+
+// the static blocks of the #defines of the main kernel, with their parameters
+
+const basegen::Fragment& get_head_fragment()
+{
+  static const basegen::Fragment head(
+    "\n\n"
+    "/* this kernel was generated for starting geometry : */\n"
+    "/* ${GEOMETRY}*/\n"
+    "#define KV__ ${K}\n"
+    "${PRAGMA}"
+    "#define TFLOAT  ${TFLOAT}\n"
+    "/* A and B (storage) and accumulation (compute) types, see floattype 'm' and 'n' */\n"
+    "#define TFLOAT_AB  ${TFLOAT_AB}\n"
+    "#define TFLOAT_ACC  ${TFLOAT_ACC}\n"
+    "${COMPLEX}"
+    "#define DOES_BETA_C_INC ${DOES_BETA_C_INC}\n"
+    "#define DOES_ALPHA_A_B_INC 1\n"
+    "\n"
+    "/* A note on how transposes isColMajor  effect the kernel generated: very little. */\n"
+    "/* just via STRIDE_PLL_K_{A,B}, STRIDE_PERP_K_{A,B}, STRIDE_PLL_M_C, STRIDE_PERP_M_C */\n"
+    "\n\n",
+    {"GEOMETRY",
+     "K",
+     "PRAGMA",
+     "TFLOAT",
+     "TFLOAT_AB",
+     "TFLOAT_ACC",
+     "COMPLEX",
+     "DOES_BETA_C_INC"});
+  return head;
+}
+
+// the comments are in the defines of A only
+const basegen::Fragment& get_chiral_fragment(Mat::E emat_x)
+{
+  static const std::string text =
+    "/* vector float type */\n"
+    "#define TVFLOAT${X} ${TVFLOAT}\n"
+    "/* vector width */\n"
+    "#define VEW_${X}  ${VEW}\n"
+    "/* micro tiles define the pattern of C that individual threads process */\n"
+    "#define MICRO_TILE_LENGTH_${X} ${MIC}\n"
+    "/* the amount of padding of ${X} in LDS (local) memory, to avoid bank comflicts */\n"
+    "#define PAD_LDS_${X}  ${PAD}\n"
+    "/* whether loading of ${X} from global should try to be long in direction of unroll (1) or "
+    "perpendicular to it (0) */\n"
+    "#define WORK_ITEM_LOAD_${X}_PLL_TO_UNROLL ${PLU}\n"
+    "/* MACRO_TILE_LENGTH_A + PAD_LDS_A : */\n"
+    "#define MACRO_TILE_LENGTH_${X}_AND_PAD ${MACRO_TILE_LENGTH_AND_PAD}\n"
+    "/* MACRO_TILE_LENGTH_A_AND_PAD * UNROLL : */\n"
+    "#define N_ELEMENTS_IN_PADDED_${X}_UNROLL ${N_ELEMENTS_IN_PADDED_UNROLL}\n"
+    "/* N_ELEMENTS_IN_A_UNROLL / N_WORK_ITEMS_PER_WORKGROUP : */\n"
+    "#define N_ELEMENTS_OF_${X}_TO_LOAD_PER_WORKITEM ${N_ELEMENTS_TO_LOAD_PER_WORKITEM}\n"
+    "/* MACRO_TILE_LENGTH_A / MICRO_TILE_LENGTH_A : */\n"
+    "#define N_MICRO_IN_MACRO_${X}  ${N_MICRO_IN_MACRO}\n"
+    "/* MICRO_A_TILE_PLL_UNROLL * MICRO_A_TILE_PERP_UNROLL = "
+    "N_ELEMENTS_OF_A_TO_LOAD_PER_WORKITEM : */\n"
+    "#define MICRO_${X}_TILE_PLL_UNROLL ${MICRO_TILE_PLL_UNROLL} \n"
+    "#define MICRO_${X}_TILE_PERP_UNROLL ${MICRO_TILE_PERP_UNROLL}\n"
+    "/* MACRO_TILE_LENGTH_A / MICRO_A_TILE_PLL_UNROLL : */\n"
+    "#define N_MICRO_${X}_TILES_PLL_UNROLL ${N_MICRO_TILES_PLL_UNROLL} \n"
+    "/* Whether the load tiles are interwoven (ala Cobalt, (1)) or if the load tiles are truly "
+    "contiguous tiles (0) */\n"
+    "#define LOAD_TO_LDS_INTERWOVEN_${X} ${LIW}\n"
+    "/* Whether micro tile being processed by a compute item is interwoven with other micro tiles "
+    "(ala Cobalt, (1)) or if the micro tiles are contiguous in C */\n"
+    "#define C_MICRO_TILES_INTERWOVEN_${X} ${MIW}\n"
+    "/* depending on whether loads to c are interwoven, set as MIW == 0 ? 1 : N_MICRO_IN_MACRO_A "
+    "*/\n"
+    "#define C_INTERWEAVE_STRIDE_${X} ${C_INTERWEAVE_STRIDE}\n";
+
+  static const std::vector<std::string> names = {"X",
+                                                 "TVFLOAT",
+                                                 "VEW",
+                                                 "MIC",
+                                                 "PAD",
+                                                 "PLU",
+                                                 "MACRO_TILE_LENGTH_AND_PAD",
+                                                 "N_ELEMENTS_IN_PADDED_UNROLL",
+                                                 "N_ELEMENTS_TO_LOAD_PER_WORKITEM",
+                                                 "N_MICRO_IN_MACRO",
+                                                 "MICRO_TILE_PLL_UNROLL",
+                                                 "MICRO_TILE_PERP_UNROLL",
+                                                 "N_MICRO_TILES_PLL_UNROLL",
+                                                 "LIW",
+                                                 "MIW",
+                                                 "C_INTERWEAVE_STRIDE"};
+
+  static const basegen::Fragment with_comments(text, names);
+  static const basegen::Fragment without_comments(basegen::Fragment::get_uncommented(text), names);
+  return emat_x == Mat::E::A ? with_comments : without_comments;
+}
+
+const basegen::Fragment& get_common_fragment()
+{
+  static const basegen::Fragment common(
+    "\n/* integer types for navigating each of the memory buffers */\n"
+    "#define TINTA ${TINTA}\n"
+    "#define TINTB ${TINTB}\n"
+    "#define TINTC ${TINTC}\n"
+    "#define TINTW ${TINTW}\n"
+    "\n/* type for integer in inner most loops (probably inlined anyway)  */\n"
+    "#define TSHORT ${TSHORT}\n"
+    "\n/* type for integers which never exceeds KV__ + UNROLL (for UFO case) */\n"
+    "#define TINTK ${TINTK}\n"
+    "\n/* ********************************** common to A and B "
+    "*************************************** */\n"
+    "/* whether or not to shimmy the starting k, in an attempt to avoid cache line overuse for "
+    "cases where lda/ldb are powers of 2 */\n"
+    "/* if 0, no shimmying. if 1, instead of starting at k = 0 workgroups start at some negative "
+    "offset dependent on work group id */\n"
+    "/* in the same way as the final unroll populates LDS with zeros in k mod UNROLL != 0, the "
+    "initial negative indices here populate with 0 */\n"
+    "#define UNROLL_FOR_OFFSET ${UFO}\n"
+    "/* How much a workgroup loads (global -> LDS) in the k-direction at each iteration of the "
+    "outer-most loop */\n"
+    "#define UNROLL ${UNR}\n"
+    "/* whether or not this kernel uses the edge trick (SC17 submission) */\n"
+    "/* this precompiler defn has no direct influence on the running the kernel, implementation "
+    "already done in make_kernel.py */\n"
+    "#define EDGETRICK ${EDGETRICK}\n"
+    "/* the number of work items working on the same c element. if this is 1, there will be just "
+    "one thread doing all k multiply-adds, */\n"
+    "/* otherwise if it is greater than 1, each thread will be computing ~ k / "
+    "N_WORK_ITEMS_PER_C_ELM of the multiply adds, to be atomically added at the end */ \n"
+    "#define N_WORK_ITEMS_PER_C_ELM ${ICE}\n"
+    "/* define the way in which work groups are assigned to tiles */\n"
+    "/* 1 : column-by-column\n"
+    " * 2 : row-by-row \n"
+    " * 3 : by rows within super-column  */\n",
+    {"TINTA", "TINTB", "TINTC", "TINTW", "TSHORT", "TINTK", "UFO", "UNR", "EDGETRICK", "ICE"});
+  return common;
+}
+
+const basegen::Fragment& get_work_fragment()
+{
+  static const basegen::Fragment work(
+    "/* Whether to use the unroll pragma to encourage the compiler to unroll certain loops */\n"
+    "/* Included here for user, in practice it has no direct effect on this kernel, as the "
+    "relevent implementation has been done in make_kernel.py */\n"
+    "#define PRAGMA_UNROLL_FORLOOPS ${PUN}\n"
+    "/* (deprecated parameter, as of 17 Nov 2016, see git log) How many steps ahead are we "
+    "reading into registers, as compared to doing the math. */\n"
+    "/* This should be the domain of the compiler, and currently (26/08/2016, Catalyst) it seems "
+    "that leaving this as 0 is best.  */\n"
+    "#define N_PREFETCH_FOR_REGISTER_LOAD 0\n"
+    "/* (deprecated parameter, as of 17 Nov 2016, see git log) How many steps ahead are we "
+    "reading into LDS, as compared to the unroll loop */\n"
+    "/* This should be the domain of the compiler, and currently (26/08/2016, Catalyst) it seems "
+    "that leaving this as 0 is best.  */\n"
+    "#define N_PREFETCH_FOR_LDS_LOAD 0\n"
+    "#define MACRO_TILE_AREA ${MACRO_TILE_AREA}\n"
+    "#define MICRO_TILE_AREA ${MICRO_TILE_AREA}\n"
+    "#define N_WORK_ITEMS_PER_WORKGROUP  ${N_WORK_ITEMS_PER_WORKGROUP}\n"
+    "/* two more parameters, which do dot have an effect the running of this kernel (used in "
+    "enqueuing) */\n"
+    "/* the total number of work groups this kernel will use (recall m,n,k are fixed) */ \n"
+    "/* N_WORK_ITEMS_PER_C_ELM * ((M/MACRO_TILE_LENGTH_A) + (M%MACRO_TILE_LENGTH_A != 0)) * "
+    "((N/MACRO_TILE_LENGTH_B) + (N%MACRO_TILE_LENGTH_B != 0)) */ \n"
+    "#define N_WORK_GROUPS ${N_WORK_GROUPS}\n"
+    "/* the global work size, ie the total mumber of work items (threads) which will run */\n"
+    " /* N_WORK_GROUPS * N_WORK_ITEMS_PER_WORKGROUP */ \n"
+    "#define GLOBAL_WORK_SIZE ${GLOBAL_WORK_SIZE}\n",
+    {"PUN",
+     "MACRO_TILE_AREA",
+     "MICRO_TILE_AREA",
+     "N_WORK_ITEMS_PER_WORKGROUP",
+     "N_WORK_GROUPS",
+     "GLOBAL_WORK_SIZE"});
+  return work;
+}
+}
+
 class AlphaGenerator : public basegen::BaseGenerator
 {
 
@@ -43,15 +219,26 @@ class AlphaGenerator : public basegen::BaseGenerator
 
     u_a     = (hp.sus[Mat::E::A].vs[Chi::E::WOS] == Scratch::E::UNUSED) ? true : false;
     u_b     = (hp.sus[Mat::E::B].vs[Chi::E::WOS] == Scratch::E::UNUSED) ? true : false;
-    u_c     = true;
-    u_w     = (not u_a or not u_b);
-    u_alpha = true;
+    u_c     = dp.main_writes_partials == 0;
+    u_w     = (not u_a or not u_b or not u_c);
+    u_alpha = u_c;
     u_beta  = dp.main_does_beta_c_inc;
+    u_bias  = ep.bias != Bias::E::NONE;
   }
 
+  // applied to the final value of each element of C, in registers
+  Epilogue ep;
+
+  // the products with B_i and C_i, for one A
+  MultiGemm mg;
+
   public:
-  AlphaGenerator(const HyPas& hp_, const Geometry& gg_, const DerivedParams& dp_)
-    : basegen::BaseGenerator(hp_, gg_, dp_)
+  AlphaGenerator(const HyPas&         hp_,
+                 const Geometry&      gg_,
+                 const DerivedParams& dp_,
+                 const Epilogue&      ep_,
+                 const MultiGemm&     mg_)
+    : basegen::BaseGenerator(hp_, gg_, dp_), ep(ep_), mg(mg_)
   {
 
     if (hp.sus[Mat::E::C].vs[NonChi::E::AFI] == Binary::E::YES)
@@ -67,7 +254,29 @@ class AlphaGenerator : public basegen::BaseGenerator
   private:
   void append_group_allocation_string(std::stringstream& ss)
   {
-    if (hp.sus[Mat::E::C].vs[NonChi::E::GAL] == GroupAllocation::E::BYCOL)
+    // a triangle of C : group_id_xy is the index of the tile in the triangle, row-by-row, where
+    // row r (of the N_GROUPS_A x N_GROUPS_A tiles) starts at index r(r + 1)/2. The float
+    // estimate of the row is corrected to the exact row.
+    if (gg.uplo != Uplo::E::NONE)
+    {
+      ss << R"(
+/* triangle of C : only the N_GROUPS_A (N_GROUPS_A + 1) / 2 tiles on and )"
+         << (gg.uplo == Uplo::E::LOWER ? "below" : "above") << R"( the diagonal */
+TINTC tri_row = (TINTC)((sqrt(8.f*group_id_xy + 1.f) - 1.f)/2.f);
+while (tri_row*(tri_row + 1)/2 > group_id_xy){
+--tri_row;
+}
+while ((tri_row + 1)*(tri_row + 2)/2 <= group_id_xy){
+++tri_row;
+}
+const TINTC tri_col = group_id_xy - tri_row*(tri_row + 1)/2;
+)";
+      bool lower = gg.uplo == Uplo::E::LOWER;
+      ss << "const TINTA group_id_a = " << (lower ? "tri_row" : "tri_col") << ";\n";
+      ss << "const TINTB group_id_b = " << (lower ? "tri_col" : "tri_row") << ";\n";
+    }
+
+    else if (hp.sus[Mat::E::C].vs[NonChi::E::GAL] == GroupAllocation::E::BYCOL)
     {
       ss <<
         R"(
@@ -177,7 +386,16 @@ group_id_a = (group_id_xy  - (N_GROUPS_B - LAST_SUPER_COLUMN_WIDTH)*N_GROUPS_A)
 
   void append_split_on_k_vardecl_write_string(std::stringstream& ss)
   {
-    if (dp.main_split_on_k != 0)
+    if (dp.main_writes_partials != 0)
+    {
+      ss << R"(
+/* the partial sums of this work group (of group_id_z), to be reduced in a fixed order */
+__global TFLOAT_ACC * w_partial = (__global TFLOAT_ACC *)(w + w_offset + GLOBAL_OFFSET_PARTIALS);
+w_partial += (TINTW)(group_id_z)*PARTIAL_STRIDE;
+)";
+    }
+
+    else if (dp.main_split_on_k != 0)
     {
       ss <<
         R"(
@@ -188,6 +406,19 @@ TFLOAT previous_value; )"
          << dp.infa << " newVal;\n"
          << dp.infa << " prevVal;"
          << "\n\n";
+      if (gg.derived.floattype_c == 'h')
+      {
+        ss << "/* there are no 16-bit atomics : the 32-bit word containing the half is swapped */\n"
+           << "global uint * ptr_to_c_word;\n"
+           << "uint c_word_shift;\n\n";
+      }
+      else if (gg.derived.floattype_c == 'z')
+      {
+        ss << "/* there are no 128-bit atomics : the real and imaginary parts are swapped */\n"
+           << "global double * ptr_to_c_part;\n"
+           << "double previous_part;\n"
+           << "TFLOAT c_increment;\n\n";
+      }
     }
   }
 
@@ -251,11 +482,39 @@ TFLOAT previous_value; )"
     // a good place to break kernel to check error checking.
     // make this* 1.11101242345 for example
 
-    std::string alpha_scaled = "alpha*rC[" + dima_index + "][" + dimb_index + "]";
+    std::string rc           = get_rc(dima_index, dimb_index);
+    std::string alpha_scaled = gg.derived.is_complex() ? "CMUL(alpha, " + rc + ")" : "alpha*" + rc;
     ss << "\nindex =  STRIDE_PLL_M_C*(write_start_a + dima) + STRIDE_PLL_N_C*(write_start_b + "
           "dimb) ;\n";
 
-    if (with_beta_scaling != 0)
+    // alpha and beta are applied in the reduction kernel
+    if (dp.main_writes_partials != 0)
+    {
+      ss << "w_partial[index] = " << rc << ";\n";
+      return;
+    }
+
+    // alpha is the scale and beta the zero point (fma : as cpugemm, without a double rounding)
+    if (gg.derived.is_requantised())
+    {
+      ss << "c[index] = convert_char_sat_rte(fma(alpha, (float)(" << rc << "), beta));\n";
+      return;
+    }
+
+    // the epilogue needs ICE = 1 (confirm_epilogue) : this is the only write of the element
+    if (!ep.is_identity())
+    {
+      append_epilogue_write_element(ss, alpha_scaled, with_beta_scaling);
+      return;
+    }
+
+    if (with_beta_scaling != 0 && gg.derived.is_complex())
+    {
+      ss << "if (beta.x >= 0 && beta.x <= 0 && beta.y >= 0 && beta.y <= 0){\nc[index] = 0; \n}\n"
+         << "else {\nc[index] = CMUL(beta, c[index]);}\n";
+    }
+
+    else if (with_beta_scaling != 0)
     {
       ss << "if (beta >= 0 && beta <= 0){\nc[index] = 0; \n}\n"
          << "else {\nc[index] *= beta;}\n";
@@ -269,6 +528,42 @@ TFLOAT previous_value; )"
         ss << "c[index] += " << alpha_scaled << +";\n";
       }
 
+      else if (gg.derived.floattype_c == 'i')
+      {
+        ss << "atomic_add(c + index, " << alpha_scaled << ");";
+      }
+
+      else if (gg.derived.floattype_c == 'z')
+      {
+        ss << "c_increment = " << alpha_scaled << ";\n";
+        for (std::string part : {"x", "y"})
+        {
+          ss << "ptr_to_c_part = (global double *)(c + index)" << (part == "y" ? " + 1" : "")
+             << ";\n"
+             << "do {\n"
+             << "previous_part = *ptr_to_c_part;\n"
+             << "prevVal = as_ulong(previous_part);\n"
+             << "newVal = as_ulong(c_increment." << part << " + previous_part);\n"
+             << "} while (" << dp.fati
+             << "((__global ulong *)(ptr_to_c_part), prevVal, newVal) != prevVal);\n";
+        }
+      }
+
+      else if (gg.derived.floattype_c == 'h')
+      {
+        // the other half of the word is written back unchanged (GPUs are little endian)
+        ss << "ptr_to_c_elm = c + index;\n"
+           << "ptr_to_c_word = (global uint *)((uintptr_t)(ptr_to_c_elm) & ~(uintptr_t)3);\n"
+           << "c_word_shift = ((uintptr_t)(ptr_to_c_elm) & 2) * 8;\n"
+           << "do {\n"
+           << "prevVal = *ptr_to_c_word;\n"
+           << "previous_value = as_half((ushort)(prevVal >> c_word_shift));\n"
+           << "newVal = (prevVal & ~(0xffffu << c_word_shift)) | "
+           << "((uint)as_ushort((half)(" << alpha_scaled << " + previous_value))"
+           << " << c_word_shift);\n"
+           << "} while (" << dp.fati << "(ptr_to_c_word, prevVal, newVal) != prevVal);";
+      }
+
       else
       {
         ss << "ptr_to_c_elm = c + index;\n"
@@ -282,6 +577,49 @@ TFLOAT previous_value; )"
     }
   }
 
+  void append_epilogue_write_element(std::stringstream& ss,
+                                     const std::string& alpha_scaled,
+                                     size_t             with_beta_scaling)
+  {
+    ss << "c_value = " << alpha_scaled << ";\n";
+    if (with_beta_scaling != 0)
+    {
+      ss << "if (!(beta >= 0 && beta <= 0)){\nc_value += beta*c[index];\n}\n";
+    }
+    else
+    {
+      ss << "c_value += c[index];\n";
+    }
+
+    if (ep.bias == Bias::E::ROW)
+    {
+      ss << "c_value += bias[write_start_a + dima];\n";
+    }
+    else if (ep.bias == Bias::E::COL)
+    {
+      ss << "c_value += bias[write_start_b + dimb];\n";
+    }
+
+    if (ep.activation == Activation::E::RELU)
+    {
+      ss << "c_value = max(c_value, (TFLOAT_ACC)(0));\n";
+    }
+    else if (ep.activation == Activation::E::GELU)
+    {
+      // the tanh approximation
+      ss << "c_value = (TFLOAT_ACC)(0.5)*c_value*((TFLOAT_ACC)(1) + "
+         << "tanh((TFLOAT_ACC)(0.7978845608028654)*(c_value + "
+         << "(TFLOAT_ACC)(0.044715)*c_value*c_value*c_value)));\n";
+    }
+
+    // the largest finite half
+    if (ep.conversion == Conversion::E::SATURATE && gg.derived.floattype_c == 'h')
+    {
+      ss << "c_value = clamp(c_value, (TFLOAT_ACC)(-65504), (TFLOAT_ACC)(65504));\n";
+    }
+    ss << "c[index] = (TFLOAT)(c_value);\n";
+  }
+
   void append_for_loops_for_c_write_open(std::stringstream& ss)
   {
 
@@ -317,6 +655,17 @@ TFLOAT previous_value; )"
 
     ss << "TINTB dimb = dimbi*VEW_B + dimbi_v;\n";
     ss << "TINTA dima = dimai*VEW_A + dimai_v;\n";
+
+    // a triangle of C : the diagonal tiles are masked, the elements of the other triangle are
+    // neither read nor written
+    if (gg.uplo != Uplo::E::NONE)
+    {
+      bool lower = gg.uplo == Uplo::E::LOWER;
+      ss << "/* triangle of C : not the elements " << (lower ? "above" : "below")
+         << " the diagonal */\n";
+      ss << "if (write_start_a + dima " << (lower ? "<" : ">") << " write_start_b + dimb){\n"
+         << "continue;\n}\n";
+    }
   }
 
   void append_for_loops_for_c_write_close(std::stringstream& ss) { ss << "\n}\n}\n}\n}\n"; }
@@ -442,8 +791,12 @@ barrier(CLK_LOCAL_MEM_FENCE); )";
     std::stringstream ss_value_to_get;
     std::stringstream ss_comment;
 
+    // the B_i are PRODUCT_STRIDE_B apart in global memory, and in consecutive tiles in LDS
+    bool multi_b = is_multi() && emat_x == Mat::E::B;
+
     std::stringstream basic_to_get_ss;
-    basic_to_get_ss << x << "_vec[(mu_pll_i*STRIDE_PLL_K_" << X << " + VEW_" << X
+    basic_to_get_ss << x << (multi_b ? "_vec_p" : "_vec") << "[(mu_pll_i*STRIDE_PLL_K_" << X
+                    << " + VEW_" << X
                     << "*mu_perp_i*STRIDE_PERP_K_" << X << ")/VEW_" << X << "]";
 
     if (final_unroll == 1 || special_first_unroll == 1)
@@ -462,16 +815,27 @@ barrier(CLK_LOCAL_MEM_FENCE); )";
       ss_value_to_get << basic_to_get_ss.str() << ';';
     }
 
-    ss << '\n' << ss_comment.str() << '\n' << dp.pragma_unroll_string;
+    ss << '\n' << ss_comment.str() << '\n';
+    if (multi_b)
+    {
+      ss << "for (TSHORT p = 0; p < N_PRODUCTS; ++p){\n"
+         << "const __global TVFLOATB * b_vec_p = b_vec + (ulong)(p)*(PRODUCT_STRIDE_B/VEW_B);\n";
+    }
+    ss << dp.pragma_unroll_string;
     append_load_for_perp(emat_x, ss);
     ss << " {\n" << dp.pragma_unroll_string;
     append_load_for_pll(emat_x, ss);
     ss << " {\n"
-       << "local" << X << "[MACRO_TILE_LENGTH_" << X << "_AND_PAD/VEW_" << X << "*(" << x
+       << "local" << X << "[" << (multi_b ? "p*N_ELEMENTS_IN_PADDED_B_UNROLL/VEW_B + " : "")
+       << "MACRO_TILE_LENGTH_" << X << "_AND_PAD/VEW_" << X << "*(" << x
        << "_offset_pll_unroll + mu_pll_i) + " << x << "_offset_perp_unroll_v + mu_perp_i] = \n"
        << ss_value_to_get.str() << '\n'
        << "}\n"
        << "}\n";
+    if (multi_b)
+    {
+      ss << "}\n";
+    }
 
     if (final_unroll == 0)
       ss << x << "_vec += "
@@ -603,6 +967,13 @@ if ((group_id_z == N_WORK_ITEMS_PER_C_ELM - 1) && k_remaining > 0){
   void append_compute_string(std::stringstream& ss)
   {
 
+    std::string rc = get_rc("dima", "dimb");
+    std::string rb = is_multi() ? "rB[p][dimb]" : "rB[dimb]";
+    if (is_multi())
+    {
+      ss << "for (TSHORT p = 0; p < N_PRODUCTS; ++p){\n";
+    }
+
     for (auto emat : mata_matb)
     {
       char x = Mat::M().lcase_name[emat];
@@ -611,37 +982,82 @@ if ((group_id_z == N_WORK_ITEMS_PER_C_ELM - 1) && k_remaining > 0){
          << " < MICRO_TILE_LENGTH_" << X << "; ++dim" << x << "){\n";
     }
 
-    if (hp.sus[Mat::E::C].vs[NonChi::E::MAD] == Binary::E::NO)
+    // (a + ib)(c + id) = (ac - bd) + i(ad + bc) : with mad, a(c, d) + (-b, b)(d, c)
+    if (gg.derived.is_complex() && hp.sus[Mat::E::C].vs[NonChi::E::MAD] == Binary::E::NO)
     {
-      ss << "rC[dima][dimb] += rA[dima]*rB[dimb];   \n}\n}\n";
+      ss << rc << " += CMUL(rA[dima], " << rb << ");   \n}\n}\n";
+    }
+    else if (gg.derived.is_complex())
+    {
+      ss << rc << " = mad((TFLOAT_ACC)(rA[dima].x), " << rb << ", "
+         << "mad((TFLOAT_ACC)(-rA[dima].y, rA[dima].y), " << rb << ".yx, " << rc
+         << "));    \n}\n}\n";
+    }
+
+    // there is no integer mad
+    else if (hp.sus[Mat::E::C].vs[NonChi::E::MAD] == Binary::E::NO ||
+             gg.derived.floattype_acc == 'i')
+    {
+      ss << rc << " += rA[dima]*" << rb << ";   \n}\n}\n";
     }
     else
     {
-      ss << "rC[dima][dimb] = mad(rA[dima], rB[dimb], rC[dima][dimb]);    \n}\n}\n";
+      ss << rc << " = mad(rA[dima], " << rb << ", " << rc << ");    \n}\n}\n";
+    }
+
+    if (is_multi())
+    {
+      ss << "}\n";
     }
   }
 
+  bool is_multi() const { return !mg.is_single(); }
+
+  // the register of C for (dima, dimb), of product p if there are several
+  std::string get_rc(const std::string& dima, const std::string& dimb) const
+  {
+    return std::string(is_multi() ? "rC[p][" : "rC[") + dima + "][" + dimb + "]";
+  }
+
   void append_load_to_register_string(Mat::E emat_x, std::stringstream& ss)
   {
     char X = Mat::M().name[emat_x];
 
+    // the B_i are in consecutive unroll tiles of LDS
+    bool        multi_b = is_multi() && emat_x == Mat::E::B;
+    std::string lds_p   = multi_b ? "p*N_ELEMENTS_IN_PADDED_B_UNROLL/VEW_B + " : "";
+    std::string r_x     = std::string("r") + X + (multi_b ? "[p]" : "");
+    std::string l_x     = std::string("l") + X + "[" + lds_p;
+
     ss << '\n' << dp.pragma_unroll_string;
+    if (multi_b)
+    {
+      ss << "for (TSHORT p = 0; p < N_PRODUCTS; ++p){\n";
+    }
     ss << "for (TSHORT i = 0; i < MICRO_TILE_LENGTH_" << X << "/VEW_" << X << "; ++i){\n";
 
     if (hp.sus[emat_x].vs[Chi::E::VEW] != 1)
     {
       for (unsigned j = 0; j < hp.sus[emat_x].vs[Chi::E::VEW]; ++j)
       {
-        ss << "r" << X << "[VEW_" << X << "*i + " << j << "] = l" << X << "["
-           << "i*"
+        ss << r_x << "[VEW_" << X << "*i + " << j << "] = " << l_x << "i*"
            << "C_INTERWEAVE_STRIDE_" << X << "].s" << j << ";\n";
       }
     }
     else
     {
-      ss << "r" << X << "[i] = l" << X << "[i*C_INTERWEAVE_STRIDE_" << X << "];\n";
+      ss << r_x << "[i] = " << l_x << "i*C_INTERWEAVE_STRIDE_" << X << "];\n";
+    }
+    // conjugated once per load, not in every product
+    if (gg.cX[emat_x])
+    {
+      ss << r_x << "[i].y = -" << r_x << "[i].y;\n";
     }
     ss << "}\n";
+    if (multi_b)
+    {
+      ss << "}\n";
+    }
 
     ss << "l" << X << " += MACRO_TILE_LENGTH_" << X << "_AND_PAD/VEW_" << X << ";\n";
   }
@@ -741,25 +1157,109 @@ if ((group_id_z == N_WORK_ITEMS_PER_C_ELM - 1) && k_remaining > 0){
          << hp.sus[Mat::E::C].vs[NonChi::E::ICE] * hp.sus[Mat::E::C].vs[NonChi::E::UNR]
          << " // N_WORK_ITEMS_PER_C_ELM*UNROLL";
     }
+
+    if (dp.main_writes_partials != 0)
+    {
+      ss << "\n/* the partial sums : their offset in workspace (in TFLOAT_AB), and the stride "
+            "between those of the splits in k (in TFLOAT_ACC) */\n"
+         << "#define GLOBAL_OFFSET_PARTIALS " << dp.red_global_offset << '\n'
+         << "#define PARTIAL_STRIDE " << dp.red_partial_stride << '\n';
+    }
   }
 
   void append_group_id_defns(std::stringstream& ss)
   {
+    // with stream-K, the unit of work plays the role of the work group
+    std::string group_id = is_stream_k() ? "unit" : "get_group_id(0)";
     if (dp.main_split_on_k == 0)
     {
-      ss << "\nconst TINTC group_id_xy = get_group_id(0);\n";
+      ss << "\nconst TINTC group_id_xy = " << group_id << ";\n";
     }
     else
     {
-      ss <<
-        R"(
-const TINTC group_id = get_group_id(0);
-const TINTC group_id_xy = group_id / N_WORK_ITEMS_PER_C_ELM;
+      ss << "\nconst TINTC group_id = " << group_id << ";\n"
+         << R"(const TINTC group_id_xy = group_id / N_WORK_ITEMS_PER_C_ELM;
 const TSHORT group_id_z = group_id % N_WORK_ITEMS_PER_C_ELM;
 )";
     }
   }
 
+  bool is_stream_k() const { return hp.sus[Mat::E::C].vs[NonChi::E::STK] != 0; }
+
+  void append_stream_k_defns(std::stringstream& ss)
+  {
+    if (is_stream_k())
+    {
+      ss << "/* stream-K : the (tile, split in k) units of work, shared by the N_WORK_GROUPS "
+            "persistent work groups */\n"
+         << "#define N_WORK_UNITS " << dp.main_n_work_units << '\n';
+    }
+  }
+
+  void append_multigemm_defns(std::stringstream& ss)
+  {
+    if (is_multi())
+    {
+      ss << "/* the products C_i = A B_i : B_i (C_i) is PRODUCT_STRIDE_B (PRODUCT_STRIDE_C) "
+            "elements after B_{i-1} (C_{i-1}) */\n"
+         << "#define N_PRODUCTS " << mg.n_products << '\n'
+         << "#define PRODUCT_STRIDE_B " << mg.b_stride << '\n'
+         << "#define PRODUCT_STRIDE_C " << mg.c_stride << '\n';
+    }
+  }
+
+  void append_stream_k_loop_open(std::stringstream& ss)
+  {
+    ss << "\n\n/* ************* stream-K : persistent work group *************** */\n";
+    for (auto emat : mata_matb)
+    {
+      append_lds_decl_string(ss, emat);
+      if (hp.sus[emat].vs[Chi::E::WOS] == Scratch::E::UNUSED)
+      {
+        char x = Mat::M().lcase_name[emat];
+        ss << "__global const TFLOAT_AB * restrict const " << x << "_base = " << x << ";\n";
+      }
+    }
+    ss << R"(
+/* register memory for C, accumulated over the units of work of a tile */
+TFLOAT_ACC rC[MICRO_TILE_LENGTH_A][MICRO_TILE_LENGTH_B] = {{0.}};
+
+/* this work group processes a contiguous range of the units of work */
+const TINTC unit_begin = (TINTC)(((ulong)(get_group_id(0))*N_WORK_UNITS)/N_WORK_GROUPS);
+const TINTC unit_end = (TINTC)(((ulong)(get_group_id(0) + 1)*N_WORK_UNITS)/N_WORK_GROUPS);
+for (TINTC unit = unit_begin; unit < unit_end; ++unit){
+)";
+  }
+
+  void append_stream_k_write_open(std::stringstream& ss)
+  {
+    // consecutive splits in k of a tile are accumulated in registers, and written (atomically)
+    // once. Partial sums for the reduction kernel are written for every split in k
+    if (dp.main_split_on_k != 0 && dp.main_writes_partials == 0)
+    {
+      ss << R"(
+/* fix-up of the tile : written when the next unit of work is of another tile, or there is none */
+if (unit + 1 == unit_end || (unit + 1) / N_WORK_ITEMS_PER_C_ELM != group_id_xy){
+)";
+    }
+  }
+
+  void append_stream_k_write_close(std::stringstream& ss)
+  {
+    ss << R"(
+for (TSHORT dima = 0; dima < MICRO_TILE_LENGTH_A; ++dima){
+for (TSHORT dimb = 0; dimb < MICRO_TILE_LENGTH_B; ++dimb){
+rC[dima][dimb] = (TFLOAT_ACC)(0);
+}
+}
+)";
+    if (dp.main_split_on_k != 0 && dp.main_writes_partials == 0)
+    {
+      ss << "}\n";
+    }
+    ss << "}\n";
+  }
+
   void append_stride_c_defn(std::stringstream& ss)
   {
 
@@ -804,6 +1304,10 @@ const TSHORT group_id_z = group_id % N_WORK_ITEMS_PER_C_ELM;
 
 c += c_offset;
 )";
+    if (u_bias)
+    {
+      ss << "bias += bias_offset;\n";
+    }
   }
 
   void append_id_string_nonsym(std::stringstream& ss)
@@ -848,6 +1352,17 @@ TINTK k_plus_offset = KV__ + unroll_offset;
     }
   }
 
+  void append_lds_decl_string(std::stringstream& ss, Mat::E emat_x)
+  {
+    char X = Mat::M().name[emat_x];
+    if (emat_x == Mat::E::A)
+      ss << "/* LDS memory */\n";
+    ss << "__local "
+       << "TVFLOAT" << X << " local" << X << "["
+       << (is_multi() && emat_x == Mat::E::B ? "N_PRODUCTS*" : "") << "N_ELEMENTS_IN_PADDED_" << X
+       << "_UNROLL/VEW_" << X << "];\n";
+  }
+
   void append_id_string_sym(std::stringstream& ss, Mat::E emat_x)
   {
 
@@ -856,18 +1371,19 @@ TINTK k_plus_offset = KV__ + unroll_offset;
 
     ss << '\n';
 
-    if (emat_x == Mat::E::A)
-      ss << "/* LDS memory */\n";
-    ss << "__local "
-       << "TVFLOAT" << X << " local" << X << "[N_ELEMENTS_IN_PADDED_" << X << "_UNROLL"
-       << "/VEW_" << X << "];\n";
+    // __local memory is declared at kernel function scope, outside the stream-K loop
+    if (!is_stream_k())
+    {
+      append_lds_decl_string(ss, emat_x);
+    }
     if (emat_x == Mat::E::A)
       ss << "/* jumping pointer to locate the LDS to load into register memory "
             "*/\n";
     ss << "__local const TVFLOAT" << X << " * l" << X << ";\n";
     if (emat_x == Mat::E::A)
       ss << "/* register memory */ \n";
-    ss << "TFLOAT r" << X << "[MICRO_TILE_LENGTH_" << X << "];\n";
+    ss << "TFLOAT_ACC r" << X << (is_multi() && emat_x == Mat::E::B ? "[N_PRODUCTS]" : "")
+       << "[MICRO_TILE_LENGTH_" << X << "];\n";
     if (emat_x == Mat::E::A)
       ss << "/* Define which part of the C macro-tile this thread will process "
             "(% / or / % ? "
@@ -893,7 +1409,14 @@ TINTK k_plus_offset = KV__ + unroll_offset;
     {
       if (emat_x == Mat::E::A)
         ss << "/* from workspace */\n";
-      ss << "const TFLOAT * restrict " << x << " = w + w_offset + GLOBAL_OFFSET_" << X << ";\n";
+      ss << "const TFLOAT_AB * restrict " << x << " = w + w_offset + GLOBAL_OFFSET_" << X
+         << ";\n";
+    }
+
+    else if (is_stream_k())
+    {
+      ss << "__global const TFLOAT_AB * restrict " << x << " = " << x << "_base + " << x
+         << "_offset;\n";
     }
 
     else
@@ -1020,25 +1543,11 @@ TINTK k_plus_offset = KV__ + unroll_offset;
     ss << '\n';
   }
 
-  void append_transpose_note(std::stringstream& ss)
-  {
-    ss << R"(
-/* A note on how transposes isColMajor  effect the kernel generated: very little. */
-/* just via STRIDE_PLL_K_{A,B}, STRIDE_PERP_K_{A,B}, STRIDE_PLL_M_C, STRIDE_PERP_M_C */
-)";
-  }
-
   void add_predefine_chiral(Mat::E emat_x, std::stringstream& ss)
   {
 
     char x = Mat::M().name[emat_x];
 
-    auto defcom = [emat_x, &ss](std::string&& comment) {
-      if (emat_x == Mat::E::A)
-        ss << "/*"
-           << " " << comment << " : */\n";
-    };
-
     bool withcomments = emat_x == Mat::E::A;
 
     bool with_x_in_name = true;
@@ -1047,73 +1556,31 @@ TINTK k_plus_offset = KV__ + unroll_offset;
     append_stride_definitions(
       emat_x, ss, hp.sus[emat_x].vs[Chi::E::WOS], withcomments, "", with_x_in_name);
 
-    if (emat_x == Mat::E::A)
-      ss << "/* vector float type */\n";
-    ss << "#define TVFLOAT" << x << " " << dp.t_float;
-    if (hp.sus[emat_x].vs[Chi::E::VEW] != 1)
-      ss << hp.sus[emat_x].vs[Chi::E::VEW];
-    ss << '\n';
-
-    if (emat_x == Mat::E::A)
-      ss << "/* vector width */\n";
-    ss << "#define VEW_" << x << "  " << hp.sus[emat_x].vs[Chi::E::VEW];
-    ss << '\n';
-
-    if (emat_x == Mat::E::A)
-      ss << "/* micro tiles define the pattern of C that individual threads "
-            "process */\n";
-    ss << "#define MICRO_TILE_LENGTH_" << x << " " << hp.sus[emat_x].vs[Chi::E::MIC] << '\n';
-
-    if (emat_x == Mat::E::A)
-      ss << "/* the amount of padding of " << x
-         << " in LDS (local) memory, to avoid bank comflicts */\n";
-    ss << "#define PAD_LDS_" << x << "  " << hp.sus[emat_x].vs[Chi::E::PAD] << '\n';
-    if (emat_x == Mat::E::A)
-      ss << "/* whether loading of " << x << " from global should try to be long in direction of "
-                                             "unroll (1) or perpendicular to it (0) */\n";
-    ss << "#define WORK_ITEM_LOAD_" << x << "_PLL_TO_UNROLL " << hp.sus[emat_x].vs[Chi::E::PLU]
-       << '\n';
-    defcom("MACRO_TILE_LENGTH_A + PAD_LDS_A");
-    ss << "#define MACRO_TILE_LENGTH_" << x << "_AND_PAD "
-       << dp.at(emat_x).main_macro_tile_length_and_pad << '\n';
-
-    defcom("MACRO_TILE_LENGTH_A_AND_PAD * UNROLL");
-    ss << "#define N_ELEMENTS_IN_PADDED_" << x << "_UNROLL "
-       << dp.at(emat_x).main_n_elements_in_padded_unroll << '\n';
-
-    defcom("N_ELEMENTS_IN_A_UNROLL / N_WORK_ITEMS_PER_WORKGROUP");
-    ss << "#define N_ELEMENTS_OF_" << x << "_TO_LOAD_PER_WORKITEM "
-       << dp.at(emat_x).main_n_elements_to_load_per_workitem << '\n';
-    defcom("MACRO_TILE_LENGTH_A / MICRO_TILE_LENGTH_A");
-    ss << "#define N_MICRO_IN_MACRO_" << x << "  " << dp.at(emat_x).main_n_micro_in_macro << '\n';
-    defcom("MICRO_A_TILE_PLL_UNROLL * MICRO_A_TILE_PERP_UNROLL = "
-           "N_ELEMENTS_OF_A_TO_LOAD_PER_WORKITEM");
-    ss << "#define MICRO_" << x << "_TILE_PLL_UNROLL " << dp.at(emat_x).main_micro_tile_pll_unroll
-       << " \n";
-    ss << "#define MICRO_" << x << "_TILE_PERP_UNROLL " << dp.at(emat_x).main_micro_tile_perp_unroll
-       << '\n';
-
-    defcom("MACRO_TILE_LENGTH_A / MICRO_A_TILE_PLL_UNROLL");
-    ss << "#define N_MICRO_" << x << "_TILES_PLL_UNROLL "
-       << dp.at(emat_x).main_n_micro_tiles_pll_unroll << " \n";
-    if (emat_x == Mat::E::A)
-      ss << "/* Whether the load tiles are interwoven (ala Cobalt, (1)) or if "
-            "the load tiles are "
-            "truly contiguous tiles (0) */\n";
-    ss << "#define LOAD_TO_LDS_INTERWOVEN_" << x << " " << hp.sus[emat_x].vs[Chi::E::LIW] << '\n';
-    if (emat_x == Mat::E::A)
-      ss << "/* Whether micro tile being processed by a compute item is "
-            "interwoven with other "
-            "micro tiles (ala Cobalt, (1)) or if the micro tiles are "
-            "contiguous in C */\n";
-    ss << "#define C_MICRO_TILES_INTERWOVEN_" << x << " " << hp.sus[emat_x].vs[Chi::E::MIW] << '\n';
-
-    if (emat_x == Mat::E::A)
-      ss << "/* depending on whether loads to c are interwoven, set as MIW == "
-            "0 ? 1 : "
-            "N_MICRO_IN_MACRO_A */\n";
-    ss << "#define C_INTERWEAVE_STRIDE_" << x << " " << dp.at(emat_x).main_c_interweave_stride
-       << '\n';
+    auto&       sus     = hp.sus[emat_x];
+    auto&       dpx     = dp.at(emat_x);
+    std::string tvfloat = dp.t_float_ab;
+    if (sus.vs[Chi::E::VEW] != 1)
+    {
+      tvfloat += std::to_string(sus.vs[Chi::E::VEW]);
+    }
+    get_chiral_fragment(emat_x).append(
+      ss,
+      {std::string(1, x),
+       tvfloat,
+       std::to_string(sus.vs[Chi::E::VEW]),
+       std::to_string(sus.vs[Chi::E::MIC]),
+       std::to_string(sus.vs[Chi::E::PAD]),
+       std::to_string(sus.vs[Chi::E::PLU]),
+       std::to_string(dpx.main_macro_tile_length_and_pad),
+       std::to_string(dpx.main_n_elements_in_padded_unroll),
+       std::to_string(dpx.main_n_elements_to_load_per_workitem),
+       std::to_string(dpx.main_n_micro_in_macro),
+       std::to_string(dpx.main_micro_tile_pll_unroll),
+       std::to_string(dpx.main_micro_tile_perp_unroll),
+       std::to_string(dpx.main_n_micro_tiles_pll_unroll),
+       std::to_string(sus.vs[Chi::E::LIW]),
+       std::to_string(sus.vs[Chi::E::MIW]),
+       std::to_string(dpx.main_c_interweave_stride)});
 
     if (hp.sus[emat_x].vs[Chi::E::WOS] != Scratch::E::UNUSED)
     {
@@ -1133,20 +1600,15 @@ TINTK k_plus_offset = KV__ + unroll_offset;
 
     std::stringstream ss;
     ss << get_time_string();
-    ss << "\n\n";
-    ss << "/* this kernel was generated for starting geometry : */\n";
-    ss << "/* " << gg.get_string() << "*/\n";
-    ss << "#define KV__ " << gg.k << '\n';
-    ss << "#define TFLOAT  " << dp.t_float << '\n';
-    ss << "#define DOES_BETA_C_INC " << dp.main_does_beta_c_inc << '\n';
-    ss << "#define DOES_ALPHA_A_B_INC 1" << '\n';
-
-    append_transpose_note(ss);
-
-    ss <<
-      R"(
-
-)";
+    get_head_fragment().append(ss,
+                               {gg.get_string(),
+                                std::to_string(gg.k),
+                                dp.t_float_pragma_string,
+                                dp.t_float,
+                                dp.t_float_ab,
+                                dp.t_float_acc,
+                                dp.t_float_complex_string,
+                                std::to_string(dp.main_does_beta_c_inc)});
 
     for (auto emat_x : mata_matb)
 
@@ -1156,94 +1618,31 @@ TINTK k_plus_offset = KV__ + unroll_offset;
       add_predefine_chiral(emat_x, ss);
     }
 
-    ss << "\n/* integer types for navigating each of the memory buffers */\n";
-    for (size_t i = 0; i < Mem::E::N; ++i)
-    {
-      ss << "#define TINT" << Mem::M().name[i] << " " << dp.tints[i] << '\n';
-    }
-    ss << "\n/* type for integer in inner most loops (probably inlined anyway)  */\n";
-    ss << "#define TSHORT " << dp.tshort << '\n';
-    ss << "\n/* type for integers which never exceeds KV__ + UNROLL (for UFO case) */\n";
-    ss << "#define TINTK " << dp.tintk << '\n';
-
-    ss << "\n/* ********************************** common to A and B "
-          "*************************************** */";
-    ss << "\n/* whether or not to shimmy the starting k, in an attempt to "
-          "avoid cache line overuse "
-          "for cases where lda/ldb are powers of 2 */\n";
-    ss << "/* if 0, no shimmying. if 1, instead of starting at k = 0 "
-          "workgroups start at some "
-          "negative offset dependent on work group id */\n";
-    ss << "/* in the same way as the final unroll populates LDS with zeros in "
-          "k mod UNROLL != 0, "
-          "the initial negative indices here populate with 0 */\n";
-    ss << "#define UNROLL_FOR_OFFSET " << hp.sus[Mat::E::C].vs[NonChi::E::UFO] << '\n';
-
-    ss << "/* How much a workgroup loads (global -> LDS) in the k-direction at "
-          "each iteration of "
-          "the outer-most loop */\n";
-    ss << "#define UNROLL " << hp.sus[Mat::E::C].vs[NonChi::E::UNR] << '\n';
-    ss << "/* whether or not this kernel uses the edge trick (SC17 submission) "
-          "*/\n";
-    ss << "/* this precompiler defn has no direct influence on the running the "
-          "kernel, "
-          "implementation already done in make_kernel.py */\n";
-    ss << "#define EDGETRICK " << dp.main_use_edge_trick << '\n';
-    ss << "/* the number of work items working on the same c element. if this "
-          "is 1, there will be "
-          "just one thread doing all k multiply-adds, */\n";
-    ss << "/* otherwise if it is greater than 1, each thread will be computing "
-          "~ k / "
-          "N_WORK_ITEMS_PER_C_ELM of the multiply adds, to be atomically added "
-          "at the end */ \n";
-    ss << "#define N_WORK_ITEMS_PER_C_ELM " << hp.sus[Mat::E::C].vs[NonChi::E::ICE] << '\n';
-
-    ss << R"(/* define the way in which work groups are assigned to tiles */
-/* 1 : column-by-column
- * 2 : row-by-row 
- * 3 : by rows within super-column  */
-)";
+    auto& suc = hp.sus[Mat::E::C];
+    get_common_fragment().append(ss,
+                                 {dp.tints[Mem::E::A],
+                                  dp.tints[Mem::E::B],
+                                  dp.tints[Mem::E::C],
+                                  dp.tints[Mem::E::W],
+                                  dp.tshort,
+                                  dp.tintk,
+                                  std::to_string(suc.vs[NonChi::E::UFO]),
+                                  std::to_string(suc.vs[NonChi::E::UNR]),
+                                  std::to_string(dp.main_use_edge_trick),
+                                  std::to_string(suc.vs[NonChi::E::ICE])});
 
     append_group_allocation_defn_string(ss);
 
-    ss << "/* Whether to use the unroll pragma to encourage the compiler to "
-          "unroll certain loops "
-          "*/\n";
-    ss << "/* Included here for user, in practice it has no direct effect on "
-          "this kernel, as the "
-          "relevent implementation has been done in make_kernel.py */\n";
-    ss << "#define PRAGMA_UNROLL_FORLOOPS " << hp.sus[Mat::E::C].vs[NonChi::E::PUN] << '\n';
-    ss << "/* (deprecated parameter, as of 17 Nov 2016, see git log) How many "
-          "steps ahead are we "
-          "reading into registers, as compared to doing the math. */\n";
-    ss << "/* This should be the domain of the compiler, and currently "
-          "(26/08/2016, Catalyst) it "
-          "seems that leaving this as 0 is best.  */\n";
-    ss << "#define N_PREFETCH_FOR_REGISTER_LOAD " << 0 << '\n';
-    ss << "/* (deprecated parameter, as of 17 Nov 2016, see git log) How many "
-          "steps ahead are we "
-          "reading into LDS, as compared to the unroll loop */\n";
-    ss << "/* This should be the domain of the compiler, and currently "
-          "(26/08/2016, Catalyst) it "
-          "seems that leaving this as 0 is best.  */\n";
-    ss << "#define N_PREFETCH_FOR_LDS_LOAD " << 0 << '\n';
-    ss << "#define MACRO_TILE_AREA " << dp.main_macro_tile_area << '\n';
-    ss << "#define MICRO_TILE_AREA " << dp.main_micro_tile_area << '\n';
-    ss << "#define N_WORK_ITEMS_PER_WORKGROUP  " << dp.main_n_work_items_per_workgroup << '\n';
-    ss << "/* two more parameters, which do dot have an effect the running of "
-          "this kernel (used in "
-          "enqueuing) */\n";
-    ss << "/* the total number of work groups this kernel will use (recall "
-          "m,n,k are fixed) */ \n";
-    ss << "/* N_WORK_ITEMS_PER_C_ELM * ((M/MACRO_TILE_LENGTH_A) + "
-          "(M%MACRO_TILE_LENGTH_A != 0)) * "
-          "((N/MACRO_TILE_LENGTH_B) + (N%MACRO_TILE_LENGTH_B != 0)) */ \n";
-    ss << "#define N_WORK_GROUPS " << dp.main_n_work_groups << '\n';
-    ss << "/* the global work size, ie the total mumber of work items "
-          "(threads) which will run */\n ";
-    ss << "/* N_WORK_GROUPS * N_WORK_ITEMS_PER_WORKGROUP */ \n";
-    ss << "#define GLOBAL_WORK_SIZE " << dp.main_global_work_size << '\n';
+    get_work_fragment().append(ss,
+                               {std::to_string(suc.vs[NonChi::E::PUN]),
+                                std::to_string(dp.main_macro_tile_area),
+                                std::to_string(dp.main_micro_tile_area),
+                                std::to_string(dp.main_n_work_items_per_workgroup),
+                                std::to_string(dp.main_n_work_groups),
+                                std::to_string(dp.main_global_work_size)});
 
+    append_stream_k_defns(ss);
+    append_multigemm_defns(ss);
     append_stride_c_defn(ss);
     append_split_on_k_defns_string(ss);
     append_super_column_width_defn(ss);
@@ -1256,7 +1655,15 @@ TINTK k_plus_offset = KV__ + unroll_offset;
 
     ss << "\n{\n\n";
 
-    append_c_offset_string(ss);
+    if (u_c)
+    {
+      append_c_offset_string(ss);
+    }
+
+    if (is_stream_k())
+    {
+      append_stream_k_loop_open(ss);
+    }
 
     append_id_string_nonsym(ss);
 
@@ -1270,9 +1677,16 @@ TINTK k_plus_offset = KV__ + unroll_offset;
 
     ss << "\n\n\n";
 
-    ss << "/* register memory for C */\n ";
-
-    ss << "TFLOAT rC[MICRO_TILE_LENGTH_A][MICRO_TILE_LENGTH_B] = {{0.}};\n";
+    if (is_multi())
+    {
+      ss << "/* register memory for the C_i */\n ";
+      ss << "TFLOAT_ACC rC[N_PRODUCTS][MICRO_TILE_LENGTH_A][MICRO_TILE_LENGTH_B] = {{{0.}}};\n";
+    }
+    else if (!is_stream_k())
+    {
+      ss << "/* register memory for C */\n ";
+      ss << "TFLOAT_ACC rC[MICRO_TILE_LENGTH_A][MICRO_TILE_LENGTH_B] = {{0.}};\n";
+    }
 
     append_first_unroll_block(ss);
 
@@ -1290,14 +1704,35 @@ TINTK k_plus_offset = KV__ + unroll_offset;
 
     ss << "\n\n";
     ss << "TINTC index;\n";
+    if (!ep.is_identity())
+    {
+      ss << "/* the final value of each element, to which the epilogue is applied */\n"
+         << "TFLOAT_ACC c_value;\n";
+    }
 
     append_split_on_k_vardecl_write_string(ss);
+    if (is_stream_k())
+    {
+      append_stream_k_write_open(ss);
+    }
+    if (is_multi())
+    {
+      ss << "\n/* the C_i, one after another */\nfor (TSHORT p = 0; p < N_PRODUCTS; ++p){\n";
+    }
     append_final_write_all(ss);
+    if (is_multi())
+    {
+      ss << "\nc += PRODUCT_STRIDE_C;\n}\n";
+    }
+    if (is_stream_k())
+    {
+      append_stream_k_write_close(ss);
+    }
 
     ss << "\n}\n";
 
     return {get_ktype(),
-            {u_a, u_b, u_c, u_w, u_alpha, u_beta},
+            {u_a, u_b, u_c, u_w, u_alpha, u_beta, u_bias},
             ss.str(),
             kernelname,
             dp.main_global_work_size,
@@ -1310,7 +1745,9 @@ TINTK k_plus_offset = KV__ + unroll_offset;
 
   virtual void set_type() override final
   {
-    type = dp.main_does_beta_c_inc ? "betac_alphaab" : "alphaab";
+    type = dp.main_writes_partials != 0
+             ? "partialab"
+             : dp.main_does_beta_c_inc != 0 ? "betac_alphaab" : "alphaab";
   }
 
   virtual void setup_final() override final {}
@@ -1318,9 +1755,13 @@ TINTK k_plus_offset = KV__ + unroll_offset;
   virtual KType::E get_ktype() override final { return KType::E::MAIN; }
 };
 
-KernBlob get_alpha_kernelstring(const HyPas& hp, const Geometry& gg, const DerivedParams& dp)
+KernBlob get_alpha_kernelstring(const HyPas&         hp,
+                                const Geometry&      gg,
+                                const DerivedParams& dp,
+                                const Epilogue&      epilogue,
+                                const MultiGemm&     multigemm)
 {
-  AlphaGenerator ag(hp, gg, dp);
+  AlphaGenerator ag(hp, gg, dp, epilogue, multigemm);
   ag.setup();
   return ag.get_kernelstring();
 }
@@ -203,7 +203,7 @@ RunStats supa_gemm0(cl_command_queue&               queue,
                                    "(runem)",
                                    true);
 
-  auto w_mem_size = get_total_workspace(gg, toff) * gg.derived.float_size_bytes;
+  auto w_mem_size = get_total_workspace(gg, toff) * gg.derived.float_size_bytes_ab;
   if (w_mem_size > 0)
   {
     oclutil::cl_set_buffer_from_command_queue(
@@ -531,6 +531,18 @@ template RunStats supa_gemm0(cl_command_queue&                    queue,
                              owrite::Writer&                      mowri,
                              const setabcw::CpuMemBundle<double>* ptr_cmb);
 
+template RunStats supa_gemm0(cl_command_queue&                  queue,
+                             const Geometry&                    gg,
+                             const Offsets&                     toff,
+                             const half                         alpha,
+                             const half                         beta,
+                             size_t                             n_runs,
+                             bool                               run_accu,
+                             GemmImpl                           impl,
+                             bool                               run_event_timer,
+                             owrite::Writer&                    mowri,
+                             const setabcw::CpuMemBundle<half>* ptr_cmb);
+
 std::string get_summary_deepstyle(const std::vector<Geometry>& geometries,
                                   const std::vector<RunStats>& all_runstats,
                                   const std::vector<GemmImpl>& impls,
@@ -29,8 +29,8 @@ Stat::Stat(const oclutil::DevInfo& devinfo,
 
   // check 0 : LDS
   size_t LDS_required =
-    gg.derived.float_size_bytes * ((dp.at(Mat::E::A).main_n_elements_in_padded_unroll +
-                                    dp.at(Mat::E::B).main_n_elements_in_padded_unroll));
+    gg.derived.float_size_bytes_ab * ((dp.at(Mat::E::A).main_n_elements_in_padded_unroll +
+                                       dp.at(Mat::E::B).main_n_elements_in_padded_unroll));
 
   if (LDS_required >= devinfo.device_local_mem_size)  // max_LDS_bytes)
   {
@@ -38,6 +38,13 @@ Stat::Stat(const oclutil::DevInfo& devinfo,
               << devinfo.device_local_mem_size << ") \n";
   }
 
+  // check 1 : half precision
+  if ((gg.derived.floattype_c == 'h' || gg.derived.floattype_ab == 'h') && !devinfo.device_fp16)
+  {
+    status_ss << "floattype " << gg.floattype
+              << " has half values but cl_khr_fp16 is not supported by the device \n";
+  }
+
   msg     = status_ss.str();
   is_good = (msg == "");
 }
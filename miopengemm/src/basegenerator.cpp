@@ -1,10 +1,10 @@
 /*******************************************************************************
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
-#include <chrono>
-#include <sstream>
+#include <algorithm>
 #include <sstream>
 #include <miopengemm/basegenerator.hpp>
+#include <miopengemm/error.hpp>
 
 namespace MIOpenGEMM
 {
@@ -12,6 +12,65 @@ namespace MIOpenGEMM
 namespace basegen
 {
 
+Fragment::Fragment(const std::string& text_, const std::vector<std::string>& names)
+  : n_names(names.size())
+{
+  size_t last = 0;
+  size_t open = text_.find("${");
+  while (open != std::string::npos)
+  {
+    size_t close = text_.find('}', open);
+    if (close == std::string::npos)
+    {
+      throw miog_error("unclosed parameter in kernel source fragment : " + text_.substr(open));
+    }
+    std::string name  = text_.substr(open + 2, close - open - 2);
+    auto        found = std::find(names.begin(), names.end(), name);
+    if (found == names.end())
+    {
+      throw miog_error("unknown parameter in kernel source fragment : " + name);
+    }
+    text.push_back(text_.substr(last, open - last));
+    params.push_back(found - names.begin());
+    last = close + 1;
+    open = text_.find("${", last);
+  }
+  text.push_back(text_.substr(last));
+}
+
+void Fragment::append(std::stringstream& ss, const std::vector<std::string>& values) const
+{
+  if (values.size() != n_names)
+  {
+    std::stringstream errm;
+    errm << "kernel source fragment with " << n_names << " parameters given " << values.size()
+         << " values";
+    throw miog_error(errm.str());
+  }
+  for (size_t i = 0; i < params.size(); ++i)
+  {
+    ss << text[i] << values[params[i]];
+  }
+  ss << text.back();
+}
+
+std::string Fragment::get_uncommented(const std::string& text)
+{
+  std::stringstream ss;
+  size_t            start = 0;
+  while (start < text.size())
+  {
+    size_t end = text.find('\n', start);
+    end        = end == std::string::npos ? text.size() : end + 1;
+    if (text.compare(start, 2, "/*") != 0)
+    {
+      ss << text.substr(start, end - start);
+    }
+    start = end;
+  }
+  return ss.str();
+}
+
 BaseGenerator::BaseGenerator(const HyPas& hp_, const Geometry& gg_, const DerivedParams& dp_)
 
   : hp(hp_), gg(gg_), dp(dp_), n_args_added(0)
@@ -31,16 +90,17 @@ void BaseGenerator::append_farg(bool u_x, std::stringstream& ss, const std::stri
 void BaseGenerator::append_fargs(std::stringstream& ss)
 {
   ss << "\n(";
-  append_farg(u_a, ss, "\n__global const TFLOAT * restrict a, \nconst ulong a_offset");
-  append_farg(u_b, ss, "\n__global const TFLOAT * restrict b, \nconst ulong b_offset");
+  append_farg(u_a, ss, "\n__global const TFLOAT_AB * restrict a, \nconst ulong a_offset");
+  append_farg(u_b, ss, "\n__global const TFLOAT_AB * restrict b, \nconst ulong b_offset");
   append_farg(u_c, ss, "\n__global TFLOAT       *          c, \nconst ulong c_offset");
   // if using c, we assume workspace is const.
   // this is a hacky, as we might have a kernel
   // which uses c and modifies w as well.
   std::string cness = (u_c == true) ? "const " : "";
-  append_farg(u_w, ss, "\n__global " + cness + "TFLOAT * restrict w,\nconst ulong w_offset");
-  append_farg(u_alpha, ss, "\nconst TFLOAT alpha");
-  append_farg(u_beta, ss, "\nconst TFLOAT beta");
+  append_farg(u_w, ss, "\n__global " + cness + "TFLOAT_AB * restrict w,\nconst ulong w_offset");
+  append_farg(u_alpha, ss, "\nconst " + dp.t_float_scalar + " alpha");
+  append_farg(u_beta, ss, "\nconst " + dp.t_float_scalar + " beta");
+  append_farg(u_bias, ss, "\n__global const TFLOAT * restrict bias, \nconst ulong bias_offset");
   ss << ")\n";
 }
 
@@ -120,34 +180,29 @@ void BaseGenerator::append_unroll_block_geometry(Mat::E             emat_x,
   }
 }
 
-std::string BaseGenerator::get_time_string()
-{
-
-  std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
-  std::time_t generation_time = std::chrono::system_clock::to_time_t(now);
-
-  std::stringstream ss;
-  ss << "This " << type << " kernel string was generated on " << std::ctime(&generation_time);
-
-  std::string time_stamp_string = ss.str();
-
-  return "";
-  // return stringutil::get_star_wrapped(time_stamp_string.substr(0, time_stamp_string.size() - 1));
-}
+// The static comment blocks are built once. The time stamp is not used : it would make the
+// kernel source differ between generations, defeating program caching.
+std::string BaseGenerator::get_time_string() { return ""; }
 
 std::string BaseGenerator::get_what_string()
 {
-  return stringutil::get_star_wrapped("These parameters define WHAT this kernel does");
+  static const std::string what =
+    stringutil::get_star_wrapped("These parameters define WHAT this kernel does");
+  return what;
 }
 
 std::string BaseGenerator::get_how_string()
 {
-  return stringutil::get_star_wrapped("These parameters define HOW it does it");
+  static const std::string how =
+    stringutil::get_star_wrapped("These parameters define HOW it does it");
+  return how;
 }
 
 std::string BaseGenerator::get_derived_string()
 {
-  return stringutil::get_star_wrapped("The following are implied by preceding: NOT free params!");
+  static const std::string derived =
+    stringutil::get_star_wrapped("The following are implied by preceding: NOT free params!");
+  return derived;
 }
 }
 }
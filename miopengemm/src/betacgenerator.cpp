@@ -35,7 +35,10 @@ void BetacGenerator::setup_additional()
 ****************************************************** */ )";
   // inner_work_string  = "\n/* the beta scaling */\nc[i] *= beta;";
   inner_work_string =
-    "\n/* beta scaling */\nif (beta <= 0 && beta >= 0){c[i] = 0;}else{c[i] *= beta;}";
+    gg.derived.is_complex()
+      ? "\n/* beta scaling */\nif (beta.x <= 0 && beta.x >= 0 && beta.y <= 0 && beta.y >= 0)"
+        "{c[i] = 0;}else{c[i] = CMUL(beta, c[i]);}"
+      : "\n/* beta scaling */\nif (beta <= 0 && beta >= 0){c[i] = 0;}else{c[i] *= beta;}";
 }
 
 void BetacGenerator::append_derived_definitions_additional(std::stringstream& ss) { ss << " "; }
@@ -6,11 +6,15 @@
 #include <cmath>
 #include <ctime>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <miopengemm/alphagenerator.hpp>
 #include <miopengemm/betacgenerator.hpp>
@@ -19,6 +23,7 @@
 #include <miopengemm/derivedparams.hpp>
 #include <miopengemm/error.hpp>
 #include <miopengemm/normalformgenerator.hpp>
+#include <miopengemm/reducegenerator.hpp>
 #include <miopengemm/stringutilbase.hpp>
 
 namespace MIOpenGEMM
@@ -26,14 +31,16 @@ namespace MIOpenGEMM
 namespace kerngen
 {
 
-// parameter order rule: {a, oa, b, ob, c, oc, ws, ows}, alpha, beta
+// parameter order rule: {a, oa, b, ob, c, oc, ws, ows}, alpha, beta, {bias, obias}
 std::vector<std::pair<size_t, const void*>>
 get_arg_sizes_values(const KernBlob& kblob,
                      const std::array<cl_mem, Mem::E::N>& cl_mems,
                      const std::array<size_t, Mem::E::N>& offsets,
-                     size_t      float_size_bytes,
-                     const void* alpha,
-                     const void* beta)
+                     size_t        float_size_bytes,
+                     const void*   alpha,
+                     const void*   beta,
+                     const cl_mem* bias,
+                     const size_t* bias_offset)
 {
 
   std::vector<std::pair<size_t, const void*>> arg_sizes_values;
@@ -55,6 +62,16 @@ get_arg_sizes_values(const KernBlob& kblob,
   {
     arg_sizes_values.emplace_back(float_size_bytes, beta);
   }
+
+  if (kblob.kuses.u_bias)
+  {
+    if (bias == nullptr || bias_offset == nullptr)
+    {
+      throw miog_error("kernel " + kblob.fname + " applies a bias, but there is no bias buffer");
+    }
+    arg_sizes_values.emplace_back(sizeof(cl_mem), static_cast<const void*>(bias));
+    arg_sizes_values.emplace_back(sizeof(size_t), bias_offset);
+  }
   return arg_sizes_values;
 }
 
@@ -108,9 +125,58 @@ std::vector<std::vector<size_t>> get_v_wait_indices(const std::vector<KernBlob>&
   return v_wait_indices;
 }
 
-Bundle::Bundle(const HyPas& hp_, const Geometry& gg_) : hp(hp_), gg(gg_), dp(hp, gg)
+namespace
 {
 
+class BundleKey
+{
+  public:
+  PackedHyPas            php;
+  std::array<size_t, 15> ggvs;
+  bool operator==(const BundleKey& rhs) const { return php == rhs.php && ggvs == rhs.ggvs; }
+};
+
+class BundleKeyHash
+{
+  public:
+  size_t operator()(const BundleKey& key) const
+  {
+    size_t h = PackedHyPasHash()(key.php);
+    for (auto v : key.ggvs)
+    {
+      h = h * 1000003 ^ std::hash<size_t>()(v);
+    }
+    return h;
+  }
+};
+
+// a Bundle's kernel strings are about 20 KB, cleared when full
+const size_t max_memoized = 512;
+
+class KernBlobMemo
+{
+  public:
+  std::unordered_map<BundleKey, std::shared_ptr<const std::vector<KernBlob>>, BundleKeyHash>
+             kblobs;
+  std::mutex mutt;
+};
+
+KernBlobMemo& get_memo()
+{
+  static KernBlobMemo memo;
+  return memo;
+}
+}
+
+std::vector<KernBlob> get_kernblobs(const HyPas&         hp,
+                                    const Geometry&      gg,
+                                    const DerivedParams& dp,
+                                    const Epilogue&      epilogue,
+                                    const MultiGemm&     multigemm)
+{
+  confirm_epilogue(epilogue, gg, dp);
+  confirm_multigemm(multigemm, epilogue, hp, gg, dp);
+  std::vector<KernBlob> v_tgks;
   for (auto emat_x : {Mat::E::A, Mat::E::B})
   {
 
@@ -138,12 +204,18 @@ Bundle::Bundle(const HyPas& hp_, const Geometry& gg_) : hp(hp_), gg(gg_), dp(hp,
     }
   }
 
-  if (dp.main_does_beta_c_inc == 0)
+  // with partial sums, beta is applied in the reduction kernel
+  if (dp.main_does_beta_c_inc == 0 && dp.main_writes_partials == 0)
   {
     v_tgks.emplace_back(betacgen::get_betac_kernelstring(hp, gg, dp));
   }
 
-  v_tgks.emplace_back(alphagen::get_alpha_kernelstring(hp, gg, dp));
+  v_tgks.emplace_back(alphagen::get_alpha_kernelstring(hp, gg, dp, epilogue, multigemm));
+
+  if (dp.main_writes_partials != 0)
+  {
+    v_tgks.emplace_back(reducegen::get_reduce_kernelstring(hp, gg, dp));
+  }
 
   // indent the kernel strings, in case someone wants to
   // print them. For (v-minorly) better
@@ -153,6 +225,44 @@ Bundle::Bundle(const HyPas& hp_, const Geometry& gg_) : hp(hp_), gg(gg_), dp(hp,
   {
     stringutil::indentify(x.kernstr);
   }
+  return v_tgks;
+}
+
+Bundle::Bundle(const HyPas& hp_, const Geometry& gg_) : hp(hp_), gg(gg_), dp(hp, gg)
+{
+  BundleKey key;
+  try
+  {
+    key.php = hp.get_packed();
+  }
+  catch (const miog_error&)
+  {
+    // a value too large to pack, not memoized
+    v_tgks = get_kernblobs(hp, gg, dp);
+    return;
+  }
+  key.ggvs = gg.get_fields();
+
+  auto& memo = get_memo();
+  {
+    std::lock_guard<std::mutex> lock(memo.mutt);
+    auto                        found = memo.kblobs.find(key);
+    if (found != memo.kblobs.end())
+    {
+      v_tgks = *found->second;
+      return;
+    }
+  }
+
+  auto kblobs = std::make_shared<const std::vector<KernBlob>>(get_kernblobs(hp, gg, dp));
+  v_tgks      = *kblobs;
+
+  std::lock_guard<std::mutex> lock(memo.mutt);
+  if (memo.kblobs.size() >= max_memoized)
+  {
+    memo.kblobs.clear();
+  }
+  memo.kblobs.emplace(key, std::move(kblobs));
 }
 }
 }
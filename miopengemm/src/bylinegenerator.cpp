@@ -209,7 +209,7 @@ KernBlob ByLineGenerator::get_kernelstring()
   append_setup_coordinates(ss);
   append_positioning_x_string(ss);
 
-  if (emat_x == Mat::E::A || emat_x == Mat::E::B)
+  if (u_w)
   {
     append_positioning_w_string(ss);
   }
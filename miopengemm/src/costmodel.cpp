@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <miopengemm/costmodel.hpp>
+#include <miopengemm/derivedparams.hpp>
+#include <miopengemm/runstats.hpp>
+#include <miopengemm/tinytwo.hpp>
+
+namespace MIOpenGEMM
+{
+namespace costmodel
+{
+
+namespace
+{
+// used when DevInfo does not have them (as with get_vega_devinfo)
+const size_t default_n_compute_units = 64;
+const double default_clock_mhz       = 1500;
+const double default_bandwidth_gbs   = 480;
+
+// work items per compute unit needed to hide latency
+const double work_items_to_fill_cu = 256;
+}
+
+Analytic::Analytic(size_t n_compute_units_, double clock_mhz_, double bandwidth_gbs_)
+  : n_compute_units(n_compute_units_), clock_mhz(clock_mhz_), bandwidth_gbs(bandwidth_gbs_)
+{
+  if (n_compute_units == 0 || clock_mhz <= 0 || bandwidth_gbs <= 0)
+  {
+    throw miog_error("Analytic cost model parameters should be positive");
+  }
+}
+
+Analytic::Analytic(const oclutil::DevInfo& devinfo)
+  : Analytic(devinfo.device_max_compute_units > 0 ? devinfo.device_max_compute_units
+                                                  : default_n_compute_units,
+             devinfo.device_max_clock_frequency > 0
+               ? static_cast<double>(devinfo.device_max_clock_frequency)
+               : default_clock_mhz,
+             default_bandwidth_gbs)
+{
+}
+
+double Analytic::get_gflops(const HyPas& hp, const Geometry& gg)
+{
+  DerivedParams dp(hp, gg);
+
+  // half is at twice the rate of float (packed math), double at half. The rate is that of the
+  // accumulation type, and the loads of A and B are of their storage type (see floattype 'm').
+  // A complex value is n_parts = 2 reals, and a complex FMA is 4 real FMAs.
+  double n_parts    = gg.derived.is_complex() ? 2 : 1;
+  double acc_size   = static_cast<double>(gg.derived.float_size_bits_acc / 8) / n_parts;
+  double float_size = static_cast<double>(gg.derived.float_size_bytes_ab);
+  double peak       = n_compute_units * 64 * 2 * clock_mhz / 1000 / (acc_size / 4);
+
+  // padding of the macro tiles, and of k to a multiple of UNR in each of the ICE splits
+  auto&  dpa      = dp.at(Mat::E::A);
+  auto&  dpb      = dp.at(Mat::E::B);
+  size_t ice      = hp.sus[Mat::E::C].vs[NonChi::E::ICE];
+  size_t unr      = hp.sus[Mat::E::C].vs[NonChi::E::UNR];
+  size_t split_k  = (gg.k + ice - 1) / ice;
+  double padded_k = static_cast<double>(((split_k + unr - 1) / unr) * unr * ice);
+  double padded_m = static_cast<double>(dpa.n_groups * dpa.macro_tile_length);
+  double padded_n = static_cast<double>(dpb.n_groups * dpb.macro_tile_length);
+  double tile_efficiency =
+    static_cast<double>(gg.m) * gg.n * gg.k / (padded_m * padded_n * padded_k);
+
+  // the last wave of work groups is partial, small problems do not fill the device
+  double n_groups        = static_cast<double>(dp.main_n_work_groups);
+  double n_work_items    = n_groups * dp.main_n_work_items_per_workgroup;
+  double n_waves         = std::ceil(n_groups / n_compute_units);
+  double wave_efficiency = n_groups / (n_waves * n_compute_units);
+
+  // STK : each persistent work group processes at most ceil(units / groups) units in turn
+  if (hp.sus[Mat::E::C].vs[NonChi::E::STK] != 0)
+  {
+    double n_units  = static_cast<double>(dp.main_n_work_units);
+    wave_efficiency = n_units / (std::ceil(n_units / n_groups) * n_waves * n_compute_units);
+  }
+  double fill_efficiency = std::min(1., n_work_items / (work_items_to_fill_cu * n_compute_units));
+
+  // LDS loads (micro_a + micro_b) per micro_a * micro_b FMAs
+  double micro_a          = static_cast<double>(hp.sus[Mat::E::A].vs[Chi::E::MIC]);
+  double micro_b          = static_cast<double>(hp.sus[Mat::E::B].vs[Chi::E::MIC]);
+  double micro_efficiency = micro_a * micro_b / (micro_a * micro_b + micro_a + micro_b);
+
+  // the splits in k of a tile processed in turn by a persistent work group (STK) are accumulated
+  // in registers : a tile is written about (tiles + groups) / tiles times, rather than ICE times
+  double n_writes_per_tile = static_cast<double>(ice);
+  if (hp.sus[Mat::E::C].vs[NonChi::E::STK] != 0 && dp.main_writes_partials == 0)
+  {
+    double n_tiles    = static_cast<double>(dpa.n_groups * dpb.n_groups);
+    n_writes_per_tile = std::min(n_writes_per_tile, (n_tiles + n_groups) / n_tiles);
+  }
+  double split_efficiency = 1. / (1. + 0.05 * (n_writes_per_tile - 1));
+  double compute_bound    = peak * tile_efficiency * wave_efficiency * fill_efficiency *
+                         micro_efficiency * split_efficiency;
+
+  // each macro tile step loads (mt_a + mt_b) * UNR values for 2 * mt_a * mt_b * UNR flops
+  double mt_a         = static_cast<double>(dpa.macro_tile_length);
+  double mt_b         = static_cast<double>(dpb.macro_tile_length);
+  double intensity    = 2 * n_parts * n_parts * mt_a * mt_b / ((mt_a + mt_b) * float_size);
+  double memory_bound = intensity * bandwidth_gbs * tile_efficiency;
+  double gflops       = std::min(compute_bound, memory_bound);
+
+  // RED : the ICE partial sums go through global memory, written by MAIN and read by REDUCE
+  if (dp.main_writes_partials != 0)
+  {
+    double flops        = 2 * n_parts * n_parts * gg.m * gg.n * gg.k;
+    double reduce_bytes = 2. * ice * gg.m * gg.n * (gg.derived.float_size_bits_acc / 8);
+    double seconds      = flops / (1e9 * gflops) + reduce_bytes / (1e9 * bandwidth_gbs);
+    gflops              = flops / seconds / 1e9;
+  }
+
+  return gflops;
+}
+
+std::string Analytic::get_name() const { return "analytic"; }
+
+Measured::Measured(const CLHint& hint_, const Halt& halt_, owrite::Writer& mowri_)
+  : hint(hint_), halt(halt_), mowri(mowri_)
+{
+}
+
+double Measured::get_gflops(const HyPas& hp, const Geometry& gg)
+{
+  dev::TinyTwo tinytwo(gg, get_zero_offsets(), mowri, hint);
+  auto         times = tinytwo.benchgemm({hp}, halt)[0];
+  RunStats     stats(times);
+  return gg.get_gflops(stats.median / 1000.);
+}
+
+std::string Measured::get_name() const { return "measured"; }
+}
+}
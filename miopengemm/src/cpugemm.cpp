@@ -1,7 +1,10 @@
 /*******************************************************************************
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <complex>
 #include <miopengemm/cpugemm.hpp>
 #include <miopengemm/error.hpp>
 #include <miopengemm/geometry.hpp>
@@ -111,17 +114,53 @@ void gemm_openblas(const Geometry& gg,
 
 namespace custom
 {
+
+// the type in which products are accumulated : float for half, int32 for int8, TFloat otherwise
+template <typename TFloat>
+class Accumulator
+{
+  public:
+  using type = TFloat;
+};
+
+template <>
+class Accumulator<half>
+{
+  public:
+  using type = float;
+};
+
+template <>
+class Accumulator<int8_t>
+{
+  public:
+  using type = int32_t;
+};
+
+template <typename TFloat>
+bool is_nonzero(const TFloat& x)
+{
+  return x > 0 || x < 0;
+}
+
+template <typename TFloat>
+bool is_nonzero(const std::complex<TFloat>& x)
+{
+  return is_nonzero(x.real()) || is_nonzero(x.imag());
+}
+
 template <typename TFloat>
 class NNInner
 {
   public:
-  inline TFloat
+  using TAcc = typename Accumulator<TFloat>::type;
+  inline TAcc
   operator()(const TFloat* a, const TFloat* b, size_t x, size_t y, size_t lda, size_t ldb, size_t k)
   {
-    TFloat inner = 0;
+    TAcc inner = 0;
     for (size_t z = 0; z < k; ++z)
     {
-      inner += a[x + z * lda] * b[y * ldb + z];
+      inner += static_cast<TAcc>(a[x + z * lda]) * static_cast<TAcc>(b[y * ldb + z]);
     }
     return inner;
   }
@@ -131,13 +170,14 @@ template <typename TFloat>
 class TTInner
 {
   public:
-  inline TFloat
+  using TAcc = typename Accumulator<TFloat>::type;
+  inline TAcc
   operator()(const TFloat* a, const TFloat* b, size_t x, size_t y, size_t lda, size_t ldb, size_t k)
   {
-    TFloat inner = 0;
+    TAcc inner = 0;
     for (size_t z = 0; z < k; ++z)
     {
-      inner += a[x * lda + z] * b[y + z * ldb];
+      inner += static_cast<TAcc>(a[x * lda + z]) * static_cast<TAcc>(b[y + z * ldb]);
     }
     return inner;
   }
@@ -147,13 +187,14 @@ template <typename TFloat>
 class NTInner
 {
   public:
-  inline TFloat
+  using TAcc = typename Accumulator<TFloat>::type;
+  inline TAcc
   operator()(const TFloat* a, const TFloat* b, size_t x, size_t y, size_t lda, size_t ldb, size_t k)
   {
-    TFloat inner = 0;
+    TAcc inner = 0;
     for (size_t z = 0; z < k; ++z)
     {
-      inner += a[x + z * lda] * b[y + z * ldb];
+      inner += static_cast<TAcc>(a[x + z * lda]) * static_cast<TAcc>(b[y + z * ldb]);
     }
     return inner;
   }
@@ -163,23 +204,25 @@ template <typename TFloat>
 class TNInner
 {
   public:
-  inline TFloat
+  using TAcc = typename Accumulator<TFloat>::type;
+  inline TAcc
   operator()(const TFloat* a, const TFloat* b, size_t x, size_t y, size_t lda, size_t ldb, size_t k)
   {
-    TFloat inner = 0;
+    TAcc inner = 0;
     for (size_t z = 0; z < k; ++z)
     {
-      inner += a[x * lda + z] * b[y * ldb + z];
+      inner += static_cast<TAcc>(a[x * lda + z]) * static_cast<TAcc>(b[y * ldb + z]);
     }
     return inner;
   }
 };
 
-template <typename TFloat, class FInner>
+// A and B of TFloatAB, C of TFloat (different for mixed precision)
+template <typename TFloatAB, typename TFloat, class FInner>
 void gemm_3fors_generic(const Geometry& gg,
                         const Offsets&  toff,
-                        const TFloat*   a,
-                        const TFloat*   b,
+                        const TFloatAB* a,
+                        const TFloatAB* b,
                         TFloat*         c,
                         TFloat          alpha,
                         TFloat          beta)
@@ -192,6 +235,7 @@ void gemm_3fors_generic(const Geometry& gg,
   c += toff.offsets[Mem::E::C];
 
   FInner finner;
+  using TAcc = typename FInner::TAcc;
 
   // For rows of C
   for (size_t x = 0; x < gg.m; ++x)
@@ -210,25 +254,24 @@ void gemm_3fors_generic(const Geometry& gg,
         target_index = y + x * gg.ldX[Mat::E::C];
       }
       // and set it
-      if (beta > 0 || beta < 0)
+      TAcc c_value = 0;
+      if (is_nonzero(beta))
       {
-        c[target_index] *= beta;
-      }
-      else
-      {
-        c[target_index] = 0;
+        c_value = static_cast<TAcc>(c[target_index]) * static_cast<TAcc>(beta);
       }
 
-      c[target_index] += alpha * finner(a, b, x, y, gg.ldX[Mat::E::A], gg.ldX[Mat::E::B], gg.k);
+      c_value += static_cast<TAcc>(alpha) *
+                 finner(a, b, x, y, gg.ldX[Mat::E::A], gg.ldX[Mat::E::B], gg.k);
+      c[target_index] = static_cast<TFloat>(c_value);
     }
   }
 }
 
-template <typename TFloat>
+template <typename TFloatAB, typename TFloat>
 void gemm_3fors(const Geometry& gg,
                 const Offsets&  toff,
-                const TFloat*   a,
-                const TFloat*   b,
+                const TFloatAB* a,
+                const TFloatAB* b,
                 TFloat*         c,
                 TFloat          alpha,
                 TFloat          beta)
@@ -246,22 +289,22 @@ void gemm_3fors(const Geometry& gg,
 
   else if (gg.tX[Mat::E::A] == false && gg.tX[Mat::E::B] == false)
   {
-    gemm_3fors_generic<TFloat, NNInner<TFloat>>(gg, toff, a, b, c, alpha, beta);
+    gemm_3fors_generic<TFloatAB, TFloat, NNInner<TFloatAB>>(gg, toff, a, b, c, alpha, beta);
   }
 
   else if (gg.tX[Mat::E::A] == false && gg.tX[Mat::E::B] == true)
   {
-    gemm_3fors_generic<TFloat, NTInner<TFloat>>(gg, toff, a, b, c, alpha, beta);
+    gemm_3fors_generic<TFloatAB, TFloat, NTInner<TFloatAB>>(gg, toff, a, b, c, alpha, beta);
   }
 
   else if (gg.tX[Mat::E::A] == true && gg.tX[Mat::E::B] == false)
   {
-    gemm_3fors_generic<TFloat, TNInner<TFloat>>(gg, toff, a, b, c, alpha, beta);
+    gemm_3fors_generic<TFloatAB, TFloat, TNInner<TFloatAB>>(gg, toff, a, b, c, alpha, beta);
   }
 
   else if (gg.tX[Mat::E::A] == true && gg.tX[Mat::E::B] == true)
   {
-    gemm_3fors_generic<TFloat, TTInner<TFloat>>(gg, toff, a, b, c, alpha, beta);
+    gemm_3fors_generic<TFloatAB, TFloat, TTInner<TFloatAB>>(gg, toff, a, b, c, alpha, beta);
   }
 
   else
@@ -272,20 +315,49 @@ void gemm_3fors(const Geometry& gg,
 }
 
 template <typename TFloat>
-void gemm(Geometry        gg,
-          Offsets         toff,
-          const TFloat*   a,
-          const TFloat*   b,
-          TFloat*         c,
-          TFloat          alpha,
-          TFloat          beta,
-          owrite::Writer& mowri)
+TFloat get_conjugate(const TFloat& x)
 {
+  return x;
+}
 
+template <typename TFloat>
+std::complex<TFloat> get_conjugate(const std::complex<TFloat>& x)
+{
+  return std::conj(x);
+}
+
+// X, or if gg.cX[emat] a conjugated copy of X in x_conj. Conjugating before redirection, the
+// conjugations do not follow the matrices through it.
+template <typename TFloat>
+const TFloat* get_conjugated(const Geometry&      gg,
+                             const Offsets&       toff,
+                             Mat::E               emat,
+                             const TFloat*        x,
+                             std::vector<TFloat>& x_conj)
+{
+  if (!gg.cX[emat])
+  {
+    return x;
+  }
+  x_conj.assign(x, x + get_mat_size(gg, toff, emat));
+  for (auto& v : x_conj)
+  {
+    v = get_conjugate(v);
+  }
+  return x_conj.data();
+}
+
+// to column major, tC false
+template <typename TFloatAB>
+void redirect(Geometry& gg, Offsets& toff, const TFloatAB*& a, const TFloatAB*& b)
+{
   bool tA = gg.tX[Mat::E::A];
   bool tB = gg.tX[Mat::E::B];
   bool tC = gg.tX[Mat::E::C];
 
+  // a triangle of C follows C through the redirection, as in get_canonical
+  Uplo::E uplo = redirection::get_canonical(gg).uplo;
+
   redirection::redirect(gg.isColMajor,
                         tA,
                         tB,
@@ -301,25 +373,182 @@ void gemm(Geometry        gg,
   gg.tX[Mat::E::A] = tA;
   gg.tX[Mat::E::B] = tB;
   gg.tX[Mat::E::C] = tC;
+  gg.uplo          = uplo;
 
   redirection::confirm_redirection(gg.isColMajor, gg.tX[Mat::E::C]);
   gg.check_ldx_consistent();
-  auto t0 = std::chrono::high_resolution_clock::now();
+}
 
-// dispatch depending on x
+// with a triangle of C (after redirection) a copy of C, from which the elements of the other
+// triangle are restored after the GEMM. Empty without a triangle.
+template <typename TFloat>
+std::vector<TFloat> get_c_copy(const Geometry& gg, const Offsets& toff, const TFloat* c)
+{
+  if (gg.uplo == Uplo::E::NONE)
+  {
+    return {};
+  }
+  return std::vector<TFloat>(c, c + get_mat_size(gg, toff, Mat::E::C));
+}
+
+template <typename TFloat>
+void restore_other_triangle(const Geometry&            gg,
+                            const Offsets&             toff,
+                            const std::vector<TFloat>& c_copy,
+                            TFloat*                    c)
+{
+  if (gg.uplo == Uplo::E::NONE)
+  {
+    return;
+  }
+  for (size_t y = 0; y < gg.n; ++y)
+  {
+    for (size_t x = 0; x < gg.m; ++x)
+    {
+      if (gg.uplo == Uplo::E::LOWER ? x < y : x > y)
+      {
+        size_t index = toff.offsets[Mem::E::C] + x + y * gg.ldX[Mat::E::C];
+        c[index]     = c_copy[index];
+      }
+    }
+  }
+}
+
+template <typename TFloat>
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const TFloat*   a,
+          const TFloat*   b,
+          TFloat*         c,
+          TFloat          alpha,
+          TFloat          beta,
+          owrite::Writer& mowri)
+{
+
+  if (gg.derived.floattype_ab != get_floattype_char<TFloat>())
+  {
+    throw miog_error("A and B of floattype " + std::string(1, gg.floattype) +
+                     " are not of the template type of cpugemm::gemm");
+  }
+
+  std::vector<TFloat> a_conj;
+  std::vector<TFloat> b_conj;
+  a = get_conjugated(gg, toff, Mat::E::A, a, a_conj);
+  b = get_conjugated(gg, toff, Mat::E::B, b, b_conj);
+
+  redirect(gg, toff, a, b);
+  auto c_copy = get_c_copy(gg, toff, c);
+  auto t0     = std::chrono::high_resolution_clock::now();
+
+// dispatch depending on x. OpenBLAS has no half GEMM, and complex is not wrapped.
 #ifdef MIOPENGEMM_USE_OPENBLAS
-  mowri << "launching OpenBLAS CPU GEMM algorithm. " << Endl;
-  openblas::gemm_openblas<TFloat>(gg, toff, a, b, c, alpha, beta);
-#else
-  mowri << "launching slow 3-fors CPU GEMM algorithm. " << Endl;
-  custom::gemm_3fors<TFloat>(gg, toff, a, b, c, alpha, beta);
-#endif  // end of no openblas case
+  if (gg.derived.floattype_c != 'h' && !gg.derived.is_complex())
+  {
+    mowri << "launching OpenBLAS CPU GEMM algorithm. " << Endl;
+    openblas::gemm_openblas<TFloat>(gg, toff, a, b, c, alpha, beta);
+  }
+  else
+#endif  // end of openblas case
+  {
+    mowri << "launching slow 3-fors CPU GEMM algorithm. " << Endl;
+    custom::gemm_3fors<TFloat, TFloat>(gg, toff, a, b, c, alpha, beta);
+  }
+  restore_other_triangle(gg, toff, c_copy, c);
 
   auto t1           = std::chrono::high_resolution_clock::now();
   auto elapsed_time = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
   mowri << "elapsed time : " << elapsed_time * 1e-6 << " [s] " << Endl;
 }
 
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const half*     a,
+          const half*     b,
+          float*          c,
+          float           alpha,
+          float           beta,
+          owrite::Writer& mowri)
+{
+  if (gg.floattype != 'm')
+  {
+    throw miog_error("the cpugemm with A and B half and C float is for floattype 'm', not " +
+                     std::string(1, gg.floattype));
+  }
+
+  redirect(gg, toff, a, b);
+  auto c_copy = get_c_copy(gg, toff, c);
+  auto t0     = std::chrono::high_resolution_clock::now();
+
+  mowri << "launching slow 3-fors CPU GEMM algorithm (mixed precision). " << Endl;
+  custom::gemm_3fors<half, float>(gg, toff, a, b, c, alpha, beta);
+  restore_other_triangle(gg, toff, c_copy, c);
+
+  auto t1           = std::chrono::high_resolution_clock::now();
+  auto elapsed_time = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+  mowri << "elapsed time : " << elapsed_time * 1e-6 << " [s] " << Endl;
+}
+
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const int8_t*   a,
+          const int8_t*   b,
+          int32_t*        c,
+          int32_t         alpha,
+          int32_t         beta,
+          owrite::Writer& mowri)
+{
+  if (gg.floattype != 'i')
+  {
+    throw miog_error("the cpugemm with A and B int8 and C int32 is for floattype 'i', not " +
+                     std::string(1, gg.floattype));
+  }
+
+  redirect(gg, toff, a, b);
+  auto c_copy = get_c_copy(gg, toff, c);
+  mowri << "launching slow 3-fors CPU GEMM algorithm (int8). " << Endl;
+  custom::gemm_3fors<int8_t, int32_t>(gg, toff, a, b, c, alpha, beta);
+  restore_other_triangle(gg, toff, c_copy, c);
+}
+
+void gemm(Geometry        gg,
+          Offsets         toff,
+          const int8_t*   a,
+          const int8_t*   b,
+          int8_t*         c,
+          float           scale,
+          float           zero_point,
+          owrite::Writer& mowri)
+{
+  if (gg.floattype != 'q')
+  {
+    throw miog_error("the cpugemm with A, B and C int8 is for floattype 'q', not " +
+                     std::string(1, gg.floattype));
+  }
+
+  redirect(gg, toff, a, b);
+  auto c_copy = get_c_copy(gg, toff, c);
+  mowri << "launching slow 3-fors CPU GEMM algorithm (int8, requantised). " << Endl;
+
+  // the int32 products AB, with the layout of C
+  std::vector<int32_t> ab(gg.ldX[Mat::E::C] * gg.n + toff.offsets[Mem::E::C]);
+  custom::gemm_3fors<int8_t, int32_t>(gg, toff, a, b, ab.data(), 1, 0);
+
+  // rounding to nearest even (the default rounding mode), as convert_char_sat_rte
+  c += toff.offsets[Mem::E::C];
+  for (size_t y = 0; y < gg.n; ++y)
+  {
+    for (size_t x = 0; x < gg.m; ++x)
+    {
+      size_t index = x + y * gg.ldX[Mat::E::C];
+      float  q =
+        std::nearbyint(std::fma(scale, static_cast<float>(ab[toff.offsets[Mem::E::C] + index]),
+                                zero_point));
+      c[index] = static_cast<int8_t>(std::min(127.f, std::max(-128.f, q)));
+    }
+  }
+  restore_other_triangle(gg, toff, c_copy, c - toff.offsets[Mem::E::C]);
+}
+
 template void gemm(Geometry        gg,
                    Offsets         toff,
                    const float*    a,
@@ -337,5 +566,32 @@ template void gemm(Geometry        gg,
                    double          alpha,
                    double          beta,
                    owrite::Writer& mowri);
+
+template void gemm(Geometry        gg,
+                   Offsets         toff,
+                   const half*     a,
+                   const half*     b,
+                   half*           c,
+                   half            alpha,
+                   half            beta,
+                   owrite::Writer& mowri);
+
+template void gemm(Geometry                   gg,
+                   Offsets                    toff,
+                   const std::complex<float>* a,
+                   const std::complex<float>* b,
+                   std::complex<float>*       c,
+                   std::complex<float>        alpha,
+                   std::complex<float>        beta,
+                   owrite::Writer&            mowri);
+
+template void gemm(Geometry                    gg,
+                   Offsets                     toff,
+                   const std::complex<double>* a,
+                   const std::complex<double>* b,
+                   std::complex<double>*       c,
+                   std::complex<double>        alpha,
+                   std::complex<double>        beta,
+                   owrite::Writer&             mowri);
 }
 }
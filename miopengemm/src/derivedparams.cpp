@@ -2,11 +2,16 @@
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <miopengemm/derivedparams.hpp>
 #include <miopengemm/error.hpp>
+#include <miopengemm/floattostring.hpp>
 #include <miopengemm/macgrid.hpp>
 #include <miopengemm/tiling.hpp>
 
@@ -104,12 +109,143 @@ void DerivedParams::reset_cw_params(Mat::E emat_x)
       : 0;
 }
 
+namespace
+{
+
+// The first checks of set_fragile, without constructing a DerivedParams : the macro tile grid,
+// the macro tile fitting in m and n, the work group size dividing the elements in an unroll,
+// and UFO. Most non-derivable HyPas of a search fail one of these.
+std::tuple<bool, std::string> get_prechecked(const HyPas& hp, const Geometry& gg)
+{
+  auto&         cvs = hp.sus[Mat::E::C].vs;
+  macgrid::Grid grid(cvs[NonChi::E::MAC], cvs[NonChi::E::SKW]);
+  if (!grid.is_good)
+  {
+    return std::make_tuple(false, grid.error_message);
+  }
+
+  size_t mic_a       = hp.sus[Mat::E::A].vs[Chi::E::MIC];
+  size_t mic_b       = hp.sus[Mat::E::B].vs[Chi::E::MIC];
+  size_t macro_a     = grid.at(Mat::E::A) * mic_a;
+  size_t macro_b     = grid.at(Mat::E::B) * mic_b;
+  size_t n_workitems = (macro_a * macro_b) / (mic_a * mic_b);
+  if (gg.m < macro_a || gg.n < macro_b)
+  {
+    return std::make_tuple(false, "the macro tile is larger than m or n (precheck). ");
+  }
+
+  if ((macro_a * cvs[NonChi::E::UNR]) % n_workitems != 0 ||
+      (macro_b * cvs[NonChi::E::UNR]) % n_workitems != 0)
+  {
+    return std::make_tuple(false,
+                           "main_n_work_items_per_workgroup is not a factor of the number of "
+                           "elements in an unroll (precheck). ");
+  }
+
+  if (cvs[NonChi::E::UFO] == Binary::E::YES && gg.k <= cvs[NonChi::E::UNR])
+  {
+    return std::make_tuple(false, "UFO = yes, so UNR must be greater that k");
+  }
+
+  // requantising needs the complete sum of a C element
+  if (gg.derived.is_requantised() && cvs[NonChi::E::ICE] != 1)
+  {
+    return std::make_tuple(false, "C is requantised (floattype 'q'), so ICE must be 1");
+  }
+
+  // there are no vectors of float2 and double2
+  if (gg.derived.is_complex() &&
+      (hp.sus[Mat::E::A].vs[Chi::E::VEW] != 1 || hp.sus[Mat::E::B].vs[Chi::E::VEW] != 1))
+  {
+    return std::make_tuple(false, "complex values are vectors already, so VEW must be 1");
+  }
+
+  return std::make_tuple(true, "");
+}
+
+// Derivabilty results, keyed by packed HyPas and the Geometry fields
+class DerivabiltyKey
+{
+  public:
+  PackedHyPas            php;
+  std::array<size_t, 15> ggvs;
+  bool operator==(const DerivabiltyKey& rhs) const { return php == rhs.php && ggvs == rhs.ggvs; }
+};
+
+class DerivabiltyKeyHash
+{
+  public:
+  size_t operator()(const DerivabiltyKey& key) const
+  {
+    size_t h = PackedHyPasHash()(key.php);
+    for (auto v : key.ggvs)
+    {
+      h = h * 1000003 ^ std::hash<size_t>()(v);
+    }
+    return h;
+  }
+};
+
+// bounded : cleared when full
+const size_t max_memoized = 1 << 16;
+
+class DerivabiltyMemo
+{
+  public:
+  std::unordered_map<DerivabiltyKey, std::tuple<bool, std::string>, DerivabiltyKeyHash> results;
+  std::mutex mutt;
+};
+
+DerivabiltyMemo& get_memo()
+{
+  static DerivabiltyMemo memo;
+  return memo;
+}
+}
+
 Derivabilty::Derivabilty(const HyPas& hp, const Geometry& gg)
 {
+  std::tie(is_derivable, msg) = get_prechecked(hp, gg);
+  if (!is_derivable)
+  {
+    return;
+  }
+
+  DerivabiltyKey key;
+  try
+  {
+    key.php = hp.get_packed();
+  }
+  catch (const miog_error&)
+  {
+    // a value too large to pack, not memoized
+    DerivedParams dp(hp, gg, "uninitialised");
+    std::tie(is_derivable, msg) = dp.set_fragile();
+    return;
+  }
+  key.ggvs = gg.get_fields();
+
+  auto& memo = get_memo();
+  {
+    std::lock_guard<std::mutex> lock(memo.mutt);
+    auto                        found = memo.results.find(key);
+    if (found != memo.results.end())
+    {
+      std::tie(is_derivable, msg) = found->second;
+      return;
+    }
+  }
+
   DerivedParams dp(hp, gg, "uninitialised");
-  auto          tup = dp.set_fragile();
-  is_derivable      = std::get<0>(tup);
-  msg               = std::get<1>(tup);
+  auto          tup           = dp.set_fragile();
+  std::tie(is_derivable, msg) = tup;
+
+  std::lock_guard<std::mutex> lock(memo.mutt);
+  if (memo.results.size() >= max_memoized)
+  {
+    memo.results.clear();
+  }
+  memo.results.emplace(key, std::move(tup));
 }
 
 bool is_dvble(const HyPas& hp, const Geometry& gg)
@@ -219,6 +355,16 @@ std::tuple<bool, std::string> DerivedParams::set_fragile()
     }
   }
 
+  // the partial sums of split-k, after the copies of A and B, aligned for TFLOAT_ACC
+  size_t ice = ptr_hp->sus[Mat::E::C].vs[NonChi::E::ICE];
+  if (ice != 1 && ptr_hp->sus[Mat::E::C].vs[NonChi::E::RED] == Binary::E::YES)
+  {
+    size_t acc_per_ab  = ptr_gg->derived.float_size_bits_acc / ptr_gg->derived.float_size_bits_ab;
+    red_global_offset  = acc_per_ab * ((required_workspace + acc_per_ab - 1) / acc_per_ab);
+    red_partial_stride = ptr_gg->ldX[Mat::E::C] * ptr_gg->get_uncoal(Mat::E::C);
+    required_workspace = red_global_offset + acc_per_ab * ice * red_partial_stride;
+  }
+
   // check -1 : enough workspace memory
   if (ptr_gg->wSpaceSize < required_workspace)
   {
@@ -303,6 +449,35 @@ std::tuple<bool, std::string> DerivedParams::set_fragile()
 
   main_split_on_k      = ptr_hp->sus[Mat::E::C].vs[NonChi::E::ICE] == 1 ? 0 : 1;
   main_does_beta_c_inc = main_split_on_k == 1 ? 0 : 1;
+  main_writes_partials = main_split_on_k == 1 ? ptr_hp->sus[Mat::E::C].vs[NonChi::E::RED] : 0;
+
+  // stream-K : fewer persistent work groups than units of work
+  main_n_work_units = ice * adps.n_groups * bdps.n_groups;
+  size_t stk        = ptr_hp->sus[Mat::E::C].vs[NonChi::E::STK];
+  if (stk != 0 && stk >= main_n_work_units)
+  {
+    set_status_ss << "STK ( " << stk << " ) is not less than the number of work units ( "
+                  << main_n_work_units << " ). ";
+    return std::make_tuple(false, set_status_ss.str());
+  }
+
+  // a triangle of C : only the T (T + 1) / 2 tiles on or to one side of the diagonal of the T x T
+  // tiles, which requires square tiles. Not with split-k or stream-K
+  if (ptr_gg->uplo != Uplo::E::NONE)
+  {
+    if (at(Mat::E::A).macro_tile_length != at(Mat::E::B).macro_tile_length)
+    {
+      set_status_ss << "a triangle of C requires square macro tiles, not "
+                    << at(Mat::E::A).macro_tile_length << " x " << at(Mat::E::B).macro_tile_length
+                    << ". ";
+      return std::make_tuple(false, set_status_ss.str());
+    }
+    if (ice != 1 || stk != 0)
+    {
+      return std::make_tuple(false, "a triangle of C requires ICE = 1 and STK = 0. ");
+    }
+    main_n_work_units = adps.n_groups * (adps.n_groups + 1) / 2;
+  }
 
   if (ptr_hp->sus[Mat::E::C].vs[NonChi::E::GAL] == 3)
   {
@@ -488,27 +663,38 @@ DerivedParams::DerivedParams(const HyPas& hp_, const Geometry& gg_) : ptr_hp(&hp
     fati = "n_work_items_per_c_elm is 1, should not be using atomics";
   }
 
+  // a double2 (floattype 'z') is incremented one double at a time
   else
   {
-    infa = ptr_gg->derived.float_size_bits == 32 ? "uint" : "ulong";
-    fati = ptr_gg->derived.float_size_bits == 32 ? "atomic_cmpxchg" : "atom_cmpxchg";
+    infa = ptr_gg->derived.float_size_bits <= 32 ? "uint" : "ulong";
+    fati = ptr_gg->derived.float_size_bits <= 32 ? "atomic_cmpxchg" : "atom_cmpxchg";
   }
 
   pragma_unroll_string = ptr_hp->sus[Mat::E::C].vs[NonChi::E::PUN] == 1 ? "#pragma unroll\n" : "";
 
   effective_k_varies_string =
     ptr_hp->sus[Mat::E::C].vs[NonChi::E::UFO] == 0 ? "KV__" : "k_plus_offset";
-  t_float = ptr_gg->derived.float_size_bits == 32 ? "float" : "double";
+  t_float        = floattostring::get_float_string(ptr_gg->derived.floattype_c);
+  t_float_ab     = floattostring::get_float_string(ptr_gg->derived.floattype_ab);
+  t_float_acc    = floattostring::get_float_string(ptr_gg->derived.floattype_acc);
+  t_float_scalar = floattostring::get_float_string(ptr_gg->derived.floattype_scalar);
+  t_float_pragma_string =
+    (ptr_gg->derived.floattype_c == 'h' || ptr_gg->derived.floattype_ab == 'h')
+      ? "#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n"
+      : "";
+  t_float_complex_string =
+    ptr_gg->derived.is_complex()
+      ? "#define CMUL(p, q) "
+        "((TFLOAT)((p).x * (q).x - (p).y * (q).y, (p).x * (q).y + (p).y * (q).x))\n"
+      : "";
 
   k_effective_mod_G_UNROLL = effective_k_varies_string + " % G_UNROLL";
   k_effective_div_G_UNROLL = effective_k_varies_string + " / G_UNROLL";
   k_effective_div_UNROLL   = effective_k_varies_string + " / UNROLL";
 
-  main_n_work_groups = ptr_hp->sus[Mat::E::C].vs[NonChi::E::ICE] *
-                       ((ptr_gg->m / at(Mat::E::A).macro_tile_length) +
-                        (ptr_gg->m % at(Mat::E::A).macro_tile_length != 0)) *
-                       ((ptr_gg->n / at(Mat::E::B).macro_tile_length) +
-                        (ptr_gg->n % at(Mat::E::B).macro_tile_length != 0));
+  main_n_work_groups = ptr_hp->sus[Mat::E::C].vs[NonChi::E::STK] == 0
+                         ? main_n_work_units
+                         : ptr_hp->sus[Mat::E::C].vs[NonChi::E::STK];
 
   main_global_work_size = main_n_work_groups * main_n_work_items_per_workgroup;
 
@@ -551,6 +737,9 @@ void DerivedParams::set_should_be_hyperparams()
   betac_local_work_size = 256;
   betac_work_per_thread = 2;
 
+  red_local_work_size = 256;
+  red_work_per_thread = 2;
+
   for (auto emat_x : {Mat::E::A, Mat::E::B})
   {
 
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <miopengemm/architests.hpp>
+#include <miopengemm/derivedparams.hpp>
+#include <miopengemm/devicemodel.hpp>
+
+namespace MIOpenGEMM
+{
+namespace devicemodel
+{
+
+namespace
+{
+Descriptor get_builtin(const std::string& identifier, size_t n_compute_units, size_t clock_mhz)
+{
+  Descriptor desc;
+  desc.identifier          = identifier;
+  desc.family              = get_family(identifier);
+  desc.n_compute_units     = n_compute_units;
+  desc.local_mem_size      = 65536;
+  desc.max_work_group_size = 256;
+  desc.clock_mhz           = clock_mhz;
+  desc.wg_atom_size        = 64;
+  return desc;
+}
+
+const std::map<std::string, Descriptor>& get_builtins()
+{
+  static const std::map<std::string, Descriptor> builtins = {
+    {"gfx803", get_builtin("gfx803", 64, 1050)},
+    {"gfx900", get_builtin("gfx900", 64, 1500)},
+    {"gfx906", get_builtin("gfx906", 60, 1800)},
+    {"gfx908", get_builtin("gfx908", 120, 1502)}};
+  return builtins;
+}
+
+class Registry
+{
+  public:
+  std::map<std::string, Descriptor>                     registered;
+  std::map<std::pair<std::string, std::string>, double> distances;
+  std::mutex                                            mutt;
+};
+
+Registry& get_registry()
+{
+  static Registry registry;
+  return registry;
+}
+
+// min(1, |log2(a / b)|), 0.5 if either is unknown
+double get_property_distance(size_t a, size_t b)
+{
+  if (a == 0 || b == 0)
+  {
+    return 0.5;
+  }
+  return std::min(1., std::abs(std::log2(static_cast<double>(a) / static_cast<double>(b))));
+}
+}
+
+std::string get_family(const std::string& identifier)
+{
+  // gfx + major version + 2 characters (minor version, stepping)
+  if (identifier.size() > 5 && identifier.substr(0, 3) == "gfx" &&
+      std::isdigit(static_cast<unsigned char>(identifier[3])))
+  {
+    return identifier.substr(0, identifier.size() - 2);
+  }
+  return identifier;
+}
+
+Descriptor::Descriptor(const oclutil::DevInfo& devinfo)
+  : identifier(devinfo.identifier),
+    family(get_family(devinfo.identifier)),
+    n_compute_units(devinfo.device_max_compute_units),
+    local_mem_size(devinfo.device_local_mem_size),
+    max_work_group_size(devinfo.device_max_work_group_size),
+    clock_mhz(devinfo.device_max_clock_frequency),
+    wg_atom_size(devinfo.wg_atom_size)
+{
+  auto builtin = get_builtins().find(identifier);
+  if (builtin != get_builtins().end())
+  {
+    auto& bi = builtin->second;
+    for (auto& x : {std::make_pair(&n_compute_units, bi.n_compute_units),
+                    std::make_pair(&local_mem_size, bi.local_mem_size),
+                    std::make_pair(&max_work_group_size, bi.max_work_group_size),
+                    std::make_pair(&clock_mhz, bi.clock_mhz),
+                    std::make_pair(&wg_atom_size, bi.wg_atom_size)})
+    {
+      *x.first = *x.first == 0 ? x.second : *x.first;
+    }
+  }
+}
+
+bool Descriptor::is_complete() const
+{
+  return n_compute_units > 0 && local_mem_size > 0 && max_work_group_size > 0 && clock_mhz > 0 &&
+         wg_atom_size > 0;
+}
+
+std::string Descriptor::get_string() const
+{
+  std::stringstream ss;
+  ss << identifier << " (" << family << ") CUs " << n_compute_units << ", LDS "
+     << local_mem_size << ", max work group " << max_work_group_size << ", clock "
+     << clock_mhz << ", wg_atom_size " << wg_atom_size;
+  return ss.str();
+}
+
+Descriptor get_descriptor(const std::string& identifier)
+{
+  auto&                       registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutt);
+  auto                        registered = registry.registered.find(identifier);
+  if (registered != registry.registered.end())
+  {
+    return registered->second;
+  }
+
+  auto builtin = get_builtins().find(identifier);
+  if (builtin != get_builtins().end())
+  {
+    return builtin->second;
+  }
+
+  Descriptor desc;
+  desc.identifier = identifier;
+  desc.family     = get_family(identifier);
+  return desc;
+}
+
+void register_device(const oclutil::DevInfo& devinfo)
+{
+  Descriptor desc(devinfo);
+  auto&      registry = get_registry();
+
+  std::lock_guard<std::mutex> lock(registry.mutt);
+  auto                        registered = registry.registered.find(desc.identifier);
+  if (registered != registry.registered.end() &&
+      (!desc.is_complete() || registered->second.get_string() == desc.get_string()))
+  {
+    return;
+  }
+  if (!desc.is_complete() && get_builtins().count(desc.identifier) != 0)
+  {
+    return;
+  }
+  registry.registered[desc.identifier] = desc;
+  registry.distances.clear();
+}
+
+double get_distance(const Descriptor& d1, const Descriptor& d2)
+{
+  if (d1.identifier == d2.identifier)
+  {
+    return 0;
+  }
+
+  double properties = 0;
+  properties += get_property_distance(d1.n_compute_units, d2.n_compute_units);
+  properties += get_property_distance(d1.local_mem_size, d2.local_mem_size);
+  properties += get_property_distance(d1.max_work_group_size, d2.max_work_group_size);
+  properties += get_property_distance(d1.clock_mhz, d2.clock_mhz);
+  properties += get_property_distance(d1.wg_atom_size, d2.wg_atom_size);
+
+  double distance = 0.5 * (d1.family != d2.family) + 0.5 * properties / 5.;
+  return std::max(distance, 1e-6);
+}
+
+double get_distance(const std::string& identifier1, const std::string& identifier2)
+{
+  if (identifier1 == identifier2)
+  {
+    return 0;
+  }
+
+  auto key = std::make_pair(identifier1, identifier2);
+  {
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutt);
+    auto                        found = registry.distances.find(key);
+    if (found != registry.distances.end())
+    {
+      return found->second;
+    }
+  }
+
+  double distance = get_distance(get_descriptor(identifier1), get_descriptor(identifier2));
+
+  auto&                       registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutt);
+  registry.distances[key] = distance;
+  return distance;
+}
+
+bool can_run(const Descriptor& desc, const HyPas& hp, const Geometry& gg)
+{
+  if (desc.max_work_group_size == 0 || desc.local_mem_size == 0)
+  {
+    return true;
+  }
+  oclutil::DevInfo devinfo(desc.identifier, desc.identifier, desc.wg_atom_size);
+  devinfo.device_max_work_group_size = desc.max_work_group_size;
+  devinfo.device_local_mem_size      = desc.local_mem_size;
+  return architests::Stat(devinfo, DerivedParams(hp, gg), gg, hp).is_good;
+}
+}
+}
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <numeric>
@@ -32,10 +33,27 @@ const double& get_default_beta()
   return default_beta;
 }
 
-MFType::MFType(double v) : v_d(v), v_f(static_cast<float>(v)) {}
+// integers are 16 v rounded, so that the defaults are not 0. Complex values are real.
+MFType::MFType(double v)
+  : v_d(v),
+    v_f(static_cast<float>(v)),
+    v_h(v),
+    v_i(static_cast<int32_t>(std::round(16 * v))),
+    v_c(static_cast<float>(v)),
+    v_z(v)
+{
+}
 const void* MFType::operator[](char floattype) const
 {
-  return floattype == 'd' ? static_cast<const void*>(&v_d) : static_cast<const void*>(&v_f);
+  switch (floattype)
+  {
+  case 'd': return static_cast<const void*>(&v_d);
+  case 'h': return static_cast<const void*>(&v_h);
+  case 'i': return static_cast<const void*>(&v_i);
+  case 'c': return static_cast<const void*>(&v_c);
+  case 'z': return static_cast<const void*>(&v_z);
+  default: return static_cast<const void*>(&v_f);
+  }
 }
 
 const MFType& get_m_alpha()
@@ -136,10 +154,12 @@ namespace KType
 std::vector<std::string> get_name()
 {
   std::vector<std::string> X(E::N, unfilled<std::string>());
-  X[E::WSA]   = "WSA";
-  X[E::WSB]   = "WSB";
-  X[E::BETAC] = "BETAC";
-  X[E::MAIN]  = "MAIN";
+  X[E::WSA]    = "WSA";
+  X[E::WSB]    = "WSB";
+  X[E::BETAC]  = "BETAC";
+  X[E::MAIN]   = "MAIN";
+  X[E::REDUCE] = "REDUCE";
+  X[E::ADD]    = "ADD";
   return X;
 }
 
@@ -168,6 +188,24 @@ const EnumMapper<std::string>& M()
 }
 }
 
+namespace BestTest
+{
+std::vector<std::string> get_name()
+{
+  std::vector<std::string> X(E::N, unfilled<std::string>());
+  X[E::RATIO]    = "RATIO";
+  X[E::WELCH]    = "WELCH";
+  X[E::DISJOINT] = "DISJOINT";
+  return X;
+}
+
+const EnumMapper<std::string>& M()
+{
+  static const EnumMapper<std::string> em = get_enum_mapper<std::string>(get_name(), "BestTest");
+  return em;
+}
+}
+
 namespace Xtr
 {
 std::vector<std::string> get_name()
@@ -202,6 +240,75 @@ const EnumMapper<std::string>& M()
 }
 }
 
+namespace Bias
+{
+std::vector<std::string> get_name()
+{
+  std::vector<std::string> X(E::N, unfilled<std::string>());
+  X[E::NONE] = "NONE";
+  X[E::ROW]  = "ROW";
+  X[E::COL]  = "COL";
+  return X;
+}
+const EnumMapper<std::string>& M()
+{
+  static const EnumMapper<std::string> em = get_enum_mapper<std::string>(get_name(), "Bias");
+  return em;
+}
+}
+
+namespace Activation
+{
+std::vector<std::string> get_name()
+{
+  std::vector<std::string> X(E::N, unfilled<std::string>());
+  X[E::NONE] = "NONE";
+  X[E::RELU] = "RELU";
+  X[E::GELU] = "GELU";
+  return X;
+}
+const EnumMapper<std::string>& M()
+{
+  static const EnumMapper<std::string> em =
+    get_enum_mapper<std::string>(get_name(), "Activation");
+  return em;
+}
+}
+
+namespace Conversion
+{
+std::vector<std::string> get_name()
+{
+  std::vector<std::string> X(E::N, unfilled<std::string>());
+  X[E::DEFAULT]  = "DEFAULT";
+  X[E::SATURATE] = "SATURATE";
+  return X;
+}
+const EnumMapper<std::string>& M()
+{
+  static const EnumMapper<std::string> em =
+    get_enum_mapper<std::string>(get_name(), "Conversion");
+  return em;
+}
+}
+
+namespace Uplo
+{
+std::vector<std::string> get_name()
+{
+  std::vector<std::string> X(E::N, unfilled<std::string>());
+  X[E::NONE]  = "NONE";
+  X[E::LOWER] = "LOWER";
+  X[E::UPPER] = "UPPER";
+  return X;
+}
+const EnumMapper<std::string>& M()
+{
+  static const EnumMapper<std::string> em = get_enum_mapper<std::string>(get_name(), "Uplo");
+  return em;
+}
+}
+
 std::vector<int> get_priority_confirmed(std::vector<int> X, size_t target_size)
 {
   if (X.size() != target_size)
@@ -326,6 +433,8 @@ std::vector<std::string> get_name()
   X[E::MAD] = "MAD";
   X[E::AFI] = "AFI";
   X[E::MIA] = "MIA";
+  X[E::RED] = "RED";
+  X[E::STK] = "STK";
   return X;
 }
 
@@ -345,6 +454,8 @@ std::vector<int> get_priority_basic()
   X[E::AFI] = -1;
   X[E::MIA] = -1;
   X[E::SZT] = -1;
+  X[E::RED] = 0;
+  X[E::STK] = 0;
   return X;
 }
 
@@ -468,10 +579,12 @@ std::array<std::vector<size_t>, E::N> get_dependencies_basic()
   {
     kdps[i] = uninitialised_vector;
   }
-  kdps[E::WSA]   = {};
-  kdps[E::WSB]   = {};
-  kdps[E::BETAC] = {};
-  kdps[E::MAIN]  = {E::BETAC, E::WSA, E::WSB};
+  kdps[E::WSA]    = {};
+  kdps[E::WSB]    = {};
+  kdps[E::BETAC]  = {};
+  kdps[E::MAIN]   = {E::BETAC, E::WSA, E::WSB};
+  kdps[E::REDUCE] = {E::MAIN};
+  kdps[E::ADD]    = {};
 
   for (auto& x : kdps)
   {
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <sstream>
+#include <miopengemm/derivedparams.hpp>
+#include <miopengemm/epilogue.hpp>
+#include <miopengemm/error.hpp>
+#include <miopengemm/geometry.hpp>
+
+namespace MIOpenGEMM
+{
+
+Epilogue::Epilogue(Bias::E bias_, Activation::E activation_, Conversion::E conversion_)
+  : bias(bias_), activation(activation_), conversion(conversion_)
+{
+  if (bias >= Bias::E::N || activation >= Activation::E::N || conversion >= Conversion::E::N)
+  {
+    throw miog_error("invalid Epilogue : unrecognised bias, activation or conversion");
+  }
+}
+
+bool Epilogue::is_identity() const
+{
+  return bias == Bias::E::NONE && activation == Activation::E::NONE &&
+         conversion == Conversion::E::DEFAULT;
+}
+
+std::string Epilogue::get_string() const
+{
+  if (is_identity())
+  {
+    return "";
+  }
+  std::stringstream ss;
+  ss << "BIAS" << Bias::M().name[bias] << "_ACT" << Activation::M().name[activation] << "_CNV"
+     << Conversion::M().name[conversion];
+  return ss.str();
+}
+
+bool Epilogue::operator==(const Epilogue& rhs) const
+{
+  return bias == rhs.bias && activation == rhs.activation && conversion == rhs.conversion;
+}
+
+void confirm_epilogue(const Epilogue& epilogue, const Geometry& gg, const DerivedParams& dp)
+{
+  if (epilogue.is_identity())
+  {
+    return;
+  }
+
+  std::stringstream errm;
+  if (dp.main_split_on_k != 0)
+  {
+    errm << "the epilogue needs the final value of C in the main kernel, so ICE must be 1. ";
+  }
+  if (gg.derived.is_complex() || gg.derived.is_requantised())
+  {
+    errm << "the epilogue is not supported for floattype " << gg.floattype << ". ";
+  }
+  if (epilogue.activation == Activation::E::GELU && gg.derived.floattype_c == 'i')
+  {
+    errm << "GELU needs a floating point C, not int32. ";
+  }
+  if (errm.str() != "")
+  {
+    throw miog_error("Epilogue " + epilogue.get_string() + " : " + errm.str());
+  }
+}
+}
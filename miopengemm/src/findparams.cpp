@@ -113,7 +113,8 @@ std::string FindParams::get_string() const
 {
   std::stringstream ss;
   ss << "(OUTER)   " << hl_outer.get_string() << "(INNER)   " << hl_core.get_string()
-     << "(SUMSTAT) " << get_sumstatkey(sumstat);
+     << "(SUMSTAT) " << get_sumstatkey(sumstat) << "(WARM STARTS) " << n_warm_starts
+     << "(BESTTEST) " << BestTest::M().name[besttest] << "(REMEASURE) " << remeasure_period;
   return ss.str();
 }
 
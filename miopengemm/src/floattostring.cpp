@@ -22,6 +22,12 @@ std::string float_string_type(float x)
   return "float";
 }
 
+std::string float_string_type(half x)
+{
+  (void)x;
+  return "half";
+}
+
 char float_char_type(double x)
 {
   (void)x;
@@ -34,12 +40,38 @@ char float_char_type(float x)
   return 'f';
 }
 
+char float_char_type(half x)
+{
+  (void)x;
+  return 'h';
+}
+
 std::string get_float_string(char floattype)
 {
-  if (floattype == 'f')
+  if (floattype == 'h')
+  {
+    return "half";
+  }
+  else if (floattype == 'f')
   {
     return "float";
   }
+  else if (floattype == 'c')
+  {
+    return "float2";
+  }
+  else if (floattype == 'z')
+  {
+    return "double2";
+  }
+  else if (floattype == 'b')
+  {
+    return "char";
+  }
+  else if (floattype == 'i')
+  {
+    return "int";
+  }
   else
   {
     return "double";
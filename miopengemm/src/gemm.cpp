@@ -9,39 +9,48 @@
 #include <miopengemm/miogemm.hpp>
 #include <miopengemm/programcacher.hpp>
 #include <miopengemm/programs.hpp>
+#include <miopengemm/strassen.hpp>
 #include <miopengemm/timer.hpp>
 #include <miopengemm/tinyzero.hpp>
 
 namespace MIOpenGEMM
 {
 
+namespace
+{
+// the xgemm variants, with an epilogue, products with one A or a triangle of C
 // TODO : alpha = 0 optimisation. beta = 0 optimisation.
 template <typename T>
-GemmStatus xgemm(bool              isColMajor,
-                 bool              tA,
-                 bool              tB,
-                 size_t            m,
-                 size_t            n,
-                 size_t            k,
-                 T                 alpha,
-                 cl_mem            a,
-                 size_t            a_offset,
-                 size_t            lda,
-                 cl_mem            b,
-                 size_t            b_offset,
-                 size_t            ldb,
-                 T                 beta,
-                 cl_mem            c,
-                 size_t            c_offset,
-                 size_t            ldc,
-                 cl_mem            w,
-                 size_t            w_offset,
-                 size_t            w_size,
-                 cl_command_queue* ptr_queue,
-                 cl_uint           num_events_in_wait_list,
-                 const cl_event*   event_wait_list,
-                 cl_event*         ptr_event_user,
-                 int               ID)
+GemmStatus xgemm_fused(bool              isColMajor,
+                       bool              tA,
+                       bool              tB,
+                       size_t            m,
+                       size_t            n,
+                       size_t            k,
+                       T                 alpha,
+                       cl_mem            a,
+                       size_t            a_offset,
+                       size_t            lda,
+                       cl_mem            b,
+                       size_t            b_offset,
+                       size_t            ldb,
+                       T                 beta,
+                       cl_mem            c,
+                       size_t            c_offset,
+                       size_t            ldc,
+                       cl_mem            w,
+                       size_t            w_offset,
+                       size_t            w_size,
+                       const Epilogue&   epilogue,
+                       cl_mem            bias,
+                       size_t            bias_offset,
+                       const MultiGemm&  multigemm,
+                       Uplo::E           uplo,
+                       cl_command_queue* ptr_queue,
+                       cl_uint           num_events_in_wait_list,
+                       const cl_event*   event_wait_list,
+                       cl_event*         ptr_event_user,
+                       int               ID)
 {
 
   if (ID < 0)
@@ -62,7 +71,10 @@ GemmStatus xgemm(bool              isColMajor,
                              w_size,
                              beta_type,
                              get_floattype_char<T>(),
-                             ptr_queue);
+                             ptr_queue,
+                             epilogue,
+                             multigemm,
+                             uplo);
   }
 
   const Programs& programs = get_cacher().program_cache[ID];
@@ -85,7 +97,8 @@ GemmStatus xgemm(bool              isColMajor,
   {
     auto& program = programs.programs[index];
     all_kern_args.emplace_back(
-      kerngen::get_arg_sizes_values(program.kblob, gpu_mems, offsets, sizeof(T), &alpha, &beta));
+      kerngen::get_arg_sizes_values(
+        program.kblob, gpu_mems, offsets, sizeof(T), &alpha, &beta, &bias, &bias_offset));
   }
 
   KernelTimes* ktimes     = nullptr;
@@ -100,6 +113,216 @@ GemmStatus xgemm(bool              isColMajor,
 
   return {true, ID};
 }
+}
+
+template <typename T>
+GemmStatus xgemm(bool              isColMajor,
+                 bool              tA,
+                 bool              tB,
+                 size_t            m,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 cl_mem            b,
+                 size_t            b_offset,
+                 size_t            ldb,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 const Epilogue&   epilogue,
+                 cl_mem            bias,
+                 size_t            bias_offset,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event_user,
+                 int               ID)
+{
+  return xgemm_fused<T>(isColMajor,
+                        tA,
+                        tB,
+                        m,
+                        n,
+                        k,
+                        alpha,
+                        a,
+                        a_offset,
+                        lda,
+                        b,
+                        b_offset,
+                        ldb,
+                        beta,
+                        c,
+                        c_offset,
+                        ldc,
+                        w,
+                        w_offset,
+                        w_size,
+                        epilogue,
+                        bias,
+                        bias_offset,
+                        MultiGemm(),
+                        Uplo::E::NONE,
+                        ptr_queue,
+                        num_events_in_wait_list,
+                        event_wait_list,
+                        ptr_event_user,
+                        ID);
+}
+
+template GemmStatus xgemm<float>(bool,
+                                 bool,
+                                 bool,
+                                 size_t,
+                                 size_t,
+                                 size_t,
+                                 float,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 float,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 const Epilogue&,
+                                 cl_mem,
+                                 size_t,
+                                 cl_command_queue*,
+                                 cl_uint,
+                                 const cl_event*,
+                                 cl_event*,
+                                 int ID);
+
+template GemmStatus xgemm<half>(bool,
+                                bool,
+                                bool,
+                                size_t,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                const Epilogue&,
+                                cl_mem,
+                                size_t,
+                                cl_command_queue*,
+                                cl_uint,
+                                const cl_event*,
+                                cl_event*,
+                                int ID);
+
+template GemmStatus xgemm<double>(bool,
+                                  bool,
+                                  bool,
+                                  size_t,
+                                  size_t,
+                                  size_t,
+                                  double,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  double,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  const Epilogue&,
+                                  cl_mem,
+                                  size_t,
+                                  cl_command_queue*,
+                                  cl_uint,
+                                  const cl_event*,
+                                  cl_event*,
+                                  int ID);
+
+template <typename T>
+GemmStatus xgemm(bool              isColMajor,
+                 bool              tA,
+                 bool              tB,
+                 size_t            m,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 cl_mem            b,
+                 size_t            b_offset,
+                 size_t            ldb,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 const MultiGemm&  multigemm,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event_user,
+                 int               ID)
+{
+  return xgemm_fused<T>(isColMajor,
+                        tA,
+                        tB,
+                        m,
+                        n,
+                        k,
+                        alpha,
+                        a,
+                        a_offset,
+                        lda,
+                        b,
+                        b_offset,
+                        ldb,
+                        beta,
+                        c,
+                        c_offset,
+                        ldc,
+                        w,
+                        w_offset,
+                        w_size,
+                        Epilogue(),
+                        nullptr,
+                        0,
+                        multigemm,
+                        Uplo::E::NONE,
+                        ptr_queue,
+                        num_events_in_wait_list,
+                        event_wait_list,
+                        ptr_event_user,
+                        ID);
+}
 
 template GemmStatus xgemm<float>(bool,
                                  bool,
@@ -121,12 +344,40 @@ template GemmStatus xgemm<float>(bool,
                                  cl_mem,
                                  size_t,
                                  size_t,
+                                 const MultiGemm&,
                                  cl_command_queue*,
                                  cl_uint,
                                  const cl_event*,
                                  cl_event*,
                                  int ID);
 
+template GemmStatus xgemm<half>(bool,
+                                bool,
+                                bool,
+                                size_t,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                const MultiGemm&,
+                                cl_command_queue*,
+                                cl_uint,
+                                const cl_event*,
+                                cl_event*,
+                                int ID);
+
 template GemmStatus xgemm<double>(bool,
                                   bool,
                                   bool,
@@ -147,6 +398,413 @@ template GemmStatus xgemm<double>(bool,
                                   cl_mem,
                                   size_t,
                                   size_t,
+                                  const MultiGemm&,
+                                  cl_command_queue*,
+                                  cl_uint,
+                                  const cl_event*,
+                                  cl_event*,
+                                  int ID);
+
+template <typename T>
+GemmStatus xgemm(bool              isColMajor,
+                 bool              tA,
+                 bool              tB,
+                 size_t            m,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 cl_mem            b,
+                 size_t            b_offset,
+                 size_t            ldb,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event_user,
+                 int               ID)
+{
+  return xgemm<T>(isColMajor,
+                  tA,
+                  tB,
+                  m,
+                  n,
+                  k,
+                  alpha,
+                  a,
+                  a_offset,
+                  lda,
+                  b,
+                  b_offset,
+                  ldb,
+                  beta,
+                  c,
+                  c_offset,
+                  ldc,
+                  w,
+                  w_offset,
+                  w_size,
+                  Epilogue(),
+                  nullptr,
+                  0,
+                  ptr_queue,
+                  num_events_in_wait_list,
+                  event_wait_list,
+                  ptr_event_user,
+                  ID);
+}
+
+template GemmStatus xgemm<float>(bool,
+                                 bool,
+                                 bool,
+                                 size_t,
+                                 size_t,
+                                 size_t,
+                                 float,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 float,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_command_queue*,
+                                 cl_uint,
+                                 const cl_event*,
+                                 cl_event*,
+                                 int ID);
+
+template GemmStatus xgemm<half>(bool,
+                                bool,
+                                bool,
+                                size_t,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_command_queue*,
+                                cl_uint,
+                                const cl_event*,
+                                cl_event*,
+                                int ID);
+
+template GemmStatus xgemm<double>(bool,
+                                  bool,
+                                  bool,
+                                  size_t,
+                                  size_t,
+                                  size_t,
+                                  double,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  double,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  cl_command_queue*,
+                                  cl_uint,
+                                  const cl_event*,
+                                  cl_event*,
+                                  int ID);
+
+template <typename T>
+GemmStatus xgemm_strassen(bool              isColMajor,
+                          bool              tA,
+                          bool              tB,
+                          size_t            m,
+                          size_t            n,
+                          size_t            k,
+                          T                 alpha,
+                          cl_mem            a,
+                          size_t            a_offset,
+                          size_t            lda,
+                          cl_mem            b,
+                          size_t            b_offset,
+                          size_t            ldb,
+                          T                 beta,
+                          cl_mem            c,
+                          size_t            c_offset,
+                          size_t            ldc,
+                          cl_mem            w,
+                          size_t            w_offset,
+                          size_t            w_size,
+                          size_t            max_levels,
+                          cl_command_queue* ptr_queue,
+                          cl_uint           num_events_in_wait_list,
+                          const cl_event*   event_wait_list,
+                          cl_event*         ptr_event_user)
+{
+  Geometry gg(
+    isColMajor, tA, tB, false, lda, ldb, ldc, m, n, k, w_size, get_floattype_char<T>());
+
+  // fewer levels if the workspace is too small for them
+  size_t levels = strassen::get_levels(gg, max_levels);
+  while (levels > 0 && strassen::get_workspace_size(gg, levels) > w_size)
+  {
+    --levels;
+  }
+
+  if (levels == 0)
+  {
+    return xgemm<T>(isColMajor,
+                    tA,
+                    tB,
+                    m,
+                    n,
+                    k,
+                    alpha,
+                    a,
+                    a_offset,
+                    lda,
+                    b,
+                    b_offset,
+                    ldb,
+                    beta,
+                    c,
+                    c_offset,
+                    ldc,
+                    w,
+                    w_offset,
+                    w_size,
+                    ptr_queue,
+                    num_events_in_wait_list,
+                    event_wait_list,
+                    ptr_event_user,
+                    -1);
+  }
+
+  std::array<cl_mem, Mem::E::N> gpu_mems;
+  std::array<size_t, Mem::E::N> offsets;
+
+  gpu_mems[Mem::E::A] = a;
+  gpu_mems[Mem::E::B] = b;
+  gpu_mems[Mem::E::C] = c;
+  gpu_mems[Mem::E::W] = w;
+
+  offsets[Mem::E::A] = a_offset;
+  offsets[Mem::E::B] = b_offset;
+  offsets[Mem::E::C] = c_offset;
+  offsets[Mem::E::W] = w_offset;
+
+  strassen::run<T>(strassen::get_plan(gg, levels),
+                   alpha,
+                   beta,
+                   gpu_mems,
+                   offsets,
+                   ptr_queue,
+                   num_events_in_wait_list,
+                   event_wait_list,
+                   ptr_event_user);
+
+  return {true, -1};
+}
+
+template GemmStatus xgemm_strassen<float>(bool,
+                                          bool,
+                                          bool,
+                                          size_t,
+                                          size_t,
+                                          size_t,
+                                          float,
+                                          cl_mem,
+                                          size_t,
+                                          size_t,
+                                          cl_mem,
+                                          size_t,
+                                          size_t,
+                                          float,
+                                          cl_mem,
+                                          size_t,
+                                          size_t,
+                                          cl_mem,
+                                          size_t,
+                                          size_t,
+                                          size_t,
+                                          cl_command_queue*,
+                                          cl_uint,
+                                          const cl_event*,
+                                          cl_event*);
+
+template GemmStatus xgemm_strassen<double>(bool,
+                                           bool,
+                                           bool,
+                                           size_t,
+                                           size_t,
+                                           size_t,
+                                           double,
+                                           cl_mem,
+                                           size_t,
+                                           size_t,
+                                           cl_mem,
+                                           size_t,
+                                           size_t,
+                                           double,
+                                           cl_mem,
+                                           size_t,
+                                           size_t,
+                                           cl_mem,
+                                           size_t,
+                                           size_t,
+                                           size_t,
+                                           cl_command_queue*,
+                                           cl_uint,
+                                           const cl_event*,
+                                           cl_event*);
+
+template <typename T>
+GemmStatus xsyrk(bool              isColMajor,
+                 Uplo::E           uplo,
+                 bool              tA,
+                 size_t            n,
+                 size_t            k,
+                 T                 alpha,
+                 cl_mem            a,
+                 size_t            a_offset,
+                 size_t            lda,
+                 T                 beta,
+                 cl_mem            c,
+                 size_t            c_offset,
+                 size_t            ldc,
+                 cl_mem            w,
+                 size_t            w_offset,
+                 size_t            w_size,
+                 cl_command_queue* ptr_queue,
+                 cl_uint           num_events_in_wait_list,
+                 const cl_event*   event_wait_list,
+                 cl_event*         ptr_event_user,
+                 int               ID)
+{
+  if (uplo == Uplo::E::NONE)
+  {
+    throw miog_error("xsyrk requires a triangle of C, Uplo::E::LOWER or Uplo::E::UPPER");
+  }
+
+  // op(B) = op(A)^T
+  return xgemm_fused<T>(isColMajor,
+                        tA,
+                        !tA,
+                        n,
+                        n,
+                        k,
+                        alpha,
+                        a,
+                        a_offset,
+                        lda,
+                        a,
+                        a_offset,
+                        lda,
+                        beta,
+                        c,
+                        c_offset,
+                        ldc,
+                        w,
+                        w_offset,
+                        w_size,
+                        Epilogue(),
+                        nullptr,
+                        0,
+                        MultiGemm(),
+                        uplo,
+                        ptr_queue,
+                        num_events_in_wait_list,
+                        event_wait_list,
+                        ptr_event_user,
+                        ID);
+}
+
+template GemmStatus xsyrk<float>(bool,
+                                 Uplo::E,
+                                 bool,
+                                 size_t,
+                                 size_t,
+                                 float,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 float,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_mem,
+                                 size_t,
+                                 size_t,
+                                 cl_command_queue*,
+                                 cl_uint,
+                                 const cl_event*,
+                                 cl_event*,
+                                 int ID);
+
+template GemmStatus xsyrk<half>(bool,
+                                Uplo::E,
+                                bool,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_command_queue*,
+                                cl_uint,
+                                const cl_event*,
+                                cl_event*,
+                                int ID);
+
+template GemmStatus xsyrk<double>(bool,
+                                  Uplo::E,
+                                  bool,
+                                  size_t,
+                                  size_t,
+                                  double,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  double,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
+                                  cl_mem,
+                                  size_t,
+                                  size_t,
                                   cl_command_queue*,
                                   cl_uint,
                                   const cl_event*,
@@ -226,6 +884,28 @@ template GemmStatus gemm0<float>(bool,
                                  const cl_event*,
                                  cl_event*);
 
+template GemmStatus gemm0<half>(bool,
+                                bool,
+                                bool,
+                                size_t,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                half,
+                                cl_mem,
+                                size_t,
+                                size_t,
+                                cl_command_queue*,
+                                cl_uint,
+                                const cl_event*,
+                                cl_event*);
+
 template GemmStatus gemm0<double>(bool,
                                   bool,
                                   bool,
@@ -1,6 +1,7 @@
 /*******************************************************************************
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -26,6 +27,24 @@ char get_floattype_char<double>()
   return 'd';
 }
 
+template <>
+char get_floattype_char<half>()
+{
+  return 'h';
+}
+
+template <>
+char get_floattype_char<std::complex<float>>()
+{
+  return 'c';
+}
+
+template <>
+char get_floattype_char<std::complex<double>>()
+{
+  return 'z';
+}
+
 Geometry::Geometry(
   size_t m_, size_t n_, size_t k_, bool tA_, bool tB_, size_t wSpaceSize_, char floattype_)
   : Geometry(
@@ -41,7 +60,7 @@ size_t get_mat_size(const Geometry& gg, const Offsets& toff, Mat::E emat)
 
 size_t get_mat_memsize(const Geometry& gg, const Offsets& toff, Mat::E emat)
 {
-  return gg.derived.float_size_bytes * get_mat_size(gg, toff, emat);
+  return gg.derived.get_float_size_bytes(Mem::mat_to_mem(emat)) * get_mat_size(gg, toff, emat);
 }
 
 Offsets::Offsets(
@@ -65,11 +84,52 @@ Offsets get_zero_offsets() { return Offsets(0, 0, 0, 0, 0, 0, 0, 0); }
 
 Geometry get_tight_geometry() { return {false, false, false, false, 1, 1, 1, 1, 1, 1, 1, 'f'}; }
 
+namespace
+{
+size_t get_size_bytes(char floattype)
+{
+  if (floattype == 'h')
+  {
+    return sizeof(half);
+  }
+  else if (floattype == 'f')
+  {
+    return sizeof(float);
+  }
+  else if (floattype == 'd')
+  {
+    return sizeof(double);
+  }
+  else if (floattype == 'c')
+  {
+    return sizeof(std::complex<float>);
+  }
+  else if (floattype == 'z')
+  {
+    return sizeof(std::complex<double>);
+  }
+  else if (floattype == 'b')
+  {
+    return sizeof(int8_t);
+  }
+  else if (floattype == 'i')
+  {
+    return sizeof(int32_t);
+  }
+  throw miog_error("what is this floattype : " + std::string(1, floattype) +
+                   std::string(" ? in get_size_bytes of geometry"));
+}
+}
+
 char get_floattype(size_t nbits)
 {
 
   char ft = 'x';
-  if (nbits == 8 * sizeof(float))
+  if (nbits == 8 * sizeof(half))
+  {
+    ft = 'h';
+  }
+  else if (nbits == 8 * sizeof(float))
   {
     ft = 'f';
   }
@@ -85,24 +145,98 @@ char get_floattype(size_t nbits)
   return ft;
 }
 
+// from the number of bits of C, of A and B, and of accumulation, and whether complex
+char get_floattype(size_t nbits, size_t nbits_ab, size_t nbits_acc, bool is_complex)
+{
+  if (is_complex)
+  {
+    if (nbits == nbits_ab && nbits == nbits_acc && (nbits == 64 || nbits == 128))
+    {
+      return nbits == 64 ? 'c' : 'z';
+    }
+  }
+  else if (nbits == nbits_ab && nbits == nbits_acc)
+  {
+    return get_floattype(nbits);
+  }
+  else if (nbits == 32 && nbits_ab == 16 && nbits_acc == 32)
+  {
+    return 'm';
+  }
+  else if (nbits == 16 && nbits_ab == 16 && nbits_acc == 32)
+  {
+    return 'n';
+  }
+  else if (nbits == 32 && nbits_ab == 8 && nbits_acc == 32)
+  {
+    return 'i';
+  }
+  else if (nbits == 8 && nbits_ab == 8 && nbits_acc == 32)
+  {
+    return 'q';
+  }
+  throw miog_error("there is no " + std::string(is_complex ? "complex " : "") +
+                   "floattype with C, A and B, and accumulation of bits " + std::to_string(nbits) +
+                   ", " + std::to_string(nbits_ab) + " and " + std::to_string(nbits_acc) +
+                   " (in get_floattype of geometry)");
+}
+
 void GeometryDerived::reset(char floattype)
 {
-  if (floattype == 'f')
+  if (floattype == 'm')
   {
-    float_size_bytes = sizeof(float);
+    floattype_c   = 'f';
+    floattype_ab  = 'h';
+    floattype_acc = 'f';
   }
-  else if (floattype == 'd')
+  else if (floattype == 'n')
+  {
+    floattype_c   = 'h';
+    floattype_ab  = 'h';
+    floattype_acc = 'f';
+  }
+  else if (floattype == 'i')
   {
-    float_size_bytes = sizeof(double);
+    floattype_c   = 'i';
+    floattype_ab  = 'b';
+    floattype_acc = 'i';
+  }
+  else if (floattype == 'q')
+  {
+    floattype_c   = 'b';
+    floattype_ab  = 'b';
+    floattype_acc = 'i';
   }
   else
   {
-    throw miog_error("what is this floattype : " + std::to_string(floattype) +
-                     std::string(" ? in reset of geometry"));
+    floattype_c   = floattype;
+    floattype_ab  = floattype;
+    floattype_acc = floattype;
   }
-  float_size_bits = 8 * float_size_bytes;
+  floattype_scalar = is_requantised() ? 'f' : floattype_c;
+
+  float_size_bytes        = get_size_bytes(floattype_c);
+  float_size_bits         = 8 * float_size_bytes;
+  float_size_bytes_scalar = get_size_bytes(floattype_scalar);
+  float_size_bytes_ab     = get_size_bytes(floattype_ab);
+  float_size_bits_ab      = 8 * float_size_bytes_ab;
+  float_size_bits_acc     = 8 * get_size_bytes(floattype_acc);
+}
+
+size_t GeometryDerived::get_float_size_bytes(Mem::E emem) const
+{
+  return emem == Mem::E::C ? float_size_bytes : float_size_bytes_ab;
+}
+
+bool GeometryDerived::is_mixed() const
+{
+  return floattype_ab != floattype_c || floattype_acc != floattype_c;
 }
 
+bool GeometryDerived::is_requantised() const { return floattype_c == 'b'; }
+
+bool GeometryDerived::is_complex() const { return floattype_c == 'c' || floattype_c == 'z'; }
+
 // return one of the dimensions of matrix a,b,c.
 // isCoal : the coalesced dimesion?
 // For example, for A which is m x k,
@@ -222,24 +356,28 @@ bool Geometry::coal_is_pll_k(Mat::E M) const
          2;
 }
 
-void Geometry::initialise(bool   isColMajor_,
-                          bool   tA_,
-                          bool   tB_,
-                          bool   tC_,
-                          size_t lda_,
-                          size_t ldb_,
-                          size_t ldc_,
-                          size_t m_,
-                          size_t n_,
-                          size_t k_,
-                          size_t wSpaceSize_,
-                          char   floattype_)
+void Geometry::initialise(bool    isColMajor_,
+                          bool    tA_,
+                          bool    tB_,
+                          bool    tC_,
+                          size_t  lda_,
+                          size_t  ldb_,
+                          size_t  ldc_,
+                          size_t  m_,
+                          size_t  n_,
+                          size_t  k_,
+                          size_t  wSpaceSize_,
+                          char    floattype_,
+                          bool    cA_,
+                          bool    cB_,
+                          Uplo::E uplo_)
 {
 
   isColMajor = isColMajor_;
   m          = m_;
   n          = n_;
   k          = k_;
+  uplo       = uplo_;
   wSpaceSize = wSpaceSize_;
   floattype  = floattype_;
 
@@ -253,15 +391,40 @@ void Geometry::initialise(bool   isColMajor_,
   ldX[Mat::E::B] = ldb_;
   ldX[Mat::E::C] = ldc_;
 
-  if (floattype != 'd' and floattype != 'f')
+  cX.resize(Mat::E::N);
+  cX[Mat::E::A] = cA_;
+  cX[Mat::E::B] = cB_;
+  cX[Mat::E::C] = false;
+
+  if (std::string("hfdczmniq").find(floattype) == std::string::npos)
   {
-    throw miog_error("floattype should be one of 'f' and 'd' (in Geometry constructor)");
+    throw miog_error("floattype should be one of 'h', 'f', 'd', 'c', 'z', 'm', 'n', 'i' and 'q' "
+                     "(in Geometry constructor)");
   }
 
   check_ldx_consistent();
 
   derived.reset(floattype);
 
+  if ((cA_ || cB_) && !derived.is_complex())
+  {
+    throw miog_error("only complex floattypes ('c' and 'z') can be conjugated, not " +
+                     std::string(1, floattype) + " (in Geometry constructor)");
+  }
+
+  if (uplo >= Uplo::E::N)
+  {
+    throw miog_error("the triangle of C should be less than " + std::to_string(Uplo::E::N) +
+                     ", not " + std::to_string(uplo) + " (in Geometry constructor)");
+  }
+
+  if (uplo != Uplo::E::NONE && m != n)
+  {
+    throw miog_error("a triangle of C (" + Uplo::M().name[uplo] + ") requires m == n, not m = " +
+                     std::to_string(m) + " and n = " + std::to_string(n) +
+                     " (in Geometry constructor)");
+  }
+
   metric_co[0] = std::log2(static_cast<double>(k));
   metric_co[1] = std::log2(static_cast<double>(m)) - std::log2(static_cast<double>(n));
   metric_co[2] = std::log2(static_cast<double>(m)) + std::log2(static_cast<double>(n));
@@ -320,11 +483,15 @@ Geometry::Geometry(std::string geometry_string)
   std::string goldstandard_geometry_string = goldstandard_geometry.get_string();
   auto        goldstandard_map             = get_key_val_map(goldstandard_geometry_string);
 
+  // only in mixed precision, complex and triangle geometry strings, see get_networkconfig_string
+  std::vector<std::string> optional_keys{"fab", "facc", "cx", "cA", "cB", "up"};
+
   std::stringstream errm_ss;
   bool              good_string{true};
   for (auto& x : key_val_map)
   {
-    if (goldstandard_map.count(x.first) == 0)
+    if (goldstandard_map.count(x.first) == 0 &&
+        std::find(optional_keys.begin(), optional_keys.end(), x.first) == optional_keys.end())
     {
       errm_ss << "The key in the geometry string `" << x.first << "' is not valid.  ";
       good_string = false;
@@ -345,6 +512,11 @@ Geometry::Geometry(std::string geometry_string)
     throw miog_error(errm_ss.str());
   }
 
+  size_t nbits     = safeat(key_val_map, "f");
+  size_t nbits_ab  = key_val_map.count("fab") == 0 ? nbits : key_val_map.at("fab");
+  size_t nbits_acc = key_val_map.count("facc") == 0 ? nbits : key_val_map.at("facc");
+  bool   is_cx     = key_val_map.count("cx") != 0 && key_val_map.at("cx") != 0;
+
   initialise(safeat(key_val_map, "colMaj"),
              safeat(key_val_map, "tA"),
              safeat(key_val_map, "tB"),
@@ -356,7 +528,11 @@ Geometry::Geometry(std::string geometry_string)
              safeat(key_val_map, "n"),
              safeat(key_val_map, "k"),
              safeat(key_val_map, "ws"),
-             get_floattype(safeat(key_val_map, "f")));
+             get_floattype(nbits, nbits_ab, nbits_acc, is_cx),
+             key_val_map.count("cA") != 0 && key_val_map.at("cA") != 0,
+             key_val_map.count("cB") != 0 && key_val_map.at("cB") != 0,
+             key_val_map.count("up") == 0 ? Uplo::E::NONE
+                                          : static_cast<Uplo::E>(key_val_map.at("up")));
 }
 
 std::string Geometry::get_string() const { return get_networkconfig_string(); }
@@ -368,6 +544,25 @@ std::string Geometry::get_networkconfig_string() const
                         << "_colMaj" << isColMajor << "_m" << m << "_n" << n << "_k" << k << "_lda"
                         << ldX[Mat::E::A] << "_ldb" << ldX[Mat::E::B] << "_ldc" << ldX[Mat::E::C]
                         << "_ws" << wSpaceSize << "_f" << derived.float_size_bits;
+  // mixed precision : A and B, and accumulation, where they differ from C
+  if (derived.float_size_bits_ab != derived.float_size_bits)
+  {
+    geometry_stringstream << "_fab" << derived.float_size_bits_ab;
+  }
+  if (derived.float_size_bits_acc != derived.float_size_bits)
+  {
+    geometry_stringstream << "_facc" << derived.float_size_bits_acc;
+  }
+  // complex : f is the size of a (real, imaginary) pair
+  if (derived.is_complex())
+  {
+    geometry_stringstream << "_cx1_cA" << cX[Mat::E::A] << "_cB" << cX[Mat::E::B];
+  }
+  // a triangle of C : 1 lower, 2 upper
+  if (uplo != Uplo::E::NONE)
+  {
+    geometry_stringstream << "_up" << static_cast<size_t>(uplo);
+  }
   return geometry_stringstream.str();
 }
 
@@ -384,6 +579,19 @@ std::string Geometry::get_tabbed_string() const
                         << " ldb=" << stringutil::get_char_padded(ldX[Mat::E::B], 6)
                         << " ldc=" << stringutil::get_char_padded(ldX[Mat::E::C], 6)
                         << " ws=" << wSpaceSize << " f=" << derived.float_size_bits;
+  if (derived.is_mixed())
+  {
+    geometry_stringstream << " fab=" << derived.float_size_bits_ab
+                          << " facc=" << derived.float_size_bits_acc;
+  }
+  if (derived.is_complex())
+  {
+    geometry_stringstream << " cx=1 cA=" << cX[Mat::E::A] << " cB=" << cX[Mat::E::B];
+  }
+  if (uplo != Uplo::E::NONE)
+  {
+    geometry_stringstream << " up=" << Uplo::M().name[uplo];
+  }
 
   return geometry_stringstream.str();
 }
@@ -394,10 +602,35 @@ size_t Geometry::get_padded_area(Mat::E M) const { return get_uncoal(M) * ldX[M]
 bool Geometry::operator==(const Geometry& rhs) const
 {
   return (isColMajor == rhs.isColMajor && tX == rhs.tX && ldX == rhs.ldX && m == rhs.m &&
-          n == rhs.n && k == rhs.k && wSpaceSize == rhs.wSpaceSize && floattype == rhs.floattype);
+          n == rhs.n && k == rhs.k && wSpaceSize == rhs.wSpaceSize && floattype == rhs.floattype &&
+          cX == rhs.cX && uplo == rhs.uplo);
 }
 
-double Geometry::get_gflops(double extime) const { return (2. * m * n * k) / (1e9 * extime); }
+std::array<size_t, 15> Geometry::get_fields() const
+{
+  return {{isColMajor,
+           tX[Mat::E::A],
+           tX[Mat::E::B],
+           tX[Mat::E::C],
+           ldX[Mat::E::A],
+           ldX[Mat::E::B],
+           ldX[Mat::E::C],
+           m,
+           n,
+           k,
+           wSpaceSize,
+           static_cast<size_t>(floattype),
+           cX[Mat::E::A],
+           cX[Mat::E::B],
+           static_cast<size_t>(uplo)}};
+}
+
+// a complex multiply-add is 4 real multiply-adds. A triangle of C is n (n + 1) / 2 elements.
+double Geometry::get_gflops(double extime) const
+{
+  double n_elements_c = uplo == Uplo::E::NONE ? 1. * m * n : 0.5 * n * (n + 1.);
+  return (derived.is_complex() ? 8. : 2.) * n_elements_c * k / (1e9 * extime);
+}
 
 bool Geometry::same_transposes(const Geometry& g2) const
 {
@@ -445,6 +678,11 @@ double Geometry::get_distance(const Geometry& g2) const
 
   distance += 1e-5 * (std::log(wSpaceSize + 1.1) - std::log(g2.wSpaceSize + 1.1));
 
+  // the storage types bound the vector widths and LDS use : prefer the same floattype
+  distance += 0.2 * (floattype != g2.floattype);
+  distance += 0.2 * (cX != g2.cX);
+  distance += 0.2 * (uplo != g2.uplo);
+
   return distance;
 }
 
@@ -2,7 +2,10 @@
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
 #include <algorithm>
+#include <iterator>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <miopengemm/architests.hpp>
 #include <miopengemm/derivedparams.hpp>
 #include <miopengemm/graph.hpp>
@@ -25,18 +28,21 @@ RandomUtil& radutil17()
 std::vector<HyPas> Graph::get_neighbors(const HyPas& hp0, bool prioritize) const
 {
 
+  auto Z                   = get_one_aways(hp0);
+  auto p_coupled_away      = get_p_coupled_away(hp0);
+  auto mic_mac_transformed = get_mic_mac_transformed(hp0);
+  for (auto z : {&p_coupled_away, &mic_mac_transformed})
+  {
+    std::move(z->begin(), z->end(), std::back_inserter(Z));
+  }
+
   std::vector<int> uni_prios;
-  std::vector<std::tuple<HyPas, int>> Z;
-  for (auto& z : {get_one_aways(hp0), get_p_coupled_away(hp0), get_mic_mac_transformed(hp0)})
+  for (auto& tup : Z)
   {
-    for (auto& tup : z)
+    int prio = std::get<1>(tup);
+    if (std::find(uni_prios.begin(), uni_prios.end(), prio) == uni_prios.end())
     {
-      Z.push_back(tup);
-      int prio = std::get<1>(tup);
-      if (std::find(uni_prios.begin(), uni_prios.end(), prio) == uni_prios.end())
-      {
-        uni_prios.push_back(prio);
-      }
+      uni_prios.push_back(prio);
     }
   }
 
@@ -46,7 +52,9 @@ std::vector<HyPas> Graph::get_neighbors(const HyPas& hp0, bool prioritize) const
   std::reverse(uni_prios.begin(), uni_prios.end());
 
   std::vector<HyPas> neighbors;
+  neighbors.reserve(Z.size());
 
+  // each neighbor has one priority, so is moved once
   if (prioritize == true)
   {
     for (auto& x : uni_prios)
@@ -55,7 +63,7 @@ std::vector<HyPas> Graph::get_neighbors(const HyPas& hp0, bool prioritize) const
       {
         if (std::get<1>(tup) == x)
         {
-          neighbors.push_back(std::get<0>(tup));
+          neighbors.push_back(std::move(std::get<0>(tup)));
         }
       }
     }
@@ -64,7 +72,7 @@ std::vector<HyPas> Graph::get_neighbors(const HyPas& hp0, bool prioritize) const
   {
     for (auto& tup : Z)
     {
-      neighbors.push_back(std::get<0>(tup));
+      neighbors.push_back(std::move(std::get<0>(tup)));
     }
   }
 
@@ -90,9 +98,9 @@ std::vector<std::tuple<HyPas, int>> Graph::get_p_coupled_away(const HyPas& hp0)
     auto second_p     = std::get<1>(second);
     auto second_value = hp0.sus[second_m].vs[second_p];
 
-    for (auto& new_first_val : at(first_m).edges[first_p].at(first_value))
+    for (auto& new_first_val : at(first_m).get_edges(first_p, first_value))
     {
-      for (auto& new_second_val : at(second_m).edges[second_p].at(second_value))
+      for (auto& new_second_val : at(second_m).get_edges(second_p, second_value))
       {
 
         // only if one increases and one decreases
@@ -101,7 +109,7 @@ std::vector<std::tuple<HyPas, int>> Graph::get_p_coupled_away(const HyPas& hp0)
           HyPas hp1(hp0);
           hp1.sus[first_m].vs[first_p]   = new_first_val;
           hp1.sus[second_m].vs[second_p] = new_second_val;
-          p_coupled_away.push_back(std::make_tuple(hp1, 0));
+          p_coupled_away.push_back(std::make_tuple(std::move(hp1), 0));
         }
       }
     }
@@ -119,7 +127,7 @@ std::vector<std::tuple<HyPas, int>> Graph::get_mic_mac_transformed(const HyPas&
   size_t        curr_mac = hp0.sus[Mat::E::C].vs[NonChi::E::MAC];
   macgrid::Grid curr_grid(curr_mac, hp0.sus[Mat::E::C].vs[NonChi::E::SKW]);
 
-  for (auto& newmac : at(Mat::E::C).edges[NonChi::E::MAC].at(curr_mac))
+  for (auto& newmac : at(Mat::E::C).get_edges(NonChi::E::MAC, curr_mac))
   {
     macgrid::Grid new_grid(newmac, hp0.sus[Mat::E::C].vs[NonChi::E::SKW]);
     if (!new_grid.is_good)
@@ -177,10 +185,10 @@ bool has_no_effect(const HyPas& hp0, Mat::E emat_x, size_t i)
     }
   }
 
-  // if ICE is 1, the IWI has no effect
+  // if ICE is 1, the IWI and RED have no effect
   if (hp0.sus.at(Mat::E::C).vs[NonChi::E::ICE] == 1)
   {
-    if (emat_x == Mat::E::C && i == NonChi::E::IWI)
+    if (emat_x == Mat::E::C && (i == NonChi::E::IWI || i == NonChi::E::RED))
     {
       return true;
     }
@@ -198,14 +206,14 @@ std::vector<std::tuple<HyPas, int>> Graph::get_one_aways(const HyPas& hp0) const
     for (size_t i = 0; i < Mat::mat_to_xchi(emat)->N; ++i)
     {
       size_t v0 = hp0.sus[emat].vs.at(i);
-      for (auto& x : at(emat).edges.at(i).at(v0))
+      for (auto& x : at(emat).get_edges(i, v0))
       {
         // has_no_effect : like NAW when GAL != 3.
         if (!has_no_effect(hp0, emat, i))
         {
           HyPas hp1(hp0);
           hp1.sus[emat].vs[i] = x;
-          one_aways.push_back(std::make_tuple(hp1, (*Mat::mat_to_priority(emat))[i]));
+          one_aways.push_back(std::make_tuple(std::move(hp1), (*Mat::mat_to_priority(emat))[i]));
         }
       }
     }
@@ -403,17 +411,13 @@ const std::map<size_t, std::vector<size_t>>& g_binary()
   return x;
 }
 
-Graph::Graph(const Geometry&         gg,
-             const oclutil::DevInfo& di,
-             const Constraints&      cs,
-             owrite::Writer&         mowri_)
-  : asubg(gg, cs.sub[Mat::E::A], devinfo),
-    bsubg(gg, cs.sub[Mat::E::B], devinfo),
-    csubg(gg, cs.sub[Mat::E::C], devinfo),
-    geometry(gg),
+Graph::Graph(const Geometry& gg, const oclutil::DevInfo& di, const Constraints& cs)
+  : geometry(gg),
     devinfo(di),
     constraints(cs),
-    mowri(mowri_)
+    asubg(geometry, constraints.sub[Mat::E::A], devinfo),
+    bsubg(geometry, constraints.sub[Mat::E::B], devinfo),
+    csubg(geometry, constraints.sub[Mat::E::C], devinfo)
 {
   asubg.initialise();
   bsubg.initialise();
@@ -480,6 +484,25 @@ void SuGr::initialise_start_range()
   }
 }
 
+void SuGr::initialise_membership()
+{
+  membership.resize(range.size());
+  for (size_t hpi = 0; hpi < range.size(); ++hpi)
+  {
+    size_t max_value = 0;
+    for (auto& x : range[hpi])
+    {
+      max_value = std::max(max_value, x);
+    }
+    membership[hpi] = std::vector<const std::vector<size_t>*>(max_value + 1, nullptr);
+    for (auto& x : range[hpi])
+    {
+      // every value in range is an edge key (see checks)
+      membership[hpi][x] = &edges[hpi].at(x);
+    }
+  }
+}
+
 void SuGr::initialise()
 {
   initialise_edges();  // virtual
@@ -489,6 +512,7 @@ void SuGr::initialise()
   checks();
   apply_constraint();
   checks();
+  initialise_membership();
 }
 
 void ChiSuGr::initialise_edges()
@@ -590,6 +614,21 @@ void CSuGr::initialise_edges()
   edges[NonChi::E::MIA] = {g_binary()};
   edges[NonChi::E::SZT] = {g_binary()};
   edges[NonChi::E::MAD] = {g_binary()};
+  edges[NonChi::E::RED] = {g_binary()};
+
+  // stream-K : 0 (off), or 1, 2 or 4 persistent work groups per compute unit, in 10 bits
+  size_t n_cus = ptr_devinfo->device_max_compute_units > 0 ? ptr_devinfo->device_max_compute_units
+                                                            : 64;
+  edges[NonChi::E::STK] = {{0, {n_cus, 2 * n_cus}},
+                           {n_cus, {0, 2 * n_cus}},
+                           {2 * n_cus, {0, n_cus, 4 * n_cus}},
+                           {4 * n_cus, {2 * n_cus}}};
+  for (auto it = edges[NonChi::E::STK].begin(); it != edges[NonChi::E::STK].end();)
+  {
+    auto& x = it->second;
+    x.erase(std::remove_if(x.begin(), x.end(), [](size_t v) { return v >= 1024; }), x.end());
+    it = it->first >= 1024 ? edges[NonChi::E::STK].erase(it) : std::next(it);
+  }
 }
 
 void ChiSuGr::refine_start_range()
@@ -607,7 +646,19 @@ void ChiSuGr::refine_start_range()
     start_range[Chi::E::WOS] = {Scratch::E::UNUSED, Scratch::E::COPY, Scratch::E::NFORM};
   }
 
-  start_range[Chi::E::VEW] = {1};
+  // half2 and char4 loads are as wide as a float load
+  if (ptr_gg->derived.floattype_ab == 'h')
+  {
+    start_range[Chi::E::VEW] = {1, 2};
+  }
+  else if (ptr_gg->derived.floattype_ab == 'b')
+  {
+    start_range[Chi::E::VEW] = {1, 2, 4};
+  }
+  else
+  {
+    start_range[Chi::E::VEW] = {1};
+  }
 
   set_start_mic();
 }
@@ -618,6 +669,8 @@ void CSuGr::refine_start_range()
   start_range[NonChi::E::ICE] = {1};
   start_range[NonChi::E::UFO] = {Binary::E::NO};
   start_range[NonChi::E::SZT] = {Binary::E::NO};
+  start_range[NonChi::E::RED] = {Binary::E::NO};
+  start_range[NonChi::E::STK] = {0};
 
   if ((ptr_gg->m) > 200 && (ptr_gg->n) > 200)
   {
@@ -718,7 +771,7 @@ HyPas Graph::get_random_start() const
                  {at(Mat::E::C).get_random_start()}}});
 }
 
-HyPas Graph::get_random_valid_start() const
+HyPas Graph::get_random_valid_start(owrite::Writer& mowri) const
 {
 
   HyPas hp0(get_random_start());
@@ -808,8 +861,62 @@ bool SuGr::contains(size_t hpi, size_t val) const
          << get_string(hpi);
     throw miog_error(errm.str());
   }
-  bool x =
-    (std::find(range[hpi].begin(), range[hpi].end(), val) == range[hpi].end()) ? false : true;
-  return x;
+  return val < membership[hpi].size() && membership[hpi][val] != nullptr;
+}
+
+const std::vector<size_t>& SuGr::get_edges(size_t hpi, size_t val) const
+{
+  if (!contains(hpi, val))
+  {
+    std::stringstream errm;
+    errm << "in SuGr::get_edges, " << val << " is not in range, internal logic err\n"
+         << get_string(hpi);
+    throw miog_error(errm.str());
+  }
+  return *membership[hpi][val];
+}
+
+std::string get_graph_key(const Geometry&         gg,
+                          const oclutil::DevInfo& devinfo,
+                          const Constraints&      constraints)
+{
+  // every DevInfo field : the Graph keeps a copy of the DevInfo (used by get_random_valid_start),
+  // which must be that of every caller sharing it
+  std::stringstream ss;
+  ss << gg.get_string() << '.' << devinfo.device_name << '.' << devinfo.device_version << '.'
+     << devinfo.driver_version << '.' << devinfo.identifier << '.' << devinfo.device_available
+     << '.' << devinfo.device_global_mem_size << '.' << devinfo.device_local_mem_size << '.'
+     << devinfo.device_max_clock_frequency << '.' << devinfo.device_max_compute_units << '.'
+     << devinfo.device_max_work_group_size << '.' << devinfo.wg_atom_size << '.'
+     << devinfo.device_fp16 << '.' << constraints.get_r_str() << '.' << constraints.get_sr_str();
+  return ss.str();
+}
+
+// bounded, as the memoized Derivabilty and KernBlobs : cleared when full. Graphs in use are kept
+// alive by their shared pointers.
+const size_t max_memoized_graphs = 256;
+
+std::shared_ptr<const Graph>
+get_graph(const Geometry& gg, const oclutil::DevInfo& devinfo, const Constraints& constraints)
+{
+  static std::unordered_map<std::string, std::shared_ptr<const Graph>> graphs;
+  static std::mutex mutt;
+
+  auto key = get_graph_key(gg, devinfo, constraints);
+
+  std::lock_guard<std::mutex> lock(mutt);
+  auto                        found = graphs.find(key);
+  if (found != graphs.end())
+  {
+    return found->second;
+  }
+
+  std::shared_ptr<const Graph> graph = std::make_shared<const Graph>(gg, devinfo, constraints);
+  if (graphs.size() >= max_memoized_graphs)
+  {
+    graphs.clear();
+  }
+  graphs[key] = graph;
+  return graph;
 }
 }
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <cmath>
+#include <cstring>
+#include <miopengemm/half.hpp>
+
+namespace MIOpenGEMM
+{
+
+uint16_t half::get_bits(float x)
+{
+  uint32_t f;
+  std::memcpy(&f, &x, sizeof(f));
+  uint32_t sign = (f >> 16) & 0x8000;
+  uint32_t absf = f & 0x7fffffff;
+
+  // inf and nan (kept quiet)
+  if (absf >= 0x7f800000)
+  {
+    return static_cast<uint16_t>(sign | 0x7c00 | (absf > 0x7f800000 ? 0x0200 : 0));
+  }
+
+  // at least 65520 = 65504 + half an ulp : rounds to inf
+  if (absf >= 0x477ff000)
+  {
+    return static_cast<uint16_t>(sign | 0x7c00);
+  }
+
+  // below 2^-14 : subnormal, in units of 2^-24. At most 2^-25 rounds to 0.
+  if (absf < 0x38800000)
+  {
+    if (absf <= 0x33000000)
+    {
+      return static_cast<uint16_t>(sign);
+    }
+    uint32_t exponent = absf >> 23;
+    uint32_t mantissa = (absf & 0x7fffff) | 0x800000;
+    uint32_t shift    = 126 - exponent;
+    uint32_t h        = mantissa >> shift;
+    uint32_t rem      = mantissa & ((1u << shift) - 1);
+    uint32_t halfway  = 1u << (shift - 1);
+    h += (rem > halfway || (rem == halfway && (h & 1)));
+    return static_cast<uint16_t>(sign | h);
+  }
+
+  // normal : rebias the exponent from 127 to 15 and round away 13 bits of mantissa. A carry
+  // into the exponent is correct, up to and including inf.
+  uint32_t h   = (absf - 0x38000000) >> 13;
+  uint32_t rem = absf & 0x1fff;
+  h += (rem > 0x1000 || (rem == 0x1000 && (h & 1)));
+  return static_cast<uint16_t>(sign | h);
+}
+
+float half::get_float(uint16_t bits_)
+{
+  uint32_t sign     = static_cast<uint32_t>(bits_ & 0x8000) << 16;
+  uint32_t exponent = (bits_ >> 10) & 0x1f;
+  uint32_t mantissa = bits_ & 0x3ff;
+
+  if (exponent == 0)
+  {
+    float x = std::ldexp(static_cast<float>(mantissa), -24);
+    return sign != 0 ? -x : x;
+  }
+
+  uint32_t f = exponent == 0x1f ? (sign | 0x7f800000 | (mantissa << 13))
+                                : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+  float x;
+  std::memcpy(&x, &f, sizeof(x));
+  return x;
+}
+}
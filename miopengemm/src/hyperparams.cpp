@@ -72,9 +72,11 @@ HyPas HyPas::get_reflected(bool swap_ab) const
   else
   {
 
-    auto suhyc = sus[Mat::E::C];
-    reflect_c(suhyc.vs);
-    return {{{sus[Mat::E::B], sus[Mat::E::A], suhyc}}};
+    // the values of A and B swap, each SuHy stays with its matrix (see replace_where_defined)
+    HyPas reflected(*this);
+    std::swap(reflected.sus[Mat::E::A].vs, reflected.sus[Mat::E::B].vs);
+    reflect_c(reflected.sus[Mat::E::C].vs);
+    return reflected;
   }
 }
 
@@ -85,7 +87,9 @@ Constraints Constraints::get_reflected(bool swap_ab) const
 
   if (swap_ab)
   {
-    std::swap(reflected.sub[Mat::E::A], reflected.sub[Mat::E::B]);
+    // the ranges of A and B swap, each Constraint stays with its matrix (see replace_where_defined)
+    std::swap(reflected.sub[Mat::E::A].range, reflected.sub[Mat::E::B].range);
+    std::swap(reflected.sub[Mat::E::A].start_range, reflected.sub[Mat::E::B].start_range);
     reflect_c(reflected.sub[Mat::E::C].range);
     reflect_c(reflected.sub[Mat::E::C].start_range);
     return reflected;
@@ -94,6 +98,33 @@ Constraints Constraints::get_reflected(bool swap_ab) const
   return reflected;
 }
 
+double Constraints::get_distance(const Constraints& tuned) const
+{
+  double distance = 0;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    auto& requested_range = sub[emat].range;
+    auto& tuned_range     = tuned.sub[emat].range;
+    for (size_t i = 0; i < requested_range.size(); ++i)
+    {
+      bool requested_defined = requested_range[i] != Status::E::UNDEFINED;
+      bool tuned_defined     = tuned_range[i] != Status::E::UNDEFINED;
+      if (requested_defined && tuned_defined)
+      {
+        // tuned with a value the request does not allow
+        distance += 0.5 * (requested_range[i] != tuned_range[i]);
+      }
+      else if (requested_defined != tuned_defined)
+      {
+        // tuned freely (the HyPas may still satisfy the request), or tuned with a restriction
+        // the request does not have
+        distance += 0.1;
+      }
+    }
+  }
+  return distance;
+}
+
 void SuHy::checks() const
 {
   if (vs.size() != Mat::mat_to_xchi(emat)->N)
@@ -335,6 +366,17 @@ std::vector<size_t> get_hy_v(std::string hy_s, bool hy_s_full, Mat::E emat)
     hy_v[keyindex] = val;
   }
 
+  // RED and STK were added after the kernel caches were written : absent, partial sums are not
+  // reduced and there are no persistent work groups
+  if (hy_s_full == true && emat == Mat::E::C && hy_v[NonChi::E::RED] == Status::E::UNDEFINED)
+  {
+    hy_v[NonChi::E::RED] = Binary::E::NO;
+  }
+  if (hy_s_full == true && emat == Mat::E::C && hy_v[NonChi::E::STK] == Status::E::UNDEFINED)
+  {
+    hy_v[NonChi::E::STK] = 0;
+  }
+
   // A special test in the case that constraints
   // are supposed to be comprehensive
   if (hy_s_full == true)
@@ -383,4 +425,132 @@ HyPas::HyPas(const str_array& hyperstrings)
 }
 
 HyPas::HyPas(std::array<SuHy, Mat::E::N>&& suhys) : sus(suhys) {}
+
+namespace packing
+{
+
+// number of bits per hyper-parameter, with head-room above the values in the search graph
+std::vector<size_t> get_chi_widths()
+{
+  std::vector<size_t> X(Chi::E::N, 0);
+  X[Chi::E::MIC] = 8;
+  X[Chi::E::PAD] = 6;
+  X[Chi::E::PLU] = 1;
+  X[Chi::E::LIW] = 1;
+  X[Chi::E::MIW] = 1;
+  X[Chi::E::WOS] = 2;
+  X[Chi::E::VEW] = 6;
+  return X;
+}
+
+std::vector<size_t> get_nonchi_widths()
+{
+  std::vector<size_t> X(NonChi::E::N, 0);
+  X[NonChi::E::UNR] = 10;
+  X[NonChi::E::GAL] = 2;
+  X[NonChi::E::PUN] = 1;
+  X[NonChi::E::ICE] = 6;
+  X[NonChi::E::IWI] = 1;
+  X[NonChi::E::SZT] = 1;
+  X[NonChi::E::MAD] = 1;
+  X[NonChi::E::NAW] = 10;
+  X[NonChi::E::UFO] = 1;
+  X[NonChi::E::MAC] = 12;
+  X[NonChi::E::SKW] = 6;
+  X[NonChi::E::AFI] = 1;
+  X[NonChi::E::MIA] = 1;
+  X[NonChi::E::RED] = 1;
+  X[NonChi::E::STK] = 10;
+  return X;
+}
+
+std::vector<size_t> get_confirmed(std::vector<size_t>&& widths, size_t available)
+{
+  size_t total = 0;
+  for (auto w : widths)
+  {
+    if (w == 0)
+    {
+      throw miog_error("a hyper-parameter has no packing width, internal logic error");
+    }
+    total += w;
+  }
+  if (total > available)
+  {
+    throw miog_error("packing widths exceed the available bits, internal logic error");
+  }
+  return widths;
+}
+
+const std::vector<size_t>& get_widths(Mat::E emat)
+{
+  static const std::vector<size_t> chi_widths    = get_confirmed(get_chi_widths(), 32);
+  static const std::vector<size_t> nonchi_widths = get_confirmed(get_nonchi_widths(), 64);
+  return emat == Mat::E::C ? nonchi_widths : chi_widths;
+}
+
+size_t get_word(Mat::E emat) { return emat == Mat::E::C ? 1 : 0; }
+
+size_t get_offset(Mat::E emat) { return emat == Mat::E::B ? 32 : 0; }
+}
+
+PackedHyPas HyPas::get_packed() const
+{
+  PackedHyPas php;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    auto&    widths = packing::get_widths(emat);
+    auto&    vs     = sus[emat].vs;
+    size_t   shift  = packing::get_offset(emat);
+    uint64_t word   = 0;
+    if (vs.size() != widths.size())
+    {
+      throw miog_error("size of vs array of SuHy is not as expected in get_packed");
+    }
+    for (size_t hpi = 0; hpi < vs.size(); ++hpi)
+    {
+      if (vs[hpi] >= (size_t(1) << widths[hpi]))
+      {
+        std::stringstream ss;
+        ss << "cannot pack " << Mat::mat_to_xchi(emat)->name[hpi] << vs[hpi] << " into "
+           << widths[hpi] << " bits (hyper-parameters " << get_string() << ')';
+        throw miog_error(ss.str());
+      }
+      word |= static_cast<uint64_t>(vs[hpi]) << shift;
+      shift += widths[hpi];
+    }
+    php.words[packing::get_word(emat)] |= word;
+  }
+  return php;
+}
+
+HyPas::HyPas(const PackedHyPas& php)
+{
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    auto&               widths = packing::get_widths(emat);
+    size_t              shift  = packing::get_offset(emat);
+    uint64_t            word   = php.words[packing::get_word(emat)];
+    std::vector<size_t> vs(widths.size());
+    for (size_t hpi = 0; hpi < widths.size(); ++hpi)
+    {
+      vs[hpi] = static_cast<size_t>((word >> shift) & ((uint64_t(1) << widths[hpi]) - 1));
+      shift += widths[hpi];
+    }
+    sus[emat] = SuHy(emat, std::move(vs));
+  }
+}
+
+bool PackedHyPas::operator==(const PackedHyPas& rhs) const { return words == rhs.words; }
+
+bool PackedHyPas::operator!=(const PackedHyPas& rhs) const { return words != rhs.words; }
+
+bool PackedHyPas::operator<(const PackedHyPas& rhs) const { return words < rhs.words; }
+
+size_t PackedHyPasHash::operator()(const PackedHyPas& php) const
+{
+  size_t h = std::hash<uint64_t>()(php.words[0]);
+  h ^= std::hash<uint64_t>()(php.words[1]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  return h;
+}
 }
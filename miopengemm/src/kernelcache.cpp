@@ -2,16 +2,32 @@
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <miopengemm/devicemodel.hpp>
 #include <miopengemm/enums.hpp>
 #include <miopengemm/kernelcache.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+#include <miopengemm/nearest.hpp>
 #include <miopengemm/redirection.hpp>
 
 namespace MIOpenGEMM
 {
 
+namespace
+{
+// an entry from a device in a different architecture family is at about the distance of a
+// geometry with a few different leading dimension alignments
+const double device_distance_weight = 0.5;
+
+// guards the Index of every KernelCache : building it, and resetting it when entries change
+std::mutex index_mutex;
+}
+
 size_t CacheKeyHash::operator()(const CacheKey& ck) const { return __hash(ck.concatenated); }
 
 std::vector<Geometry> get_geometries(const std::vector<CacheKey>& cks)
@@ -45,9 +61,21 @@ CacheKey::CacheKey(const std::string& dvc_, const Constraints& cns_, const Geome
 }
 
 std::string get_cache_entry_string(const CacheKey& ck, const HyPas& hypas, bool swap_ab)
+{
+  return get_cache_entry_string(ck, hypas, swap_ab, "");
+}
+
+std::string get_cache_entry_string(const CacheKey&   ck,
+                                   const HyPas&       hypas,
+                                   bool               swap_ab,
+                                   const std::string& comment)
 {
   std::string       swap_ab_str = swap_ab ? "true" : "false";
   std::stringstream cache_write_ss;
+  if (comment.size() > 0)
+  {
+    cache_write_ss << "// " << comment << '\n';
+  }
   cache_write_ss << "kc.add(\n";
   cache_write_ss << "{\"" << ck.dvc << "\",  // dev\n";
   cache_write_ss << "{\"" << ck.constraints.get_string() << "\"},  // con\n";
@@ -74,20 +102,52 @@ std::string CacheKey::get_string() const
   return ss.str();
 }
 
-KernelCache init_kernel_cache()
+namespace
+{
+std::mutex        kernel_cache_path_mutex;
+std::string       kernel_cache_path;
+std::atomic<bool> kernel_cache_loaded{false};
+}
+
+void set_kernel_cache_path(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(kernel_cache_path_mutex);
+  if (kernel_cache_loaded)
+  {
+    throw miog_error("set_kernel_cache_path called after the kernel cache was first used");
+  }
+  kernel_cache_path = path;
+}
+
+KernelCache init_layered_kernel_cache()
 {
-  KernelCache kc;
+  KernelCache kc = init_kernel_cache();
+
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(kernel_cache_path_mutex);
+    kernel_cache_loaded = true;
+    path                = kernel_cache_path;
+  }
+  if (path.size() == 0 && std::getenv("MIOPENGEMM_KERNEL_CACHE") != nullptr)
+  {
+    path = std::getenv("MIOPENGEMM_KERNEL_CACHE");
+  }
 
-#include "cache1.cachetxt"
-#include "cache2.cachetxt"
-#include "cache3.cachetxt"
-#include "cache4.cachetxt"
+  if (path.size() > 0)
+  {
+    auto kc_file = cachefile::read(path);
+    for (auto& ck : kc_file.get_keys())
+    {
+      kc.add_or_replace(ck, kc_file.at(ck));
+    }
+  }
   return kc;
 }
 
 const KernelCache& get_kernel_cache()
 {
-  static const KernelCache kc = init_kernel_cache();
+  static const KernelCache kc = init_layered_kernel_cache();
   return kc;
 }
 
@@ -132,7 +192,41 @@ void KernelCache::add(const CacheKey& ckey, const HyPas& hp)
     throw miog_error(ss.str());
   }
 
+  std::lock_guard<std::mutex> lock(index_mutex);
+  vals[ckey] = hp;
+  p_index    = nullptr;
+}
+
+void KernelCache::add_or_replace(const CacheKey& ckey, const HyPas& hp)
+{
+  if (redirection::get_is_not_canonical(ckey.gg))
+  {
+    throw miog_error(
+      "internal logic error : CacheKey has geometry in non-canonical form (in add_or_replace)");
+  }
+  std::lock_guard<std::mutex> lock(index_mutex);
   vals[ckey] = hp;
+  p_index    = nullptr;
+}
+
+void KernelCache::remove(const CacheKey& ckey)
+{
+  std::lock_guard<std::mutex> lock(index_mutex);
+  if (vals.erase(ckey) == 0)
+  {
+    throw miog_error("(in KernelCache::remove) no entry for " + ckey.get_string());
+  }
+  p_index = nullptr;
+}
+
+std::shared_ptr<const nearest::Index> KernelCache::get_index() const
+{
+  std::lock_guard<std::mutex> lock(index_mutex);
+  if (p_index == nullptr)
+  {
+    p_index = std::make_shared<nearest::Index>(*this);
+  }
+  return p_index;
 }
 
 std::vector<CacheKey> KernelCache::get_keys() const
@@ -195,7 +289,8 @@ void filter_floattype(std::vector<CacheKey>& cks, size_t float_size_bytes)
   std::vector<CacheKey> valid;
   for (auto& ck : cks)
   {
-    if (ck.gg.derived.float_size_bytes == float_size_bytes)
+    if (ck.gg.derived.float_size_bytes == float_size_bytes && !ck.gg.derived.is_mixed() &&
+        !ck.gg.derived.is_complex())
     {
       valid.push_back(ck);
     }
@@ -208,11 +303,10 @@ double CacheKey::get_distance(const CacheKey& ck) const
   double distance = 0;
   distance += gg.get_distance(ck.gg);
 
-  // TODO : distance between devices, how should this work?
-  distance += 1e-6 * (dvc != ck.dvc);
+  // entries from more similar devices are preferred, see devicemodel::get_distance
+  distance += device_distance_weight * devicemodel::get_distance(dvc, ck.dvc);
 
-  // TODO : improved distance between constraints. will be non-sym.
-  distance += 1 * (constraints.get_string() != ck.constraints.get_string());
+  distance += constraints.get_distance(ck.constraints);
 
   return distance;
 }
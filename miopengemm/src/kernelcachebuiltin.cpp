@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+
+// The built-in kernel cache. cachegen (see miopengemm/cachegen) is built with
+// MIOPENGEMM_BUILTIN_CACHE_TEXT, adding the kc.add(...) entries of the cacheN.cachetxt files, and
+// writes them at build time as a binary kernel cache file, in kernelcachebuiltin.inc. The library
+// decodes its records instead of parsing geometry and hyper-parameter strings. Where cachegen
+// cannot be run (cross compiling), the library is also built with MIOPENGEMM_BUILTIN_CACHE_TEXT.
+
+namespace MIOpenGEMM
+{
+
+#ifdef MIOPENGEMM_BUILTIN_CACHE_TEXT
+KernelCache init_kernel_cache()
+{
+  KernelCache kc;
+
+#include "cache1.cachetxt"
+#include "cache2.cachetxt"
+#include "cache3.cachetxt"
+#include "cache4.cachetxt"
+  return kc;
+}
+#else
+namespace
+{
+const unsigned char builtin_cache[] = {
+#include "kernelcachebuiltin.inc"
+};
+}
+
+KernelCache init_kernel_cache()
+{
+  return cachefile::read(
+    reinterpret_cast<const char*>(builtin_cache), sizeof(builtin_cache), "built-in kernel cache");
+}
+#endif
+}
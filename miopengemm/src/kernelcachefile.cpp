@@ -0,0 +1,321 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <array>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <miopengemm/error.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+
+namespace MIOpenGEMM
+{
+namespace cachefile
+{
+
+namespace
+{
+
+const std::string magic = "MIOGEMMK";
+// magic, version, number of records, strings size
+const size_t header_size = 8 + 4 + 4 + 4;
+// 2 string references, 7 geometry integers, 8 geometry chars (the last padding), PackedHyPas
+const size_t record_size = 4 * 4 + 7 * 8 + 8 + 2 * 8;
+
+void put(std::string& buffer, uint64_t x, size_t n_bytes)
+{
+  for (size_t i = 0; i < n_bytes; ++i)
+  {
+    buffer.push_back(static_cast<char>((x >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t get(const char*& p, size_t n_bytes)
+{
+  uint64_t x = 0;
+  for (size_t i = 0; i < n_bytes; ++i)
+  {
+    x |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+  }
+  p += n_bytes;
+  return x;
+}
+
+std::string get_file_contents(const std::string& filename)
+{
+  std::ifstream fin(filename, std::ios::in | std::ios::binary);
+  if (!fin.good())
+  {
+    throw miog_error("failed to open kernel cache file `" + filename + "'");
+  }
+  std::stringstream ss;
+  ss << fin.rdbuf();
+  return ss.str();
+}
+}
+
+// A binary kernel cache file, mapped read-only : its pages are only read when records are
+// decoded, and nothing is copied. Without mmap (Windows), the file is read into memory.
+class MappedFile
+{
+  public:
+  MappedFile(const std::string& filename);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  const char* data() const { return ptr; }
+  size_t      size() const { return n_bytes; }
+
+  private:
+  const char* ptr     = nullptr;
+  size_t      n_bytes = 0;
+  std::string contents;
+};
+
+#ifndef _WIN32
+MappedFile::MappedFile(const std::string& filename)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw miog_error("failed to open kernel cache file `" + filename + "'");
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    throw miog_error("failed to stat kernel cache file `" + filename + "'");
+  }
+  n_bytes = static_cast<size_t>(st.st_size);
+  if (n_bytes > 0)
+  {
+    void* mapped = mmap(nullptr, n_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+      close(fd);
+      throw miog_error("failed to mmap kernel cache file `" + filename + "'");
+    }
+    ptr = static_cast<const char*>(mapped);
+  }
+  // the mapping remains valid after the descriptor is closed
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (ptr != nullptr)
+  {
+    munmap(const_cast<char*>(ptr), n_bytes);
+  }
+}
+#else
+MappedFile::MappedFile(const std::string& filename)
+  : contents(get_file_contents(filename))
+{
+  ptr     = contents.data();
+  n_bytes = contents.size();
+}
+
+MappedFile::~MappedFile() {}
+#endif
+void write(const KernelCache& kc, const std::string& filename)
+{
+  std::string                     records;
+  std::string                     strings;
+  std::map<std::string, uint32_t> string_offsets;
+
+  auto put_string = [&records, &strings, &string_offsets](const std::string& s) {
+    if (string_offsets.count(s) == 0)
+    {
+      string_offsets[s] = static_cast<uint32_t>(strings.size());
+      strings += s;
+    }
+    put(records, string_offsets[s], 4);
+    put(records, s.size(), 4);
+  };
+
+  auto keys = kc.get_keys();
+  for (auto& ck : keys)
+  {
+    put_string(ck.dvc);
+    put_string(ck.constraints.get_string());
+
+    const Geometry& gg = ck.gg;
+    for (auto x : {gg.m, gg.n, gg.k, gg.ldX[Mat::E::A], gg.ldX[Mat::E::B], gg.ldX[Mat::E::C]})
+    {
+      put(records, x, 8);
+    }
+    put(records, gg.wSpaceSize, 8);
+    for (bool x : {gg.isColMajor, gg.tX[Mat::E::A], gg.tX[Mat::E::B], gg.tX[Mat::E::C]})
+    {
+      put(records, x, 1);
+    }
+    put(records, static_cast<unsigned char>(gg.floattype), 1);
+    // the conjugations (complex only) in what was padding : earlier files read as not conjugated
+    put(records, gg.cX[Mat::E::A] + 2 * gg.cX[Mat::E::B], 1);
+    // and the triangle of C : earlier files read as Uplo::E::NONE
+    put(records, static_cast<size_t>(gg.uplo), 1);
+    put(records, 0, 1);
+
+    auto packed = kc.at(ck).get_packed();
+    put(records, packed.words[0], 8);
+    put(records, packed.words[1], 8);
+  }
+
+  std::string header = magic;
+  put(header, version, 4);
+  put(header, keys.size(), 4);
+  put(header, strings.size(), 4);
+
+  std::ofstream fout(filename, std::ios::out | std::ios::binary);
+  if (!fout.good())
+  {
+    throw miog_error("failed to open `" + filename + "' for writing kernel cache");
+  }
+  fout << header << records << strings;
+}
+
+KernelCache read(const std::string& filename)
+{
+  MappedFile contents(filename);
+  return read(contents.data(), contents.size(), filename);
+}
+
+KernelCache read(const char* data, size_t n_bytes, const std::string& filename)
+{
+  if (n_bytes < header_size || std::string(data, magic.size()) != magic)
+  {
+    throw miog_error("`" + filename + "' is not a binary kernel cache file");
+  }
+
+  const char* p = data + magic.size();
+  auto file_version = get(p, 4);
+  if (file_version < min_version || file_version > version)
+  {
+    std::stringstream ss;
+    ss << "kernel cache file `" << filename << "' is version " << file_version << ", only versions "
+       << min_version << " to " << version << " are supported";
+    throw miog_error(ss.str());
+  }
+
+  size_t n_records    = get(p, 4);
+  size_t strings_size = get(p, 4);
+  if (n_bytes != header_size + n_records * record_size + strings_size)
+  {
+    throw miog_error("kernel cache file `" + filename + "' is truncated or corrupt");
+  }
+  const char* strings = data + header_size + n_records * record_size;
+
+  auto get_string = [&p, strings, strings_size, &filename]() {
+    size_t offset = get(p, 4);
+    size_t size   = get(p, 4);
+    if (offset + size > strings_size)
+    {
+      throw miog_error("bad string reference in kernel cache file `" + filename + "'");
+    }
+    return std::string(strings + offset, size);
+  };
+
+  KernelCache kc;
+  for (size_t ri = 0; ri < n_records; ++ri)
+  {
+    std::string dvc = get_string();
+    std::string cns = get_string();
+
+    std::array<size_t, 7> ints;
+    for (auto& x : ints)
+    {
+      x = get(p, 8);
+    }
+    std::array<bool, 4> bools;
+    for (auto& x : bools)
+    {
+      x = get(p, 1) != 0;
+    }
+    char floattype = static_cast<char>(get(p, 1));
+    auto conj      = get(p, 1);
+    auto uplo      = get(p, 1);
+    get(p, 1);
+    if (file_version < 2)
+    {
+      // padding, and no complex floattypes
+      conj = 0;
+      if (floattype == 'c' || floattype == 'z')
+      {
+        throw miog_error("complex floattype in kernel cache file `" + filename + "' of version 1");
+      }
+    }
+    if (file_version < 3)
+    {
+      // padding
+      uplo = 0;
+    }
+    if (uplo >= Uplo::E::N)
+    {
+      throw miog_error("bad triangle of C in kernel cache file `" + filename + "'");
+    }
+
+    Geometry gg(bools[0],
+                bools[1],
+                bools[2],
+                bools[3],
+                ints[3],
+                ints[4],
+                ints[5],
+                ints[0],
+                ints[1],
+                ints[2],
+                ints[6],
+                floattype,
+                (conj & 1) != 0,
+                (conj & 2) != 0,
+                static_cast<Uplo::E>(uplo));
+
+    PackedHyPas packed;
+    packed.words[0] = get(p, 8);
+    packed.words[1] = get(p, 8);
+
+    kc.add_or_replace({dvc, Constraints(cns), gg}, HyPas(packed));
+  }
+  return kc;
+}
+
+KernelCache read_text(const std::string& filename)
+{
+  std::string contents = get_file_contents(filename);
+  std::string entry_start("kc.add(");
+
+  KernelCache kc;
+  size_t      pos = contents.find(entry_start);
+  while (pos != std::string::npos)
+  {
+    // dev, con, gg, and the A, B, C hyper-parameters
+    std::array<std::string, 6> quoted;
+    size_t                     end = pos + entry_start.size();
+    for (auto& x : quoted)
+    {
+      size_t open  = contents.find('"', end);
+      size_t close = open == std::string::npos ? open : contents.find('"', open + 1);
+      if (close == std::string::npos)
+      {
+        throw miog_error("incomplete kc.add entry in `" + filename + "'");
+      }
+      x   = contents.substr(open + 1, close - open - 1);
+      end = close + 1;
+    }
+
+    HyPas hp(HyPas::str_array{{quoted[3], quoted[4], quoted[5]}});
+    kc.add_or_replace({quoted[0], Constraints(quoted[1]), Geometry(quoted[2])}, hp);
+    pos = contents.find(entry_start, end);
+  }
+  return kc;
+}
+}
+}
@@ -2,10 +2,22 @@
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <deque>
+#include <fstream>
 #include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
+#include <miopengemm/kernelcachefile.hpp>
 #include <miopengemm/kernelcachemerge.hpp>
+#include <miopengemm/miogemm.hpp>
+#include <miopengemm/nearest.hpp>
+#include <miopengemm/runstats.hpp>
 #include <miopengemm/setabcw.hpp>
 #include <miopengemm/tinytwo.hpp>
 
@@ -33,43 +45,120 @@ std::vector<bool> get_thue_morse(size_t length)
   return thue_morse;
 }
 
+// the kernels of the two candidate HyPas for a key, each compiled on its own TinyOne so that
+// neither is recompiled when they alternate. Constructed (compiled) off the benchmarking thread.
+template <typename TFl>
+class Contest
+{
+  public:
+  std::array<HyPas, 2>       hps;
+  std::array<bool, 2>        compiled{{false, false}};
+  std::array<std::string, 2> compile_msgs;
+  owrite::Writer             silent;
+  dev::TinyOne<TFl>          diva1;
+  dev::TinyOne<TFl>          diva2;
+
+  Contest(const CacheKey&                          ck,
+          const HyPas&                             hp1,
+          const HyPas&                             hp2,
+          const std::array<const TFl*, Mat::E::N>& r_mem,
+          const CLHint&                            xhint)
+    : hps{{hp1, hp2}},
+      silent(Ver::E::SILENT, ""),
+      diva1(ck.gg, get_zero_offsets(), r_mem, silent, xhint),
+      diva2(ck.gg, get_zero_offsets(), r_mem, silent, xhint)
+  {
+    std::array<dev::TinyOne<TFl>*, 2> divas{{&diva1, &diva2}};
+    for (size_t i = 0; i < 2; ++i)
+    {
+      try
+      {
+        divas[i]->prepare(hps[i]);
+        compiled[i] = true;
+      }
+      catch (const miog_error& e)
+      {
+        compile_msgs[i] = e.what();
+      }
+    }
+  }
+};
+
 template <typename TFl>
 void populate(const std::vector<CacheKey>& cache_keys,
               const KernelCache&           kc1,
               const KernelCache&           kc2,
               KernelCache&                 kc,
               const Halt&                  halt,
+              size_t                       n_compile_threads,
+              std::ofstream&               journal,
               owrite::Writer&              mowri)
 {
 
-  Offsets offsets = get_zero_offsets();
-  CLHint  xhint;
+  CLHint xhint;
 
-  // we set the CPU memory once for all geometries.
-  // This is much faster than once for each geometry using TinyTwos
-  mowri.bw[OutPart::MER] << "generating random matrices on CPU ... " << Flush;
-  setabcw::CpuMemBundle<TFl> cmb(get_geometries(cache_keys), offsets);
-  mowri.bw[OutPart::MER] << "done. Will perform Thue–Morse ABBABAAB 1-on-1." << Endl;
-  for (size_t i = 0; i < cache_keys.size(); ++i)
+  auto record = [&kc, &journal](const CacheKey& ck, const HyPas& hp, const std::string& prov) {
+    kc.add(ck, hp);
+    if (journal.is_open())
+    {
+      journal << '\n' << get_cache_entry_string(ck, hp, canonical::noswap, prov) << std::flush;
+    }
+  };
+
+  // the keys with different HyPas are compiled concurrently, up to n_compile_threads ahead of
+  // the one being benchmarked, while benchmarking is sequential so that runs do not interfere.
+  std::vector<CacheKey> contested;
+  for (auto& ck : cache_keys)
   {
-    auto ck = cache_keys[i];
     if (kc1.at(ck, canonical::noswap) == kc2.at(ck, canonical::noswap))
     {
-      kc.add(ck, kc1.at(ck, canonical::noswap));
+      record(ck, kc1.at(ck, canonical::noswap), "merge : identical in kc1 and kc2");
       mowri.bw[OutPart::MER] << "[ss]" << Flush;
-      continue;
     }
-    mowri.bw[OutPart::MER] << '\n' << "(" << i << " / " << cache_keys.size() << ")";
-    mowri.bw[OutPart::MER] << ck.gg.get_string() << Endl;
+    else
+    {
+      contested.push_back(ck);
+    }
+  }
+
+  if (contested.empty())
+  {
+    return;
+  }
 
-    mowri.bw[OutPart::MER] << "soln1 : " << kc1.at(ck, canonical::noswap).get_string() << Endl;
-    mowri.bw[OutPart::MER] << "soln2 : " << kc2.at(ck, canonical::noswap).get_string() << Endl;
+  // we set the CPU memory once for all contested geometries.
+  // This is much faster than once for each geometry using TinyTwos
+  mowri.bw[OutPart::MER] << "generating random matrices on CPU ... " << Flush;
+  setabcw::CpuMemBundle<TFl> cmb(get_geometries(contested), get_zero_offsets());
+  mowri.bw[OutPart::MER] << "done. Will perform Thue–Morse ABBABAAB 1-on-1." << Endl;
+
+  using up_contest = std::unique_ptr<Contest<TFl>>;
+  std::deque<std::future<up_contest>> compiling;
+  size_t                              n_launched = 0;
+  auto                                launch     = [&]() {
+    auto& ck = contested[n_launched++];
+    compiling.push_back(std::async(std::launch::async, [&ck, &kc1, &kc2, &cmb, &xhint]() {
+      return up_contest(new Contest<TFl>(
+        ck, kc1.at(ck, canonical::noswap), kc2.at(ck, canonical::noswap), cmb.r_mem, xhint));
+    }));
+  };
+
+  for (size_t i = 0; i < contested.size(); ++i)
+  {
+    size_t n_ahead = std::max<size_t>(n_compile_threads, 1);
+    while (n_launched < contested.size() && n_launched < i + n_ahead)
+    {
+      launch();
+    }
+    auto contest = compiling.front().get();
+    compiling.pop_front();
 
-    // having two TinyOnes means that each opposing kernel only needs be compiled once. Optional.
-    dev::TinyOne<TFl> diva1(ck.gg, offsets, cmb.r_mem, mowri, xhint);
-    dev::TinyOne<TFl> diva2(ck.gg, offsets, cmb.r_mem, mowri, xhint);
+    auto& ck = contested[i];
+    mowri.bw[OutPart::MER] << '\n' << "(" << i << " / " << contested.size() << ")";
+    mowri.bw[OutPart::MER] << ck.gg.get_string() << Endl;
 
-    mowri.bw[OutPart::MER] << "Two divas generated" << Endl;
+    mowri.bw[OutPart::MER] << "soln1 : " << contest->hps[0].get_string() << Endl;
+    mowri.bw[OutPart::MER] << "soln2 : " << contest->hps[1].get_string() << Endl;
 
     std::vector<double> times_kc1;
     std::vector<double> times_kc2;
@@ -77,28 +166,18 @@ void populate(const std::vector<CacheKey>& cache_keys,
     size_t kc1_wins = 0;
     size_t kc2_wins = 0;
 
-    std::string prefix = std::to_string(i) + "/" + std::to_string(cache_keys.size());
-    prefix.resize(8, ' ');
-
-    auto act_kcx = [&halt, &mowri, &ck, &prefix](const KernelCache& kcx,
-                                                 std::string          frag,
-                                                 std::vector<double>& times,
-                                                 dev::TinyOne<TFl>&   diva) {
-      mowri.bw[OutPart::MER] << '<' << frag << Flush;
+    auto act_kcx = [&halt, &mowri, &contest](size_t               x,
+                                             std::vector<double>& times,
+                                             dev::TinyOne<TFl>&   diva) {
+      mowri.bw[OutPart::MER] << '<' << x + 1 << Flush;
       std::this_thread::sleep_for(std::chrono::milliseconds(20));
 
-      auto        hp = kcx.at(ck, canonical::noswap);
-      Derivabilty drvble(hp, ck.gg);
-      double      zoo;
-      if (drvble.is_derivable)
+      double zoo = 1e8;
+      if (contest->compiled[x])
       {
-        std::vector<double> ltimes = diva.benchgemm({hp}, halt).back();
+        std::vector<double> ltimes = diva.benchgemm({contest->hps[x]}, halt).back();
         zoo                        = *std::min_element(ltimes.begin(), ltimes.end());
       }
-      else
-      {
-        zoo = 1e8;
-      }
       mowri.bw[OutPart::MER] << '>' << Flush;
 
       times.push_back(zoo);
@@ -108,13 +187,13 @@ void populate(const std::vector<CacheKey>& cache_keys,
     {
       if (kc1_first)
       {
-        act_kcx(kc1, "1", times_kc1, diva1);
-        act_kcx(kc2, "2", times_kc2, diva1);
+        act_kcx(0, times_kc1, contest->diva1);
+        act_kcx(1, times_kc2, contest->diva2);
       }
       else
       {
-        act_kcx(kc2, "2", times_kc2, diva1);
-        act_kcx(kc1, "1", times_kc1, diva1);
+        act_kcx(1, times_kc2, contest->diva2);
+        act_kcx(0, times_kc1, contest->diva1);
       }
       mowri.bw[OutPart::MER] << '|' << Flush;
 
@@ -130,8 +209,8 @@ void populate(const std::vector<CacheKey>& cache_keys,
     mowri.bw[OutPart::MER] << Endl;
     for (unsigned ri = 0; ri < times_kc1.size(); ++ri)
     {
-      auto g1 = ck.gg.get_gflops(times_kc1[ri]);
-      auto g2 = ck.gg.get_gflops(times_kc2[ri]);
+      auto g1 = ck.gg.get_gflops(times_kc1[ri] / 1000.);
+      auto g2 = ck.gg.get_gflops(times_kc2[ri] / 1000.);
 
       mowri.bw[OutPart::MER] << stringutil::get_char_padded(g1, 8) << " \t ";
       if (g1 > g2)
@@ -145,45 +224,131 @@ void populate(const std::vector<CacheKey>& cache_keys,
       mowri.bw[OutPart::MER] << " \t " << stringutil::get_char_padded(g2, 8) << Endl;
     }
 
-    if (kc1_wins > kc2_wins)
+    // provenance : the winner, the score, and the median of each candidate's best-of-bout times
+    bool              kc1_won = kc1_wins > kc2_wins;
+    std::stringstream prov;
+    prov << "merge : kc" << (kc1_won ? 1 : 2) << " won " << std::max(kc1_wins, kc2_wins) << ':'
+         << std::min(kc1_wins, kc2_wins) << ", median [ms] kc1 "
+         << RunStats(times_kc1, 1e9).median << " kc2 " << RunStats(times_kc2, 1e9).median;
+    for (size_t x = 0; x < 2; ++x)
+    {
+      if (!contest->compiled[x])
+      {
+        // the comment is a single line
+        std::string msg = contest->compile_msgs[x];
+        std::replace(msg.begin(), msg.end(), '\n', ' ');
+        prov << ", kc" << x + 1 << " failed : " << msg;
+      }
+    }
+    mowri.bw[OutPart::MER] << prov.str() << '\n';
+    record(ck, contest->hps[kc1_won ? 0 : 1], prov.str());
+    mowri.bw[OutPart::MER] << '\n';
+  }
+
+  mowri.bw[OutPart::MER] << '\n';
+}
+
+// For the floattypes which can not be benchmarked on the device (mixed precision, integer and
+// complex, which have no TinyOne), the entry of kc1 is kept where kc1 and kc2 differ. Each such
+// key is reported.
+void populate_unbenchmarked(const std::vector<CacheKey>& cache_keys,
+                            const KernelCache&           kc1,
+                            const KernelCache&           kc2,
+                            KernelCache&                 kc,
+                            std::ofstream&               journal,
+                            owrite::Writer&              mowri)
+{
+  for (auto& ck : cache_keys)
+  {
+    HyPas       hp1       = kc1.at(ck, canonical::noswap);
+    bool        identical = hp1 == kc2.at(ck, canonical::noswap);
+    std::string prov      = identical ? "merge : identical in kc1 and kc2"
+                                 : std::string("merge : not benchmarked (floattype ") +
+                                     ck.gg.floattype + "), kept kc1";
+    kc.add(ck, hp1);
+    if (journal.is_open())
     {
-      mowri.bw[OutPart::MER] << "kc1 won, " << kc1_wins << ':' << kc2_wins << '.' << '\n';
-      kc.add(ck, kc1.at(ck, canonical::noswap));
+      journal << '\n' << get_cache_entry_string(ck, hp1, canonical::noswap, prov) << std::flush;
+    }
+    if (identical)
+    {
+      mowri.bw[OutPart::MER] << "[ss]" << Flush;
     }
     else
     {
-      mowri.bw[OutPart::MER] << "kc2 won, " << kc2_wins << ':' << kc1_wins << '.' << '\n';
-      kc.add(ck, kc2.at(ck, canonical::noswap));
+      mowri.bw[OutPart::MER] << '\n' << ck.get_string() << '\n' << prov << '\n';
     }
-    mowri.bw[OutPart::MER] << '\n';
   }
-
   mowri.bw[OutPart::MER] << '\n';
 }
 
 KernelCache
 get_merged(const KernelCache& kc1, const KernelCache& kc2, const Halt& halt, owrite::Writer& mowri)
+{
+  return get_merged(kc1, kc2, halt, "", 4, mowri);
+}
+
+KernelCache get_merged(const KernelCache& kc1,
+                       const KernelCache& kc2,
+                       const Halt&        halt,
+                       const std::string& journal_filename,
+                       size_t             n_compile_threads,
+                       owrite::Writer&    mowri)
 {
 
+  // entries resolved in a previous (interrupted) merge
+  KernelCache   resolved;
+  std::ofstream journal;
+  if (journal_filename.size() > 0)
+  {
+    if (std::ifstream(journal_filename).good())
+    {
+      resolved = cachefile::read_text(journal_filename);
+    }
+    journal.open(journal_filename, std::ios::out | std::ios::app);
+    if (!journal.good())
+    {
+      throw miog_error("failed to open merge journal `" + journal_filename + "'");
+    }
+  }
+
   KernelCache kc;
   std::map<char, std::vector<CacheKey>> in_both;
 
   size_t from_kc1{0};
   size_t from_kc2{0};
+  size_t from_journal{0};
   size_t undetermined{0};
+
+  auto take = [&kc, &resolved, &journal, &from_journal](
+    const CacheKey& ck, const HyPas& hp, const std::string& prov) {
+    if (resolved.check_for(ck).is_present)
+    {
+      kc.add(ck, resolved.at(ck));
+      ++from_journal;
+      return;
+    }
+    kc.add(ck, hp);
+    if (journal.is_open())
+    {
+      journal << '\n' << get_cache_entry_string(ck, hp, canonical::noswap, prov) << std::flush;
+    }
+  };
+
   for (auto& k1 : kc1.get_keys())
   {
     if (!kc2.check_for(k1).is_present)
     {
-      kc.add(k1, kc1.at(k1, canonical::noswap));
+      take(k1, kc1.at(k1, canonical::noswap), "merge : only in kc1");
       ++from_kc1;
     }
+    else if (resolved.check_for(k1).is_present)
+    {
+      kc.add(k1, resolved.at(k1));
+      ++from_journal;
+    }
     else
     {
-      if (in_both.count(k1.gg.floattype) == 0)
-      {
-        in_both[k1.gg.floattype] = {};
-      }
       in_both[k1.gg.floattype].push_back(k1);
       ++undetermined;
     }
@@ -193,20 +358,34 @@ get_merged(const KernelCache& kc1, const KernelCache& kc2, const Halt& halt, owr
   {
     if (!kc1.check_for(k2).is_present)
     {
-      kc.add(k2, kc2.at(k2, canonical::noswap));
+      take(k2, kc2.at(k2, canonical::noswap), "merge : only in kc2");
       ++from_kc2;
     }
   }
 
   mowri.bw[OutPart::MER] << "from kc1 : " << from_kc1 << ", from kc2 : " << from_kc2
+                         << ", from journal : " << from_journal
                          << ", to be determined : " << undetermined << Endl;
 
   for (auto& x : in_both)
   {
     switch (std::get<0>(x))
     {
-    case 'f': populate<float>(in_both['f'], kc1, kc2, kc, halt, mowri); break;
-    case 'd': populate<double>(in_both['f'], kc1, kc2, kc, halt, mowri); break;
+    case 'f':
+      populate<float>(x.second, kc1, kc2, kc, halt, n_compile_threads, journal, mowri);
+      break;
+    case 'd':
+      populate<double>(x.second, kc1, kc2, kc, halt, n_compile_threads, journal, mowri);
+      break;
+    case 'h':
+      populate<half>(x.second, kc1, kc2, kc, halt, n_compile_threads, journal, mowri);
+      break;
+    case 'm':
+    case 'n':
+    case 'i':
+    case 'q':
+    case 'c':
+    case 'z': populate_unbenchmarked(x.second, kc1, kc2, kc, journal, mowri); break;
     default: throw miog_error("unrecognised floattype in get_merged");
     }
   }
@@ -229,4 +408,166 @@ KernelCache get_wSpaceReduced(const KernelCache& kc)
   }
   return kc_new;
 }
+
+bool get_selected(const KernelCache& kc,
+                  const CacheKey&    reference,
+                  CacheKey&          selected,
+                  HyPas&             hp)
+{
+  oclutil::DevInfo devinfo(reference.dvc, reference.dvc, 64);
+  auto             graph = get_graph(reference.gg, devinfo, reference.constraints);
+  owrite::Writer   silent(Ver::E::SILENT, "");
+  return get_nearest_cached(
+    reference.gg, reference.constraints, reference, *graph, kc, 0, selected, hp, silent);
+}
+
+bool get_selected(const KernelCache& kc, const CacheKey& reference, CacheKey& selected)
+{
+  HyPas hp;
+  return get_selected(kc, reference, selected, hp);
+}
+
+namespace
+{
+KernelCache compact(const KernelCache&           kc,
+                    const std::vector<CacheKey>& references,
+                    costmodel::CostModel*        cost,
+                    double                       tolerance,
+                    owrite::Writer&              mowri)
+{
+  KernelCache compacted = kc;
+  auto        keys      = kc.get_keys();
+  std::sort(keys.begin(), keys.end(), [](const CacheKey& a, const CacheKey& b) {
+    return a.concatenated < b.concatenated;
+  });
+
+  // the references selecting each key, and the HyPas each reference originally selected
+  std::unordered_map<std::string, std::vector<size_t>> users;
+  std::vector<HyPas>                                   original(references.size());
+  for (size_t r = 0; r < references.size(); ++r)
+  {
+    CacheKey selected = references[r];
+    if (get_selected(kc, references[r], selected, original[r]))
+    {
+      users[selected.concatenated].push_back(r);
+    }
+  }
+
+  // candidates for removal, nearest to an entry with the same HyPas first, then densest first
+  using order_tup = std::tuple<double, double, size_t>;
+  std::vector<order_tup> order;
+  for (size_t a = 0; a < keys.size(); ++a)
+  {
+    double nearest_same = std::numeric_limits<double>::max();
+    double nearest_any  = std::numeric_limits<double>::max();
+    for (size_t b = 0; b < keys.size(); ++b)
+    {
+      if (a != b)
+      {
+        double distance = keys[a].get_distance(keys[b]);
+        nearest_any     = std::min(nearest_any, distance);
+        if (kc.at(keys[a]) == kc.at(keys[b]))
+        {
+          nearest_same = std::min(nearest_same, distance);
+        }
+      }
+    }
+    // without a cost model, the references selecting a unique HyPas must keep it
+    if (cost != nullptr || nearest_same < std::numeric_limits<double>::max() ||
+        users.count(keys[a].concatenated) == 0)
+    {
+      order.emplace_back(std::make_tuple(nearest_same, nearest_any, a));
+    }
+  }
+  std::sort(order.begin(), order.end());
+
+  size_t n_removed = 0;
+  for (auto& x : order)
+  {
+    auto& key      = keys[std::get<2>(x)];
+    HyPas hp       = compacted.at(key);
+    auto  affected = users[key.concatenated];
+    compacted.remove(key);
+
+    bool                  accept = true;
+    std::vector<CacheKey> reselected;
+    for (auto r : affected)
+    {
+      CacheKey selected = references[r];
+      HyPas    new_hp;
+      if (!get_selected(compacted, references[r], selected, new_hp))
+      {
+        accept = false;
+        break;
+      }
+      if (!(new_hp == original[r]) &&
+          (cost == nullptr ||
+           cost->get_gflops(new_hp, references[r].gg) <
+             (1 - tolerance) * cost->get_gflops(original[r], references[r].gg)))
+      {
+        accept = false;
+        break;
+      }
+      reselected.push_back(selected);
+    }
+
+    if (accept)
+    {
+      for (size_t i = 0; i < affected.size(); ++i)
+      {
+        users[reselected[i].concatenated].push_back(affected[i]);
+      }
+      users.erase(key.concatenated);
+      ++n_removed;
+    }
+    else
+    {
+      compacted.add(key, hp);
+    }
+  }
+
+  mowri.bw[OutPart::MER] << "compacted from " << keys.size() << " to " << keys.size() - n_removed
+                         << " entries (" << order.size() << " candidates, " << references.size()
+                         << " references)" << Endl;
+  return compacted;
+}
+}
+
+KernelCache get_compacted(const KernelCache&           kc,
+                          const std::vector<CacheKey>& references,
+                          owrite::Writer&              mowri)
+{
+  return compact(kc, references, nullptr, 0, mowri);
+}
+
+KernelCache get_compacted(const KernelCache&           kc,
+                          const std::vector<CacheKey>& references,
+                          costmodel::CostModel&        cost,
+                          double                       tolerance,
+                          owrite::Writer&              mowri)
+{
+  return compact(kc, references, &cost, tolerance, mowri);
+}
+
+std::vector<std::tuple<double, CacheKey>>
+get_coverage_gaps(const KernelCache& kc, const std::vector<CacheKey>& references, size_t n)
+{
+  std::vector<std::tuple<double, size_t>> distances;
+  for (size_t r = 0; r < references.size(); ++r)
+  {
+    CacheKey selected = references[r];
+    double   distance = get_selected(kc, references[r], selected)
+                        ? references[r].get_distance(selected)
+                        : std::numeric_limits<double>::max();
+    distances.emplace_back(std::make_tuple(distance, r));
+  }
+  std::sort(distances.begin(), distances.end(), std::greater<std::tuple<double, size_t>>());
+
+  std::vector<std::tuple<double, CacheKey>> gaps;
+  for (size_t i = 0; i < std::min(n, distances.size()); ++i)
+  {
+    gaps.emplace_back(std::get<0>(distances[i]), references[std::get<1>(distances[i])]);
+  }
+  return gaps;
+}
 }
@@ -25,8 +25,9 @@ bool KernUses::at(Mem::E emat_x) const
   throw miog_error("failed in KernUses::at");
 }
 
-KernUses::KernUses(bool u_a_, bool u_b_, bool u_c_, bool u_w_, bool u_alpha_, bool u_beta_)
-  : u_a(u_a_), u_b(u_b_), u_c(u_c_), u_w(u_w_), u_alpha(u_alpha_), u_beta(u_beta_)
+KernUses::KernUses(
+  bool u_a_, bool u_b_, bool u_c_, bool u_w_, bool u_alpha_, bool u_beta_, bool u_bias_)
+  : u_a(u_a_), u_b(u_b_), u_c(u_c_), u_w(u_w_), u_alpha(u_alpha_), u_beta(u_beta_), u_bias(u_bias_)
 {
   for (auto& x : {Mem::E::A, Mem::E::B, Mem::E::C, Mem::E::W})
   {
@@ -45,5 +46,10 @@ KernUses::KernUses(bool u_a_, bool u_b_, bool u_c_, bool u_w_, bool u_alpha_, bo
   {
     full += "_beta";
   }
+
+  if (u_bias)
+  {
+    full += "_bias";
+  }
 }
 }
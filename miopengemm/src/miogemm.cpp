@@ -3,10 +3,12 @@
  *******************************************************************************/
 #include <miopengemm/bundle.hpp>
 #include <miopengemm/derivedparams.hpp>
+#include <miopengemm/devicemodel.hpp>
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/kernelcache.hpp>
 #include <miopengemm/miogemm.hpp>
 #include <miopengemm/nearest.hpp>
+#include <miopengemm/predictor.hpp>
 #include <miopengemm/redirection.hpp>
 #include <miopengemm/timer.hpp>
 #include <miopengemm/tinyzero.hpp>
@@ -41,6 +43,11 @@ HyPas get_generic(const Geometry& gg, const Constraints& constraints)
   }
 
   hp.replace_where_defined(constraints);
+  // a triangle of C requires square macro tiles : the micro tiles of B as those of A
+  if (gg.uplo != Uplo::E::NONE)
+  {
+    hp.sus[Mat::E::B].vs[Chi::E::MIC] = hp.sus[Mat::E::A].vs[Chi::E::MIC];
+  }
   if (!Derivabilty(hp, gg).is_derivable)
   {
     std::stringstream errm;
@@ -53,9 +60,52 @@ HyPas get_generic(const Geometry& gg, const Constraints& constraints)
   return hp;
 }
 
+bool get_nearest_cached(const Geometry&    gg,
+                        const Constraints& constraints,
+                        const CacheKey&    ck,
+                        const Graph&       graph,
+                        const KernelCache& kernel_cache,
+                        size_t             rank,
+                        CacheKey&          nearest_ck,
+                        HyPas&             hp,
+                        owrite::Writer&    mowri)
+{
+  if (!nearest::is_within(ck, graph, kernel_cache, 0.1 * std::numeric_limits<double>::max(), rank))
+  {
+    return false;
+  }
+
+  nearest_ck            = nearest::get(ck, graph, kernel_cache, rank);
+  bool is_not_canonical = redirection::get_is_not_canonical(gg);
+  hp                    = kernel_cache.at(nearest_ck, is_not_canonical);
+  // the cached HyPas need not satisfy constraints, see nearest::get_projected
+  hp.replace_where_defined(constraints);
+
+  mowri << "Nearest match in kernel cache:\n" << nearest_ck.get_string() << Flush;
+
+  auto&& model = get_predictor();
+  if (!(nearest_ck == ck) && model.applies_to(ck.dvc))
+  {
+    hp = predictor::get_repaired(model, hp, gg, graph);
+    mowri << "Adjusted by predictor to " << hp.get_string() << Flush;
+  }
+  return true;
+}
+
+Solution get_default_soln(const oclutil::DevInfo& devinfo,
+                          const Geometry&         gg,
+                          const Constraints&      constraints,
+                          owrite::Writer&         mowri,
+                          IfNoCache::E            enoc,
+                          size_t                  rank)
+{
+  return get_default_soln(devinfo, gg, constraints, get_kernel_cache(), mowri, enoc, rank);
+}
+
 Solution get_default_soln(const oclutil::DevInfo& devinfo,
                           const Geometry&         gg,
                           const Constraints&      constraints,
+                          const KernelCache&      kernel_cache,
                           owrite::Writer&         mowri,
                           IfNoCache::E            enoc,
                           size_t                  rank)
@@ -64,26 +114,30 @@ Solution get_default_soln(const oclutil::DevInfo& devinfo,
   double extime = 0;
   HyPas  hp;
 
-  auto&& kernel_cache = get_kernel_cache();
-
   Timer timer;
   timer.start();
 
-  CacheKey ck(devinfo.identifier, constraints, gg);
-  Graph    graph(gg, devinfo, constraints, mowri);
+  // so that entries from the most similar device are preferred for devices not in the cache
+  devicemodel::register_device(devinfo);
+
+  CacheKey    ck(devinfo.identifier, constraints, gg);
+  auto        p_graph = get_graph(gg, devinfo, constraints);
+  const auto& graph   = *p_graph;
 
   bool   catch_ROCm_small_k = false;
   size_t ROCm_small_k       = 1;
 
+  CacheKey nearest_ck = ck;
   // TODO : check this.
   if ((catch_ROCm_small_k == false || gg.k > ROCm_small_k) &&
-      (nearest::is_within(ck, graph, kernel_cache, 0.1 * std::numeric_limits<double>::max(), rank)))
+      get_nearest_cached(gg, constraints, ck, graph, kernel_cache, rank, nearest_ck, hp, mowri))
   {
-    auto nearest_ck       = nearest::get(ck, graph, kernel_cache, rank);
-    bool is_not_canonical = redirection::get_is_not_canonical(gg);
-    hp                    = kernel_cache.at(nearest_ck, is_not_canonical);
-
-    mowri << "Nearest match in kernel cache:\n" << nearest_ck.get_string() << Flush;
+    // such as non-square macro tiles from the nearest match for a triangle of C
+    if (!Derivabilty(hp, gg).is_derivable && enoc == IfNoCache::GENERIC)
+    {
+      hp = get_generic(gg, constraints);
+      mowri << "Nearest match not derivable, returning generic.\n";
+    }
   }
 
   else
@@ -95,7 +149,7 @@ Solution get_default_soln(const oclutil::DevInfo& devinfo,
     }
     else
     {
-      hp = graph.get_random_valid_start();
+      hp = graph.get_random_valid_start(mowri);
       mowri << "No kernel cache match found, returning random valid.\n";
     }
   }
@@ -123,7 +177,7 @@ Solution find(float            allotted_time,
   cl_mem workspace_gpu = nullptr;
 
   Ver::E         e_ver              = verbose ? Ver::E::TERMINAL : Ver::E::SILENT;
-  std::string    constraints_string = enforce_determinism ? "C__ICE1" : "";
+  std::string    constraints_string = enforce_determinism ? "C_RED1" : "";
   Constraints    constraints(constraints_string);
   auto           find_params = get_at_least_n_seconds(static_cast<double>(allotted_time));
   owrite::Writer mowri(e_ver, "");
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <sstream>
+#include <miopengemm/derivedparams.hpp>
+#include <miopengemm/epilogue.hpp>
+#include <miopengemm/error.hpp>
+#include <miopengemm/geometry.hpp>
+#include <miopengemm/graph.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/miogemm.hpp>
+#include <miopengemm/multigemm.hpp>
+
+namespace MIOpenGEMM
+{
+
+MultiGemm::MultiGemm(size_t n_products_, size_t b_stride_, size_t c_stride_)
+  : n_products(n_products_), b_stride(b_stride_), c_stride(c_stride_)
+{
+  if (n_products == 0)
+  {
+    throw miog_error("invalid MultiGemm : there should be at least 1 product");
+  }
+}
+
+bool MultiGemm::is_single() const { return n_products == 1; }
+
+std::string MultiGemm::get_string() const
+{
+  if (is_single())
+  {
+    return "";
+  }
+  std::stringstream ss;
+  ss << "NPR" << n_products << "_BST" << b_stride << "_CST" << c_stride;
+  return ss.str();
+}
+
+Constraints MultiGemm::get_constraints() const
+{
+  if (is_single())
+  {
+    return Constraints("");
+  }
+  // B_i are loaded with vector width VEW_B from b_stride apart
+  std::string b_vew = b_stride % 4 == 0 ? "" : (b_stride % 2 == 0 ? "_VEW2" : "_VEW1");
+  return Constraints("B_WOS0" + b_vew + "__C_ICE1_STK0");
+}
+
+bool MultiGemm::operator==(const MultiGemm& rhs) const
+{
+  return n_products == rhs.n_products && b_stride == rhs.b_stride && c_stride == rhs.c_stride;
+}
+
+void confirm_multigemm(const MultiGemm&     multigemm,
+                       const Epilogue&      epilogue,
+                       const HyPas&         hp,
+                       const Geometry&      gg,
+                       const DerivedParams& dp)
+{
+  if (multigemm.is_single())
+  {
+    return;
+  }
+
+  std::stringstream errm;
+  if (dp.main_split_on_k != 0 || hp.sus[Mat::E::C].vs[NonChi::E::STK] != 0)
+  {
+    errm << "the products need the final value of each C_i in registers, so ICE must be 1 and "
+            "STK 0. ";
+  }
+  if (hp.sus[Mat::E::B].vs[Chi::E::WOS] != Scratch::E::UNUSED)
+  {
+    errm << "the B_i are loaded directly, so WOS of B must be 0. ";
+  }
+  if (multigemm.b_stride % hp.sus[Mat::E::B].vs[Chi::E::VEW] != 0)
+  {
+    errm << "b_stride should be a multiple of VEW of B. ";
+  }
+  if (multigemm.c_stride < gg.ldX[Mat::E::C] * gg.get_uncoal(Mat::E::C))
+  {
+    errm << "the C_i should not overlap : c_stride is less than ldc * "
+         << gg.get_uncoal(Mat::E::C) << ". ";
+  }
+  if (!epilogue.is_identity())
+  {
+    errm << "the products do not support an epilogue. ";
+  }
+  if (errm.str() != "")
+  {
+    throw miog_error("MultiGemm " + multigemm.get_string() + " : " + errm.str());
+  }
+}
+
+size_t get_lds_bytes(const MultiGemm& multigemm, const Geometry& gg, const DerivedParams& dp)
+{
+  return gg.derived.float_size_bytes_ab *
+         (dp.at(Mat::E::A).main_n_elements_in_padded_unroll +
+          multigemm.n_products * dp.at(Mat::E::B).main_n_elements_in_padded_unroll);
+}
+
+HyPas get_nearest_hypas(const MultiGemm&        multigemm,
+                        const oclutil::DevInfo& devinfo,
+                        const Geometry&         gg,
+                        const Constraints&      constraints,
+                        owrite::Writer&         mowri)
+{
+  CacheKey ck(devinfo.identifier, constraints, gg);
+  auto     p_graph      = get_graph(gg, devinfo, constraints);
+  auto&&   kernel_cache = get_kernel_cache();
+  CacheKey nearest_ck   = ck;
+  HyPas    hp;
+  for (size_t rank = 0;
+       get_nearest_cached(gg, constraints, ck, *p_graph, kernel_cache, rank, nearest_ck, hp, mowri);
+       ++rank)
+  {
+    if (Derivabilty(hp, gg).is_derivable &&
+        get_lds_bytes(multigemm, gg, DerivedParams(hp, gg)) < devinfo.device_local_mem_size)
+    {
+      return hp;
+    }
+  }
+  mowri << "No nearest match fits the LDS of " << multigemm.n_products
+        << " products, returning generic.\n";
+  return get_generic(gg, constraints);
+}
+}
@@ -3,6 +3,10 @@
  *******************************************************************************/
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <miopengemm/devicemodel.hpp>
 #include <miopengemm/nearest.hpp>
 
 namespace MIOpenGEMM
@@ -10,73 +14,241 @@ namespace MIOpenGEMM
 namespace nearest
 {
 
-bool is_within(
-  const CacheKey& ck, const Graph& graph, const KernelCache& kc, double threshold, size_t rank)
+namespace
+{
+// keys are at maximum distance unless they have the same bucket
+size_t get_bucket(const Geometry& gg)
+{
+  return 8 * gg.isColMajor + 4 * gg.tX[Mat::E::A] + 2 * gg.tX[Mat::E::B] + gg.tX[Mat::E::C];
+}
+
+// |log2(m) + log2(n) - log2(m') - log2(n')| is a lower bound on the distance between geometries
+// with the same transposes, except for the (non-symmetric, possibly negative) workspace term,
+// which is smaller than 1e-5 * log(2^64).
+double get_coord(const Geometry& gg)
+{
+  return std::log2(static_cast<double>(gg.m)) + std::log2(static_cast<double>(gg.n));
+}
+const double bound_slack = 1e-3;
+
+// per value defined in the constraints of the target which a cached HyPas does not have, so that
+// HyPas which need no projection are preferred
+const double projection_weight = 0.2;
+
+double get_projection_distance(const Constraints& constraints, const HyPas& hp)
+{
+  double distance = 0;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    auto& range = constraints.sub[emat].range;
+    for (size_t i = 0; i < range.size(); ++i)
+    {
+      distance += projection_weight *
+                  (range[i] != Status::E::UNDEFINED && range[i] != hp.sus[emat].vs[i]);
+    }
+  }
+  return distance;
+}
+
+// upper bound on the number of targets memoized
+const size_t max_memos = 1024;
+}
+
+Index::Index(const KernelCache& kc)
+{
+  keys = kc.get_keys();
+  // for determinism in the visiting order of equidistant keys
+  std::sort(keys.begin(), keys.end(), [](const CacheKey& a, const CacheKey& b) {
+    return a.concatenated < b.concatenated;
+  });
+
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    hps.push_back(kc.at(keys[i]));
+    buckets[get_bucket(keys[i].gg)].emplace_back(std::make_tuple(get_coord(keys[i].gg), i));
+  }
+  for (auto& x : buckets)
+  {
+    std::sort(x.second.begin(), x.second.end());
+  }
+}
+
+Index::Stream::Stream(const Index& index, const CacheKey& target_)
+  : p_index(&index), target(target_), coord(get_coord(target_.gg)), other(0)
+{
+  static const std::vector<dst_tup> empty_bucket;
+  auto                              bucket = index.buckets.find(get_bucket(target.gg));
+  p_bucket = bucket == index.buckets.end() ? &empty_bucket : &bucket->second;
+  auto start =
+    std::lower_bound(p_bucket->begin(), p_bucket->end(), std::make_tuple(coord, size_t(0)));
+  upper = start - p_bucket->begin();
+  lower = upper;
+}
+
+bool Index::Stream::next(size_t& key_index, double& distance)
 {
-  size_t count = 0;
-  for (auto& key : kc.get_keys())
+  auto& bucket = *p_bucket;
+  while (true)
   {
-    if (graph.contains(kc.at(key)) && key.get_distance(ck) < threshold &&
-        Derivabilty(kc.at(key), ck.gg).is_derivable)
+    // lower bound on the distance of all keys in the bucket not yet in the frontier
+    double bound      = std::numeric_limits<double>::max();
+    bool   from_lower = false;
+    bool   remaining  = false;
+    if (lower > 0)
     {
-      ++count;
-      if (count > rank)
+      bound      = coord - std::get<0>(bucket[lower - 1]);
+      from_lower = true;
+      remaining  = true;
+    }
+    if (upper < bucket.size())
+    {
+      if (std::get<0>(bucket[upper]) - coord < bound)
       {
-        return true;
+        bound      = std::get<0>(bucket[upper]) - coord;
+        from_lower = false;
       }
+      remaining = true;
+    }
+
+    if (!frontier.empty() && (!remaining || std::get<0>(frontier.top()) <= bound - bound_slack))
+    {
+      std::tie(distance, key_index) = frontier.top();
+      frontier.pop();
+      return true;
+    }
+
+    if (!remaining)
+    {
+      break;
+    }
+
+    size_t i = std::get<1>(from_lower ? bucket[--lower] : bucket[upper++]);
+    double distance_i = target.get_distance(p_index->keys[i]) +
+                        get_projection_distance(target.constraints, p_index->hps[i]);
+    frontier.emplace(std::make_tuple(distance_i, i));
+  }
+
+  // the keys with different transposes
+  auto bucket_id = get_bucket(target.gg);
+  for (; other < p_index->keys.size(); ++other)
+  {
+    if (get_bucket(p_index->keys[other].gg) != bucket_id)
+    {
+      key_index = other++;
+      distance  = std::numeric_limits<double>::max();
+      return true;
     }
   }
   return false;
 }
 
-// rank = 0 for nearest, 1 for second nearest etc.
-CacheKey get(const CacheKey& ck, const Graph& graph, const KernelCache& kc, size_t rank)
+bool Index::get_ranked(
+  const CacheKey& target, const Graph& graph, size_t rank, size_t& key_index, double& distance)
+  const
 {
-  if (!is_within(ck, graph, kc, std::numeric_limits<double>::max(), rank))
+  // the device which the HyPas must run on, more completely described than by target.dvc, and the
+  // constraints of the graph, which the accepted HyPas are in
+  devicemodel::Descriptor device(graph.get_devinfo());
+  std::string             memo_key = target.concatenated + '.' +
+                         graph.get_constraints().get_string() + '.' + device.get_string();
+
+  std::lock_guard<std::mutex> lock(memos_mutex);
+
+  auto memo = memos.find(memo_key);
+  if (memo == memos.end())
   {
-    throw miog_error("In get, with none within radius <double>::max.");
+    if (memos.size() >= max_memos)
+    {
+      memos.clear();
+    }
+    memo = memos.emplace(memo_key, Memo(*this, target)).first;
   }
 
-  auto cache_keys = kc.get_keys();
-  if (cache_keys.size() == 0)
+  auto& m = memo->second;
+  while (m.accepted.size() <= rank && !m.exhausted)
   {
-    throw miog_error("No cache keys. Possibly not included in kernelcache.cpp, very strange");
+    size_t i;
+    double d;
+    if (!m.stream.next(i, d))
+    {
+      m.exhausted = true;
+    }
+    else
+    {
+      HyPas hp = get_projected(hps[i], target.constraints);
+      if (graph.contains(hp) && Derivabilty(hp, target.gg).is_derivable &&
+          devicemodel::can_run(device, hp, target.gg))
+      {
+        m.accepted.push_back(i);
+        m.distances.push_back(d);
+      }
+    }
   }
 
-  using dst_tup = std::tuple<double, size_t>;
-  std::vector<dst_tup> v_di;
+  if (rank >= m.accepted.size())
+  {
+    return false;
+  }
+  key_index = m.accepted[rank];
+  distance  = m.distances[rank];
+  return true;
+}
 
-  for (size_t keyi = 0; keyi < cache_keys.size(); ++keyi)
+HyPas get_projected(const HyPas& hp, const Constraints& constraints)
+{
+  HyPas projected(hp);
+  projected.replace_where_defined(constraints);
+  return projected;
+}
+
+bool is_within(
+  const CacheKey& ck, const Graph& graph, const KernelCache& kc, double threshold, size_t rank)
+{
+  size_t key_index;
+  double distance;
+  return kc.get_index()->get_ranked(ck, graph, rank, key_index, distance) && distance < threshold;
+}
+
+// rank = 0 for nearest, 1 for second nearest etc.
+CacheKey get(const CacheKey& ck, const Graph& graph, const KernelCache& kc, size_t rank)
+{
+  auto   p_index = kc.get_index();
+  size_t key_index;
+  double distance;
+  if (p_index->keys.size() == 0)
   {
-    auto key      = cache_keys[keyi];
-    auto distance = ck.get_distance(key);
-    auto hp       = kc.at(key);
-    if (graph.contains(kc.at(key)) && Derivabilty(hp, ck.gg).is_derivable)
-    {
-      v_di.emplace_back(std::make_tuple(distance, keyi));
-    }
+    throw miog_error("No cache keys. Possibly not included in kernelcache.cpp, very strange");
   }
 
-  if (rank >= v_di.size())
+  if (!p_index->get_ranked(ck, graph, rank, key_index, distance))
   {
     throw miog_error("rank too large in get, too few candidates. Use is_within to check");
   }
 
-  std::nth_element(
-    v_di.begin(), v_di.begin() + rank, v_di.end(), [](const dst_tup& a, const dst_tup& b) {
-      return std::get<0>(a) < std::get<0>(b);
-    });
+  return p_index->keys[key_index];
+}
 
-  auto nearest_derivable = cache_keys[std::get<1>(v_di[rank])];
+std::vector<HyPas>
+get_adapted(const CacheKey& ck, const Graph& graph, const KernelCache& kc, size_t k)
+{
+  auto                    p_index = kc.get_index();
+  Index::Stream           stream(*p_index, ck);
+  devicemodel::Descriptor device(graph.get_devinfo());
 
-  // confirm derivability
-  Derivabilty drvble(kc.at(nearest_derivable), ck.gg);
-  if (!drvble.is_derivable)
+  std::vector<HyPas>                               adapted;
+  std::unordered_set<PackedHyPas, PackedHyPasHash> seen;
+  size_t                                           key_index;
+  double                                           distance;
+  while (adapted.size() < k && stream.next(key_index, distance))
   {
-    throw miog_error("internal logic error : nearest is not derivable. msg : " + drvble.msg);
+    HyPas hp = get_projected(p_index->hps[key_index], ck.constraints);
+    if (graph.contains(hp) && seen.insert(hp.get_packed()).second &&
+        Derivabilty(hp, ck.gg).is_derivable && devicemodel::can_run(device, hp, ck.gg))
+    {
+      adapted.push_back(hp);
+    }
   }
-
-  return nearest_derivable;
+  return adapted;
 }
 }
 }
@@ -44,7 +44,8 @@ class NormalFormGenerator : public prepgen::PrepGenerator
   {
     std::stringstream ss;
 
-    ss << "#define TFLOAT " << dp.t_float << '\n'
+    ss << dp.t_float_pragma_string << "#define TFLOAT " << dp.t_float << '\n'
+       << "#define TFLOAT_AB " << dp.t_float_ab << '\n'
        << "#define TINT" << Mem::M().name[emat_x] << " " << dp.tints[emat_x] << '\n'
        << "#define N_WORK_ITEMS_PER_GROUP " << dp.at(emat_x).cw2_local_work_size << '\n'
        << "#define UNROLL " << hp.sus[Mat::E::C].vs[NonChi::E::UNR] << '\n'
@@ -1159,6 +1159,23 @@ void DevInfo::initialise()
                      strict);
   driver_version = info_st.substr(0, info_size - 1);
 
+  cl_set_device_info(device,
+                     CL_DEVICE_EXTENSIONS,
+                     0,
+                     nullptr,
+                     &info_size,
+                     "obtaining the size of CL_DEVICE_EXTENSIONS",
+                     strict);
+  std::string extensions(info_size, ' ');
+  cl_set_device_info(device,
+                     CL_DEVICE_EXTENSIONS,
+                     extensions.size(),
+                     &extensions[0],
+                     nullptr,
+                     "obtaining CL_DEVICE_EXTENSIONS",
+                     strict);
+  device_fp16 = extensions.find("cl_khr_fp16") != std::string::npos;
+
   if (platinfo.vendor.find("vidia") != std::string::npos ||
       platinfo.vendor.find("NVIDIA") != std::string::npos)
   {
@@ -1237,6 +1254,7 @@ std::string DevInfo::get_string() const
   ss << "device_max_clock_frequency : " << device_max_clock_frequency << "\n";
   ss << "device_max_compute_units : " << device_max_compute_units << "\n";
   ss << "device_max_work_group_size : " << device_max_work_group_size << "\n";
+  ss << "device_fp16 : " << device_fp16 << "\n";
   ss << "(identifier) : " << identifier << "\n";
   ss << "\n";
 
@@ -0,0 +1,436 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <miopengemm/derivedparams.hpp>
+#include <miopengemm/predictor.hpp>
+#include <miopengemm/redirection.hpp>
+
+namespace MIOpenGEMM
+{
+namespace predictor
+{
+
+namespace
+{
+const std::string header = "MIOpenGEMM predictor 3";
+
+// predictors written before RED (1) and before STK (2) have no trees for them
+size_t get_n_c_trees(const std::string& line)
+{
+  if (line == "MIOpenGEMM predictor 1")
+  {
+    return NonChi::E::RED;
+  }
+  if (line == "MIOpenGEMM predictor 2")
+  {
+    return NonChi::E::STK;
+  }
+  if (line != header)
+  {
+    throw miog_error("predictor : expected header `" + header + "', not `" + line + "'");
+  }
+  return NonChi::E::N;
+}
+
+size_t get_n_params(Mat::E emat)
+{
+  return emat == Mat::E::C ? static_cast<size_t>(NonChi::E::N) : static_cast<size_t>(Chi::E::N);
+}
+
+double get_log2_alignment(size_t ld)
+{
+  size_t alignment = 0;
+  while (alignment < 10 && ld % (size_t(2) << alignment) == 0)
+  {
+    ++alignment;
+  }
+  return static_cast<double>(alignment);
+}
+
+// fits the tree below nodes[node_index] to the samples in indices (which it reorders)
+class TreeFitter
+{
+  public:
+  const std::vector<std::vector<double>>& x;
+  const std::vector<size_t>&              y;
+  const std::vector<size_t>&              values;
+  size_t                                  n_classes;
+  size_t                                  max_depth;
+  size_t                                  min_leaf;
+  Tree&                                   tree;
+
+  void fit(std::vector<size_t>::iterator begin,
+           std::vector<size_t>::iterator end,
+           size_t                        node_index,
+           size_t                        depth)
+  {
+    size_t              n_samples = end - begin;
+    std::vector<size_t> counts(n_classes, 0);
+    for (auto it = begin; it != end; ++it)
+    {
+      ++counts[y[*it]];
+    }
+    size_t majority = std::max_element(counts.begin(), counts.end()) - counts.begin();
+
+    tree.nodes[node_index] = {-1, 0, 0, 0, values[majority]};
+    if (depth >= max_depth || n_samples < 2 * min_leaf || counts[majority] == n_samples)
+    {
+      return;
+    }
+
+    // minimising the Gini impurity of a split is maximising sum_c nL_c^2 / nL + nR_c^2 / nR
+    double parent_score = 0;
+    for (auto c : counts)
+    {
+      parent_score += static_cast<double>(c * c) / n_samples;
+    }
+
+    int    best_feature   = -1;
+    double best_threshold = 0;
+    double best_score     = parent_score + 1e-9;
+
+    std::vector<size_t> order(begin, end);
+    for (size_t f = 0; f < x[0].size(); ++f)
+    {
+      std::sort(order.begin(), order.end(), [this, f](size_t a, size_t b) {
+        return x[a][f] < x[b][f];
+      });
+      std::vector<size_t> left(n_classes, 0);
+      std::vector<size_t> right(counts);
+      double              left_sq  = 0;
+      double              right_sq = 0;
+      for (auto c : counts)
+      {
+        right_sq += static_cast<double>(c * c);
+      }
+      for (size_t i = 0; i + 1 < n_samples; ++i)
+      {
+        size_t c = y[order[i]];
+        left_sq += 2. * left[c] + 1;
+        right_sq -= 2. * right[c] - 1;
+        ++left[c];
+        --right[c];
+        size_t n_left = i + 1;
+        if (n_left < min_leaf || n_samples - n_left < min_leaf ||
+            x[order[i]][f] == x[order[i + 1]][f])
+        {
+          continue;
+        }
+        double score = left_sq / n_left + right_sq / (n_samples - n_left);
+        if (score > best_score)
+        {
+          best_score     = score;
+          best_feature   = static_cast<int>(f);
+          best_threshold = 0.5 * (x[order[i]][f] + x[order[i + 1]][f]);
+        }
+      }
+    }
+
+    if (best_feature < 0)
+    {
+      return;
+    }
+
+    auto middle = std::partition(begin, end, [this, best_feature, best_threshold](size_t i) {
+      return x[i][best_feature] < best_threshold;
+    });
+
+    size_t left_index  = tree.nodes.size();
+    size_t right_index = left_index + 1;
+    tree.nodes.resize(tree.nodes.size() + 2);
+    tree.nodes[node_index] = {best_feature, best_threshold, left_index, right_index, 0};
+    fit(begin, middle, left_index, depth + 1);
+    fit(middle, end, right_index, depth + 1);
+  }
+};
+}
+
+const std::vector<std::string>& get_feature_names()
+{
+  static const std::vector<std::string> names = {"log2_m",
+                                                 "log2_n",
+                                                 "log2_k",
+                                                 "log2_m_over_n",
+                                                 "tA",
+                                                 "tB",
+                                                 "float_size",
+                                                 "log2_pad_a",
+                                                 "log2_pad_b",
+                                                 "log2_pad_c",
+                                                 "log2_align_a",
+                                                 "log2_align_b",
+                                                 "log2_align_c"};
+  return names;
+}
+
+std::vector<double> get_features(const Geometry& gg)
+{
+  std::vector<double> features{std::log2(static_cast<double>(gg.m)),
+                               std::log2(static_cast<double>(gg.n)),
+                               std::log2(static_cast<double>(gg.k)),
+                               std::log2(static_cast<double>(gg.m) / gg.n),
+                               static_cast<double>(gg.tX[Mat::E::A]),
+                               static_cast<double>(gg.tX[Mat::E::B]),
+                               static_cast<double>(gg.derived.float_size_bytes)};
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    features.push_back(std::log2(1. + gg.ldX[emat] - gg.get_coal(emat)));
+  }
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    features.push_back(get_log2_alignment(gg.ldX[emat]));
+  }
+  return features;
+}
+
+size_t Tree::predict(const std::vector<double>& x) const
+{
+  size_t i = 0;
+  while (nodes[i].feature >= 0)
+  {
+    i = x[nodes[i].feature] < nodes[i].threshold ? nodes[i].left : nodes[i].right;
+  }
+  return nodes[i].value;
+}
+
+Predictor::Predictor(const std::string&           dvc_,
+                     const std::vector<Geometry>& geometries,
+                     const std::vector<HyPas>&    hps,
+                     size_t                       max_depth,
+                     size_t                       min_leaf)
+  : dvc(dvc_)
+{
+  if (geometries.size() != hps.size() || geometries.size() == 0)
+  {
+    throw miog_error("Predictor needs the same (non-zero) number of geometries and HyPas");
+  }
+
+  std::vector<std::vector<double>> x;
+  for (auto& gg : geometries)
+  {
+    x.push_back(get_features(gg));
+  }
+
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    for (size_t p = 0; p < get_n_params(emat); ++p)
+    {
+      // classes are the distinct values of the hyper-parameter
+      std::vector<size_t> values;
+      for (auto& hp : hps)
+      {
+        values.push_back(hp.sus[emat].vs.at(p));
+      }
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+
+      std::vector<size_t> y;
+      for (auto& hp : hps)
+      {
+        y.push_back(std::lower_bound(values.begin(), values.end(), hp.sus[emat].vs[p]) -
+                    values.begin());
+      }
+
+      Tree tree;
+      tree.nodes.resize(1);
+      TreeFitter          fitter{x, y, values, values.size(), max_depth, min_leaf, tree};
+      std::vector<size_t> indices(hps.size());
+      std::iota(indices.begin(), indices.end(), 0);
+      fitter.fit(indices.begin(), indices.end(), 0, 0);
+      trees[emat].push_back(tree);
+    }
+  }
+}
+
+bool Predictor::is_empty() const { return trees[Mat::E::C].size() == 0; }
+
+bool Predictor::applies_to(const std::string& device) const
+{
+  return !is_empty() && (dvc.size() == 0 || dvc == device);
+}
+
+HyPas Predictor::predict(const Geometry& gg) const
+{
+  if (is_empty())
+  {
+    throw miog_error("predict called on an empty Predictor");
+  }
+  auto                        x = get_features(gg);
+  std::array<SuHy, Mat::E::N> sus;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    std::vector<size_t> vs;
+    for (auto& tree : trees[emat])
+    {
+      vs.push_back(tree.predict(x));
+    }
+    sus[emat] = SuHy(emat, std::move(vs));
+  }
+  return HyPas(std::move(sus));
+}
+
+std::string Predictor::get_string() const
+{
+  std::stringstream ss;
+  ss << header << '\n' << dvc << '\n' << std::setprecision(17);
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    for (auto& tree : trees[emat])
+    {
+      ss << tree.nodes.size() << '\n';
+      for (auto& node : tree.nodes)
+      {
+        ss << node.feature << ' ' << node.threshold << ' ' << node.left << ' ' << node.right << ' '
+           << node.value << '\n';
+      }
+    }
+  }
+  return ss.str();
+}
+
+Predictor from_string(const std::string& str)
+{
+  std::stringstream ss(str);
+  std::string       line;
+  std::getline(ss, line);
+  size_t n_c_trees = get_n_c_trees(line);
+
+  Predictor predictor;
+  std::getline(ss, predictor.dvc);
+  auto n_features = get_feature_names().size();
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    size_t n_params = emat == Mat::E::C ? n_c_trees : get_n_params(emat);
+    for (size_t p = 0; p < n_params; ++p)
+    {
+      Tree   tree;
+      size_t n_nodes = 0;
+      ss >> n_nodes;
+      tree.nodes.resize(n_nodes);
+      for (auto& node : tree.nodes)
+      {
+        ss >> node.feature >> node.threshold >> node.left >> node.right >> node.value;
+        if (node.feature >= static_cast<int>(n_features) ||
+            (node.feature >= 0 && (node.left >= n_nodes || node.right >= n_nodes)))
+        {
+          throw miog_error("predictor : invalid tree node");
+        }
+      }
+      if (!ss || n_nodes == 0)
+      {
+        throw miog_error("predictor : truncated, or too few trees");
+      }
+      predictor.trees[emat].push_back(tree);
+    }
+  }
+
+  // RED and STK : partial sums are not reduced and there are no persistent work groups, as in
+  // the HyPas it was trained on
+  for (size_t p = n_c_trees; p < NonChi::E::N; ++p)
+  {
+    Tree   tree;
+    size_t value = p == NonChi::E::RED ? static_cast<size_t>(Binary::E::NO) : 0;
+    tree.nodes.push_back({-1, 0, 0, 0, value});
+    predictor.trees[Mat::E::C].push_back(tree);
+  }
+  return predictor;
+}
+
+void write(const Predictor& predictor, const std::string& filename)
+{
+  std::ofstream fout(filename, std::ios::out);
+  if (!fout.good())
+  {
+    throw miog_error("failed to open predictor file `" + filename + "' for writing");
+  }
+  fout << predictor.get_string();
+}
+
+Predictor read(const std::string& filename)
+{
+  std::ifstream fin(filename, std::ios::in);
+  if (!fin.good())
+  {
+    throw miog_error("failed to open predictor file `" + filename + "'");
+  }
+  std::stringstream ss;
+  ss << fin.rdbuf();
+  return from_string(ss.str());
+}
+
+HyPas get_repaired(const Predictor& predictor,
+                   const HyPas&     start,
+                   const Geometry&  gg,
+                   const Graph&     graph)
+{
+  bool  swap_ab   = redirection::get_is_not_canonical(gg);
+  HyPas predicted = predictor.predict(redirection::get_canonical(gg)).get_reflected(swap_ab);
+
+  HyPas hp = start;
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    for (size_t p = 0; p < hp.sus[emat].vs.size(); ++p)
+    {
+      if (predicted.sus[emat].vs[p] != hp.sus[emat].vs[p])
+      {
+        HyPas candidate           = hp;
+        candidate.sus[emat].vs[p] = predicted.sus[emat].vs[p];
+        if (graph.contains(candidate) && Derivabilty(candidate, gg).is_derivable)
+        {
+          hp = candidate;
+        }
+      }
+    }
+  }
+  return hp;
+}
+}
+
+namespace
+{
+std::string       predictor_path;
+std::mutex        predictor_path_mutex;
+std::atomic<bool> predictor_loaded{false};
+
+predictor::Predictor init_predictor()
+{
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(predictor_path_mutex);
+    predictor_loaded = true;
+    path             = predictor_path;
+  }
+  if (path.size() == 0 && std::getenv("MIOPENGEMM_PREDICTOR") != nullptr)
+  {
+    path = std::getenv("MIOPENGEMM_PREDICTOR");
+  }
+  return path.size() > 0 ? predictor::read(path) : predictor::Predictor();
+}
+}
+
+void set_predictor_path(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(predictor_path_mutex);
+  if (predictor_loaded)
+  {
+    throw miog_error("set_predictor_path called after the predictor was first used");
+  }
+  predictor_path = path;
+}
+
+const predictor::Predictor& get_predictor()
+{
+  static const predictor::Predictor predictor = init_predictor();
+  return predictor;
+}
+}
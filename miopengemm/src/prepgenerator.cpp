@@ -49,8 +49,9 @@ void PrepGenerator::set_usage()
 
 void PrepGenerator::append_basic_what_definitions(std::stringstream& ss)
 {
-  ss << "#define TFLOAT  " << dp.t_float << "\n"
-     << "#define LD" << MCHAR << " " << gg.ldX.at(emat_x) << "\n"
+  ss << dp.t_float_pragma_string << "#define TFLOAT  " << dp.t_float << "\n"
+     << "#define TFLOAT_AB  " << dp.t_float_ab << "\n"
+     << dp.t_float_complex_string << "#define LD" << MCHAR << " " << gg.ldX.at(emat_x) << "\n"
      << "/* less than or equal to LD" << MCHAR
      << ", DIM_COAL is size in the contiguous direction (m for c matrix if col "
      << "contiguous and not transposed) */ \n"
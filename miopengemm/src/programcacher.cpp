@@ -8,6 +8,7 @@
 #include <miopengemm/geometry.hpp>
 #include <miopengemm/hyperparams.hpp>
 #include <miopengemm/miogemm.hpp>
+#include <miopengemm/multigemm.hpp>
 #include <miopengemm/programcacher.hpp>
 #include <miopengemm/programs.hpp>
 #include <miopengemm/timer.hpp>
@@ -52,9 +53,24 @@ namespace MIOpenGEMM
 // available_IDs.push_back(ID);
 //}
 
+namespace
+{
+// get device id and name from ptr_queue.
+std::string get_device_name(cl_command_queue* ptr_queue, cl_device_id& device_id)
+{
+  clGetCommandQueueInfo(*ptr_queue, CL_QUEUE_DEVICE, sizeof(cl_device_id), &device_id, nullptr);
+  size_t      info_size(0);
+  std::string info_st(400, ' ');
+  clGetDeviceInfo(device_id, CL_DEVICE_NAME, info_st.size(), &info_st[0], &info_size);
+  return info_st.substr(0, info_size - 1);
+}
+}
+
 int ProgramCacher::get_ID_from_geom(const Geometry&   gg,
                                     BetaType          betatype,
-                                    cl_command_queue* ptr_queue)
+                                    cl_command_queue* ptr_queue,
+                                    const Epilogue&   epilogue,
+                                    const MultiGemm&  multigemm)
 {
   return get_ID(gg.isColMajor,
                 gg.tX[Mat::E::A],
@@ -69,7 +85,10 @@ int ProgramCacher::get_ID_from_geom(const Geometry&   gg,
                 gg.wSpaceSize,
                 betatype,
                 gg.floattype,
-                ptr_queue);
+                ptr_queue,
+                epilogue,
+                multigemm,
+                gg.uplo);
 }
 
 int ProgramCacher::get_ID(bool              isColMajor,
@@ -85,7 +104,10 @@ int ProgramCacher::get_ID(bool              isColMajor,
                           size_t            w_size,
                           BetaType          beta_type,
                           char              floattype,
-                          cl_command_queue* ptr_queue)
+                          cl_command_queue* ptr_queue,
+                          const Epilogue&   epilogue,
+                          const MultiGemm&  multigemm,
+                          Uplo::E           uplo)
 {
 
   std::unique_lock<std::mutex> lock(mutt);
@@ -93,18 +115,12 @@ int ProgramCacher::get_ID(bool              isColMajor,
   int               ID = -1;
   std::stringstream ss;
 
-  // get device id from ptr_queue.
   cl_device_id device_id;
-  clGetCommandQueueInfo(*ptr_queue, CL_QUEUE_DEVICE, sizeof(cl_device_id), &device_id, nullptr);
-
-  // Getting device name.
-  size_t      info_size(0);
-  std::string info_st(400, ' ');
-  clGetDeviceInfo(device_id, CL_DEVICE_NAME, info_st.size(), &info_st[0], &info_size);
-  std::string device_name = info_st.substr(0, info_size - 1);
+  std::string  device_name = get_device_name(ptr_queue, device_id);
 
   ss << isColMajor << tA << tB << tC << '.' << m << '.' << n << '.' << k << '.' << lda << '.' << ldb
-     << '.' << ldc << '.' << w_size << '.' << beta_type << '.' << floattype << '.' << device_name;
+     << '.' << ldc << '.' << w_size << '.' << beta_type << '.' << floattype << '.' << device_name
+     << '.' << epilogue.get_string() << '.' << multigemm.get_string() << '.' << uplo;
 
   auto key = ss.str();
 
@@ -121,13 +137,40 @@ int ProgramCacher::get_ID(bool              isColMajor,
     oclutil::cl_set_command_queue_info(
       *ptr_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, nullptr, "GEMM", true);
 
-    size_t      rank = 0;
-    Constraints constraints("");
-    Geometry    gg(isColMajor, tA, tB, tC, lda, ldb, ldc, m, n, k, w_size, floattype);
+    // the epilogue is applied to the final value of C : no split on k. A triangle of C is
+    // neither split on k nor streamed (see DerivedParams)
+    if (uplo != Uplo::E::NONE && !multigemm.is_single())
+    {
+      throw miog_error("a triangle of C is not supported with products with one A");
+    }
+    size_t      rank        = 0;
+    Constraints constraints = multigemm.is_single()
+                                ? Constraints(uplo != Uplo::E::NONE
+                                                ? "C_ICE1_STK0"
+                                                : (epilogue.is_identity() ? "" : "C_ICE1"))
+                                : multigemm.get_constraints();
+    Geometry gg(
+      isColMajor, tA, tB, tC, lda, ldb, ldc, m, n, k, w_size, floattype, false, false, uplo);
 
     oclutil::DevInfo devinfo(*ptr_queue);
     auto             soln =
       get_default_soln(devinfo, gg, constraints, silent_mowri, IfNoCache::E::GENERIC, rank);
+    if (!epilogue.is_identity() || !multigemm.is_single())
+    {
+      // the nearest HyPas is derivable for a single product, which has less LDS
+      if (get_lds_bytes(multigemm, gg, DerivedParams(soln.hypas, gg)) >=
+          devinfo.device_local_mem_size)
+      {
+        soln.hypas = get_nearest_hypas(multigemm, devinfo, gg, constraints, silent_mowri);
+      }
+      DerivedParams dp(soln.hypas, gg);
+      if (get_lds_bytes(multigemm, gg, dp) >= devinfo.device_local_mem_size)
+      {
+        throw miog_error("the " + std::to_string(multigemm.n_products) +
+                         " products need more LDS than the device has, use fewer products");
+      }
+      soln.v_tgks = kerngen::get_kernblobs(soln.hypas, gg, dp, epilogue, multigemm);
+    }
 
     std::vector<KernBlob> v_blobs;
 
@@ -165,6 +208,41 @@ int ProgramCacher::get_ID(bool              isColMajor,
   return ID;
 }
 
+int ProgramCacher::get_ID_from_kernblob(const KernBlob& kblob, cl_command_queue* ptr_queue)
+{
+
+  std::unique_lock<std::mutex> lock(mutt);
+
+  cl_device_id device_id;
+  std::string  key = "kernblob." + get_device_name(ptr_queue, device_id) + '.' + kblob.kernstr;
+
+  if (IDs.count(key) != 0)
+  {
+    return IDs[key];
+  }
+
+  static owrite::Writer silent_mowri(Ver::E::SILENT, "");
+  cl_context            context;
+  oclutil::cl_set_command_queue_info(
+    *ptr_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, nullptr, "GEMM", true);
+
+  int ID = current_ID;
+  ++current_ID;
+  if (current_ID >= max_cache_size)
+  {
+    std::stringstream errm;
+    errm << "Number of programs exceeded limit of max_cache_size = " << max_cache_size << '.';
+    throw miog_error(errm.str());
+  }
+
+  program_cache[ID] = Programs(device_id, context, silent_mowri);
+  IDs[key]          = ID;
+
+  lock.unlock();
+  program_cache[ID].update({kblob});
+  return ID;
+}
+
 ProgramCacher& get_cacher()
 {
   static ProgramCacher cacher;
@@ -2,6 +2,7 @@
  * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
  *******************************************************************************/
 #include <algorithm>
+#include <complex>
 #include <iostream>
 #include <miopengemm/error.hpp>
 #include <miopengemm/platform.hpp>
@@ -138,6 +139,58 @@ template void redirect(bool&         isColMajor,
                        const float*& a,
                        const float*& b);
 
+template void redirect(bool&        isColMajor,
+                       bool&        tA,
+                       bool&        tB,
+                       bool&        tC,
+                       size_t&      m,
+                       size_t&      n,
+                       size_t&      lda,
+                       size_t&      ldb,
+                       size_t&      a_offset,
+                       size_t&      b_offset,
+                       const half*& a,
+                       const half*& b);
+
+template void redirect(bool&                       isColMajor,
+                       bool&                       tA,
+                       bool&                       tB,
+                       bool&                       tC,
+                       size_t&                     m,
+                       size_t&                     n,
+                       size_t&                     lda,
+                       size_t&                     ldb,
+                       size_t&                     a_offset,
+                       size_t&                     b_offset,
+                       const std::complex<float>*& a,
+                       const std::complex<float>*& b);
+
+template void redirect(bool&                        isColMajor,
+                       bool&                        tA,
+                       bool&                        tB,
+                       bool&                        tC,
+                       size_t&                      m,
+                       size_t&                      n,
+                       size_t&                      lda,
+                       size_t&                      ldb,
+                       size_t&                      a_offset,
+                       size_t&                      b_offset,
+                       const std::complex<double>*& a,
+                       const std::complex<double>*& b);
+
+template void redirect(bool&          isColMajor,
+                       bool&          tA,
+                       bool&          tB,
+                       bool&          tC,
+                       size_t&        m,
+                       size_t&        n,
+                       size_t&        lda,
+                       size_t&        ldb,
+                       size_t&        a_offset,
+                       size_t&        b_offset,
+                       const int8_t*& a,
+                       const int8_t*& b);
+
 void redirect(bool&        isColMajor,
               bool&        tA,
               bool&        tB,
@@ -188,12 +241,14 @@ void confirm_redirection(bool isColMajor, bool tC)
   }
 }
 
+// a conjugate transpose is a transpose : the conjugation stays with the matrix when A and B swap
 class SimpleBundle
 {
   public:
   size_t ldx;
   Mat::E emat;
-  SimpleBundle(size_t ldx_, Mat::E e_) : ldx(ldx_), emat(e_) {}
+  bool   conj;
+  SimpleBundle(size_t ldx_, Mat::E e_, bool conj_) : ldx(ldx_), emat(e_), conj(conj_) {}
 };
 
 Geometry get_canonical(const Geometry& gg, bool& swap_ab)
@@ -204,10 +259,16 @@ Geometry get_canonical(const Geometry& gg, bool& swap_ab)
   bool         tC         = gg.tX[Mat::E::C];
   size_t       m          = gg.m;
   size_t       n          = gg.n;
-  SimpleBundle sba(gg.ldX[Mat::E::A], Mat::E::A);
-  SimpleBundle sbb(gg.ldX[Mat::E::B], Mat::E::B);
+  SimpleBundle sba(gg.ldX[Mat::E::A], Mat::E::A, gg.cX[Mat::E::A]);
+  SimpleBundle sbb(gg.ldX[Mat::E::B], Mat::E::B, gg.cX[Mat::E::B]);
   redirect_base(isColMajor, tA, tB, tC, m, n, sba, sbb);
   swap_ab = (sba.emat == Mat::E::B);
+  // swapping A and B transposes C : a triangle of C is the other triangle of C^T
+  Uplo::E uplo = gg.uplo;
+  if (swap_ab && uplo != Uplo::E::NONE)
+  {
+    uplo = uplo == Uplo::E::LOWER ? Uplo::E::UPPER : Uplo::E::LOWER;
+  }
   return {isColMajor,
           tA,
           tB,
@@ -219,7 +280,10 @@ Geometry get_canonical(const Geometry& gg, bool& swap_ab)
           n,
           gg.k,
           gg.wSpaceSize,
-          gg.floattype};
+          gg.floattype,
+          sba.conj,
+          sbb.conj,
+          uplo};
 }
 
 Geometry get_canonical(const Geometry& gg)
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <sstream>
+#include <miopengemm/error.hpp>
+#include <miopengemm/reducegenerator.hpp>
+
+namespace MIOpenGEMM
+{
+namespace reducegen
+{
+
+ReduceGenerator::ReduceGenerator(const HyPas& hp_, const Geometry& gg_, const DerivedParams& dp_)
+
+  : bylinegen::ByLineGenerator(Mat::E::C, hp_, gg_, dp_)
+{
+}
+
+void ReduceGenerator::set_type() { type = "reduce"; }
+
+size_t ReduceGenerator::get_local_work_size() { return dp.red_local_work_size; }
+
+size_t ReduceGenerator::get_work_per_thread() { return dp.red_work_per_thread; }
+
+KType::E ReduceGenerator::get_ktype() { return KType::E::REDUCE; }
+
+void ReduceGenerator::set_usage()
+{
+  u_a     = false;
+  u_b     = false;
+  u_c     = true;
+  u_w     = true;
+  u_alpha = true;
+  u_beta  = true;
+}
+
+void ReduceGenerator::setup_additional()
+{
+  if (dp.main_writes_partials == 0)
+  {
+    throw miog_error("the reduction kernel requires ICE != 1 and RED = 1");
+  }
+
+  description_string = R"(
+/* ****************************************************
+* It is used to sum the partial sums of the work groups
+* splitting k (ICE), always in the same order, and to
+* perform C <- alpha*sum + beta*C. It replaces the atomic
+* increments to C of the main kernel, which are not
+* deterministic.
+****************************************************** */ )";
+
+  std::string partial_sum = R"(
+/* the partial sums, in a fixed order */
+partial = partials + i;
+sum = *partial;
+for (TSHORT z = 1; z < N_PARTIALS; ++z){
+partial += PARTIAL_STRIDE;
+sum += *partial;
+}
+)";
+
+  inner_work_string =
+    partial_sum +
+    (gg.derived.is_complex()
+       ? "/* beta scaling and alpha increment */\n"
+         "if (beta.x <= 0 && beta.x >= 0 && beta.y <= 0 && beta.y >= 0)"
+         "{c[i] = 0;}else{c[i] = CMUL(beta, c[i]);}\nc[i] += CMUL(alpha, sum);"
+       : "/* beta scaling and alpha increment */\n"
+         "if (beta <= 0 && beta >= 0){c[i] = 0;}else{c[i] *= beta;}\nc[i] += alpha*sum;");
+}
+
+void ReduceGenerator::append_derived_definitions_additional(std::stringstream& ss)
+{
+  ss << "#define TFLOAT_ACC  " << dp.t_float_acc << "\n"
+     << "#define N_PARTIALS " << hp.sus[Mat::E::C].vs[NonChi::E::ICE] << "\n"
+     << "#define GLOBAL_OFFSET_PARTIALS " << dp.red_global_offset << "\n"
+     << "#define PARTIAL_STRIDE " << dp.red_partial_stride << "\n";
+}
+
+void ReduceGenerator::append_positioning_w_string(std::stringstream& ss)
+{
+  ss << R"(
+
+/* the partial sums (of TFLOAT_ACC) are at the same position in their C footprints as c */
+const __global TFLOAT_ACC * partials = (const __global TFLOAT_ACC *)(w + w_offset + GLOBAL_OFFSET_PARTIALS);
+partials += start_uncoal * LDC;
+partials += start_coal;
+const __global TFLOAT_ACC * partial;
+TFLOAT_ACC sum;
+)";
+}
+
+KernBlob get_reduce_kernelstring(const HyPas& hp, const Geometry& gg, const DerivedParams& dp)
+{
+  ReduceGenerator rg(hp, gg, dp);
+  rg.setup();
+  return rg.get_kernelstring();
+}
+}
+}
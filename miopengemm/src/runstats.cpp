@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <miopengemm/error.hpp>
+#include <miopengemm/runstats.hpp>
+
+namespace MIOpenGEMM
+{
+
+namespace
+{
+
+// Student's t quantiles for degrees of freedom 1 ... 30, beyond which the normal is used
+double get_t_quantile(double df, const std::vector<double>& table, double normal)
+{
+  if (df < 1)
+  {
+    return table[0];
+  }
+  size_t i = static_cast<size_t>(df);
+  return i <= table.size() ? table[i - 1] : normal;
+}
+
+// 0.975 quantiles, for two-sided 95% intervals
+double get_t975(double df)
+{
+  static const std::vector<double> table{
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  return get_t_quantile(df, table, 1.960);
+}
+
+// 0.95 quantiles, for one-sided tests at 95%
+double get_t95(double df)
+{
+  static const std::vector<double> table{
+    6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+    1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+    1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697};
+  return get_t_quantile(df, table, 1.645);
+}
+
+double get_upper_median(std::vector<double> x)
+{
+  std::nth_element(x.begin(), x.begin() + x.size() / 2, x.end());
+  return x[x.size() / 2];
+}
+}
+
+RunStats::RunStats(const std::vector<double>& times, double outlier_mads)
+{
+  if (times.size() == 0)
+  {
+    throw miog_error("no times to summarise in RunStats constructor");
+  }
+
+  double              raw_median = get_upper_median(times);
+  std::vector<double> deviations;
+  for (auto t : times)
+  {
+    deviations.push_back(std::abs(t - raw_median));
+  }
+  // 1.4826 scales the MAD to the standard deviation, for normally distributed times
+  double scaled_mad = 1.4826 * get_upper_median(deviations);
+
+  std::vector<double> kept;
+  for (auto t : times)
+  {
+    if (scaled_mad == 0 || std::abs(t - raw_median) <= outlier_mads * scaled_mad)
+    {
+      kept.push_back(t);
+    }
+  }
+
+  min    = *std::min_element(times.begin(), times.end());
+  median = raw_median;
+  mean   = std::accumulate(times.begin(), times.end(), 0.) / times.size();
+
+  n_runs     = kept.size();
+  n_outliers = times.size() - kept.size();
+  kept_mean  = std::accumulate(kept.begin(), kept.end(), 0.) / n_runs;
+
+  double sum_squares = 0;
+  for (auto t : kept)
+  {
+    sum_squares += (t - kept_mean) * (t - kept_mean);
+  }
+  stddev = n_runs > 1 ? std::sqrt(sum_squares / (n_runs - 1)) : 0;
+
+  double half_width = n_runs > 1 ? get_t975(n_runs - 1) * stddev / std::sqrt(n_runs) : 0;
+  ci_lower          = kept_mean - half_width;
+  ci_upper          = kept_mean + half_width;
+}
+
+double RunStats::get(SummStat::E sumstat) const
+{
+  switch (sumstat)
+  {
+  case SummStat::E::MAX: return min;
+  case SummStat::E::MEDIAN: return median;
+  case SummStat::E::MEAN: return mean;
+  case SummStat::E::N: throw miog_error("N not allowed in SummStat in RunStats::get");
+  }
+  throw miog_error("unrecognised SummStat in RunStats::get");
+}
+
+std::string RunStats::get_string() const
+{
+  std::stringstream ss;
+  ss << "runs " << n_runs << " (+" << n_outliers << " outliers)  min " << min << "  median "
+     << median << "  mean " << mean << " (" << kept_mean << " without outliers)  95% ci ["
+     << ci_lower << ", " << ci_upper << "] ms";
+  return ss.str();
+}
+
+bool is_faster(const RunStats& candidate,
+               const RunStats& incumbent,
+               BestTest::E     besttest,
+               SummStat::E     sumstat,
+               double          improvement_factor)
+{
+  switch (besttest)
+  {
+  case BestTest::E::RATIO:
+    return improvement_factor * incumbent.get(sumstat) >= candidate.get(sumstat);
+
+  case BestTest::E::WELCH:
+  {
+    double v_c = candidate.stddev * candidate.stddev / candidate.n_runs;
+    double v_i = incumbent.stddev * incumbent.stddev / incumbent.n_runs;
+    if (v_c + v_i == 0)
+    {
+      return improvement_factor * incumbent.kept_mean >= candidate.kept_mean;
+    }
+    double t = (incumbent.kept_mean - candidate.kept_mean) / std::sqrt(v_c + v_i);
+    // Welch-Satterthwaite degrees of freedom
+    double df = (v_c + v_i) * (v_c + v_i) /
+                ((candidate.n_runs > 1 ? v_c * v_c / (candidate.n_runs - 1) : 0) +
+                 (incumbent.n_runs > 1 ? v_i * v_i / (incumbent.n_runs - 1) : 0));
+    return t > get_t95(df);
+  }
+
+  case BestTest::E::DISJOINT: return candidate.ci_upper < incumbent.ci_lower;
+
+  case BestTest::E::N: throw miog_error("N not allowed in BestTest in is_faster");
+  }
+  throw miog_error("unrecognised BestTest in is_faster");
+}
+}
@@ -150,5 +150,12 @@ set_multigeom_abc(const MatData<float>& v_abc, const std::vector<Geometry>&, con
 template void set_abcw(const MatData<double>& v_abcw, const Geometry& gg, const Offsets& toff);
 
 template void set_abcw(const MatData<float>& v_abcw, const Geometry& gg, const Offsets& toff);
+
+template void set_abc(const MatData<half>& v_abc, const Geometry& gg, const Offsets& toff);
+
+template void
+set_multigeom_abc(const MatData<half>& v_abc, const std::vector<Geometry>&, const Offsets& toff);
+
+template void set_abcw(const MatData<half>& v_abcw, const Geometry& gg, const Offsets& toff);
 }
 }
@@ -35,6 +35,7 @@ std::string Solution::get_cache_entry_string() const
   return MIOpenGEMM::get_cache_entry_string(
     {devinfo.identifier, constraints, redirection::get_canonical(geometry)},
     hypas,
-    redirection::get_is_not_canonical(geometry));
+    redirection::get_is_not_canonical(geometry),
+    stats.n_runs > 0 ? stats.get_string() : "");
 }
 }
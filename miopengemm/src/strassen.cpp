@@ -0,0 +1,526 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/error.hpp>
+#include <miopengemm/floattostring.hpp>
+#include <miopengemm/gemm.hpp>
+#include <miopengemm/programcacher.hpp>
+#include <miopengemm/strassen.hpp>
+
+namespace MIOpenGEMM
+{
+namespace strassen
+{
+
+size_t View::get_row_stride(bool isColMajor) const { return isColMajor != transposed ? 1 : ld; }
+
+size_t View::get_col_stride(bool isColMajor) const { return isColMajor != transposed ? ld : 1; }
+
+View View::get_block(bool isColMajor, size_t row, size_t col, size_t n_rows, size_t n_cols) const
+{
+  return {mem,
+          offset + row * n_rows * get_row_stride(isColMajor) +
+            col * n_cols * get_col_stride(isColMajor),
+          ld,
+          transposed};
+}
+
+namespace
+{
+
+// the elements of one level : 4 sums of blocks of A, 4 of B, and the 7 sub-products
+size_t get_level_size(size_t m, size_t n, size_t k)
+{
+  return 4 * (m / 2) * (k / 2) + 4 * (k / 2) * (n / 2) + 7 * (m / 2) * (n / 2);
+}
+
+View get_workspace_view(bool isColMajor, size_t offset, size_t n_rows, size_t n_cols)
+{
+  return {Mem::E::W, offset, isColMajor ? n_rows : n_cols, false};
+}
+
+// the 4 blocks (11, 12, 21, 22) of op(X), each n_rows x n_cols
+std::vector<View> get_blocks(bool isColMajor, const View& x, size_t n_rows, size_t n_cols)
+{
+  return {x.get_block(isColMajor, 0, 0, n_rows, n_cols),
+          x.get_block(isColMajor, 0, 1, n_rows, n_cols),
+          x.get_block(isColMajor, 1, 0, n_rows, n_cols),
+          x.get_block(isColMajor, 1, 1, n_rows, n_cols)};
+}
+
+Step get_sums_step(const std::vector<View>&             in,
+                   const std::vector<View>&             out,
+                   const std::vector<std::vector<int>>& coefs,
+                   size_t                               n_rows,
+                   size_t                               n_cols,
+                   bool                                 scaled)
+{
+  Step step{};
+  step.is_product = false;
+  step.sums       = {in, out, coefs, n_rows, n_cols, scaled};
+  return step;
+}
+
+// c = a b (scaled : c = alpha a b + beta c) with levels levels, using the workspace from w_start
+void append_steps(const Geometry&    gg,
+                  const View&        a,
+                  const View&        b,
+                  const View&        c,
+                  size_t             m,
+                  size_t             n,
+                  size_t             k,
+                  size_t             levels,
+                  bool               scaled,
+                  size_t             w_start,
+                  std::vector<Step>& steps)
+{
+  if (levels == 0)
+  {
+    Step step{};
+    step.is_product = true;
+    step.product    = {a, b, c, m, n, k, scaled};
+    steps.push_back(step);
+    return;
+  }
+
+  bool   cm = gg.isColMajor;
+  size_t hm = m / 2;
+  size_t hn = n / 2;
+  size_t hk = k / 2;
+
+  std::vector<View> s, t, p;
+  size_t            w_at = w_start;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    s.push_back(get_workspace_view(cm, w_at, hm, hk));
+    w_at += hm * hk;
+  }
+  for (size_t i = 0; i < 4; ++i)
+  {
+    t.push_back(get_workspace_view(cm, w_at, hk, hn));
+    w_at += hk * hn;
+  }
+  for (size_t i = 0; i < 7; ++i)
+  {
+    p.push_back(get_workspace_view(cm, w_at, hm, hn));
+    w_at += hm * hn;
+  }
+
+  auto a_blocks = get_blocks(cm, a, hm, hk);
+  auto b_blocks = get_blocks(cm, b, hk, hn);
+  auto c_blocks = get_blocks(cm, c, hm, hn);
+
+  // Winograd's sums, from the blocks 11, 12, 21, 22 :
+  // S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2
+  // T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21
+  steps.push_back(get_sums_step(
+    a_blocks, s, {{0, 0, 1, 1}, {-1, 0, 1, 1}, {1, 0, -1, 0}, {1, 1, -1, -1}}, hm, hk, false));
+  steps.push_back(get_sums_step(
+    b_blocks, t, {{-1, 1, 0, 0}, {1, -1, 0, 1}, {0, -1, 0, 1}, {1, -1, -1, 1}}, hk, hn, false));
+
+  // P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4, P5 = S1 T1, P6 = S2 T2, P7 = S3 T3
+  std::vector<std::array<View, 2>> factors = {{{a_blocks[0], b_blocks[0]}},
+                                              {{a_blocks[1], b_blocks[2]}},
+                                              {{s[3], b_blocks[3]}},
+                                              {{a_blocks[3], t[3]}},
+                                              {{s[0], t[0]}},
+                                              {{s[1], t[1]}},
+                                              {{s[2], t[2]}}};
+  for (size_t i = 0; i < 7; ++i)
+  {
+    append_steps(
+      gg, factors[i][0], factors[i][1], p[i], hm, hn, hk, levels - 1, false, w_at, steps);
+  }
+
+  // C11 = P1 + P2, C12 = P1 + P6 + P5 + P3, C21 = P1 + P6 + P7 - P4, C22 = P1 + P6 + P7 + P5
+  steps.push_back(get_sums_step(p,
+                                c_blocks,
+                                {{1, 1, 0, 0, 0, 0, 0},
+                                 {1, 0, 1, 0, 1, 1, 0},
+                                 {1, 0, 0, -1, 0, 1, 1},
+                                 {1, 0, 0, 0, 1, 1, 1}},
+                                hm,
+                                hn,
+                                scaled));
+}
+
+std::string get_element(const Geometry& gg, const View& v)
+{
+  std::stringstream ss;
+  ss << static_cast<char>(std::tolower(Mem::M().name[v.mem])) << '[' << v.offset << " + row*"
+     << v.get_row_stride(gg.isColMajor) << " + col*" << v.get_col_stride(gg.isColMajor) << ']';
+  return ss.str();
+}
+
+std::string get_sum(const std::vector<int>& coefs, const std::string& prefix)
+{
+  std::stringstream ss;
+  for (size_t i = 0; i < coefs.size(); ++i)
+  {
+    if (coefs[i] != 0)
+    {
+      bool first = ss.str().empty();
+      ss << (coefs[i] < 0 ? (first ? "-" : " - ") : (first ? "" : " + ")) << prefix << i;
+    }
+  }
+  return ss.str();
+}
+
+template <typename T>
+T get_value(const std::vector<int>& coefs, const std::vector<T>& x)
+{
+  T sum = 0;
+  for (size_t i = 0; i < coefs.size(); ++i)
+  {
+    sum += static_cast<T>(coefs[i]) * x[i];
+  }
+  return sum;
+}
+}
+
+size_t get_levels(const Geometry& gg, size_t max_levels_user)
+{
+  if (gg.floattype != 'f' && gg.floattype != 'd')
+  {
+    return 0;
+  }
+  size_t levels = 0;
+  size_t m      = gg.m;
+  size_t n      = gg.n;
+  size_t k      = gg.k;
+  while (levels < std::min(max_levels, max_levels_user) && std::min({m, n, k}) >= min_dim &&
+         m % 2 == 0 && n % 2 == 0 && k % 2 == 0)
+  {
+    m /= 2;
+    n /= 2;
+    k /= 2;
+    ++levels;
+  }
+  return levels;
+}
+
+size_t get_workspace_size(const Geometry& gg, size_t levels)
+{
+  size_t w_size = 0;
+  size_t m      = gg.m;
+  size_t n      = gg.n;
+  size_t k      = gg.k;
+  for (size_t l = 0; l < levels; ++l)
+  {
+    w_size += get_level_size(m, n, k);
+    m /= 2;
+    n /= 2;
+    k /= 2;
+  }
+  return w_size;
+}
+
+Plan get_plan(const Geometry& gg, size_t levels)
+{
+  std::stringstream errm;
+  if (levels > max_levels)
+  {
+    errm << "at most " << max_levels << " levels are supported, not " << levels << ". ";
+  }
+  if (gg.floattype != 'f' && gg.floattype != 'd')
+  {
+    errm << "only fp32 and fp64 are supported, not floattype " << gg.floattype << ". ";
+  }
+  size_t divisor = size_t(1) << levels;
+  if (gg.m % divisor != 0 || gg.n % divisor != 0 || gg.k % divisor != 0)
+  {
+    errm << "m, n and k should be divisible by 2^levels = " << divisor << ". ";
+  }
+  if (errm.str() != "")
+  {
+    throw miog_error("Strassen-Winograd with " + std::to_string(levels) + " levels : " +
+                     errm.str());
+  }
+
+  Plan plan;
+  plan.gg             = gg;
+  plan.levels         = levels;
+  plan.workspace_size = get_workspace_size(gg, levels);
+  View a{Mem::E::A, 0, gg.ldX[Mat::E::A], gg.tX[Mat::E::A]};
+  View b{Mem::E::B, 0, gg.ldX[Mat::E::B], gg.tX[Mat::E::B]};
+  View c{Mem::E::C, 0, gg.ldX[Mat::E::C], gg.tX[Mat::E::C]};
+  append_steps(gg, a, b, c, gg.m, gg.n, gg.k, levels, true, 0, plan.steps);
+  return plan;
+}
+
+KernBlob get_sums_kernblob(const Plan& plan, const Sums& sums)
+{
+  const Geometry& gg = plan.gg;
+
+  std::array<bool, Mem::E::N> uses{};
+  for (auto& views : {sums.in, sums.out})
+  {
+    for (auto& v : views)
+    {
+      uses[v.mem] = true;
+    }
+  }
+
+  size_t local_work_size  = 256;
+  size_t n_groups         = (sums.n_rows * sums.n_cols + local_work_size - 1) / local_work_size;
+  size_t global_work_size = n_groups * local_work_size;
+
+  std::stringstream ss;
+  ss << R"(
+/* ****************************************************
+* It is used by the Strassen-Winograd layer, to form the
+* sums of the blocks of A and of B in the workspace, and
+* to combine the sub-products into the blocks of C.
+* Each work item processes one element of each block.
+****************************************************** */
+)";
+  ss << "\n#define TFLOAT " << floattostring::get_float_string(gg.floattype) << '\n'
+     << "#define N_ROWS " << sums.n_rows << '\n'
+     << "#define N_COLS " << sums.n_cols << '\n'
+     << "#define N_WORK_ITEMS_PER_GROUP " << local_work_size << "\n\n"
+     << "__attribute__((reqd_work_group_size(N_WORK_ITEMS_PER_GROUP,1,1)))\n"
+     << "__kernel void miog_strassen_sums\n(";
+
+  // the inputs and outputs may be in the same buffer (the workspace), at different offsets
+  size_t n_args = 0;
+  for (auto x : {Mem::E::A, Mem::E::B, Mem::E::C, Mem::E::W})
+  {
+    if (uses[x])
+    {
+      char name     = static_cast<char>(std::tolower(Mem::M().name[x]));
+      bool is_input = x == Mem::E::A || x == Mem::E::B;
+      ss << (n_args == 0 ? "" : ",") << "\n__global " << (is_input ? "const " : "") << "TFLOAT * "
+         << (is_input ? "restrict " : "") << name << ", \nconst ulong " << name << "_offset";
+      ++n_args;
+    }
+  }
+  if (sums.scaled)
+  {
+    ss << ",\nconst TFLOAT alpha,\nconst TFLOAT beta";
+  }
+  ss << ")\n{\n"
+     << "const ulong global_id = get_global_id(0);\n"
+     << "if (global_id >= N_ROWS * N_COLS)\n{\nreturn;\n}\n";
+
+  if (gg.isColMajor)
+  {
+    ss << "/* consecutive work items process consecutive rows (contiguous in the workspace) */\n"
+       << "const ulong row = global_id % N_ROWS;\nconst ulong col = global_id / N_ROWS;\n";
+  }
+  else
+  {
+    ss << "/* consecutive work items process consecutive columns (contiguous in the workspace) */\n"
+       << "const ulong row = global_id / N_COLS;\nconst ulong col = global_id % N_COLS;\n";
+  }
+
+  for (auto x : {Mem::E::A, Mem::E::B, Mem::E::C, Mem::E::W})
+  {
+    if (uses[x])
+    {
+      char name = static_cast<char>(std::tolower(Mem::M().name[x]));
+      ss << name << " += " << name << "_offset;\n";
+    }
+  }
+
+  for (size_t i = 0; i < sums.in.size(); ++i)
+  {
+    ss << "const TFLOAT x" << i << " = " << get_element(gg, sums.in[i]) << ";\n";
+  }
+  ss << "TFLOAT y;\n";
+  for (size_t o = 0; o < sums.out.size(); ++o)
+  {
+    std::string target = get_element(gg, sums.out[o]);
+    ss << "y = " << get_sum(sums.coefs[o], "x") << ";\n";
+    if (sums.scaled)
+    {
+      ss << "if (beta <= 0 && beta >= 0){" << target << " = alpha*y;}else{" << target
+         << " = alpha*y + beta*" << target << ";}\n";
+    }
+    else
+    {
+      ss << target << " = y;\n";
+    }
+  }
+  ss << "}\n";
+
+  return {KType::E::ADD,
+          {uses[Mem::E::A], uses[Mem::E::B], uses[Mem::E::C], uses[Mem::E::W], sums.scaled,
+           sums.scaled},
+          ss.str(),
+          "miog_strassen_sums",
+          global_work_size,
+          local_work_size};
+}
+
+template <typename T>
+void run(const Plan&                          plan,
+         T                                    alpha,
+         T                                    beta,
+         const std::array<cl_mem, Mem::E::N>& gpu_mems,
+         const std::array<size_t, Mem::E::N>& offsets,
+         cl_command_queue*                    ptr_queue,
+         cl_uint                              num_events_in_wait_list,
+         const cl_event*                      event_wait_list,
+         cl_event*                            ptr_event)
+{
+  const Geometry& gg      = plan.gg;
+  size_t          n_steps = plan.steps.size();
+
+  // each step waits for the previous one, the first for the user's events
+  std::vector<cl_event> events(n_steps);
+  for (size_t si = 0; si < n_steps; ++si)
+  {
+    cl_uint         n_wait     = si == 0 ? num_events_in_wait_list : 1;
+    const cl_event* wait_list  = si == 0 ? event_wait_list : &events[si - 1];
+    cl_event*       step_event = si + 1 == n_steps ? ptr_event : &events[si];
+    const Step&     step       = plan.steps[si];
+
+    if (step.is_product)
+    {
+      const Product& pr = step.product;
+      xgemm<T>(gg.isColMajor,
+               pr.a.transposed,
+               pr.b.transposed,
+               pr.m,
+               pr.n,
+               pr.k,
+               pr.scaled ? alpha : T(1),
+               gpu_mems[pr.a.mem],
+               offsets[pr.a.mem] + pr.a.offset,
+               pr.a.ld,
+               gpu_mems[pr.b.mem],
+               offsets[pr.b.mem] + pr.b.offset,
+               pr.b.ld,
+               pr.scaled ? beta : T(0),
+               gpu_mems[pr.c.mem],
+               offsets[pr.c.mem] + pr.c.offset,
+               pr.c.ld,
+               nullptr,
+               0,
+               0,
+               ptr_queue,
+               n_wait,
+               wait_list,
+               step_event,
+               -1);
+    }
+    else
+    {
+      KernBlob        kblob    = get_sums_kernblob(plan, step.sums);
+      int             ID       = get_cacher().get_ID_from_kernblob(kblob, ptr_queue);
+      const Programs& programs = get_cacher().program_cache[ID];
+      AllKernArgs     all_kern_args{
+        kerngen::get_arg_sizes_values(kblob, gpu_mems, offsets, sizeof(T), &alpha, &beta)};
+      programs.run(*ptr_queue, all_kern_args, n_wait, wait_list, nullptr, step_event, false);
+    }
+  }
+
+  for (size_t si = 0; si + 1 < n_steps; ++si)
+  {
+    oclutil::cl_release_event(events[si], "strassen::run", true);
+  }
+}
+
+template void run<float>(const Plan&,
+                         float,
+                         float,
+                         const std::array<cl_mem, Mem::E::N>&,
+                         const std::array<size_t, Mem::E::N>&,
+                         cl_command_queue*,
+                         cl_uint,
+                         const cl_event*,
+                         cl_event*);
+
+template void run<double>(const Plan&,
+                          double,
+                          double,
+                          const std::array<cl_mem, Mem::E::N>&,
+                          const std::array<size_t, Mem::E::N>&,
+                          cl_command_queue*,
+                          cl_uint,
+                          const cl_event*,
+                          cl_event*);
+
+template <typename T>
+void cpu_run(const Plan& plan, const T* a, const T* b, T* c, T* w, T alpha, T beta)
+{
+  const Geometry& gg = plan.gg;
+  owrite::Writer  silent_mowri(Ver::E::SILENT, "");
+
+  std::array<T*, Mem::E::N> ptrs;
+  ptrs[Mem::E::A] = const_cast<T*>(a);
+  ptrs[Mem::E::B] = const_cast<T*>(b);
+  ptrs[Mem::E::C] = c;
+  ptrs[Mem::E::W] = w;
+
+  for (auto& step : plan.steps)
+  {
+    if (step.is_product)
+    {
+      const Product& pr = step.product;
+      Geometry       sub_gg(gg.isColMajor,
+                      pr.a.transposed,
+                      pr.b.transposed,
+                      pr.c.transposed,
+                      pr.a.ld,
+                      pr.b.ld,
+                      pr.c.ld,
+                      pr.m,
+                      pr.n,
+                      pr.k,
+                      0,
+                      gg.floattype);
+      cpugemm::gemm<T>(sub_gg,
+                       Offsets(pr.a.offset, pr.b.offset, pr.c.offset, 0, 0, 0, 0, 0),
+                       ptrs[pr.a.mem],
+                       ptrs[pr.b.mem],
+                       ptrs[pr.c.mem],
+                       pr.scaled ? alpha : T(1),
+                       pr.scaled ? beta : T(0),
+                       silent_mowri);
+      continue;
+    }
+
+    const Sums&    sums = step.sums;
+    std::vector<T> x(sums.in.size());
+    for (size_t row = 0; row < sums.n_rows; ++row)
+    {
+      for (size_t col = 0; col < sums.n_cols; ++col)
+      {
+        auto element = [&gg, row, col](const View& v) {
+          return v.offset + row * v.get_row_stride(gg.isColMajor) +
+                 col * v.get_col_stride(gg.isColMajor);
+        };
+        for (size_t i = 0; i < sums.in.size(); ++i)
+        {
+          x[i] = ptrs[sums.in[i].mem][element(sums.in[i])];
+        }
+        for (size_t o = 0; o < sums.out.size(); ++o)
+        {
+          T& target = ptrs[sums.out[o].mem][element(sums.out[o])];
+          T  y      = get_value(sums.coefs[o], x);
+          if (!sums.scaled)
+          {
+            target = y;
+          }
+          else
+          {
+            target = (beta <= 0 && beta >= 0) ? alpha * y : alpha * y + beta * target;
+          }
+        }
+      }
+    }
+  }
+}
+
+template void cpu_run<float>(const Plan&, const float*, const float*, float*, float*, float, float);
+
+template void
+cpu_run<double>(const Plan&, const double*, const double*, double*, double*, double, double);
+}
+}
@@ -16,7 +16,8 @@ namespace stringutil
 void indentify(std::string& source)
 {
   std::string newsource;
-  newsource.reserve(source.length());
+  // room for the indentation, so that newsource is not reallocated
+  newsource.reserve(source.length() + source.length() / 2);
   std::string::size_type last_lend = source.find("\n", 0);
 
   if (std::string::npos == last_lend)
@@ -51,10 +52,10 @@ void indentify(std::string& source)
 
     else
     {
-      newsource.append("\n");
-      for (int i = 0; i < indent_level; ++i)
+      newsource += '\n';
+      if (indent_level > 0)
       {
-        newsource.append("  ");
+        newsource.append(2 * indent_level, ' ');
       }
       newsource.append(source, last_lend + 1, next_lend - last_lend - 1);
       last_lend = next_lend;
@@ -62,7 +63,7 @@ void indentify(std::string& source)
     }
   }
 
-  newsource += source.substr(last_lend);
+  newsource.append(source, last_lend, std::string::npos);
   source.swap(newsource);
 }
 
@@ -98,6 +98,13 @@ TinyOne<TFl>::TinyOne(
     errm << "the size from the template parameter is " << sizeof(TFl) << ".";
     throw miog_error(errm.str());
   }
+
+  if (gg.derived.is_mixed() || gg.derived.is_complex())
+  {
+    throw miog_error("TinyOne has one real host type for A, B and C, it does not support the "
+                     "mixed precision, integer or complex floattype " +
+                     std::string(1, gg.floattype) + ". Use TinyZero (device memories).");
+  }
 }
 
 template <typename TFl>
@@ -213,6 +220,9 @@ std::vector<std::vector<double>> TinyOne<TFl>::benchgemm(const std::vector<HyPas
   return times_s;
 }
 
+template <typename TFl>
+void TinyOne<TFl>::prepare(const HyPas& hp) { up_jinx->prepare(hp); }
+
 template <typename TFl>
 Solution TinyOne<TFl>::find1(const FindParams& find_params, const Constraints& constraints)
 {
@@ -325,5 +335,6 @@ void TinyOne<TFl>::accuracy_test(const HyPas& hp)  //, const TFl* c_true_for_tes
 
 template class TinyOne<float>;
 template class TinyOne<double>;
+template class TinyOne<half>;
 }
 }
@@ -39,6 +39,7 @@ TinyTwo::TinyTwo(Geometry gg_, Offsets toff_, owrite::Writer& mowri_, const CLHi
 
   case 'f': f_moa.reset(new TinyOne<float>(gg_, toff_, mowri_, xhint)); break;
   case 'd': d_moa.reset(new TinyOne<double>(gg_, toff_, mowri_, xhint)); break;
+  case 'h': h_moa.reset(new TinyOne<half>(gg_, toff_, mowri_, xhint)); break;
   default: throw miog_error("unrecognised floattype char in TinyTwo constructor");
   }
 
@@ -51,6 +52,7 @@ std::vector<std::vector<double>> TinyTwo::benchgemm(const std::vector<HyPas>& hp
   {
   case 'f': return f_moa->benchgemm(hps, hl);
   case 'd': return d_moa->benchgemm(hps, hl);
+  case 'h': return h_moa->benchgemm(hps, hl);
   default: throw miog_error("unrecognised floattype char in TinyTwo benchgemm");
   }
 }
@@ -62,6 +64,7 @@ void TinyTwo::accuracy_test(const HyPas& hp)
   {
   case 'f': f_moa->accuracy_test(hp); break;
   case 'd': d_moa->accuracy_test(hp); break;
+  case 'h': h_moa->accuracy_test(hp); break;
   default: throw miog_error("unrecognised floattype char in TinyTwo accuracy_test with 1 parm");
   }
 }
@@ -72,6 +75,7 @@ Solution TinyTwo::find2(const FindParams& find_params, const Constraints& constr
   {
   case 'f': return f_moa->find1(find_params, constraints);
   case 'd': return d_moa->find1(find_params, constraints);
+  case 'h': return h_moa->find1(find_params, constraints);
   default: throw miog_error("unrecognised floattype char in TinyTwo find");
   }
 }
@@ -88,6 +92,12 @@ std::unique_ptr<TinyOne<double>>& TinyTwo::get_up_moa<double>()
   return d_moa;
 }
 
+template <>
+std::unique_ptr<TinyOne<half>>& TinyTwo::get_up_moa<half>()
+{
+  return h_moa;
+}
+
 template <>
 void TinyTwo::set_active_type<float>()
 {
@@ -99,5 +109,11 @@ void TinyTwo::set_active_type<double>()
 {
   active_type = 'd';
 }
+
+template <>
+void TinyTwo::set_active_type<half>()
+{
+  active_type = 'h';
+}
 }
 }
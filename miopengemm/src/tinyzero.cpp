@@ -10,6 +10,7 @@
 #include <sstream>
 #include <thread>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 #include <miopengemm/architests.hpp>
 #include <miopengemm/bundle.hpp>
@@ -44,6 +45,45 @@ void FindTracker::incr_kernels() { ++kernels; }
 
 size_t FindTracker::get_descents() const { return descents; }
 
+void FindTracker::record_gflops(double gflops)
+{
+  if (improvements.size() == 0 || gflops > std::get<1>(improvements.back()))
+  {
+    improvements.emplace_back(std::make_tuple(timer.get_elapsed(), gflops));
+  }
+}
+
+void FindTracker::record_drift(double drift) { drifts.push_back(drift); }
+
+std::string FindTracker::get_drift_string() const
+{
+  std::stringstream ss;
+  ss << drifts.size() << " re-measurements of the incumbent";
+  if (drifts.size() > 0)
+  {
+    auto minmax = std::minmax_element(drifts.begin(), drifts.end());
+    ss << ", drift in [" << *minmax.first << ", " << *minmax.second << ']';
+  }
+  return ss.str();
+}
+
+double FindTracker::get_time_to_within(double fraction) const
+{
+  if (improvements.size() == 0)
+  {
+    return std::numeric_limits<double>::max();
+  }
+  double best_gflops = std::get<1>(improvements.back());
+  for (auto& x : improvements)
+  {
+    if (std::get<1>(x) >= fraction * best_gflops)
+    {
+      return std::get<0>(x);
+    }
+  }
+  return std::get<0>(improvements.back());
+}
+
 std::string FindTracker::get_string() const
 {
   auto format = [](const size_t& x) { return std::string("") + stringutil::get_padded(x, 7); };
@@ -108,7 +148,8 @@ TinyZero::TinyZero(cl_command_queue command_queue_,
   oclutil::cl_set_context_and_device_from_command_queue(
     command_queue, context, device_id, mowri, true);
 
-  programs = Programs(device_id, context, mowri);
+  programs           = Programs(device_id, context, mowri);
+  incumbent_programs = Programs(device_id, context, mowri);
 }
 
 void TinyZero::address_check_valid()
@@ -178,7 +219,7 @@ std::string TinyZero::get_run_times_heading()
   return ss.str();
 }
 
-std::string TinyZero::get_run_time_string(cl_int status)
+std::string TinyZero::get_run_time_string(cl_int status, const Programs& progs)
 {
   std::stringstream ss;
   if (status == CL_SUCCESS)
@@ -186,9 +227,9 @@ std::string TinyZero::get_run_time_string(cl_int status)
     ss << std::fixed << std::setprecision(3) << kernel_times.extime << '\t';
 
     double sumtimes{0};
-    for (size_t k_ind = 0; k_ind < programs.get_n_active(); ++k_ind)
+    for (size_t k_ind = 0; k_ind < progs.get_n_active(); ++k_ind)
     {
-      double tk = kernel_times.ktimes[programs.act_inds[k_ind]].v_times.back();
+      double tk = kernel_times.ktimes[progs.act_inds[k_ind]].v_times.back();
       sumtimes += tk;
       ss << " " << tk << "\t";
     }
@@ -203,7 +244,8 @@ std::string TinyZero::get_run_time_string(cl_int status)
   return ss.str();
 }
 
-oclutil::Result TinyZero::true_core(std::function<void(std::string)> acton,
+oclutil::Result TinyZero::true_core(const Programs&                  progs,
+                                    std::function<void(std::string)> acton,
                                     std::vector<double>&             all_times,
                                     const Halt&                      hl,
                                     const AllKernArgs&               all_kern_args)
@@ -220,7 +262,7 @@ oclutil::Result TinyZero::true_core(std::function<void(std::string)> acton,
 
     // see `overheat' comment at bottom
 
-    if (programs.get_n_active() == 0)
+    if (progs.get_n_active() == 0)
     {
       throw miog_error("zero kernels active : internal logic error");
     }
@@ -231,13 +273,13 @@ oclutil::Result TinyZero::true_core(std::function<void(std::string)> acton,
     bool update_times = false;
     bool debug_mode   = false;
 
-    oclr = programs.run(command_queue,
-                        all_kern_args,
-                        update_times,
-                        nullptr,
-                        &kernel_times,
-                        &safe_last_event.clevent,
-                        debug_mode);
+    oclr = progs.run(command_queue,
+                     all_kern_args,
+                     update_times,
+                     nullptr,
+                     &kernel_times,
+                     &safe_last_event.clevent,
+                     debug_mode);
 
     if (oclr.success == CL_SUCCESS)
     {
@@ -265,7 +307,7 @@ oclutil::Result TinyZero::true_core(std::function<void(std::string)> acton,
     oclutil::cl_flush(command_queue, "cl flush in core gemm loop", true);
 
     // act on the results string.
-    acton(get_run_time_string(oclr.success));
+    acton(get_run_time_string(oclr.success, progs));
 
     ++runi;
     all_times.push_back(kernel_times.extime);
@@ -307,10 +349,107 @@ std::vector<double> TinyZero::benchgemm(const HyPas& hp, const Halt& hl)
         << "Entering the core gemm loops" << Endl << get_run_times_heading();
 
   std::vector<double> all_times;
-  true_core([this](std::string x) { mowri << x << '\n'; }, all_times, hl, all_kern_args);
+  true_core(
+    programs, [this](std::string x) { mowri << x << '\n'; }, all_times, hl, all_kern_args);
   return all_times;
 }
 
+void TinyZero::prepare(const HyPas& hp)
+{
+  Derivabilty dblt(hp, gg);
+  if (dblt.is_derivable == false)
+  {
+    throw miog_error("Non-derivable in prepare : " + dblt.msg);
+  }
+
+  kerngen::Bundle  bundle(hp, gg);
+  architests::Stat atr(command_queue, bundle.dp, gg, hp);
+  if (!atr.is_good)
+  {
+    throw miog_error(atr.msg);
+  }
+  programs.update(bundle.v_tgks);
+}
+
+RunStats TinyZero::get_run_stats(const std::vector<KernBlob>& kblobs, const Halt& hl)
+{
+  programs.update(kblobs);
+  return get_run_stats(programs, kblobs, hl);
+}
+
+RunStats
+TinyZero::get_run_stats(const Programs& progs, const std::vector<KernBlob>& kblobs, const Halt& hl)
+{
+  auto all_kern_args = get_all_kern_args(kblobs);
+
+  std::vector<double> times;
+  kernel_times.reset_times();
+  auto oclr = true_core(progs, [](std::string) {}, times, hl, all_kern_args);
+  if (oclr.fail() || times.size() == 0)
+  {
+    return {};
+  }
+  return RunStats(times);
+}
+
+double TinyZero::get_quick_time(const HyPas& hp, const Halt& hl)
+{
+  kerngen::Bundle  bundle(hp, gg);
+  architests::Stat atr(devinfo, bundle.dp, gg, hp);
+  if (!atr.is_good)
+  {
+    return std::numeric_limits<double>::max();
+  }
+
+  auto stats = get_run_stats(bundle.v_tgks, hl);
+  return stats.n_runs == 0 ? std::numeric_limits<double>::max() : stats.min;
+}
+
+std::vector<HyPas> TinyZero::get_warm_starts(const Constraints& constraints,
+                                             const FindParams&  fparms,
+                                             FindTracker&       ftrack)
+{
+  CacheKey ck(devinfo.identifier, constraints, gg);
+  auto     p_graph          = get_graph(gg, devinfo, constraints);
+  bool     is_not_canonical = redirection::get_is_not_canonical(gg);
+  auto candidates = nearest::get_adapted(ck, *p_graph, get_kernel_cache(), fparms.n_warm_starts);
+
+  // a few runs each, and at most a quarter of the find time on this stage
+  Halt   quick_halt({{1, 3}}, {{0, 0.02}});
+  double allotted = 0.25 * fparms.hl_outer.max_time;
+
+  using time_index = std::tuple<double, size_t>;
+  std::vector<time_index> v_ti;
+  for (size_t ci = 0; ci < candidates.size() && ftrack.get_elapsed() < allotted; ++ci)
+  {
+    // get_adapted checks in the canonical frame, the graph is in the frame of gg
+    candidates[ci] = candidates[ci].get_reflected(is_not_canonical);
+    if (!p_graph->contains(candidates[ci]) || !is_dvble(candidates[ci], gg))
+    {
+      continue;
+    }
+    double t = get_quick_time(candidates[ci], quick_halt);
+    ftrack.incr_kernels();
+    if (t < std::numeric_limits<double>::max())
+    {
+      v_ti.emplace_back(std::make_tuple(t, ci));
+    }
+  }
+  std::sort(v_ti.begin(), v_ti.end());
+
+  mowri << "Warm starts (" << v_ti.size() << " of " << candidates.size()
+        << " nearest cache entries benchmarked) :\n";
+  std::vector<HyPas> warm_starts;
+  for (auto& x : v_ti)
+  {
+    warm_starts.push_back(candidates[std::get<1>(x)]);
+    mowri << gg.get_gflops(std::get<0>(x) / 1000.) << " gflops  "
+          << warm_starts.back().get_string() << '\n';
+  }
+  mowri << Flush;
+  return warm_starts;
+}
+
 AllKernArgs TinyZero::get_all_kern_args(const std::vector<KernBlob>& kblobs) const
 {
 
@@ -319,12 +458,13 @@ AllKernArgs TinyZero::get_all_kern_args(const std::vector<KernBlob>& kblobs) con
   for (auto& kblob : kblobs)
   {
 
-    all_kern_args.emplace_back(kerngen::get_arg_sizes_values(kblob,
-                                                             gpum.cl_mems,
-                                                             toff.offsets,
-                                                             gg.derived.float_size_bytes,
-                                                             Floating::get_m_alpha()[gg.floattype],
-                                                             Floating::get_m_beta()[gg.floattype]));
+    all_kern_args.emplace_back(
+      kerngen::get_arg_sizes_values(kblob,
+                                    gpum.cl_mems,
+                                    toff.offsets,
+                                    gg.derived.float_size_bytes_scalar,
+                                    Floating::get_m_alpha()[gg.derived.floattype_scalar],
+                                    Floating::get_m_beta()[gg.derived.floattype_scalar]));
   }
 
   return all_kern_args;
@@ -346,10 +486,13 @@ Solution TinyZero::find0(const Constraints& constraints, const FindParams& fparm
   ftrack.start();
   std::vector<Solution> v_solns;
 
+  auto warm_starts = get_warm_starts(constraints, fparms, ftrack);
+
   bool   warmstart      = true;
   size_t warmstart_rank = 0;
 
-  while (!fparms.hl_outer.halt(ftrack.get_descents(), ftrack.get_elapsed()))
+  // at least one descent, even if benchmarking the warm starts used up the allotted time
+  while (v_solns.empty() || !fparms.hl_outer.halt(ftrack.get_descents(), ftrack.get_elapsed()))
   {
     mowri << "\nEntering new descent. \n"
           << fparms.hl_outer.get_status(ftrack.get_descents(), ftrack.get_elapsed()) << '\n';
@@ -359,8 +502,25 @@ Solution TinyZero::find0(const Constraints& constraints, const FindParams& fparm
 
     double allotted_sd = std::max(1.0, fparms.hl_outer.max_time - ftrack.get_elapsed());
 
-    auto soln = single_descent_find(
-      allotted_sd, constraints, fparms.hl_core, ftrack, fparms.sumstat, warmstart, warmstart_rank);
+    HyPas warm_start_hp;
+    if (warmstart)
+    {
+      mowri << "Warmstart requested [@ rank " << warmstart_rank << "]  " << Flush;
+      if (warmstart_rank < warm_starts.size())
+      {
+        warm_start_hp = warm_starts[warmstart_rank];
+        mowri << "(benchmarked nearest cache entry)" << Endl;
+      }
+      else
+      {
+        warm_start_hp =
+          get_default_soln(devinfo, gg, constraints, mowri, IfNoCache::E::RANDOM, warmstart_rank)
+            .hypas;
+      }
+    }
+
+    auto soln =
+      single_descent_find(allotted_sd, constraints, fparms, ftrack, warmstart, warm_start_hp);
     v_solns.emplace_back(soln);
     ftrack.incr_descents();
 
@@ -387,6 +547,9 @@ Solution TinyZero::find0(const Constraints& constraints, const FindParams& fparm
 
   mowri << '\n'
         << "Search summary  :  " << ftrack.get_string() << '\n'
+        << "time to within 5% of best gflops : " << ftrack.get_time_to_within(0.95) << " [s]\n"
+        << "clock drift : " << ftrack.get_drift_string() << '\n'
+        << "best run statistics : " << v_solns[best_soln_index].stats.get_string() << '\n'
         << stringutil::get_star_wrapped("The gflops found by single descents:") << '\n'
         << '\n';
 
@@ -400,8 +563,10 @@ Solution TinyZero::find0(const Constraints& constraints, const FindParams& fparm
   mowri.bw[OutPart::CCH] << "\n\n\n -- snip -- -- -- snip --\n\n" << Endl;
 
   bool is_not_canonical = redirection::get_is_not_canonical(gg);
-  mowri.bw[OutPart::CCH] << get_cache_entry_string(
-    {devinfo.identifier, constraints, gg}, v_solns[best_soln_index].hypas, is_not_canonical);
+  mowri.bw[OutPart::CCH] << get_cache_entry_string({devinfo.identifier, constraints, gg},
+                                                    v_solns[best_soln_index].hypas,
+                                                    is_not_canonical,
+                                                    v_solns[best_soln_index].stats.get_string());
   mowri.bw[OutPart::CCH] << "\n -- snip -- -- -- snip --\n\n\n" << Endl;
 
   return v_solns[best_soln_index];
@@ -409,16 +574,22 @@ Solution TinyZero::find0(const Constraints& constraints, const FindParams& fparm
 
 Solution TinyZero::single_descent_find(double             allotted_time,
                                        const Constraints& constraints,
-                                       const Halt&        core_halt,
+                                       const FindParams&  fparms,
                                        FindTracker&       ftrack,
-                                       SummStat::E        sumstat,
                                        bool               warmstart,
-                                       size_t             warmstart_rank)
+                                       const HyPas&       warm_start_hp)
 {
 
   // only considered an improvement if ratio new/old less than this
   double improvement_factor_required = 0.998;
 
+  // the incumbent is re-measured when its time drifts by more than this fraction
+  double drift_tolerance         = 0.02;
+  size_t kernels_since_remeasure = 0;
+
+  const Halt&       core_halt = fparms.hl_core;
+  const SummStat::E sumstat   = fparms.sumstat;
+
   get_kernel_cache();  // Make sure the cache is initialized before starting timer
 
   Timer timer;
@@ -426,9 +597,9 @@ Solution TinyZero::single_descent_find(double             allotted_time,
 
   mowri << "geometry : " << gg.get_string() << "\nallotted time : " << allotted_time << Endl;
 
-  // re-creating the same graph for every single_descent is currently wasteful,
-  // but maybe in the future different constraints will be passed on each run
-  const Graph graph(gg, devinfo, constraints, mowri);
+  // the graph is memoized, only constructed on the first descent
+  auto        p_graph = get_graph(gg, devinfo, constraints);
+  const auto& graph   = *p_graph;
 
   // number of kernels whose strings are generated
   size_t single_descent_counter = 0;
@@ -437,7 +608,7 @@ Solution TinyZero::single_descent_find(double             allotted_time,
   // ensure that we do not consider a HyperParam more than once
   // Maybe this should be in the outer find loop ?
   // Although then the stats between runs wouldn't be indep.
-  std::vector<HyPas> hyper_front_history;
+  std::unordered_set<PackedHyPas, PackedHyPasHash> hyper_front_history;
 
   // Keep track of the `records' as they get broken
   std::vector<Solution> best_solns_path;
@@ -453,20 +624,14 @@ Solution TinyZero::single_descent_find(double             allotted_time,
   // the hyper params to be considered on a single wave
   std::vector<HyPas> hyper_front;
 
-  HyPas warm_start_hp;
   if (warmstart == false)
   {
     // what if I put 2 or three here ? might help fast escape from bad region
-    hyper_front = {graph.get_random_valid_start()};
+    hyper_front = {graph.get_random_valid_start(mowri)};
   }
   else
   {
-    mowri << "Warmstart requested [@ rank " << warmstart_rank << "]  " << Flush;
-
-    auto soln =
-      get_default_soln(devinfo, gg, constraints, mowri, IfNoCache::E::RANDOM, warmstart_rank);
-    warm_start_hp = soln.hypas;
-    hyper_front   = {warm_start_hp};
+    hyper_front = {warm_start_hp};
   }
 
   HyPas hp_curr;
@@ -484,7 +649,7 @@ Solution TinyZero::single_descent_find(double             allotted_time,
 
       hp_curr = hyper_front[hfi];
 
-      hyper_front_history.push_back(hp_curr);
+      hyper_front_history.insert(hp_curr.get_packed());
 
       // extra precaution, should be able to remove this
       Derivabilty dblt(hp_curr, gg);
@@ -528,7 +693,8 @@ Solution TinyZero::single_descent_find(double             allotted_time,
       kernel_times.reset_times();
       std::vector<std::string> summary;
 
-      auto oclr = true_core([&summary, &v_t_total](std::string x) { summary.push_back(x); },
+      auto oclr = true_core(programs,
+                            [&summary, &v_t_total](std::string x) { summary.push_back(x); },
                             v_t_total,
                             core_halt,
                             all_kern_args);
@@ -540,18 +706,17 @@ Solution TinyZero::single_descent_find(double             allotted_time,
         continue;
       }
 
-      auto v_t_total_copy = v_t_total;
+      // the sumstat is of all runs. Outliers (for example from other work on the device) are
+      // rejected for the statistical BestTests only
+      RunStats run_stats(v_t_total);
+      k_seconds = run_stats.get(sumstat);
 
-      std::sort(v_t_total_copy.begin(), v_t_total_copy.end());
-      switch (sumstat)
-      {
-      case SummStat::E::MAX: k_seconds    = v_t_total_copy[0]; break;
-      case SummStat::E::MEDIAN: k_seconds = v_t_total_copy[v_t_total.size() / 2]; break;
-      case SummStat::E::MEAN:
-        k_seconds = std::accumulate(v_t_total.begin(), v_t_total.end(), 0.) / v_t_total.size();
-        break;
-      case SummStat::E::N: throw miog_error("N not allowed in SummStat in find ");
-      }
+      bool is_new_best = best_solns_path.size() == 0 ||
+                         is_faster(run_stats,
+                                   best_solns_path.back().stats,
+                                   fparms.besttest,
+                                   sumstat,
+                                   improvement_factor_required);
 
       mowri << get_run_times_heading() << Flush;
       for (size_t ir = 0; ir < summary.size(); ++ir)
@@ -560,27 +725,52 @@ Solution TinyZero::single_descent_find(double             allotted_time,
         if (v_t_total[ir] >= k_seconds && v_t_total[ir] <= k_seconds)  // avoid == suppression
         {
           mowri << " (" << SummStat::M().name[sumstat] << ')';
-          if (best_solns_path.size() > 0 &&
-              (improvement_factor_required * best_solns_path.back().extime >= k_seconds))
+          if (best_solns_path.size() > 0 && is_new_best)
           {
             mowri << " (NEW BEST) ";
           }
         }
         mowri << '\n';
       }
+      mowri << run_stats.get_string() << Endl;
 
-      if (best_solns_path.size() == 0 ||
-          (improvement_factor_required * best_solns_path.back().extime >= k_seconds))
+      if (is_new_best)
       {
 
         improvement_found_on_front = true;
 
         best_solns_path.emplace_back(gg, k_seconds, bundle.v_tgks, hp_curr, devinfo, constraints);
+        best_solns_path.back().stats = run_stats;
         disco_times.push_back(timer.get_elapsed());
+        ftrack.record_gflops(gg.get_gflops(k_seconds / 1000.));
+        // keep the compiled kernels of the new incumbent, the next candidate is compiled into
+        // those of the previous incumbent
+        std::swap(programs, incumbent_programs);
       }
 
       ++hfi;
       ftrack.incr_kernels();
+      ++kernels_since_remeasure;
+
+      // re-measure the incumbent, if its time has drifted (clocks, throttling) rescale it
+      if (fparms.remeasure_period > 0 && kernels_since_remeasure >= fparms.remeasure_period &&
+          best_solns_path.size() > 0 && !is_new_best)
+      {
+        kernels_since_remeasure = 0;
+        auto& incumbent         = best_solns_path.back();
+        auto  remeasured        = get_run_stats(incumbent_programs, incumbent.v_tgks, core_halt);
+        if (remeasured.n_runs > 0)
+        {
+          double drift = remeasured.get(sumstat) / incumbent.extime;
+          ftrack.record_drift(drift);
+          if (std::abs(drift - 1) > drift_tolerance)
+          {
+            mowri << "incumbent re-measured, drift " << drift << ", rescaling" << Endl;
+            incumbent.extime = remeasured.get(sumstat);
+            incumbent.stats  = remeasured;
+          }
+        }
+      }
     }
 
     if (improvement_found_on_front == true && allotted_time > timer.get_elapsed())
@@ -591,9 +781,11 @@ Solution TinyZero::single_descent_find(double             allotted_time,
       // refreshing hyper front
       hyper_front.clear();
 
+      std::unordered_set<PackedHyPas, PackedHyPasHash> neighbors_seen;
       for (auto& hp : neighbors)
       {
-        if (std::count(neighbors.begin(), neighbors.end(), hp) > 1)
+        auto packed = hp.get_packed();
+        if (neighbors_seen.insert(packed).second == false)
         {
           throw miog_error("duplicates in neighbors not allowed, should have already been "
                            "filtered. Could filter out here, but less efficient ");
@@ -609,8 +801,7 @@ Solution TinyZero::single_descent_find(double             allotted_time,
         }
 
         // filtering out if it has already been considered
-        else if (std::find(hyper_front_history.begin(), hyper_front_history.end(), hp) !=
-                 hyper_front_history.end())
+        else if (hyper_front_history.count(packed) != 0)
         {
         }
 
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/redirection.hpp>
+#include "testutil.hpp"
+
+// Complex GEMM on the host : Geometry with floattypes 'c' (float2) and 'z' (double2) and
+// conjugate transposes, their redirection and cache keys, the generation of their kernels from the
+// kernel cache HyPas (run against cpugemm if there is an OpenCL device), and the complex CPU
+// reference GEMM, against 4 real GEMMs.
+
+namespace
+{
+// C = alpha op(A) op(B) + beta C with the CPU reference for TComplex, and with 4 real GEMMs in
+// double : the largest difference, relative to 1 + |C|
+template <typename TComplex>
+double get_max_error(const MIOpenGEMM::Geometry& gg, std::mt19937& gen)
+{
+  using namespace MIOpenGEMM;
+  using TReal = typename TComplex::value_type;
+
+  Offsets                                toff = get_padding_offsets();
+  std::uniform_real_distribution<double> dis(-1, 1);
+  std::vector<std::vector<TComplex>>     cmem(Mat::E::N);
+  std::vector<std::vector<double>>       rmem(Mat::E::N);
+  std::vector<std::vector<double>>       imem(Mat::E::N);
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    for (size_t i = 0; i < get_mat_size(gg, toff, emat); ++i)
+    {
+      cmem[emat].emplace_back(static_cast<TReal>(dis(gen)), static_cast<TReal>(dis(gen)));
+      rmem[emat].push_back(cmem[emat].back().real());
+      imem[emat].push_back(gg.cX[emat] ? -cmem[emat].back().imag() : cmem[emat].back().imag());
+    }
+  }
+  TComplex       alpha(static_cast<TReal>(0.75), static_cast<TReal>(-0.5));
+  TComplex       beta(static_cast<TReal>(-0.25), static_cast<TReal>(0.125));
+  auto           c_before = cmem[Mat::E::C];
+  owrite::Writer silent(Ver::E::SILENT, "");
+  cpugemm::gemm<TComplex>(gg,
+                          toff,
+                          cmem[Mat::E::A].data(),
+                          cmem[Mat::E::B].data(),
+                          cmem[Mat::E::C].data(),
+                          alpha,
+                          beta,
+                          silent);
+
+  // AB = (Ar Br - Ai Bi) + i(Ar Bi + Ai Br)
+  Geometry            dgg = testutil::get_with_floattype(gg, 'd');
+  std::vector<double> re(rmem[Mat::E::C].size(), 0);
+  std::vector<double> im(rmem[Mat::E::C].size(), 0);
+  auto gemm = [&dgg, &toff, &silent](const std::vector<double>& a,
+                                     const std::vector<double>& b,
+                                     std::vector<double>&       c,
+                                     double                     sign) {
+    cpugemm::gemm<double>(dgg, toff, a.data(), b.data(), c.data(), sign, 1, silent);
+  };
+  gemm(rmem[Mat::E::A], rmem[Mat::E::B], re, 1);
+  gemm(imem[Mat::E::A], imem[Mat::E::B], re, -1);
+  gemm(rmem[Mat::E::A], imem[Mat::E::B], im, 1);
+  gemm(imem[Mat::E::A], rmem[Mat::E::B], im, 1);
+
+  double max_err = 0;
+  for (size_t i = 0; i < gg.get_uncoal(Mat::E::C); ++i)
+  {
+    for (size_t j = 0; j < gg.get_coal(Mat::E::C); ++j)
+    {
+      size_t index = toff.offsets[Mem::E::C] + i * gg.ldX[Mat::E::C] + j;
+      auto   expected =
+        std::complex<double>(alpha) * std::complex<double>(re[index], im[index]) +
+        std::complex<double>(beta) * std::complex<double>(c_before[index]);
+      double err = std::abs(std::complex<double>(cmem[Mat::E::C][index]) - expected);
+      max_err    = std::max(max_err, err / (1 + std::abs(expected)));
+    }
+  }
+  return max_err;
+}
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // geometries, their strings and memory sizes
+  Geometry dgg(false, true, false, false, 53 + 3, 37 + 5, 37 + 2, 53, 37, 71, 0, 'd');
+  Geometry cgg = get_with_floattype(dgg, 'c', true, false);
+  Geometry zgg = get_with_floattype(dgg, 'z', false, true);
+  Offsets  toff = get_padding_offsets();
+  for (auto& gg : {cgg, zgg})
+  {
+    check(Geometry(gg.get_string()) == gg,
+          "geometry string round trip failed : " + gg.get_string());
+    check(gg.derived.is_complex() && !gg.derived.is_mixed(),
+          "complex geometry should not be mixed");
+    check(get_mat_memsize(gg, toff, Mat::E::A) ==
+            2 * sizeof(double) / (gg.floattype == 'c' ? 2 : 1) * get_mat_size(gg, toff, Mat::E::A),
+          "complex geometry should have pairs of values");
+  }
+  check(contains(cgg.get_string(), "_f64_cx1_cA1_cB0"), "'c' string " + cgg.get_string());
+  check(contains(zgg.get_string(), "_f128_cx1_cA0_cB1"), "'z' string " + zgg.get_string());
+  check(!(get_with_floattype(dgg, 'c', false, false) == dgg) &&
+          !(get_with_floattype(dgg, 'c', false, false) == cgg),
+        "complex geometries should differ from double, and by conjugation");
+
+  check(throws([&dgg]() { get_with_floattype(dgg, 'f', true, false); }),
+        "a real geometry should not be conjugated");
+
+  // the canonical geometry swaps A and B (row major), and their conjugations with them
+  bool     swap_ab = false;
+  Geometry canon   = redirection::get_canonical(cgg, swap_ab);
+  check(swap_ab && canon.isColMajor && !canon.cX[Mat::E::A] && canon.cX[Mat::E::B],
+        "the conjugation of A should become that of B : " + canon.get_string());
+
+  // complex and double keys are cached separately
+  auto&&      kernel_cache = get_kernel_cache();
+  auto        keys         = kernel_cache.get_keys();
+  KernelCache kc;
+  Geometry    cgg0         = get_with_floattype(keys[0].gg, 'c', false, true);
+  CacheKey    dck(keys[0].dvc, keys[0].constraints, keys[0].gg);
+  CacheKey    cck(keys[0].dvc, keys[0].constraints, cgg0);
+  kc.add(dck, kernel_cache.at(keys[0]));
+  check(!kc.check_for(cck).is_present, "a complex key should not find the double entry");
+  kc.add(cck, kernel_cache.at(keys[1]));
+  check(kc.at(cck) == kernel_cache.at(keys[1]) && kc.at(dck) == kernel_cache.at(keys[0]),
+        "complex and double entries should be distinct");
+
+  // kernel generation : float2 and double2, complex products, conjugation on loading registers
+  size_t n_generated = 0;
+  size_t n_atomic    = 0;
+  for (auto& ck : keys)
+  {
+    for (char floattype : {'c', 'z'})
+    {
+      bool     cA  = (n_generated % 3) == 1;
+      bool     cB  = (n_generated % 3) == 2;
+      Geometry xgg = get_with_floattype(ck.gg, floattype, cA, cB);
+      HyPas    hp  = kernel_cache.at(ck);
+      for (auto emat : {Mat::E::A, Mat::E::B})
+      {
+        hp.sus[emat].vs[Chi::E::VEW] = 1;
+      }
+      if (!Derivabilty(hp, xgg).is_derivable)
+      {
+        continue;
+      }
+      DerivedParams dp(hp, xgg);
+      std::string   t_float = floattype == 'c' ? "float2" : "double2";
+      auto          kblobs  = kerngen::get_kernblobs(hp, xgg, dp);
+      bool          atomic  = false;
+      for (auto& kblob : kblobs)
+      {
+        bool good = contains(kblob.kernstr, " " + t_float + "\n");
+        if (kblob.e_ktype == KType::E::MAIN)
+        {
+          good = good && contains(kblob.kernstr, "#define CMUL(p, q)") &&
+                 contains(kblob.kernstr, "CMUL(alpha, rC[") &&
+                 !contains(kblob.kernstr, "alpha*rC") &&
+                 contains(kblob.kernstr, "rA[i].y = -rA[i].y;") == cA &&
+                 contains(kblob.kernstr, "rB[i].y = -rB[i].y;") == cB;
+          atomic = atomic ||
+                   contains(kblob.kernstr, floattype == 'c' ? "atom_cmpxchg" : "ptr_to_c_part");
+        }
+        else if (kblob.e_ktype == KType::E::BETAC)
+        {
+          good = good && contains(kblob.kernstr, "CMUL(beta, c[i])");
+        }
+        check(good, std::string("complex kernel ") + kblob.fname + " has unexpected types");
+      }
+      n_atomic += atomic;
+      std::string feature = std::string("complex ") + floattype;
+      runner.run(feature + (cA || cB ? " conjugated" : ""), kblobs, xgg);
+      if (atomic)
+      {
+        runner.run(feature + " with atomics", kblobs, xgg);
+      }
+      ++n_generated;
+    }
+  }
+  check(n_generated > 0 && n_atomic > 0, "no complex kernels (with atomics) generated");
+  runner.check_run({"complex c",
+                    "complex c conjugated",
+                    "complex c with atomics",
+                    "complex z",
+                    "complex z conjugated",
+                    "complex z with atomics"});
+
+  // the complex CPU references, against 4 real GEMMs in double
+  std::mt19937 gen(1011);
+  Geometry     z00 = get_with_floattype(dgg, 'z', false, false);
+  Geometry     z11 = get_with_floattype(dgg, 'z', true, true);
+  for (auto& gg : {z00, zgg, z11})
+  {
+    double max_err = get_max_error<std::complex<double>>(gg, gen);
+    check(max_err <= 1e-12, "complex double CPU GEMM error " + std::to_string(max_err));
+  }
+  double max_err = get_max_error<std::complex<float>>(cgg, gen);
+  check(max_err <= 1e-5, "complex float CPU GEMM error " + std::to_string(max_err));
+
+  std::cout << n_generated << " complex kernel bundles generated (" << n_atomic
+            << " with atomics), " << runner.get_summary() << ", ";
+  return check.finish();
+}
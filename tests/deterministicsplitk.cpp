@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/miogemm.hpp>
+#include "testutil.hpp"
+
+// Deterministic split-k on the host : HyPas with RED (partial sums to workspace, reduced in a
+// fixed order by the REDUCE kernel), its workspace requirement, the kernels generated from the
+// kernel cache HyPas and their dependencies (run twice against cpugemm if there is an OpenCL
+// device, computing the same bytes), and find's determinism constraint.
+
+namespace
+{
+bool has_atomics(const std::string& kernstr)
+{
+  using MIOpenGEMM::testutil::contains;
+  return contains(kernstr, "atomic_cmpxchg") || contains(kernstr, "atom_cmpxchg") ||
+         contains(kernstr, "atomic_add");
+}
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // RED is absent in the strings of the kernel caches : it is then NO
+  HyPas old_hp = {{{"MIC5_PAD2_PLU0_LIW1_MIW1_WOS0_VEW1",
+                 "MIC4_PAD2_PLU0_LIW0_MIW1_WOS0_VEW1",
+                 "UNR16_GAL1_PUN0_ICE4_IWI0_SZT0_NAW64_UFO0_MAC256_SKW10_AFI1_MIA1_MAD0"}}};
+  check(old_hp.sus[Mat::E::C].vs[NonChi::E::RED] == Binary::E::NO, "RED should default to NO");
+  HyPas red_hp = old_hp;
+  red_hp.replace_where_defined(Constraints("C_RED1"));
+  std::string red_s = red_hp.sus[Mat::E::C].get_string();
+  check(SuHy(Mat::E::C, red_s).vs == red_hp.sus[Mat::E::C].vs && contains(red_s, "_RED1"),
+        "RED string round trip failed : " + red_s);
+  check(!(red_hp.get_packed() == old_hp.get_packed()), "RED should be packed");
+
+  // kernel generation from the kernel cache HyPas with split-k : partial sums to workspace, the
+  // reduction kernel after the main kernel, and no atomics
+  auto&& kernel_cache = get_kernel_cache();
+  size_t n_generated  = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    for (char floattype : {'f', 'n', 'z'})
+    {
+      HyPas hp = kernel_cache.at(ck);
+      if (hp.sus[Mat::E::C].vs[NonChi::E::ICE] == 1)
+      {
+        continue;
+      }
+      hp.sus[Mat::E::C].vs[NonChi::E::RED] = Binary::E::YES;
+      if (floattype == 'z')
+      {
+        hp.sus[Mat::E::A].vs[Chi::E::VEW] = 1;
+        hp.sus[Mat::E::B].vs[Chi::E::VEW] = 1;
+      }
+
+      Geometry bigg = get_with_workspace(get_with_floattype(ck.gg, floattype), size_t(1) << 30);
+      if (!Derivabilty(hp, bigg).is_derivable)
+      {
+        continue;
+      }
+
+      // exactly the required workspace
+      DerivedParams bigdp(hp, bigg);
+      Geometry      xgg = get_with_workspace(bigg, bigdp.required_workspace);
+      check(Derivabilty(hp, xgg).is_derivable, "the required workspace should be sufficient");
+      check(!Derivabilty(hp, get_with_workspace(bigg, bigdp.required_workspace - 1)).is_derivable,
+            "the partial sums should not fit in less than the required workspace");
+      DerivedParams dp(hp, xgg);
+
+      // aligned for TFLOAT_ACC, after the copies of A and B
+      size_t acc_per_ab = xgg.derived.float_size_bits_acc / xgg.derived.float_size_bits_ab;
+      size_t ice        = hp.sus[Mat::E::C].vs[NonChi::E::ICE];
+      size_t n_partials = ice * xgg.ldX[Mat::E::C] * xgg.get_uncoal(Mat::E::C);
+      check(dp.main_writes_partials == 1 && dp.red_global_offset % acc_per_ab == 0 &&
+              dp.required_workspace == dp.red_global_offset + acc_per_ab * n_partials,
+            "unexpected workspace for the partial sums");
+
+      auto kblobs = kerngen::get_kernblobs(hp, xgg, dp);
+      check(kblobs.back().e_ktype == KType::E::REDUCE, "the reduction kernel should be last");
+      for (auto& kblob : kblobs)
+      {
+        check(!has_atomics(kblob.kernstr), "kernel " + kblob.fname + " has atomics");
+        check(kblob.e_ktype != KType::E::BETAC, "beta should be applied in the reduction");
+        if (kblob.e_ktype == KType::E::MAIN)
+        {
+          check(contains(kblob.kernstr, "w_partial[index] = rC[") && !kblob.kuses.u_c &&
+                  kblob.kuses.u_w && !kblob.kuses.u_alpha,
+                "the main kernel should write partial sums to workspace only");
+        }
+        else if (kblob.e_ktype == KType::E::REDUCE)
+        {
+          std::string alpha_inc =
+            floattype == 'z' ? "c[i] += CMUL(alpha, sum);" : "c[i] += alpha*sum;";
+          check(contains(kblob.kernstr, "#define N_PARTIALS " + std::to_string(ice) + "\n") &&
+                  contains(kblob.kernstr, "sum += *partial;") &&
+                  contains(kblob.kernstr, alpha_inc) && kblob.kuses.u_c && kblob.kuses.u_w &&
+                  kblob.kuses.u_alpha && kblob.kuses.u_beta,
+                "unexpected reduction kernel");
+        }
+      }
+
+      // REDUCE waits for MAIN, which waits for the copies
+      owrite::Writer silent(Ver::E::SILENT, "");
+      auto           waits = kerngen::get_v_wait_indices(kblobs, silent);
+      check(waits.back() == std::vector<size_t>{kblobs.size() - 2},
+            "the reduction kernel should wait for the main kernel only");
+      runner.run(std::string("split-k with reduction ") + floattype, kblobs, xgg);
+      ++n_generated;
+    }
+  }
+  check(n_generated > 0, "no split-k kernel bundles with reduction generated");
+  runner.check_run(
+    {"split-k with reduction f", "split-k with reduction n", "split-k with reduction z"});
+
+  // with determinism enforced and workspace, split-k solutions reduce partial sums
+  oclutil::DevInfo devinfo = oclutil::get_vega_devinfo();
+  Constraints      deterministic("C_RED1");
+  owrite::Writer   silent(Ver::E::SILENT, "");
+  size_t           n_split = 0;
+  auto             keys    = kernel_cache.get_keys();
+  for (size_t i = 0; i < keys.size(); i += 1 + keys.size() / 40)
+  {
+    Geometry gg   = get_with_workspace(get_with_floattype(keys[i].gg, 'f'), size_t(1) << 28);
+    Solution soln = get_default_soln(devinfo, gg, deterministic, silent, IfNoCache::E::GENERIC, 0);
+    check(soln.hypas.sus[Mat::E::C].vs[NonChi::E::RED] == Binary::E::YES,
+          "determinism should set RED");
+    for (auto& kblob : soln.v_tgks)
+    {
+      check(!has_atomics(kblob.kernstr), "a deterministic solution has atomics");
+      n_split += (kblob.e_ktype == KType::E::REDUCE);
+    }
+  }
+
+  std::cout << n_generated << " split-k kernel bundles with reduction generated, " << n_split
+            << " deterministic split-k solutions, " << runner.get_summary() << ", ";
+  return check.finish();
+}
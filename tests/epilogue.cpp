@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/epilogue.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include "testutil.hpp"
+
+// Fused epilogues on the host : their strings (part of program cache keys), the main kernels
+// generated with bias, activation and conversion from the kernel cache HyPas (run against cpugemm
+// with the epilogue applied on the host, if there is an OpenCL device), their arguments, and the
+// geometries and HyPas for which they are not supported.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // the strings : empty for the identity, otherwise distinct
+  std::set<std::string> strings;
+  for (size_t b = 0; b < Bias::E::N; ++b)
+  {
+    for (size_t a = 0; a < Activation::E::N; ++a)
+    {
+      for (size_t c = 0; c < Conversion::E::N; ++c)
+      {
+        Epilogue ep(static_cast<Bias::E>(b),
+                    static_cast<Activation::E>(a),
+                    static_cast<Conversion::E>(c));
+        check(ep.is_identity() == (ep == Epilogue()) &&
+                ep.get_string().empty() == ep.is_identity(),
+              "only the identity should have an empty string : " + ep.get_string());
+        strings.insert(ep.get_string());
+      }
+    }
+  }
+  check(strings.size() == Bias::E::N * Activation::E::N * Conversion::E::N,
+        "epilogue strings should be distinct");
+  check(Epilogue(Bias::E::ROW, Activation::E::RELU, Conversion::E::DEFAULT).get_string() ==
+          "BIASROW_ACTRELU_CNVDEFAULT",
+        "unexpected epilogue string");
+
+  check(throws([]() { Epilogue(Bias::E::N, Activation::E::NONE, Conversion::E::DEFAULT); }),
+        "an invalid bias should throw");
+
+  // kernel generation from the kernel cache HyPas which do not split on k
+  auto&&   kernel_cache = get_kernel_cache();
+  Epilogue row_relu(Bias::E::ROW, Activation::E::RELU, Conversion::E::DEFAULT);
+  Epilogue col_gelu(Bias::E::COL, Activation::E::GELU, Conversion::E::SATURATE);
+  Epilogue saturate(Bias::E::NONE, Activation::E::NONE, Conversion::E::SATURATE);
+  size_t   n_generated = 0;
+  size_t   n_split     = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    for (char floattype : {'f', 'h', 'n'})
+    {
+      HyPas    hp  = kernel_cache.at(ck);
+      Geometry xgg = get_with_floattype(ck.gg, floattype);
+      if (!Derivabilty(hp, xgg).is_derivable)
+      {
+        continue;
+      }
+      DerivedParams dp(hp, xgg);
+
+      if (dp.main_split_on_k != 0)
+      {
+        check(throws([&]() { kerngen::get_kernblobs(hp, xgg, dp, row_relu); }),
+              "an epilogue with a split on k should throw");
+        ++n_split;
+        continue;
+      }
+
+      // the identity is the kernel without an epilogue
+      auto kblobs = kerngen::get_kernblobs(hp, xgg, dp);
+      auto ident  = get_main(kerngen::get_kernblobs(hp, xgg, dp, Epilogue()));
+      auto base   = get_main(kblobs);
+      check(ident.kernstr == base.kernstr && !ident.kuses.u_bias &&
+              !contains(ident.kernstr, "bias") && !contains(ident.kernstr, "c_value"),
+            "the identity epilogue should not change the kernel");
+
+      bool half_c    = xgg.derived.floattype_c == 'h';
+      auto rr_kblobs = kerngen::get_kernblobs(hp, xgg, dp, row_relu);
+      auto rr        = get_main(rr_kblobs);
+      check(rr.kuses.u_bias && contains(rr.kuses.full, "_bias") &&
+              contains(rr.kernstr, "__global const TFLOAT * restrict bias") &&
+              contains(rr.kernstr, "bias += bias_offset;") &&
+              contains(rr.kernstr, "c_value += bias[write_start_a + dima];") &&
+              contains(rr.kernstr, "c_value = max(c_value, (TFLOAT_ACC)(0));") &&
+              contains(rr.kernstr, "c[index] = (TFLOAT)(c_value);") &&
+              !contains(rr.kernstr, "c[index] *= beta") && !contains(rr.kernstr, "clamp("),
+            "unexpected main kernel with a row bias and relu");
+
+      auto cg_kblobs = kerngen::get_kernblobs(hp, xgg, dp, col_gelu);
+      auto cg        = get_main(cg_kblobs);
+      check(cg.kuses.u_bias && contains(cg.kernstr, "c_value += bias[write_start_b + dimb];") &&
+              contains(cg.kernstr, "tanh(") && contains(cg.kernstr, "clamp(") == half_c,
+            "unexpected main kernel with a column bias, gelu and saturation");
+      runner.run(std::string("row bias and relu ") + floattype, rr_kblobs, xgg, row_relu);
+      runner.run(std::string("column bias and gelu ") + floattype, cg_kblobs, xgg, col_gelu);
+
+      auto sat_kblobs = kerngen::get_kernblobs(hp, xgg, dp, saturate);
+      auto sat        = get_main(sat_kblobs);
+      check(!sat.kuses.u_bias && !contains(sat.kernstr, "bias") &&
+              contains(sat.kernstr, "clamp(") == half_c,
+            "unexpected main kernel with saturation only");
+      if (half_c)
+      {
+        runner.run(std::string("saturation ") + floattype, sat_kblobs, xgg, saturate);
+      }
+
+      // the bias and its offset are the last arguments
+      std::array<cl_mem, Mem::E::N> cl_mems{};
+      std::array<size_t, Mem::E::N> offsets{};
+      float                         alpha       = 1;
+      float                         beta        = 1;
+      cl_mem                        bias        = nullptr;
+      size_t                        bias_offset = 3;
+      auto args      = kerngen::get_arg_sizes_values(base, cl_mems, offsets, 4, &alpha, &beta);
+      auto bias_args = kerngen::get_arg_sizes_values(
+        rr, cl_mems, offsets, 4, &alpha, &beta, &bias, &bias_offset);
+      check(bias_args.size() == args.size() + 2 && bias_args.back().second == &bias_offset,
+            "the bias should be 2 more arguments");
+      check(throws([&]() {
+              kerngen::get_arg_sizes_values(rr, cl_mems, offsets, 4, &alpha, &beta);
+            }),
+            "a kernel with a bias should need a bias buffer");
+      ++n_generated;
+    }
+  }
+  check(n_generated > 0 && n_split > 0, "no kernel bundles with epilogues (and split on k)");
+  for (char floattype : {'f', 'h', 'n'})
+  {
+    runner.check_run({std::string("row bias and relu ") + floattype,
+                      std::string("column bias and gelu ") + floattype});
+  }
+  runner.check_run({"saturation h", "saturation n"});
+
+  // complex and requantised C are not supported, nor is GELU for int32 C
+  size_t n_unsupported = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    for (char floattype : {'c', 'q', 'i'})
+    {
+      HyPas hp = kernel_cache.at(ck);
+      for (auto emat : {Mat::E::A, Mat::E::B})
+      {
+        hp.sus[emat].vs[Chi::E::VEW] = 1;
+      }
+      hp.sus[Mat::E::C].vs[NonChi::E::ICE] = 1;
+      Geometry xgg = get_with_floattype(ck.gg, floattype);
+      if (!Derivabilty(hp, xgg).is_derivable)
+      {
+        continue;
+      }
+      DerivedParams dp(hp, xgg);
+      Epilogue      ep = floattype == 'i' ? col_gelu : row_relu;
+      check(throws([&]() { kerngen::get_kernblobs(hp, xgg, dp, ep); }),
+            std::string("epilogue ") + ep.get_string() + " should throw for " + floattype);
+      if (floattype == 'i')
+      {
+        auto kblobs = kerngen::get_kernblobs(hp, xgg, dp, row_relu);
+        check(get_main(kblobs).kuses.u_bias, "an int32 C should support a bias and relu");
+        runner.run("row bias and relu i", kblobs, xgg, row_relu);
+      }
+      ++n_unsupported;
+    }
+  }
+  check(n_unsupported > 0, "no unsupported epilogues checked");
+  runner.check_run({"row bias and relu i"});
+
+  std::cout << n_generated << " kernel bundles with epilogues generated, " << n_split
+            << " with a split on k, " << runner.get_summary() << ", ";
+  return check.finish();
+}
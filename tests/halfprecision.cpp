@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/half.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/setabcw.hpp>
+#include "testutil.hpp"
+
+// Half precision on the host : conversions of half, Geometry with floattype 'h', generation of
+// half kernels from the kernel cache HyPas (run against cpugemm if there is an OpenCL device), and
+// the CPU reference GEMM.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // every half other than nan is exactly a float
+  for (uint32_t bits = 0; bits < 65536; ++bits)
+  {
+    half  h = half::from_bits(static_cast<uint16_t>(bits));
+    float x = h;
+    check(std::isnan(x) || half(x).bits == bits,
+          "round trip failed for bits " + std::to_string(bits));
+  }
+
+  // round to nearest even, overflow to inf, underflow through the subnormals
+  check(half(1.f + std::ldexp(1.f, -11)).bits == 0x3c00, "1 + 2^-11 should round to 1");
+  check(half(1.f + 3 * std::ldexp(1.f, -11)).bits == 0x3c02, "1 + 3 2^-11 should round up");
+  check(half(65519.f).bits == 0x7bff, "65519 should round to 65504");
+  check(half(65520.f).bits == 0x7c00, "65520 should round to inf");
+  check(half(-std::ldexp(1.f, -24)).bits == 0x8001, "-2^-24 should be the smallest subnormal");
+  check(half(std::ldexp(1.f, -25)).bits == 0x0000, "2^-25 should round to 0");
+  check(half(std::ldexp(1.5f, -25)).bits == 0x0001, "1.5 2^-25 should round to 2^-24");
+  check(std::isnan(static_cast<float>(std::numeric_limits<half>::quiet_NaN())), "nan");
+  check(static_cast<float>(std::numeric_limits<half>::max()) == 65504.f, "max should be 65504");
+
+  Geometry gg(64, 48, 80, false, true, 0, 'h');
+  check(gg.derived.float_size_bytes == 2, "half geometry should have 2 byte values");
+  check(Geometry(gg.get_string()) == gg, "geometry string round trip failed : " + gg.get_string());
+
+  // kernel generation, with split-k (atomic increments) and half2 loads where derivable
+  auto&& kernel_cache = get_kernel_cache();
+  size_t n_generated  = 0;
+  size_t n_atomic     = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    Geometry hgg = get_with_floattype(ck.gg, 'h');
+    HyPas    hp  = kernel_cache.at(ck);
+    for (auto emat : {Mat::E::A, Mat::E::B})
+    {
+      hp.sus[emat].vs[Chi::E::VEW] = 2;
+    }
+    if (!Derivabilty(hp, hgg).is_derivable)
+    {
+      hp = kernel_cache.at(ck);
+      if (!Derivabilty(hp, hgg).is_derivable)
+      {
+        continue;
+      }
+    }
+    DerivedParams dp(hp, hgg);
+    auto          kblobs = kerngen::get_kernblobs(hp, hgg, dp);
+    bool          atomic = false;
+    for (auto& kblob : kblobs)
+    {
+      check(contains(kblob.kernstr, "#pragma OPENCL EXTENSION cl_khr_fp16 : enable") &&
+              contains(kblob.kernstr, " half\n"),
+            "half kernel " + kblob.fname + " does not enable cl_khr_fp16 or define TFLOAT half");
+      atomic = atomic || contains(kblob.kernstr, "as_ushort");
+    }
+    n_atomic += atomic;
+    runner.run(atomic ? "half with atomics" : "half", kblobs, hgg);
+    ++n_generated;
+  }
+  check(n_generated > 0 && n_atomic > 0, "no half kernels (with atomics) generated");
+  runner.check_run({"half", "half with atomics"});
+
+  // the CPU reference in half accumulates in float : close to the float reference
+  Offsets                         toff = get_padding_offsets();
+  setabcw::CpuMemBundle<half>     hcmb({gg}, toff);
+  std::vector<std::vector<float>> fmem(Mat::E::N);
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    fmem[emat].assign(hcmb.a_mem[emat].begin(), hcmb.a_mem[emat].end());
+  }
+  Geometry       fgg = get_with_floattype(gg, 'f');
+  owrite::Writer silent(Ver::E::SILENT, "");
+  cpugemm::gemm<half>(gg,
+                      toff,
+                      hcmb.r_mem[Mat::E::A],
+                      hcmb.r_mem[Mat::E::B],
+                      hcmb.a_mem[Mat::E::C].data(),
+                      half(0.5),
+                      half(-0.25),
+                      silent);
+  cpugemm::gemm<float>(fgg,
+                       toff,
+                       fmem[Mat::E::A].data(),
+                       fmem[Mat::E::B].data(),
+                       fmem[Mat::E::C].data(),
+                       0.5,
+                       -0.25,
+                       silent);
+  double max_err = 0;
+  for (size_t i = 0; i < fmem[Mat::E::C].size(); ++i)
+  {
+    double hc = static_cast<float>(hcmb.a_mem[Mat::E::C][i]);
+    max_err   = std::max(max_err, std::abs(hc - fmem[Mat::E::C][i]) / (1 + std::abs(hc)));
+  }
+  check(max_err <= std::ldexp(1., -11), "half CPU GEMM error " + std::to_string(max_err));
+
+  std::cout << n_generated << " half kernel bundles generated (" << n_atomic << " with atomics), "
+            << runner.get_summary() << ", ";
+  return check.finish();
+}
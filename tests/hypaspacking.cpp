@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <iostream>
+#include <set>
+#include <unordered_set>
+#include <miopengemm/hyperparams.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include "testutil.hpp"
+
+// Round trip of every kernel cache HyPas through PackedHyPas. No GPU required.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  auto&& kernel_cache = get_kernel_cache();
+
+  std::unordered_set<PackedHyPas, PackedHyPasHash> hashed;
+  std::set<PackedHyPas>                             ordered;
+  std::set<std::string>                             strings;
+
+  Checks check;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    const HyPas& hp     = kernel_cache.at(ck);
+    auto         packed = hp.get_packed();
+    check(HyPas(packed) == hp && HyPas(packed).get_string() == hp.get_string(),
+          "round trip failed for " + hp.get_string());
+    hashed.insert(packed);
+    ordered.insert(packed);
+    strings.insert(hp.get_string());
+  }
+
+  // the encoding is canonical : distinct HyPas have distinct encodings
+  check(hashed.size() == strings.size() && ordered.size() == strings.size(),
+        "number of distinct encodings (" + std::to_string(hashed.size()) + ", " +
+          std::to_string(ordered.size()) + ") differs from number of distinct HyPas (" +
+          std::to_string(strings.size()) + ")");
+
+  HyPas too_large = kernel_cache.at(kernel_cache.get_keys()[0]);
+  too_large.sus[Mat::E::C].vs[NonChi::E::MAC] = 1 << 20;
+  check(throws([&too_large]() { too_large.get_packed(); }),
+        "packing an out-of-range value did not throw");
+
+  std::cout << strings.size() << " distinct HyPas packed, ";
+  return check.finish();
+}
@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <miopengemm/accuracytests.hpp>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/graph.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include "testutil.hpp"
+
+// Integer GEMM on the host : Geometry with floattypes 'i' (int8 A and B, int32 C) and 'q' (int8 C,
+// requantised), the generation of their kernels from the kernel cache HyPas (run against cpugemm,
+// exactly, if there is an OpenCL device) and from the search graph (with char4 loads), and the
+// integer CPU reference GEMMs, compared exactly.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // geometries, their strings and memory sizes
+  Geometry igg(53, 37, 71, true, false, 0, 'i');
+  Geometry qgg = get_with_floattype(igg, 'q');
+  Offsets  toff = get_padding_offsets();
+  for (auto& gg : {igg, qgg})
+  {
+    check(Geometry(gg.get_string()) == gg,
+          "geometry string round trip failed : " + gg.get_string());
+    check(get_mat_memsize(gg, toff, Mat::E::B) == get_mat_size(gg, toff, Mat::E::B),
+          "integer geometry should have 1 byte B values");
+  }
+  check(contains(igg.get_string(), "_f32_fab8"), "'i' string " + igg.get_string());
+  check(contains(qgg.get_string(), "_f8_facc32"), "'q' string " + qgg.get_string());
+  check(qgg.derived.is_requantised() && qgg.derived.float_size_bytes_scalar == 4 &&
+          !igg.derived.is_requantised() && igg.derived.float_size_bytes == 4,
+        "'q' should have float alpha and beta, 'i' int32 C");
+
+  // kernel generation from the kernel cache HyPas : integer accumulation, split-k with
+  // atomic_add for 'i', not derivable for 'q'
+  auto&& kernel_cache = get_kernel_cache();
+  size_t n_generated  = 0;
+  size_t n_atomic     = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    for (char floattype : {'i', 'q'})
+    {
+      Geometry xgg = get_with_floattype(ck.gg, floattype);
+      HyPas    hp  = kernel_cache.at(ck);
+      for (auto emat : {Mat::E::A, Mat::E::B})
+      {
+        hp.sus[emat].vs[Chi::E::VEW] = 4;
+      }
+      if (!Derivabilty(hp, xgg).is_derivable)
+      {
+        hp = kernel_cache.at(ck);
+        if (!Derivabilty(hp, xgg).is_derivable)
+        {
+          continue;
+        }
+      }
+      check(floattype == 'i' || hp.sus[Mat::E::C].vs[NonChi::E::ICE] == 1,
+            "'q' should not split k");
+      DerivedParams dp(hp, xgg);
+      auto          kblobs = kerngen::get_kernblobs(hp, xgg, dp);
+      bool          atomic = false;
+      for (auto& kblob : kblobs)
+      {
+        if (kblob.e_ktype == KType::E::MAIN)
+        {
+          bool good = contains(kblob.kernstr, "#define TFLOAT_AB  char\n") &&
+                      contains(kblob.kernstr, "#define TFLOAT_ACC  int\n") &&
+                      !contains(kblob.kernstr, "mad(");
+          good = good && (floattype == 'i' || contains(kblob.kernstr, "convert_char_sat_rte"));
+          check(good, std::string("integer kernel ") + kblob.fname + " has unexpected types");
+          atomic = atomic || contains(kblob.kernstr, "atomic_add(c + index");
+        }
+      }
+      n_atomic += atomic;
+      runner.run(
+        std::string("integer ") + floattype + (atomic ? " with atomics" : ""), kblobs, xgg);
+      ++n_generated;
+    }
+  }
+  check(n_generated > 0 && n_atomic > 0, "no integer kernels (with atomic_add) generated");
+  runner.check_run({"integer i", "integer i with atomics", "integer q"});
+
+  // the search graph starts with char4 loads among its vector widths
+  Geometry         sgg(256, 192, 300, false, true, 0, 'i');
+  oclutil::DevInfo devinfo           = oclutil::get_vega_devinfo();
+  devinfo.device_max_work_group_size = 256;
+  devinfo.device_local_mem_size      = 65536;
+  Graph  graph(sgg, devinfo, Constraints(""));
+  size_t n_char4 = 0;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    owrite::Writer silent(Ver::E::SILENT, "");
+    HyPas          hp = graph.get_random_valid_start(silent);
+    check(Derivabilty(hp, sgg).is_derivable, "graph start should be derivable");
+    n_char4 += (hp.sus[Mat::E::A].vs[Chi::E::VEW] == 4 || hp.sus[Mat::E::B].vs[Chi::E::VEW] == 4);
+  }
+  check(n_char4 > 0, "no char4 loads in graph starts");
+
+  // the CPU references, against products computed in double (exact), compared exactly
+  std::mt19937                       gen(1011);
+  std::uniform_int_distribution<int> dis(-128, 127);
+  std::vector<std::vector<int8_t>>   abmem(Mat::E::N);
+  std::vector<std::vector<double>>   dmem(Mat::E::N);
+  std::vector<int32_t>               c_before(get_mat_size(igg, toff, Mat::E::C));
+  for (auto emat : {Mat::E::A, Mat::E::B})
+  {
+    abmem[emat].resize(get_mat_size(igg, toff, emat));
+    for (auto& x : abmem[emat])
+    {
+      x = static_cast<int8_t>(dis(gen));
+    }
+    dmem[emat].assign(abmem[emat].begin(), abmem[emat].end());
+  }
+  for (auto& x : c_before)
+  {
+    x = dis(gen);
+  }
+  dmem[Mat::E::C].assign(c_before.begin(), c_before.end());
+
+  owrite::Writer       silent(Ver::E::SILENT, "");
+  std::vector<int32_t> c_int = c_before;
+  cpugemm::gemm(
+    igg, toff, abmem[Mat::E::A].data(), abmem[Mat::E::B].data(), c_int.data(), 3, -2, silent);
+  cpugemm::gemm<double>(get_with_floattype(igg, 'd'),
+                        toff,
+                        dmem[Mat::E::A].data(),
+                        dmem[Mat::E::B].data(),
+                        dmem[Mat::E::C].data(),
+                        3,
+                        -2,
+                        silent);
+  std::vector<int32_t> c_double(dmem[Mat::E::C].begin(), dmem[Mat::E::C].end());
+  std::vector<int32_t> c_abs(c_double.size(), 1);
+  try
+  {
+    accuracytests::elementwise_compare(
+      igg, toff, c_before.data(), c_double.data(), c_int.data(), c_abs.data(), "", silent);
+  }
+  catch (const miog_error& e)
+  {
+    check(false, std::string("int8 CPU GEMM is not exact : ") + e.what());
+  }
+
+  // a difference of 1 is an error
+  c_int[toff.offsets[Mem::E::C] + 1] += 1;
+  check(throws([&]() {
+          accuracytests::elementwise_compare(
+            igg, toff, c_before.data(), c_double.data(), c_int.data(), c_abs.data(), "", silent);
+        }),
+        "integer comparison should be exact");
+
+  // requantised : the scale is a power of 2, so the rounding of scale * AB + zero_point is exact
+  std::vector<int8_t> c_q(get_mat_size(qgg, toff, Mat::E::C), 0);
+  cpugemm::gemm(qgg,
+                toff,
+                abmem[Mat::E::A].data(),
+                abmem[Mat::E::B].data(),
+                c_q.data(),
+                1.f / 512,
+                3.f,
+                silent);
+  cpugemm::gemm<double>(get_with_floattype(igg, 'd'),
+                        toff,
+                        dmem[Mat::E::A].data(),
+                        dmem[Mat::E::B].data(),
+                        dmem[Mat::E::C].data(),
+                        1,
+                        0,
+                        silent);
+  size_t n_saturated = 0;
+  bool   q_exact     = true;
+  for (size_t i = 0; i < qgg.get_uncoal(Mat::E::C); ++i)
+  {
+    for (size_t j = 0; j < qgg.get_coal(Mat::E::C); ++j)
+    {
+      size_t index = toff.offsets[Mem::E::C] + i * qgg.ldX[Mat::E::C] + j;
+      double q     = std::nearbyint(dmem[Mat::E::C][index] / 512 + 3);
+      q            = std::min(127., std::max(-128., q));
+      n_saturated += (std::abs(q) >= 127);
+      q_exact      = q_exact && (c_q[index] == static_cast<int8_t>(q));
+    }
+  }
+  check(q_exact, "requantised CPU GEMM is not exact");
+  check(n_saturated > 0, "the requantised test should saturate");
+
+  std::cout << n_generated << " integer kernel bundles generated (" << n_atomic
+            << " with atomic_add), " << runner.get_summary() << ", ";
+  return check.finish();
+}
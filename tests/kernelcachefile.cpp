@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+#include "testutil.hpp"
+
+// The binary kernel cache file : the round trip of the built-in cache, that files with a bad
+// magic, a truncated file (also in memory) and a file of an unknown version are rejected, and that
+// files of older versions, written byte by byte, are read back. No GPU required.
+
+namespace
+{
+std::string get_bytes(const std::string& filename)
+{
+  std::ifstream     fin(filename, std::ios::in | std::ios::binary);
+  std::stringstream ss;
+  ss << fin.rdbuf();
+  return ss.str();
+}
+
+void put_bytes(const std::string& filename, const std::string& bytes)
+{
+  std::ofstream fout(filename, std::ios::out | std::ios::binary);
+  fout << bytes;
+}
+
+void put(std::string& bytes, uint64_t x, size_t n_bytes)
+{
+  for (size_t i = 0; i < n_bytes; ++i)
+  {
+    bytes.push_back(static_cast<char>((x >> (8 * i)) & 0xff));
+  }
+}
+
+// a file of version file_version, written byte by byte, with one record : device "dev", no
+// constraints, the column major m = n = 100, k = 300 (lda = 100, ldb = 300, ldc = 100) without
+// transposes, and the bytes which follow the floattype
+std::string get_one_record_file(uint32_t                  file_version,
+                                char                      floattype,
+                                const std::array<int, 3>& after_floattype,
+                                const MIOpenGEMM::HyPas&  hp)
+{
+  std::string bytes = "MIOGEMMK";
+  put(bytes, file_version, 4);
+  put(bytes, 1, 4);
+  put(bytes, 3, 4);
+  // device (0, 3) and constraints (0, 0) in the strings
+  for (uint64_t x : {0, 3, 0, 0})
+  {
+    put(bytes, x, 4);
+  }
+  for (uint64_t x : {100, 100, 300, 100, 300, 100, 0})
+  {
+    put(bytes, x, 8);
+  }
+  for (uint64_t x : {1, 0, 0, 0})
+  {
+    put(bytes, x, 1);
+  }
+  put(bytes, static_cast<unsigned char>(floattype), 1);
+  for (int x : after_floattype)
+  {
+    put(bytes, x, 1);
+  }
+  auto packed = hp.get_packed();
+  put(bytes, packed.words[0], 8);
+  put(bytes, packed.words[1], 8);
+  return bytes + "dev";
+}
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks check;
+
+  // the round trip of the built-in cache
+  auto&&      kernel_cache = get_kernel_cache();
+  std::string filename     = "kernelcachefile_test.bin";
+  cachefile::write(kernel_cache, filename);
+  auto   kc    = cachefile::read(filename);
+  size_t n_hps = 0;
+  check(kc.get_keys().size() == kernel_cache.get_keys().size(),
+        "the number of entries should be unchanged by the round trip");
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    bool same = kc.check_for(ck).is_present &&
+                kc.at(ck).get_string() == kernel_cache.at(ck).get_string();
+    check(same, "entry changed by the round trip : " + ck.get_string());
+    n_hps += same;
+  }
+
+  // an empty cache
+  cachefile::write(KernelCache(), filename);
+  check(cachefile::read(filename).get_keys().size() == 0, "an empty cache should round trip");
+
+  // bad magic, truncated, an unknown version, absent
+  cachefile::write(kernel_cache, filename);
+  std::string bytes = get_bytes(filename);
+
+  std::string bad_magic = bytes;
+  bad_magic[0]          = 'X';
+  put_bytes(filename, bad_magic);
+  check(throws([&filename]() { cachefile::read(filename); }), "a bad magic should throw");
+
+  for (size_t size : {size_t(0), size_t(5), size_t(20), bytes.size() / 2, bytes.size() - 1})
+  {
+    put_bytes(filename, bytes.substr(0, size));
+    check(throws([&filename]() { cachefile::read(filename); }) &&
+            throws([&bytes, size]() { cachefile::read(bytes.data(), size, "truncated"); }),
+          "a file truncated to " + std::to_string(size) + " bytes should throw");
+  }
+  put_bytes(filename, bytes + "x");
+  check(throws([&filename]() { cachefile::read(filename); }), "trailing bytes should throw");
+
+  // the contents of a file in memory, as the built-in cache is compiled into the library
+  auto kc_memory = cachefile::read(bytes.data(), bytes.size(), "in memory");
+  check(kc_memory.get_keys().size() == kernel_cache.get_keys().size() &&
+          init_kernel_cache().get_keys().size() == kernel_cache.get_keys().size(),
+        "the contents of a file in memory, and the built-in cache, should have all entries");
+
+  // the version follows the 8 bytes of the magic, little endian
+  std::string unknown_version = bytes;
+  unknown_version[8]          = static_cast<char>(cachefile::version + 1);
+  put_bytes(filename, unknown_version);
+  check(throws([&filename]() { cachefile::read(filename); }), "an unknown version should throw");
+
+  // files of older versions : the conjugations were padding before version 2, and the triangle
+  // of C before version 3. 'f' in version 1, 'c' (which can be conjugated) after, all written
+  // with conjugations and a lower triangle of C in the (square) record.
+  HyPas hp = {{{"MIC4_PAD2_PLU0_LIW1_MIW1_WOS0_VEW1",
+                "MIC4_PAD2_PLU0_LIW0_MIW1_WOS0_VEW1",
+                "UNR16_GAL1_PUN0_ICE1_IWI0_SZT0_NAW64_UFO0_MAC256_SKW10_AFI1_MIA1_MAD0"}}};
+  for (uint32_t file_version : {1, 2, 3})
+  {
+    char floattype = file_version == 1 ? 'f' : 'c';
+    auto uplo      = static_cast<int>(Uplo::E::LOWER);
+    put_bytes(filename, get_one_record_file(file_version, floattype, {{3, uplo, 0}}, hp));
+    auto     kc_old = cachefile::read(filename);
+    auto     keys   = kc_old.get_keys();
+    Geometry gg     = keys.size() == 1 ? keys[0].gg : Geometry();
+    bool     conj   = file_version >= 2;
+    check(keys.size() == 1 && keys[0].dvc == "dev" && gg.m == 100 && gg.n == 100 &&
+            gg.k == 300 && gg.floattype == floattype && gg.cX[Mat::E::A] == conj &&
+            gg.cX[Mat::E::B] == conj &&
+            gg.uplo == (file_version >= 3 ? Uplo::E::LOWER : Uplo::E::NONE) &&
+            kc_old.at(keys[0]).get_string() == hp.get_string(),
+          "unexpected record read from a file of version " + std::to_string(file_version));
+  }
+  put_bytes(filename, get_one_record_file(1, 'c', {{0, 0, 0}}, hp));
+  check(throws([&filename]() { cachefile::read(filename); }),
+        "a complex floattype in a file of version 1 should throw");
+  put_bytes(filename, get_one_record_file(0, 'f', {{0, 0, 0}}, hp));
+  check(throws([&filename]() { cachefile::read(filename); }), "version 0 should throw");
+
+  std::remove(filename.c_str());
+  check(throws([&filename]() { cachefile::read(filename); }), "an absent file should throw");
+
+  std::cout << n_hps << " entries round tripped, ";
+  return check.finish();
+}
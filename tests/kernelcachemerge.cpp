@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <miopengemm/kernelcachemerge.hpp>
+#include "testutil.hpp"
+
+// Merging kernel caches with keys of the floattypes which are not benchmarked (mixed precision,
+// integer, complex) : keys in one cache only, identical in both, and different in both (kc1 is
+// kept and reported), with the journal and resuming from it. No GPU required.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks check;
+
+  HyPas hp1 = {{{"MIC4_PAD2_PLU0_LIW1_MIW1_WOS0_VEW1",
+                 "MIC4_PAD2_PLU0_LIW0_MIW1_WOS0_VEW1",
+                 "UNR16_GAL1_PUN0_ICE1_IWI0_SZT0_NAW64_UFO0_MAC256_SKW10_AFI1_MIA1_MAD0"}}};
+  HyPas hp2                             = hp1;
+  hp2.sus[Mat::E::C].vs[NonChi::E::UNR] = 32;
+
+  auto get_key = [](char floattype) {
+    Geometry gg(true, false, false, false, 500, 600, 500, 500, 400, 600, 0, floattype);
+    return CacheKey("dev", Constraints(""), gg);
+  };
+
+  // 'i' and 'm' in both (the same and different HyPas), 'c' only in kc2 and 'q' only in kc1
+  KernelCache kc1;
+  KernelCache kc2;
+  for (auto kc : {&kc1, &kc2})
+  {
+    kc->add(get_key('i'), hp1);
+  }
+  kc1.add(get_key('m'), hp1);
+  kc2.add(get_key('m'), hp2);
+  kc2.add(get_key('c'), hp2);
+  kc1.add(get_key('q'), hp1);
+
+  std::string       journal_filename = "kernelcachemerge_journal.txt";
+  std::stringstream ss;
+  owrite::Writer    mowri(Ver::E::SILENT, "");
+  std::remove(journal_filename.c_str());
+  for (size_t resume : {0, 1})
+  {
+    KernelCache kc = get_merged(kc1, kc2, Halt(), journal_filename, 1, mowri);
+    check(kc.get_keys().size() == 4 && kc.at(get_key('i')) == hp1 &&
+            kc.at(get_key('m')) == hp1 && kc.at(get_key('c')) == hp2 &&
+            kc.at(get_key('q')) == hp1,
+          "unexpected merge" + std::string(resume ? " resumed from the journal" : ""));
+  }
+
+  std::ifstream fin(journal_filename);
+  ss << fin.rdbuf();
+  check(ss.str().find("merge : not benchmarked (floattype m), kept kc1") != std::string::npos,
+        "the key which was not benchmarked should be in the journal");
+  std::remove(journal_filename.c_str());
+
+  return check.finish();
+}
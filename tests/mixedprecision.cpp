@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/half.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/setabcw.hpp>
+#include "testutil.hpp"
+
+// Mixed precision on the host : Geometry with floattypes 'm' (A and B half, C float) and 'n' (A,
+// B and C half, accumulation float), their cache keys, the generation of their kernels from the
+// kernel cache HyPas (run against cpugemm if there is an OpenCL device), and the mixed CPU
+// reference GEMM.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // geometries, their strings and memory sizes
+  Geometry fgg(64, 48, 80, false, true, 0, 'f');
+  Geometry mgg = get_with_floattype(fgg, 'm');
+  Geometry ngg = get_with_floattype(fgg, 'n');
+  Offsets  toff = get_padding_offsets();
+  for (auto& gg : {mgg, ngg})
+  {
+    check(Geometry(gg.get_string()) == gg,
+          "geometry string round trip failed : " + gg.get_string());
+    check(!(gg == fgg) && gg.get_string() != fgg.get_string(), "mixed geometry equals float");
+    check(gg.derived.is_mixed() && gg.derived.float_size_bytes_ab == 2 &&
+            get_mat_memsize(gg, toff, Mat::E::A) == 2 * get_mat_size(gg, toff, Mat::E::A),
+          "mixed geometry should have 2 byte A values");
+  }
+  check(contains(mgg.get_string(), "_f32_fab16"), "'m' string " + mgg.get_string());
+  check(contains(ngg.get_string(), "_f16_facc32"), "'n' string " + ngg.get_string());
+  check(get_mat_memsize(mgg, toff, Mat::E::C) == 4 * get_mat_size(mgg, toff, Mat::E::C),
+        "'m' geometry should have 4 byte C values");
+  check(!fgg.derived.is_mixed() && !Geometry(fgg.get_string()).derived.is_mixed(),
+        "float geometry should not be mixed");
+
+  // mixed and float keys are cached separately
+  auto&&      kernel_cache = get_kernel_cache();
+  auto        keys         = kernel_cache.get_keys();
+  KernelCache kc;
+  CacheKey    fck(keys[0].dvc, keys[0].constraints, keys[0].gg);
+  CacheKey    mck(keys[0].dvc, keys[0].constraints, get_with_floattype(keys[0].gg, 'm'));
+  kc.add(fck, kernel_cache.at(keys[0]));
+  check(!kc.check_for(mck).is_present, "a mixed key should not find the float entry");
+  kc.add(mck, kernel_cache.at(keys[1]));
+  check(kc.at(mck) == kernel_cache.at(keys[1]) && kc.at(fck) == kernel_cache.at(keys[0]),
+        "mixed and float entries should be distinct");
+
+  // kernel generation : A and B in half (LDS, workspace), accumulation in float
+  size_t n_generated = 0;
+  size_t n_atomic    = 0;
+  for (auto& ck : keys)
+  {
+    for (char floattype : {'m', 'n'})
+    {
+      Geometry xgg = get_with_floattype(ck.gg, floattype);
+      HyPas    hp  = kernel_cache.at(ck);
+      if (!Derivabilty(hp, xgg).is_derivable)
+      {
+        continue;
+      }
+      DerivedParams dp(hp, xgg);
+      std::string   t_float = floattype == 'm' ? "float" : "half";
+      auto          kblobs  = kerngen::get_kernblobs(hp, xgg, dp);
+      for (auto& kblob : kblobs)
+      {
+        bool good = contains(kblob.kernstr, "#pragma OPENCL EXTENSION cl_khr_fp16 : enable") &&
+                    (contains(kblob.kernstr, "#define TFLOAT_AB  half\n") ||
+                     contains(kblob.kernstr, "#define TFLOAT_AB half\n"));
+        if (kblob.e_ktype == KType::E::MAIN)
+        {
+          good = good && contains(kblob.kernstr, "#define TFLOAT  " + t_float + "\n") &&
+                 contains(kblob.kernstr, "#define TFLOAT_ACC  float") &&
+                 contains(kblob.kernstr, "TFLOAT_ACC rC");
+        }
+        check(good, std::string("mixed kernel ") + kblob.fname + " has unexpected types");
+        if (contains(kblob.kernstr, "atomic_cmpxchg"))
+        {
+          ++n_atomic;
+        }
+      }
+      runner.run(std::string("mixed ") + floattype, kblobs, xgg);
+      ++n_generated;
+    }
+  }
+  check(n_generated > 0 && n_atomic > 0, "no mixed kernels (with atomics) generated");
+  runner.check_run({"mixed m", "mixed n"});
+
+  // the CPU reference for 'm' : the products of halves are exact in float
+  setabcw::CpuMemBundle<half>     hcmb({get_with_floattype(fgg, 'h')}, toff);
+  std::vector<std::vector<float>> fmem(Mat::E::N);
+  for (auto emat : {Mat::E::A, Mat::E::B, Mat::E::C})
+  {
+    fmem[emat].assign(hcmb.a_mem[emat].begin(), hcmb.a_mem[emat].end());
+  }
+  std::vector<float> mc = fmem[Mat::E::C];
+  owrite::Writer     silent(Ver::E::SILENT, "");
+  cpugemm::gemm(
+    mgg, toff, hcmb.r_mem[Mat::E::A], hcmb.r_mem[Mat::E::B], mc.data(), 0.5f, -0.25f, silent);
+  cpugemm::gemm<float>(fgg,
+                       toff,
+                       fmem[Mat::E::A].data(),
+                       fmem[Mat::E::B].data(),
+                       fmem[Mat::E::C].data(),
+                       0.5,
+                       -0.25,
+                       silent);
+  double max_err = 0;
+  for (size_t i = 0; i < mc.size(); ++i)
+  {
+    max_err = std::max<double>(max_err,
+                               std::abs(mc[i] - fmem[Mat::E::C][i]) / (1 + std::abs(mc[i])));
+  }
+  check(max_err <= 1e-6, "mixed CPU GEMM error " + std::to_string(max_err));
+
+  check(throws([&]() {
+          cpugemm::gemm<float>(
+            mgg, toff, fmem[Mat::E::A].data(), fmem[Mat::E::B].data(), mc.data(), 1, 0, silent);
+        }),
+        "the float CPU GEMM should reject floattype 'm'");
+
+  std::cout << n_generated << " mixed kernel bundles generated (" << n_atomic
+            << " atomic kernels), " << runner.get_summary() << ", ";
+  return check.finish();
+}
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/miogemm.hpp>
+#include <miopengemm/multigemm.hpp>
+#include "testutil.hpp"
+
+// Products with one A on the host : MultiGemm strings (part of program cache keys) and
+// constraints, the main kernels generated from the kernel cache HyPas (A loaded into LDS once for
+// all the B_i, a register tile per product, each C_i run against cpugemm of A B_i if there is an
+// OpenCL device), their LDS, and the HyPas and strides for which they are not supported.
+
+namespace
+{
+size_t count(const std::string& kernstr, const std::string& frag)
+{
+  size_t n = 0;
+  for (size_t pos = kernstr.find(frag); pos != std::string::npos; pos = kernstr.find(frag, pos + 1))
+  {
+    ++n;
+  }
+  return n;
+}
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // strings and constraints
+  check(MultiGemm().get_string() == "" && MultiGemm(1, 7, 9).is_single(),
+        "a single product should have an empty string");
+  check(MultiGemm(3, 1024, 4096).get_string() == "NPR3_BST1024_CST4096",
+        "unexpected string " + MultiGemm(3, 1024, 4096).get_string());
+  std::set<std::string> strings;
+  for (auto& mg :
+       {MultiGemm(2, 8, 8), MultiGemm(3, 8, 8), MultiGemm(2, 16, 8), MultiGemm(2, 8, 16)})
+  {
+    strings.insert(mg.get_string());
+  }
+  check(strings.size() == 4, "MultiGemm strings should be distinct");
+  check(throws([]() { MultiGemm(0, 8, 8); }), "0 products should throw");
+
+  HyPas hp0 = {{{"MIC5_PAD2_PLU0_LIW1_MIW1_WOS0_VEW4",
+                 "MIC4_PAD2_PLU0_LIW0_MIW1_WOS1_VEW4",
+                 "UNR16_GAL1_PUN0_ICE4_IWI0_SZT0_NAW64_UFO0_MAC256_SKW10_AFI1_MIA1_MAD0_STK60"}}};
+  for (size_t b_stride : {4096, 4098, 4099})
+  {
+    HyPas hp = hp0;
+    hp.replace_where_defined(MultiGemm(2, b_stride, 0).get_constraints());
+    size_t vew = b_stride % 4 == 0 ? 4 : (b_stride % 2 == 0 ? 2 : 1);
+    check(hp.sus[Mat::E::B].vs[Chi::E::WOS] == Scratch::E::UNUSED &&
+            hp.sus[Mat::E::B].vs[Chi::E::VEW] == vew &&
+            hp.sus[Mat::E::A].vs[Chi::E::VEW] == 4 &&
+            hp.sus[Mat::E::C].vs[NonChi::E::ICE] == 1 &&
+            hp.sus[Mat::E::C].vs[NonChi::E::STK] == 0,
+          "unexpected constraints for b_stride " + std::to_string(b_stride));
+  }
+
+  // kernel generation from the kernel cache HyPas, with the constraints of 3 products
+  auto&& kernel_cache = get_kernel_cache();
+  size_t n_generated  = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    const Geometry& gg       = ck.gg;
+    size_t          c_stride = gg.ldX[Mat::E::C] * gg.get_uncoal(Mat::E::C);
+    MultiGemm       mg(3, 4 * gg.k * gg.n, c_stride);
+    HyPas           hp = kernel_cache.at(ck);
+    hp.replace_where_defined(mg.get_constraints());
+    if (!Derivabilty(hp, gg).is_derivable)
+    {
+      continue;
+    }
+    DerivedParams dp(hp, gg);
+
+    // a single product is the kernel without products
+    auto single = get_main(kerngen::get_kernblobs(hp, gg, dp));
+    check(get_main(kerngen::get_kernblobs(hp, gg, dp, Epilogue(), MultiGemm())).kernstr ==
+              single.kernstr &&
+            !contains(single.kernstr, "N_PRODUCTS"),
+          "a single product should not change the kernel");
+
+    auto multi_kblobs = kerngen::get_kernblobs(hp, gg, dp, Epilogue(), mg);
+    auto multi        = get_main(multi_kblobs);
+    check(contains(multi.kernstr, "#define N_PRODUCTS 3\n") &&
+            contains(multi.kernstr, "localB[N_PRODUCTS*N_ELEMENTS_IN_PADDED_B_UNROLL/VEW_B]") &&
+            contains(multi.kernstr, "TFLOAT_ACC rB[N_PRODUCTS][MICRO_TILE_LENGTH_B];") &&
+            contains(multi.kernstr, "TFLOAT_ACC rC[N_PRODUCTS][") &&
+            contains(multi.kernstr, "b_vec_p[") && contains(multi.kernstr, "rB[p][dimb]") &&
+            contains(multi.kernstr, "c += PRODUCT_STRIDE_C;") &&
+            multi.kuses.full == single.kuses.full,
+          "unexpected main kernel with 3 products");
+
+    // A is loaded into LDS as often as with a single product
+    check(count(multi.kernstr, "localA[") == count(single.kernstr, "localA[") &&
+            count(multi.kernstr, "a_vec[") == count(single.kernstr, "a_vec["),
+          "A should be loaded once for all the products");
+
+    size_t ab_bytes = gg.derived.float_size_bytes_ab;
+    size_t lds_a    = ab_bytes * dp.at(Mat::E::A).main_n_elements_in_padded_unroll;
+    size_t lds_b    = ab_bytes * dp.at(Mat::E::B).main_n_elements_in_padded_unroll;
+    check(get_lds_bytes(mg, gg, dp) == lds_a + 3 * lds_b &&
+            get_lds_bytes(MultiGemm(), gg, dp) == lds_a + lds_b,
+          "unexpected LDS for 3 products");
+
+    // overlapping C_i, and an epilogue
+    check(throws([&]() {
+            kerngen::get_kernblobs(hp, gg, dp, Epilogue(), MultiGemm(3, 0, c_stride - 1));
+          }),
+          "overlapping C_i should throw");
+    Epilogue relu(Bias::E::NONE, Activation::E::RELU, Conversion::E::DEFAULT);
+    check(throws([&]() { kerngen::get_kernblobs(hp, gg, dp, relu, mg); }),
+          "products with an epilogue should throw");
+    runner.run("3 products", multi_kblobs, gg, mg);
+    ++n_generated;
+  }
+  check(n_generated > 0, "no kernel bundles with products generated");
+  runner.check_run({"3 products"});
+
+  // split-k, a copy of B and stride of B not a multiple of VEW_B are not supported
+  size_t n_unsupported = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    HyPas       hp = kernel_cache.at(ck);
+    const auto& gg = ck.gg;
+    MultiGemm   mg(2, 1 + 4 * gg.k * gg.n, gg.ldX[Mat::E::C] * gg.get_uncoal(Mat::E::C));
+    bool        supported = hp.sus[Mat::E::C].vs[NonChi::E::ICE] == 1 &&
+                     hp.sus[Mat::E::C].vs[NonChi::E::STK] == 0 &&
+                     hp.sus[Mat::E::B].vs[Chi::E::WOS] == Scratch::E::UNUSED &&
+                     hp.sus[Mat::E::B].vs[Chi::E::VEW] == 1;
+    if (supported || !Derivabilty(hp, gg).is_derivable)
+    {
+      continue;
+    }
+    DerivedParams dp(hp, gg);
+    check(throws([&]() { kerngen::get_kernblobs(hp, gg, dp, Epilogue(), mg); }),
+          "MultiGemm should throw with " + hp.get_string());
+    ++n_unsupported;
+  }
+  check(n_unsupported > 0, "no unsupported HyPas checked");
+
+  // the nearest HyPas which fits 12 unroll tiles of B in the LDS of a device, where the nearest
+  // for a single product may not
+  oclutil::DevInfo devinfo      = oclutil::get_vega_devinfo();
+  devinfo.device_local_mem_size = 65536;
+  owrite::Writer silent(Ver::E::SILENT, "");
+  size_t         n_further = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    const Geometry& gg = ck.gg;
+    MultiGemm       mg(12, 4 * gg.k * gg.n, gg.ldX[Mat::E::C] * gg.get_uncoal(Mat::E::C));
+    if (gg.floattype != 'f')
+    {
+      continue;
+    }
+    HyPas nearest =
+      get_default_soln(devinfo, gg, mg.get_constraints(), silent, IfNoCache::E::GENERIC, 0).hypas;
+    HyPas hp = get_nearest_hypas(mg, devinfo, gg, mg.get_constraints(), silent);
+    check(Derivabilty(hp, gg).is_derivable &&
+            get_lds_bytes(mg, gg, DerivedParams(hp, gg)) < devinfo.device_local_mem_size,
+          "the nearest HyPas for 12 products should fit in LDS, not " + hp.get_string());
+    if (get_lds_bytes(mg, gg, DerivedParams(nearest, gg)) >= devinfo.device_local_mem_size &&
+        !(hp == get_generic(gg, mg.get_constraints())))
+    {
+      ++n_further;
+    }
+  }
+  check(n_further > 0, "no cache key further than the nearest selected for 12 products");
+
+  std::cout << n_generated << " kernel bundles with 3 products generated, " << n_unsupported
+            << " unsupported HyPas, " << n_further
+            << " nearest HyPas for 12 products further than for one, " << runner.get_summary()
+            << ", ";
+  return check.finish();
+}
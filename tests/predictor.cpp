@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <iostream>
+#include <miopengemm/derivedparams.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include <miopengemm/nearest.hpp>
+#include <miopengemm/predictor.hpp>
+#include "testutil.hpp"
+
+// Trains a predictor on the gfx900 kernel cache entries, checks its serialization round trip,
+// and that predictions repaired from the nearest neighbor are in the graph and derivable, for
+// geometries not in the cache. No GPU required.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  auto        devinfo = oclutil::get_vega_devinfo();
+  Constraints constraints("");
+
+  auto&& kernel_cache = get_kernel_cache();
+  auto   cache_keys   = kernel_cache.get_keys();
+  filter_device(cache_keys, {devinfo.identifier});
+
+  std::vector<Geometry> geometries;
+  std::vector<HyPas>    hps;
+  for (auto& ck : cache_keys)
+  {
+    geometries.push_back(ck.gg);
+    hps.push_back(kernel_cache.at(ck));
+  }
+
+  predictor::Predictor model(devinfo.identifier, geometries, hps, 6, 4);
+  auto                 reread = predictor::from_string(model.get_string());
+
+  Checks check;
+  check(model.applies_to(devinfo.identifier) && !model.applies_to("not" + devinfo.identifier) &&
+          reread.dvc == model.dvc,
+        "predictor device mismatch");
+
+  size_t n_repaired = 0;
+  for (size_t i = 0; i < cache_keys.size(); i += 20)
+  {
+    auto& g = geometries[i];
+    check(model.predict(g) == reread.predict(g),
+          "serialization round trip changed prediction for " + g.get_string());
+
+    Geometry gg(g.isColMajor,
+                g.tX[Mat::E::A],
+                g.tX[Mat::E::B],
+                g.tX[Mat::E::C],
+                g.ldX[Mat::E::A] + 8,
+                g.ldX[Mat::E::B] + 8,
+                g.ldX[Mat::E::C] + 8,
+                g.m + 5,
+                g.n + 3,
+                g.k + 1,
+                g.wSpaceSize,
+                g.floattype);
+    CacheKey ck(devinfo.identifier, constraints, gg);
+    auto     graph = get_graph(gg, devinfo, constraints);
+    if (!nearest::is_within(ck, *graph, kernel_cache, std::numeric_limits<double>::max(), 0))
+    {
+      continue;
+    }
+    HyPas start = kernel_cache.at(nearest::get(ck, *graph, kernel_cache, 0));
+    HyPas hp    = predictor::get_repaired(model, start, gg, *graph);
+    check(graph->contains(hp) && Derivabilty(hp, gg).is_derivable,
+          "repaired prediction not valid for " + gg.get_string());
+    n_repaired += !(hp == start);
+  }
+
+  std::cout << cache_keys.size() << " entries trained on, " << n_repaired
+            << " nearest neighbor(s) adjusted by the predictor, ";
+  return check.finish();
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <miopengemm/runstats.hpp>
+#include "testutil.hpp"
+
+// Run statistics of known samples : an outlier rejected from the statistics of the statistical
+// BestTests but not from the SummStats, the widths of the confidence intervals, and ties and
+// clear wins under each BestTest. No GPU required.
+
+namespace
+{
+bool is_close(double a, double b) { return std::abs(a - b) < 1e-3; }
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks check;
+
+  // 10 is 3.5 scaled MADs (1.4826 * 0.05) from the median 1 : rejected, but in the SummStats
+  RunStats with_outlier({1.0, 1.1, 0.9, 1.0, 1.05, 0.95, 10.0});
+  check(with_outlier.n_runs == 6 && with_outlier.n_outliers == 1,
+        "10 should be the only outlier : " + with_outlier.get_string());
+  check(is_close(with_outlier.get(SummStat::E::MAX), 0.9) &&
+          is_close(with_outlier.get(SummStat::E::MEDIAN), 1.0) &&
+          is_close(with_outlier.get(SummStat::E::MEAN), 16. / 7),
+        "the SummStats should be of all runs : " + with_outlier.get_string());
+  check(is_close(with_outlier.kept_mean, 1.0) && with_outlier.ci_upper < 1.1,
+        "the outlier should not be in the mean and interval of the runs kept");
+
+  // no outliers : mean 3, standard deviation sqrt(2.5), half width t(0.975, 4) sqrt(2.5 / 5)
+  RunStats spread({1, 2, 3, 4, 5});
+  double   half_width = 2.776 * std::sqrt(2.5 / 5);
+  check(spread.n_outliers == 0 && is_close(spread.stddev, std::sqrt(2.5)) &&
+          is_close(spread.ci_lower, 3 - half_width) && is_close(spread.ci_upper, 3 + half_width),
+        "unexpected 95% confidence interval : " + spread.get_string());
+  RunStats single({2.5});
+  check(single.n_runs == 1 && single.ci_lower == 2.5 && single.ci_upper == 2.5,
+        "the interval of a single run should have width 0");
+  RunStats wide({1, 2, 3, 4, 5, 1, 2, 3, 4, 5, 1, 2, 3, 4, 5, 1, 2, 3, 4, 5});
+  check(wide.ci_upper - wide.ci_lower < spread.ci_upper - spread.ci_lower,
+        "the interval should narrow with more runs");
+  check(throws([]() { RunStats(std::vector<double>{}); }), "no runs should throw");
+
+  // ties and clear wins
+  RunStats incumbent({1.02, 1.08, 0.92, 1.0, 0.98});
+  RunStats noisy_tie({1.0, 1.1, 0.9, 1.05, 0.95});
+  RunStats clear_win({0.5, 0.51, 0.49, 0.5, 0.52});
+  auto     faster = [](const RunStats& c, const RunStats& i, BestTest::E besttest) {
+    return is_faster(c, i, besttest, SummStat::E::MAX, 0.998);
+  };
+  for (auto besttest : {BestTest::E::RATIO, BestTest::E::WELCH, BestTest::E::DISJOINT})
+  {
+    std::string name = BestTest::M().name[besttest];
+    check(faster(clear_win, incumbent, besttest) && !faster(incumbent, clear_win, besttest),
+          name + " should find a clear win");
+    check(!faster(incumbent, incumbent, besttest), name + " should not find a tie faster");
+  }
+  // the fastest run of the tie is 2% faster : enough for RATIO, not for the statistical tests
+  check(faster(noisy_tie, incumbent, BestTest::E::RATIO) &&
+          !faster(noisy_tie, incumbent, BestTest::E::WELCH) &&
+          !faster(noisy_tie, incumbent, BestTest::E::DISJOINT),
+        "a noisy tie should only be faster by RATIO");
+
+  return check.finish();
+}
@@ -0,0 +1,356 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/strassen.hpp>
+#include "testutil.hpp"
+
+// Strassen-Winograd : the accuracy guard (levels used), the workspace, the plans and
+// their add kernels, and the plans run with cpugemm for the sub-products, against classical GEMM.
+// The error growth with levels is that of python/strassennumstab.py. If there is an OpenCL
+// device, the plans are also run on it (the add kernels, and the tuned GEMM for the sub-products)
+// against cpugemm.
+
+namespace
+{
+MIOpenGEMM::Geometry
+get_geometry(bool isColMajor, bool tA, bool tB, size_t m, size_t n, size_t k, char floattype)
+{
+  using namespace MIOpenGEMM;
+  // padded leading dimensions
+  size_t lda = (isColMajor != tA ? m : k) + 3;
+  size_t ldb = (isColMajor != tB ? k : n) + 5;
+  size_t ldc = (isColMajor ? m : n) + 1;
+  return Geometry(isColMajor, tA, tB, false, lda, ldb, ldc, m, n, k, 0, floattype);
+}
+
+template <typename T>
+std::vector<T> get_random(size_t n_elements, double mean, std::mt19937& gen)
+{
+  std::normal_distribution<double> nd(mean, 1.);
+  std::vector<T>                   x(n_elements);
+  for (auto& v : x)
+  {
+    v = static_cast<T>(nd(gen));
+  }
+  return x;
+}
+
+// the max absolute difference over the m x n elements of C
+template <typename T>
+double get_max_error(const MIOpenGEMM::Geometry& gg,
+                     const std::vector<T>&       c,
+                     const std::vector<double>&  c_ref)
+{
+  size_t ldc       = gg.ldX[MIOpenGEMM::Mat::E::C];
+  double max_error = 0;
+  for (size_t i = 0; i < gg.m; ++i)
+  {
+    for (size_t j = 0; j < gg.n; ++j)
+    {
+      size_t index = gg.isColMajor ? i + j * ldc : i * ldc + j;
+      max_error    = std::max(max_error, std::abs(static_cast<double>(c[index]) - c_ref[index]));
+    }
+  }
+  return max_error;
+}
+// one level of Strassen-Winograd written out, independently of the plans : the m x k A and the
+// k x n B are column major and dense, the 2 x 2 blocks multiplied naively. Returns A B.
+std::vector<double> get_winograd_level(
+  size_t m, size_t n, size_t k, const std::vector<double>& a, const std::vector<double>& b)
+{
+  size_t hm = m / 2;
+  size_t hn = n / 2;
+  size_t hk = k / 2;
+  using Block = std::vector<double>;
+  // block (row, col) of the column major x with ld rows, in blocks of r x c
+  auto get_block = [](const Block& x, size_t ld, size_t row, size_t col, size_t r, size_t c) {
+    Block y(r * c);
+    for (size_t j = 0; j < c; ++j)
+    {
+      for (size_t i = 0; i < r; ++i)
+      {
+        y[i + j * r] = x[(row * r + i) + (col * c + j) * ld];
+      }
+    }
+    return y;
+  };
+  auto add = [](const Block& x, const Block& y, double s) {
+    Block z(x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      z[i] = x[i] + s * y[i];
+    }
+    return z;
+  };
+  // the r x q x, times the q x c y
+  auto mul = [](const Block& x, const Block& y, size_t r, size_t q, size_t c) {
+    Block z(r * c, 0);
+    for (size_t j = 0; j < c; ++j)
+    {
+      for (size_t l = 0; l < q; ++l)
+      {
+        for (size_t i = 0; i < r; ++i)
+        {
+          z[i + j * r] += x[i + l * r] * y[l + j * q];
+        }
+      }
+    }
+    return z;
+  };
+
+  Block a11 = get_block(a, m, 0, 0, hm, hk), a12 = get_block(a, m, 0, 1, hm, hk);
+  Block a21 = get_block(a, m, 1, 0, hm, hk), a22 = get_block(a, m, 1, 1, hm, hk);
+  Block b11 = get_block(b, k, 0, 0, hk, hn), b12 = get_block(b, k, 0, 1, hk, hn);
+  Block b21 = get_block(b, k, 1, 0, hk, hn), b22 = get_block(b, k, 1, 1, hk, hn);
+
+  Block s1 = add(a21, a22, 1), s2 = add(s1, a11, -1);
+  Block s3 = add(a11, a21, -1), s4 = add(a12, s2, -1);
+  Block t1 = add(b12, b11, -1), t2 = add(b22, t1, -1);
+  Block t3 = add(b22, b12, -1), t4 = add(t2, b21, -1);
+
+  Block p1 = mul(a11, b11, hm, hk, hn), p2 = mul(a12, b21, hm, hk, hn);
+  Block p3 = mul(s4, b22, hm, hk, hn), p4 = mul(a22, t4, hm, hk, hn);
+  Block p5 = mul(s1, t1, hm, hk, hn), p6 = mul(s2, t2, hm, hk, hn), p7 = mul(s3, t3, hm, hk, hn);
+
+  Block u2 = add(p1, p6, 1), u3 = add(u2, p7, 1), u4 = add(u2, p5, 1);
+  // C11, C21, C12 and C22
+  std::array<Block, 4> c_blocks = {
+    {add(p1, p2, 1), add(u3, p4, -1), add(u4, p3, 1), add(u3, p5, 1)}};
+
+  std::vector<double> c(m * n);
+  for (size_t row = 0; row < 2; ++row)
+  {
+    for (size_t col = 0; col < 2; ++col)
+    {
+      for (size_t j = 0; j < hn; ++j)
+      {
+        for (size_t i = 0; i < hm; ++i)
+        {
+          c[(row * hm + i) + (col * hn + j) * m] = c_blocks[row + 2 * col][i + j * hm];
+        }
+      }
+    }
+  }
+  return c;
+}
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // the accuracy guard : fp32 and fp64, at most max_levels, each level even and at least min_dim
+  check(strassen::get_levels(Geometry(8192, 8192, 8192, false, false, 0, 'f'), 5) == 2 &&
+          strassen::get_levels(Geometry(8192, 8192, 8192, false, false, 0, 'd'), 1) == 1 &&
+          strassen::get_levels(Geometry(8192, 8192, 4096, false, false, 0, 'f'), 5) == 1 &&
+          strassen::get_levels(Geometry(8192, 8192, 8190, false, false, 0, 'f'), 5) == 1 &&
+          strassen::get_levels(Geometry(8192, 8192, 4095, false, false, 0, 'f'), 5) == 0 &&
+          strassen::get_levels(Geometry(8192, 8192, 8192, false, false, 0, 'h'), 5) == 0 &&
+          strassen::get_levels(Geometry(8192, 8192, 8192, false, false, 0, 'c'), 5) == 0 &&
+          strassen::get_levels(Geometry(2048, 2048, 2048, false, false, 0, 'f'), 5) == 0,
+        "unexpected levels from the accuracy guard");
+  check(throws([]() { strassen::get_plan(Geometry(64, 64, 64, false, false, 0, 'h'), 1); }) &&
+          throws([]() { strassen::get_plan(Geometry(64, 64, 64, false, false, 0, 'f'), 3); }) &&
+          throws([]() { strassen::get_plan(Geometry(64, 66, 64, false, false, 0, 'f'), 2); }),
+        "half, too many levels and indivisible dimensions should throw");
+
+  // the workspace : 4 sums of A, 4 of B and 7 sub-products per level
+  Geometry g1024(1024, 1024, 1024, false, false, 0, 'f');
+  check(strassen::get_workspace_size(g1024, 1) == 15 * 512 * 512 &&
+          strassen::get_workspace_size(g1024, 2) == 15 * 512 * 512 + 15 * 256 * 256,
+        "unexpected workspace size");
+
+  // the plans : 2 sums, 7 products (or levels), 1 combination per level
+  for (size_t levels : {0, 1, 2})
+  {
+    auto   plan       = strassen::get_plan(g1024, levels);
+    size_t n_products = 0;
+    for (auto& step : plan.steps)
+    {
+      n_products += step.is_product ? 1 : 0;
+    }
+    size_t n_expected = levels == 0 ? 1 : (levels == 1 ? 7 : 49);
+    size_t n_sums     = levels == 0 ? 0 : (levels == 1 ? 3 : 3 + 7 * 3);
+    check(n_products == n_expected && plan.steps.size() == n_expected + n_sums &&
+            plan.workspace_size == strassen::get_workspace_size(g1024, levels),
+          "unexpected plan with " + std::to_string(levels) + " levels");
+  }
+
+  // the add kernels : sums of A into the workspace, and the combination into C with alpha, beta
+  auto plan  = strassen::get_plan(g1024, 1);
+  auto sum_a = strassen::get_sums_kernblob(plan, plan.steps.front().sums);
+  auto comb  = strassen::get_sums_kernblob(plan, plan.steps.back().sums);
+  check(sum_a.e_ktype == KType::E::ADD && sum_a.kuses.u_a && sum_a.kuses.u_w &&
+          !sum_a.kuses.u_b && !sum_a.kuses.u_c && !sum_a.kuses.u_alpha &&
+          contains(sum_a.kernstr, "__global const TFLOAT * restrict a") &&
+          contains(sum_a.kernstr, "#define TFLOAT float") &&
+          contains(sum_a.kernstr, "y = x2 + x3;") &&
+          sum_a.global_work_size % sum_a.local_work_size == 0 &&
+          sum_a.global_work_size >= 512 * 512,
+        "unexpected add kernel for the sums of A");
+  check(comb.kuses.u_c && comb.kuses.u_w && comb.kuses.u_alpha && comb.kuses.u_beta &&
+          !comb.kuses.u_a && contains(comb.kernstr, "y = x0 - x3 + x5 + x6;") &&
+          contains(comb.kernstr, "alpha*y + beta*") &&
+          contains(comb.kernstr, "if (beta <= 0 && beta >= 0)"),
+        "unexpected add kernel for the combination into C");
+
+  // the plans on the host, against a classical fp64 reference
+  std::mt19937 gen(1011);
+  size_t       n_run = 0;
+  for (bool isColMajor : {true, false})
+  {
+    for (bool tA : {false, true})
+    {
+      for (bool tB : {false, true})
+      {
+        // A and B as in python/strassennumstab.py, N(-0.2, 1) and N(0.1, 1)
+        Geometry gf = get_geometry(isColMajor, tA, tB, 192, 256, 320, 'f');
+        Geometry gd = get_geometry(isColMajor, tA, tB, 192, 256, 320, 'd');
+        Offsets  zo = get_zero_offsets();
+        auto     ad = get_random<double>(get_mat_size(gd, zo, Mat::E::A), -0.2, gen);
+        auto     bd = get_random<double>(get_mat_size(gd, zo, Mat::E::B), 0.1, gen);
+        auto     cd = get_random<double>(get_mat_size(gd, zo, Mat::E::C), 0, gen);
+        std::vector<float> af(ad.begin(), ad.end());
+        std::vector<float> bf(bd.begin(), bd.end());
+        std::vector<float> cf(cd.begin(), cd.end());
+        for (auto& x : {&ad, &bd, &cd})
+        {
+          // the fp32 values, in fp64
+          for (auto& v : *x)
+          {
+            v = static_cast<double>(static_cast<float>(v));
+          }
+        }
+
+        double              alpha = 0.75;
+        double              beta  = -0.5;
+        std::vector<double> c_ref = cd;
+        owrite::Writer      mowri(Ver::E::SILENT, "");
+        cpugemm::gemm<double>(gd, zo, ad.data(), bd.data(), c_ref.data(), alpha, beta, mowri);
+
+        std::vector<float> c_classic = cf;
+        cpugemm::gemm<float>(gf, zo, af.data(), bf.data(), c_classic.data(), 0.75f, -0.5f, mowri);
+        double error0 = get_max_error(gf, c_classic, c_ref);
+
+        for (size_t levels : {1, 2})
+        {
+          // fp64 : the same product, to rounding
+          auto                plan_d = strassen::get_plan(gd, levels);
+          std::vector<double> wd(plan_d.workspace_size);
+          std::vector<double> c_d = cd;
+          strassen::cpu_run<double>(
+            plan_d, ad.data(), bd.data(), c_d.data(), wd.data(), alpha, beta);
+          check(get_max_error(gd, c_d, c_ref) < 1e-10,
+                "fp64 Strassen-Winograd differs from classical GEMM");
+
+          // fp32 : the max error grows with each level, as in python/strassennumstab.py
+          auto               plan_f = strassen::get_plan(gf, levels);
+          std::vector<float> wf(plan_f.workspace_size);
+          std::vector<float> c_f = cf;
+          strassen::cpu_run<float>(
+            plan_f, af.data(), bf.data(), c_f.data(), wf.data(), 0.75f, -0.5f);
+          double ratio = get_max_error(gf, c_f, c_ref) / error0;
+          check(ratio < (levels == 1 ? 4. : 8.),
+                "fp32 error ratio " + std::to_string(ratio) + " too large with " +
+                  std::to_string(levels) + " levels");
+          ++n_run;
+        }
+      }
+    }
+  }
+
+  // one level, against the Winograd formulas written out and classical GEMM, with dense column
+  // major matrices
+  {
+    size_t              m = 48, n = 64, k = 80;
+    Geometry            gd(true, false, false, false, m, k, m, m, n, k, 0, 'd');
+    Offsets             zo = get_zero_offsets();
+    auto                a  = get_random<double>(m * k, 0, gen);
+    auto                b  = get_random<double>(k * n, 0, gen);
+    auto                c  = get_random<double>(m * n, 0, gen);
+    std::vector<double> c_classic = c;
+    owrite::Writer      mowri(Ver::E::SILENT, "");
+    cpugemm::gemm<double>(gd, zo, a.data(), b.data(), c_classic.data(), 0.75, -0.5, mowri);
+    std::vector<double> c_formulas = get_winograd_level(m, n, k, a, b);
+    for (size_t i = 0; i < m * n; ++i)
+    {
+      c_formulas[i] = 0.75 * c_formulas[i] - 0.5 * c[i];
+    }
+    auto                plan_d = strassen::get_plan(gd, 1);
+    std::vector<double> w(plan_d.workspace_size);
+    std::vector<double> c_plan = c;
+    strassen::cpu_run<double>(plan_d, a.data(), b.data(), c_plan.data(), w.data(), 0.75, -0.5);
+    size_t n_products = std::count_if(plan_d.steps.begin(),
+                                      plan_d.steps.end(),
+                                      [](const strassen::Step& step) { return step.is_product; });
+    check(n_products == 7 && get_max_error(gd, c_formulas, c_classic) < 1e-10 &&
+            get_max_error(gd, c_plan, c_formulas) < 1e-10,
+          "one level of Strassen-Winograd differs from its formulas or classical GEMM");
+  }
+
+  // beta = 0 : C is not read, NaNs are overwritten
+  Geometry           g0 = get_geometry(true, false, false, 64, 64, 64, 'f');
+  Offsets            zo = get_zero_offsets();
+  auto               p0 = strassen::get_plan(g0, 2);
+  auto               a0 = get_random<float>(get_mat_size(g0, zo, Mat::E::A), 0, gen);
+  auto               b0 = get_random<float>(get_mat_size(g0, zo, Mat::E::B), 0, gen);
+  std::vector<float> c0(get_mat_size(g0, zo, Mat::E::C), NAN);
+  std::vector<float> w0(p0.workspace_size, NAN);
+  strassen::cpu_run<float>(p0, a0.data(), b0.data(), c0.data(), w0.data(), 1.f, 0.f);
+  check(std::isfinite(c0[0]) && std::isfinite(c0[63 + 63 * g0.ldX[Mat::E::C]]),
+        "beta = 0 should not read C");
+
+  // the plans on the device, against cpugemm
+  for (char floattype : {'f', 'd'})
+  {
+    for (size_t levels : {1, 2})
+    {
+      Geometry    gg      = get_geometry(false, true, false, 192, 256, 320, floattype);
+      auto        plan_l  = strassen::get_plan(gg, levels);
+      std::string feature = std::to_string(levels) + " level(s) " + floattype;
+      runner.run(feature,
+                 get_with_workspace(gg, plan_l.workspace_size),
+                 [&plan_l, floattype](cl_command_queue*                    ptr_queue,
+                                      const std::array<cl_mem, Mem::E::N>& mems,
+                                      const std::array<size_t, Mem::E::N>& offsets,
+                                      double                               alpha,
+                                      double                               beta,
+                                      cl_event*                            ptr_event) {
+                   if (floattype == 'f')
+                   {
+                     strassen::run<float>(plan_l,
+                                          static_cast<float>(alpha),
+                                          static_cast<float>(beta),
+                                          mems,
+                                          offsets,
+                                          ptr_queue,
+                                          0,
+                                          nullptr,
+                                          ptr_event);
+                   }
+                   else
+                   {
+                     strassen::run<double>(
+                       plan_l, alpha, beta, mems, offsets, ptr_queue, 0, nullptr, ptr_event);
+                   }
+                 });
+      runner.check_run({feature});
+    }
+  }
+
+  std::cout << n_run << " plans run on the host, " << runner.get_summary() << ", ";
+  return check.finish();
+}
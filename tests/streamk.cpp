@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/costmodel.hpp>
+#include <miopengemm/graph.hpp>
+#include <miopengemm/kernelcache.hpp>
+#include "testutil.hpp"
+
+// Stream-K on the host : HyPas with STK persistent work groups, their derivability, the main
+// kernels generated from the kernel cache HyPas (a loop over contiguous units of work, with the
+// fix-up of tiles split in k, run against cpugemm if there is an OpenCL device), the search graph
+// edges from the number of compute units, and the analytic model on DeepBench shapes.
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // STK is absent in the strings of the kernel caches : it is then 0
+  HyPas old_hp = {{{"MIC5_PAD2_PLU0_LIW1_MIW1_WOS0_VEW1",
+                 "MIC4_PAD2_PLU0_LIW0_MIW1_WOS0_VEW1",
+                 "UNR16_GAL1_PUN0_ICE4_IWI0_SZT0_NAW64_UFO0_MAC256_SKW10_AFI1_MIA1_MAD0"}}};
+  check(old_hp.sus[Mat::E::C].vs[NonChi::E::STK] == 0, "STK should default to 0");
+  HyPas stk_hp = old_hp;
+  stk_hp.replace_where_defined(Constraints("C_STK960"));
+  std::string stk_s = stk_hp.sus[Mat::E::C].get_string();
+  check(SuHy(Mat::E::C, stk_s).vs == stk_hp.sus[Mat::E::C].vs && contains(stk_s, "_STK960"),
+        "STK string round trip failed : " + stk_s);
+  check(HyPas(stk_hp.get_packed()) == stk_hp && !(stk_hp.get_packed() == old_hp.get_packed()),
+        "STK should be packed");
+
+  // kernel generation from the kernel cache HyPas, with as many persistent work groups as a
+  // third of the units of work
+  auto&& kernel_cache = get_kernel_cache();
+  size_t n_generated  = 0;
+  size_t n_fixup      = 0;
+  for (auto& ck : kernel_cache.get_keys())
+  {
+    HyPas hp = kernel_cache.at(ck);
+    if (!Derivabilty(hp, ck.gg).is_derivable)
+    {
+      continue;
+    }
+    size_t n_units = DerivedParams(hp, ck.gg).main_n_work_units;
+    if (n_units < 3)
+    {
+      continue;
+    }
+
+    hp.sus[Mat::E::C].vs[NonChi::E::STK] = n_units;
+    check(!Derivabilty(hp, ck.gg).is_derivable, "STK should be less than the units of work");
+    hp.sus[Mat::E::C].vs[NonChi::E::STK] = n_units / 3;
+    check(Derivabilty(hp, ck.gg).is_derivable, "STK less than the units of work should be valid");
+    DerivedParams dp(hp, ck.gg);
+    check(dp.main_n_work_units == n_units && dp.main_n_work_groups == n_units / 3,
+          "STK should be the number of work groups");
+
+    bool split_on_k = hp.sus[Mat::E::C].vs[NonChi::E::ICE] != 1;
+    auto kblobs     = kerngen::get_kernblobs(hp, ck.gg, dp);
+    for (auto& kblob : kblobs)
+    {
+      if (kblob.e_ktype != KType::E::MAIN)
+      {
+        continue;
+      }
+      size_t loop = kblob.kernstr.find("for (TINTC unit = unit_begin; unit < unit_end; ++unit){");
+      check(kblob.global_work_size == (n_units / 3) * dp.main_n_work_items_per_workgroup &&
+              contains(kblob.kernstr, "#define N_WORK_UNITS " + std::to_string(n_units) + "\n"),
+            "unexpected number of persistent work groups");
+      check(loop != std::string::npos &&
+              kblob.kernstr.rfind("__local TVFLOAT", loop) != std::string::npos &&
+              kblob.kernstr.find("__local TVFLOAT", loop) == std::string::npos,
+            "LDS should be declared before the loop over units of work");
+      bool fixup = contains(kblob.kernstr, "(unit + 1) / N_WORK_ITEMS_PER_C_ELM != group_id_xy");
+      check(fixup == split_on_k, "tiles should be written once per persistent work group");
+      n_fixup += fixup;
+    }
+    runner.run(split_on_k ? "stream-K with fix-up" : "stream-K", kblobs, ck.gg);
+    ++n_generated;
+  }
+  check(n_generated > 0 && n_fixup > 0, "no stream-K kernel bundles (with fix-up) generated");
+  runner.check_run({"stream-K", "stream-K with fix-up"});
+
+  // the search graph : 1, 2 and 4 persistent work groups per compute unit
+  Geometry         sgg(35, 8457, 2560, false, false, 0, 'f');
+  oclutil::DevInfo devinfo           = oclutil::get_vega_devinfo();
+  devinfo.device_max_work_group_size = 256;
+  devinfo.device_local_mem_size      = 65536;
+  devinfo.device_max_compute_units   = 60;
+  Graph          graph(sgg, devinfo, Constraints(""));
+  owrite::Writer silent(Ver::E::SILENT, "");
+  HyPas          start = graph.get_random_valid_start(silent);
+  check(start.sus[Mat::E::C].vs[NonChi::E::STK] == 0, "the graph should start without STK");
+  for (size_t stk : {60, 120, 240, 64})
+  {
+    HyPas hp                             = start;
+    hp.sus[Mat::E::C].vs[NonChi::E::STK] = stk;
+    check(graph.contains(hp) == (stk != 64),
+          "STK" + std::to_string(stk) + " in graph for 60 compute units");
+  }
+
+  // the memoized graphs : devices which differ only in their number of compute units do not share
+  // a graph
+  oclutil::DevInfo devinfo56         = devinfo;
+  devinfo56.device_max_compute_units = 56;
+  oclutil::DevInfo devinfo64         = devinfo;
+  devinfo64.device_max_compute_units = 64;
+  auto graph56                       = get_graph(sgg, devinfo56, Constraints(""));
+  auto graph64                       = get_graph(sgg, devinfo64, Constraints(""));
+  check(graph56 != graph64 && graph56 == get_graph(sgg, devinfo56, Constraints("")),
+        "memoized graphs should be shared only by identical devices");
+  for (size_t stk : {56, 64})
+  {
+    HyPas hp                             = start;
+    hp.sus[Mat::E::C].vs[NonChi::E::STK] = stk;
+    check(graph56->contains(hp) == (stk == 56) && graph64->contains(hp) == (stk == 64),
+          "STK" + std::to_string(stk) + " in the memoized graphs for 56 and 64 compute units");
+  }
+  check(graph64->get_devinfo().device_max_compute_units == 64,
+        "a memoized graph should keep the DevInfo it was requested with");
+
+  // the analytic model : on DeepBench shapes with a partial last wave, persistent work groups
+  // which accumulate the splits in k of their tiles do better than the same splits in k alone
+  costmodel::Analytic analytic(64, 1500, 480);
+  size_t              n_better = 0;
+  for (auto& gg : {Geometry(35, 8457, 2560, false, false, 0, 'f'),
+                   Geometry(5124, 9124, 2560, false, false, 0, 'f'),
+                   Geometry(7680, 48, 2560, false, false, 0, 'f')})
+  {
+    HyPas hp = {{{"MIC8_PAD1_PLU0_LIW0_MIW1_WOS0_VEW1",
+                  "MIC8_PAD1_PLU0_LIW0_MIW1_WOS0_VEW1",
+                  "UNR16_GAL2_PUN0_ICE8_IWI1_SZT0_NAW64_UFO0_MAC64_SKW10_AFI1_MIA0_MAD1"}}};
+    if (!Derivabilty(hp, gg).is_derivable)
+    {
+      continue;
+    }
+    double gflops = analytic.get_gflops(hp, gg);
+    for (size_t stk : {64, 128, 256})
+    {
+      hp.sus[Mat::E::C].vs[NonChi::E::STK] = stk;
+      if (Derivabilty(hp, gg).is_derivable && analytic.get_gflops(hp, gg) > gflops)
+      {
+        ++n_better;
+        break;
+      }
+    }
+  }
+  check(n_better > 0, "the analytic model should favour stream-K on some DeepBench shape");
+
+  std::cout << n_generated << " stream-K kernel bundles generated (" << n_fixup
+            << " with fix-up), " << n_better << " DeepBench shape(s) better with STK, "
+            << runner.get_summary() << ", ";
+  return check.finish();
+}
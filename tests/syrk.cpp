@@ -0,0 +1,239 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/kernelcachefile.hpp>
+#include <miopengemm/miogemm.hpp>
+#include <miopengemm/redirection.hpp>
+#include "testutil.hpp"
+
+// A triangle of C (SYRK) : Geometry strings and canonical form, the HyPas which are derivable,
+// the triangular allocation of work groups and the mask of the diagonal tiles in the main kernels
+// (run against cpugemm if there is an OpenCL device, the other triangle unchanged), cpugemm which
+// leaves the other triangle unchanged, and the binary kernel cache file.
+
+namespace
+{
+// C = op(A) op(A)^T is n x n, op(A) n x k
+MIOpenGEMM::Geometry
+get_geometry(bool isColMajor, bool tA, size_t n, size_t k, char floattype, MIOpenGEMM::Uplo::E uplo)
+{
+  using namespace MIOpenGEMM;
+  size_t lda = (isColMajor != tA ? n : k) + 3;
+  return Geometry(
+    isColMajor, tA, !tA, false, lda, lda, n + 1, n, n, k, 0, floattype, false, false, uplo);
+}
+
+std::string get_feature(bool isColMajor, bool is_lower, const std::string& tiles)
+{
+  return std::string(isColMajor ? "column major " : "row major ") +
+         (is_lower ? "lower triangle" : "upper triangle") + " of " + tiles + " tiles";
+}
+}
+
+int main()
+{
+
+  using namespace MIOpenGEMM;
+  using namespace MIOpenGEMM::testutil;
+
+  Checks       check;
+  KernelRunner runner(check);
+
+  // strings : the triangle only where there is one
+  Geometry lower = get_geometry(true, false, 70, 33, 'f', Uplo::E::LOWER);
+  Geometry none  = get_geometry(true, false, 70, 33, 'f', Uplo::E::NONE);
+  check(contains(lower.get_string(), "_up1") && !contains(none.get_string(), "_up") &&
+          contains(lower.get_tabbed_string(), " up=LOWER") &&
+          Geometry(lower.get_string()) == lower && Geometry(none.get_string()) == none &&
+          !(lower == none),
+        "unexpected geometry string " + lower.get_string());
+  check(lower.get_fields() != none.get_fields() &&
+          lower.get_distance(none) > none.get_distance(none),
+        "the triangle should be part of the fields and the distance");
+  check(std::abs(lower.get_gflops(1.) * 70 - none.get_gflops(1.) * 71 / 2) < 1e-9,
+        "a triangle of C should have n (n + 1) / 2 elements in gflops");
+  check(throws([]() {
+          Geometry(
+            true, false, true, false, 80, 70, 80, 80, 70, 33, 0, 'f', false, false, Uplo::E::UPPER);
+        }),
+        "a triangle of C with m != n should throw");
+  std::string up3 = lower.get_string();
+  up3.replace(up3.find("_up1"), 4, "_up3");
+  check(throws([&up3]() { Geometry gg(up3); }), "a geometry string with up3 should throw");
+
+  // the canonical form : swapping A and B transposes C, and the triangle
+  bool     swap_ab;
+  Geometry canon =
+    redirection::get_canonical(get_geometry(false, false, 70, 33, 'f', Uplo::E::LOWER), swap_ab);
+  check(swap_ab && canon.isColMajor && canon.uplo == Uplo::E::UPPER,
+        "the canonical form of a row major lower triangle should be upper");
+  check(redirection::get_canonical(lower).uplo == Uplo::E::LOWER,
+        "a canonical geometry should keep its triangle");
+
+  // derivability : square macro tiles, no split-k, no stream-K
+  HyPas square = {{{"MIC4_PAD2_PLU0_LIW1_MIW1_WOS0_VEW1",
+                    "MIC4_PAD2_PLU0_LIW0_MIW1_WOS0_VEW1",
+                    "UNR16_GAL1_PUN0_ICE1_IWI0_SZT0_NAW64_UFO0_MAC256_SKW10_AFI1_MIA1_MAD0_STK0"}}};
+  HyPas not_square                          = square;
+  not_square.sus[Mat::E::B].vs[Chi::E::MIC] = 5;
+  HyPas split_k                             = square;
+  split_k.sus[Mat::E::C].vs[NonChi::E::ICE] = 2;
+  Geometry g1000 = get_geometry(true, false, 1000, 300, 'f', Uplo::E::LOWER);
+  check(Derivabilty(square, g1000).is_derivable && !Derivabilty(not_square, g1000).is_derivable &&
+          contains(Derivabilty(not_square, g1000).msg, "square") &&
+          !Derivabilty(split_k, g1000).is_derivable,
+        "a triangle of C requires square macro tiles and ICE = 1");
+  check(Derivabilty(not_square, get_geometry(true, false, 1000, 300, 'f', Uplo::E::NONE))
+          .is_derivable,
+        "without a triangle, macro tiles need not be square");
+
+  // the generic HyPas, and the main kernels : T (T + 1) / 2 work groups, the triangular allocation
+  // and the mask of the diagonal tiles
+  size_t n_generated = 0;
+  for (bool isColMajor : {true, false})
+  {
+    for (size_t n : {50, 300, 1000})
+    {
+      for (auto uplo : {Uplo::E::LOWER, Uplo::E::UPPER})
+      {
+        Geometry      gg = get_geometry(isColMajor, n % 2 == 0, n, 97, 'f', uplo);
+        HyPas         hp = get_generic(gg, Constraints("C_ICE1_STK0"));
+        DerivedParams dp(hp, gg);
+        size_t        T = dp.at(Mat::E::A).n_groups;
+        check(T == dp.at(Mat::E::B).n_groups && dp.main_n_work_groups == T * (T + 1) / 2,
+              "unexpected number of work groups for " + gg.get_string());
+        auto        kblobs   = kerngen::get_kernblobs(hp, gg, dp);
+        auto        main     = get_main(kblobs);
+        bool        is_lower = uplo == Uplo::E::LOWER;
+        std::string row_a    = is_lower ? "tri_row" : "tri_col";
+        std::string sign     = is_lower ? " < " : " > ";
+        check(contains(main.kernstr, "tri_col = group_id_xy - tri_row*(tri_row + 1)/2;") &&
+                contains(main.kernstr, "const TINTA group_id_a = " + row_a + ";") &&
+                contains(main.kernstr,
+                         "if (write_start_a + dima" + sign + "write_start_b + dimb){") &&
+                main.global_work_size == dp.main_n_work_groups * main.local_work_size,
+              "unexpected main kernel for " + gg.get_string());
+        runner.run(get_feature(isColMajor, is_lower, "generic"), kblobs, gg);
+        ++n_generated;
+      }
+    }
+  }
+
+  // square macro tiles of more than one element, so that the mask of the diagonal tiles is run
+  std::vector<std::string> features;
+  for (bool isColMajor : {true, false})
+  {
+    for (auto uplo : {Uplo::E::LOWER, Uplo::E::UPPER})
+    {
+      Geometry gg = get_geometry(isColMajor, isColMajor, 70, 45, 'f', uplo);
+      check(Derivabilty(square, gg).is_derivable,
+            "the square HyPas should be derivable for " + gg.get_string());
+      DerivedParams dp(square, gg);
+      bool          is_lower = uplo == Uplo::E::LOWER;
+      features.push_back(get_feature(isColMajor, is_lower, "generic"));
+      features.push_back(get_feature(isColMajor, is_lower, "square"));
+      runner.run(features.back(), kerngen::get_kernblobs(square, gg, dp), gg);
+    }
+  }
+  runner.check_run(features);
+
+  // the allocation of the kernel, with its float estimate of the row : each tile of the triangle
+  // exactly once
+  bool allocated = true;
+  for (size_t T : {1, 2, 7, 100, 3001})
+  {
+    std::vector<size_t> n_groups_at(T * T, 0);
+    for (size_t g = 0; g < T * (T + 1) / 2; ++g)
+    {
+      size_t row = static_cast<size_t>((std::sqrt(8.f * g + 1.f) - 1.f) / 2.f);
+      while (row * (row + 1) / 2 > g)
+      {
+        --row;
+      }
+      while ((row + 1) * (row + 2) / 2 <= g)
+      {
+        ++row;
+      }
+      size_t col = g - row * (row + 1) / 2;
+      allocated  = allocated && row < T && col <= row;
+      ++n_groups_at[(row < T ? row : 0) * T + col % T];
+    }
+    for (size_t row = 0; row < T; ++row)
+    {
+      for (size_t col = 0; col < T; ++col)
+      {
+        allocated = allocated && n_groups_at[row * T + col] == (col <= row ? 1 : 0);
+      }
+    }
+  }
+  check(allocated, "the triangular allocation should launch each tile of the triangle once");
+
+  // cpugemm : the triangle of the full GEMM, the other triangle unchanged
+  std::mt19937                     gen(1012);
+  std::normal_distribution<double> nd(0, 1);
+  owrite::Writer                   mowri(Ver::E::SILENT, "");
+  size_t                           n_cpu = 0;
+  for (bool isColMajor : {true, false})
+  {
+    for (bool tA : {false, true})
+    {
+      for (auto uplo : {Uplo::E::LOWER, Uplo::E::UPPER})
+      {
+        Geometry            gg   = get_geometry(isColMajor, tA, 37, 19, 'd', uplo);
+        Geometry            full = get_geometry(isColMajor, tA, 37, 19, 'd', Uplo::E::NONE);
+        Offsets             zo   = get_zero_offsets();
+        std::vector<double> a(get_mat_size(gg, zo, Mat::E::A));
+        std::vector<double> c(get_mat_size(gg, zo, Mat::E::C));
+        for (auto x : {&a, &c})
+        {
+          for (auto& v : *x)
+          {
+            v = nd(gen);
+          }
+        }
+        std::vector<double> c_tri  = c;
+        std::vector<double> c_full = c;
+        cpugemm::gemm<double>(gg, zo, a.data(), a.data(), c_tri.data(), 0.5, -1.5, mowri);
+        cpugemm::gemm<double>(full, zo, a.data(), a.data(), c_full.data(), 0.5, -1.5, mowri);
+        bool as_expected = true;
+        for (size_t i = 0; i < 37; ++i)
+        {
+          for (size_t j = 0; j < 37; ++j)
+          {
+            size_t index    = isColMajor ? i + j * 38 : i * 38 + j;
+            bool   in_tri   = uplo == Uplo::E::LOWER ? i >= j : i <= j;
+            double expected = in_tri ? c_full[index] : c[index];
+            as_expected     = as_expected && c_tri[index] == expected;
+          }
+        }
+        check(as_expected, "cpugemm should only change the triangle of " + gg.get_string());
+        ++n_cpu;
+      }
+    }
+  }
+
+  // the binary kernel cache file : the triangle in what was padding
+  KernelCache kc;
+  kc.add_or_replace({"dev", Constraints("C_ICE1_STK0"), lower}, square);
+  kc.add_or_replace({"dev", Constraints("C_ICE1_STK0"), none}, square);
+  std::string filename = "syrk_kernelcache.bin";
+  cachefile::write(kc, filename);
+  auto kc2 = cachefile::read(filename);
+  std::remove(filename.c_str());
+  check(kc2.get_keys().size() == 2 &&
+          kc2.at({"dev", Constraints("C_ICE1_STK0"), lower}, false).get_string() ==
+            square.get_string(),
+        "the triangle of C should be read from the kernel cache file");
+
+  std::cout << n_generated << " main kernels for triangles generated, " << n_cpu
+            << " cpugemm triangles, " << runner.get_summary() << ", ";
+  return check.finish();
+}
@@ -0,0 +1,829 @@
+/*******************************************************************************
+ * Copyright (C) 2017 Advanced Micro Devices, Inc. All rights reserved.
+ *******************************************************************************/
+#ifndef GUARD_MIOPENGEMM_TESTUTIL_HPP
+#define GUARD_MIOPENGEMM_TESTUTIL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <miopengemm/bundle.hpp>
+#include <miopengemm/cpugemm.hpp>
+#include <miopengemm/epilogue.hpp>
+#include <miopengemm/error.hpp>
+#include <miopengemm/geometry.hpp>
+#include <miopengemm/half.hpp>
+#include <miopengemm/hint.hpp>
+#include <miopengemm/multigemm.hpp>
+#include <miopengemm/oclutil.hpp>
+#include <miopengemm/programs.hpp>
+
+// Helpers shared by the tests : counting failed checks, the generated kernels, and running kernel
+// bundles on the first OpenCL device (when there is one) against cpugemm.
+
+namespace MIOpenGEMM
+{
+namespace testutil
+{
+
+// check(ok, what) prints what if not ok. finish prints the number of failures, and FAILED (the
+// FAIL_REGULAR_EXPRESSION of the tests) if there are any : it is the return value of main.
+class Checks
+{
+  public:
+  size_t n_failed = 0;
+
+  void operator()(bool ok, const std::string& what)
+  {
+    if (!ok)
+    {
+      std::cout << what << '\n';
+      ++n_failed;
+    }
+  }
+
+  int finish() const
+  {
+    std::cout << n_failed << " failure(s)\n";
+    if (n_failed != 0)
+    {
+      std::cout << "FAILED\n";
+      return 1;
+    }
+    return 0;
+  }
+};
+
+inline bool throws(const std::function<void()>& f)
+{
+  try
+  {
+    f();
+  }
+  catch (const miog_error&)
+  {
+    return true;
+  }
+  return false;
+}
+
+inline bool contains(const std::string& kernstr, const std::string& frag)
+{
+  return kernstr.find(frag) != std::string::npos;
+}
+
+inline KernBlob get_main(const std::vector<KernBlob>& kblobs)
+{
+  for (auto& kblob : kblobs)
+  {
+    if (kblob.e_ktype == KType::E::MAIN)
+    {
+      return kblob;
+    }
+  }
+  throw miog_error("no main kernel");
+}
+
+// gg with another workspace size
+inline Geometry get_with_workspace(const Geometry& gg, size_t wSpaceSize)
+{
+  return Geometry(gg.isColMajor,
+                  gg.tX[Mat::E::A],
+                  gg.tX[Mat::E::B],
+                  gg.tX[Mat::E::C],
+                  gg.ldX[Mat::E::A],
+                  gg.ldX[Mat::E::B],
+                  gg.ldX[Mat::E::C],
+                  gg.m,
+                  gg.n,
+                  gg.k,
+                  wSpaceSize,
+                  gg.floattype,
+                  gg.cX[Mat::E::A],
+                  gg.cX[Mat::E::B],
+                  gg.uplo);
+}
+
+// gg with another floattype (and conjugations, only for the complex floattypes)
+inline Geometry
+get_with_floattype(const Geometry& gg, char floattype, bool cA = false, bool cB = false)
+{
+  return Geometry(gg.isColMajor,
+                  gg.tX[Mat::E::A],
+                  gg.tX[Mat::E::B],
+                  gg.tX[Mat::E::C],
+                  gg.ldX[Mat::E::A],
+                  gg.ldX[Mat::E::B],
+                  gg.ldX[Mat::E::C],
+                  gg.m,
+                  gg.n,
+                  gg.k,
+                  gg.wSpaceSize,
+                  floattype,
+                  cA,
+                  cB,
+                  gg.uplo);
+}
+
+namespace detail
+{
+
+// complex values are pairs of parts, of float ('c') or double ('z')
+inline size_t get_n_parts(char floattype) { return floattype == 'c' || floattype == 'z' ? 2 : 1; }
+
+// the bytes of a value of floattype (of one part of a complex value)
+inline size_t get_part_bytes(char floattype)
+{
+  switch (floattype)
+  {
+  case 'b': return 1;
+  case 'h': return 2;
+  case 'i':
+  case 'c':
+  case 'f': return 4;
+  case 'z':
+  case 'd': return 8;
+  }
+  throw miog_error("KernelRunner does not support values of type " + std::string(1, floattype));
+}
+
+// the i'th value (part) of floattype in mem
+inline double get_value(char floattype, const std::vector<char>& mem, size_t i)
+{
+  switch (floattype)
+  {
+  case 'b': return reinterpret_cast<const int8_t*>(mem.data())[i];
+  case 'i': return reinterpret_cast<const int32_t*>(mem.data())[i];
+  case 'h': return static_cast<float>(reinterpret_cast<const half*>(mem.data())[i]);
+  case 'c':
+  case 'f': return reinterpret_cast<const float*>(mem.data())[i];
+  case 'z':
+  case 'd': return reinterpret_cast<const double*>(mem.data())[i];
+  }
+  throw miog_error("KernelRunner does not support values of type " + std::string(1, floattype));
+}
+
+// v rounded to floattype, as the i'th value (part) in mem
+inline void set_value(char floattype, std::vector<char>& mem, size_t i, double v)
+{
+  switch (floattype)
+  {
+  case 'b': reinterpret_cast<int8_t*>(mem.data())[i]  = static_cast<int8_t>(v); return;
+  case 'i': reinterpret_cast<int32_t*>(mem.data())[i] = static_cast<int32_t>(v); return;
+  case 'h': reinterpret_cast<half*>(mem.data())[i]    = half(static_cast<float>(v)); return;
+  case 'c':
+  case 'f': reinterpret_cast<float*>(mem.data())[i] = static_cast<float>(v); return;
+  case 'z':
+  case 'd': reinterpret_cast<double*>(mem.data())[i] = v; return;
+  }
+  throw miog_error("KernelRunner does not support values of type " + std::string(1, floattype));
+}
+
+inline std::vector<char> get_values(char floattype, const std::vector<double>& vs)
+{
+  std::vector<char> mem(vs.size() * get_part_bytes(floattype));
+  for (size_t i = 0; i < vs.size(); ++i)
+  {
+    set_value(floattype, mem, i, vs[i]);
+  }
+  return mem;
+}
+
+// n_values of floattype, uniform in [-1, 1] (each part), or integers in [-8, 8] for int8 and
+// [-100, 100] for int32
+inline std::vector<char> get_random(char floattype, size_t n_values, std::mt19937& gen)
+{
+  std::uniform_real_distribution<double> distribution(-1, 1);
+  double                                 scale = floattype == 'b' ? 8 : 100;
+  std::vector<double>                    vs(n_values * get_n_parts(floattype));
+  for (auto& v : vs)
+  {
+    v = distribution(gen);
+    if (floattype == 'b' || floattype == 'i')
+    {
+      v = std::round(scale * v);
+    }
+  }
+  return get_values(floattype, vs);
+}
+
+// the absolute values (moduli) of mem, of floattype, as doubles
+inline std::vector<char> get_abs(char floattype, const std::vector<char>& mem)
+{
+  size_t              n_parts = get_n_parts(floattype);
+  std::vector<double> vs(mem.size() / (n_parts * get_part_bytes(floattype)));
+  for (size_t i = 0; i < vs.size(); ++i)
+  {
+    double squares = 0;
+    for (size_t part = 0; part < n_parts; ++part)
+    {
+      double v = get_value(floattype, mem, i * n_parts + part);
+      squares += v * v;
+    }
+    vs[i] = std::sqrt(squares);
+  }
+  return get_values('d', vs);
+}
+
+// alpha or beta, of floattype
+inline std::vector<char> get_scalar(char floattype, std::complex<double> v)
+{
+  return get_n_parts(floattype) == 2 ? get_values(floattype, {v.real(), v.imag()})
+                                     : get_values(floattype, {v.real()});
+}
+
+template <typename TAB, typename TC, typename TScalar>
+void cpu_gemm(const Geometry&          gg,
+              const Offsets&           toff,
+              const std::vector<char>& a,
+              const std::vector<char>& b,
+              std::vector<char>&       c,
+              TScalar                  alpha,
+              TScalar                  beta,
+              owrite::Writer&          mowri)
+{
+  cpugemm::gemm(gg,
+                toff,
+                reinterpret_cast<const TAB*>(a.data()),
+                reinterpret_cast<const TAB*>(b.data()),
+                reinterpret_cast<TC*>(c.data()),
+                alpha,
+                beta,
+                mowri);
+}
+
+// C <- alpha AB + beta C with the cpugemm of the floattype of gg
+inline void cpu_gemm(const Geometry&          gg,
+                     const Offsets&           toff,
+                     const std::vector<char>& a,
+                     const std::vector<char>& b,
+                     std::vector<char>&       c,
+                     std::complex<double>     alpha,
+                     std::complex<double>     beta,
+                     owrite::Writer&          mowri)
+{
+  double a_r = alpha.real();
+  double b_r = beta.real();
+  switch (gg.floattype)
+  {
+  case 'h': cpu_gemm<half, half>(gg, toff, a, b, c, half(a_r), half(b_r), mowri); return;
+  case 'f':
+    cpu_gemm<float, float>(
+      gg, toff, a, b, c, static_cast<float>(a_r), static_cast<float>(b_r), mowri);
+    return;
+  case 'd': cpu_gemm<double, double>(gg, toff, a, b, c, a_r, b_r, mowri); return;
+  case 'm':
+    cpu_gemm<half, float>(
+      gg, toff, a, b, c, static_cast<float>(a_r), static_cast<float>(b_r), mowri);
+    return;
+  case 'n': cpu_gemm<half, half>(gg, toff, a, b, c, half(a_r), half(b_r), mowri); return;
+  case 'i':
+    cpu_gemm<int8_t, int32_t>(
+      gg, toff, a, b, c, static_cast<int32_t>(a_r), static_cast<int32_t>(b_r), mowri);
+    return;
+  case 'q':
+    cpu_gemm<int8_t, int8_t>(
+      gg, toff, a, b, c, static_cast<float>(a_r), static_cast<float>(b_r), mowri);
+    return;
+  case 'c':
+    cpu_gemm<std::complex<float>, std::complex<float>>(
+      gg, toff, a, b, c, std::complex<float>(alpha), std::complex<float>(beta), mowri);
+    return;
+  case 'z':
+    cpu_gemm<std::complex<double>, std::complex<double>>(gg, toff, a, b, c, alpha, beta, mowri);
+    return;
+  }
+  throw miog_error("KernelRunner does not support floattype " + std::string(1, gg.floattype));
+}
+
+// the n_bytes of mem from byte first
+inline std::vector<char> get_slice(const std::vector<char>& mem, size_t first, size_t n_bytes)
+{
+  return std::vector<char>(mem.begin() + first, mem.begin() + first + n_bytes);
+}
+
+inline void set_slice(std::vector<char>& mem, size_t first, const std::vector<char>& slice)
+{
+  std::copy(slice.begin(), slice.end(), mem.begin() + first);
+}
+
+// as elementwise_compare : relative to alpha abs(A)abs(B) + beta abs(C), rounding errors grow as
+// sqrt(k) units in the last place of half, integer GEMM is exact
+inline double get_threshold(const Geometry& gg)
+{
+  if (gg.derived.floattype_acc == 'i')
+  {
+    return 0;
+  }
+  return gg.derived.floattype_c == 'h'
+           ? std::numeric_limits<half>::epsilon() * (2 + std::sqrt(gg.k))
+           : 1e-6;
+}
+
+// the index in the C buffer of element (i, j) of C, i < m and j < n
+inline size_t get_c_index(const Geometry& gg, const Offsets& toff, size_t i, size_t j)
+{
+  bool m_coal = (gg.tX[Mat::E::C] + gg.isColMajor) % 2 == 1;
+  return toff.offsets[Mem::E::C] + (m_coal ? i + j * gg.ldX[Mat::E::C] : i * gg.ldX[Mat::E::C] + j);
+}
+
+// whether element (i, j) of C is computed : with a triangle of C, i >= j (LOWER) or i <= j (UPPER)
+inline bool is_in_c(const Geometry& gg, size_t i, size_t j)
+{
+  return gg.uplo == Uplo::E::NONE || (gg.uplo == Uplo::E::LOWER ? i >= j : i <= j);
+}
+
+// the largest finite half
+const double half_max = 65504;
+
+// applies ep to C computed by cpugemm, as the main kernel does to the final value of each element,
+// and adds abs(bias) to the tolerance. Returns "" if ep has an effect : relu clips some (not all)
+// elements, and if saturating, some elements are clamped.
+inline std::string apply_epilogue(const Geometry&          gg,
+                                  const Offsets&           toff,
+                                  const Epilogue&          ep,
+                                  const std::vector<char>& bias,
+                                  size_t                   bias_offset,
+                                  bool                     saturating,
+                                  std::vector<char>&       c_cpu,
+                                  std::vector<char>&       c_abs)
+{
+  char   type_c      = gg.derived.floattype_c;
+  size_t n_elements  = 0;
+  size_t n_clipped   = 0;
+  size_t n_saturated = 0;
+  for (size_t i = 0; i < gg.m; ++i)
+  {
+    for (size_t j = 0; j < gg.n; ++j)
+    {
+      if (!is_in_c(gg, i, j))
+      {
+        continue;
+      }
+      ++n_elements;
+      size_t index = get_c_index(gg, toff, i, j);
+      double v     = get_value(type_c, c_cpu, index);
+      if (ep.bias != Bias::E::NONE)
+      {
+        double b = get_value(type_c, bias, bias_offset + (ep.bias == Bias::E::ROW ? i : j));
+        v += b;
+        set_value('d', c_abs, index, get_value('d', c_abs, index) + std::abs(b));
+      }
+      if (ep.activation == Activation::E::RELU)
+      {
+        n_clipped += v < 0;
+        v = std::max(v, 0.);
+      }
+      else if (ep.activation == Activation::E::GELU)
+      {
+        v = 0.5 * v * (1 + std::tanh(0.7978845608028654 * (v + 0.044715 * v * v * v)));
+      }
+      if (ep.conversion == Conversion::E::SATURATE && type_c == 'h')
+      {
+        n_saturated += std::abs(v) > half_max;
+        v = std::min(std::max(v, -half_max), half_max);
+      }
+      set_value(type_c, c_cpu, index, v);
+    }
+  }
+
+  if (ep.activation == Activation::E::RELU && (n_clipped == 0 || n_clipped == n_elements))
+  {
+    return "relu clipped " + std::to_string(n_clipped) + " elements, not some";
+  }
+  if (saturating && n_saturated == 0)
+  {
+    return "no elements saturated";
+  }
+  return "";
+}
+}
+
+// Builds kernel bundles (with the build options of Programs) on the first OpenCL device, and runs
+// them on random A, B and C with alpha and beta not 0 or 1, and a random bias for epilogues. C is
+// checked against cpugemm (with the epilogue applied on the host), and the elements of the C buffer
+// not in the matrix (padding and ldc) must be unchanged. Bundles without atomics are run twice,
+// and must compute the same bytes. Without a device, nothing is built : the tests then only check
+// the generated source. One bundle is run per feature (a name chosen by the test), of a geometry
+// small enough to run on a CPU device.
+class KernelRunner
+{
+  private:
+  // the inputs of a run
+  class Inputs
+  {
+    public:
+    std::array<std::vector<char>, Mem::E::N> mem;
+    std::vector<char>                        bias;
+    size_t                                   bias_offset = 3;
+    std::complex<double>                     alpha;
+    std::complex<double>                     beta;
+  };
+
+  // enqueues the computation of C on the buffers (A, B, C, W and the bias) of in, setting the event
+  // of its last kernel
+  using Launch = std::function<void(const std::array<cl_mem, Mem::E::N>& mems,
+                                    cl_mem                               bias,
+                                    const Offsets&                       toff,
+                                    const Inputs&                        in,
+                                    cl_event*                            ptr_event)>;
+
+  Checks&                                         check;
+  owrite::Writer                                  silent;
+  std::unique_ptr<oclutil::CommandQueueInContext> cqic;
+  std::set<std::string>                           features_run;
+  std::mt19937                                    gen;
+
+  public:
+  // enqueues C <- alpha A B + beta C on the queue, with the buffers of A, B, C and W whose first
+  // elements are offsets after their starts, setting the event of its last kernel
+  using Enqueue = std::function<void(cl_command_queue*                    ptr_queue,
+                                     const std::array<cl_mem, Mem::E::N>& mems,
+                                     const std::array<size_t, Mem::E::N>& offsets,
+                                     double                               alpha,
+                                     double                               beta,
+                                     cl_event*                            ptr_event)>;
+
+  KernelRunner(Checks& check_) : check(check_), silent(Ver::E::SILENT, "")
+  {
+    try
+    {
+      cqic.reset(new oclutil::CommandQueueInContext(silent, 0, CLHint(0, 0), "KernelRunner"));
+    }
+    catch (const miog_error&)
+    {
+      cqic.reset();
+    }
+  }
+
+  bool has_device() const { return cqic != nullptr; }
+
+  // runs kblobs, generated for gg (with the epilogue ep), and checks C, if there is a device, no
+  // bundle of feature has been run, and gg has at most 2^27 multiply-adds
+  void run(const std::string&           feature,
+           const std::vector<KernBlob>& kblobs,
+           const Geometry&              gg,
+           const Epilogue&              ep = Epilogue())
+  {
+    run(feature, kblobs, gg, ep, MultiGemm());
+  }
+
+  // as above, for kblobs computing the products of mg, each C_i checked against cpugemm of A B_i
+  void run(const std::string&           feature,
+           const std::vector<KernBlob>& kblobs,
+           const Geometry&              gg,
+           const MultiGemm&             mg)
+  {
+    run(feature, kblobs, gg, Epilogue(), mg);
+  }
+
+  // as above, for C of gg (real) computed by enqueue, such as the steps of a Strassen-Winograd
+  // plan, run once
+  void run(const std::string& feature, const Geometry& gg, const Enqueue& enqueue)
+  {
+    if (!is_to_run(feature, gg))
+    {
+      return;
+    }
+    std::string error;
+    try
+    {
+      error = run_and_compare(
+        gg,
+        Epilogue(),
+        MultiGemm(),
+        false,
+        [this, &enqueue](const std::array<cl_mem, Mem::E::N>& mems,
+                         cl_mem,
+                         const Offsets& toff,
+                         const Inputs&  in,
+                         cl_event*      ptr_event) {
+          enqueue(
+            &cqic->command_queue, mems, toff.offsets, in.alpha.real(), in.beta.real(), ptr_event);
+        });
+    }
+    catch (const miog_error& e)
+    {
+      error = e.what();
+    }
+    set_run(feature, gg, error);
+  }
+
+  // with a device, a bundle of each of features should have been run
+  void check_run(const std::vector<std::string>& features)
+  {
+    for (auto& feature : features)
+    {
+      check(!has_device() || features_run.count(feature) != 0,
+            "no " + feature + " kernels run");
+    }
+  }
+
+  std::string get_summary() const
+  {
+    if (!has_device())
+    {
+      return "no OpenCL device (no kernels run)";
+    }
+    return std::to_string(features_run.size()) + " kernel bundle(s) run and checked";
+  }
+
+  private:
+  void run(const std::string&           feature,
+           const std::vector<KernBlob>& kblobs,
+           const Geometry&              gg,
+           const Epilogue&              ep,
+           const MultiGemm&             mg)
+  {
+    if (!is_to_run(feature, gg))
+    {
+      return;
+    }
+    std::string error;
+    try
+    {
+      cl_context   context;
+      cl_device_id device;
+      oclutil::cl_set_context_and_device_from_command_queue(
+        cqic->command_queue, context, device, silent, true);
+      Programs programs(device, context, silent);
+      programs.update(kblobs);
+      // without atomics, the order of the work groups does not change C
+      error = run_and_compare(
+        gg,
+        ep,
+        mg,
+        !has_atomics(kblobs),
+        [this, &programs, &gg](const std::array<cl_mem, Mem::E::N>& mems,
+                               cl_mem                               bias,
+                               const Offsets&                       toff,
+                               const Inputs&                        in,
+                               cl_event*                            ptr_event) {
+          std::vector<char> alpha = detail::get_scalar(gg.derived.floattype_scalar, in.alpha);
+          std::vector<char> beta  = detail::get_scalar(gg.derived.floattype_scalar, in.beta);
+          AllKernArgs       all_kern_args;
+          for (auto& index : programs.act_inds)
+          {
+            all_kern_args.emplace_back(
+              kerngen::get_arg_sizes_values(programs.programs[index].kblob,
+                                            mems,
+                                            toff.offsets,
+                                            alpha.size(),
+                                            alpha.data(),
+                                            beta.data(),
+                                            &bias,
+                                            &in.bias_offset));
+          }
+          programs.run(cqic->command_queue, all_kern_args, 0, nullptr, nullptr, ptr_event, true);
+        });
+    }
+    catch (const miog_error& e)
+    {
+      error = e.what();
+    }
+    set_run(feature, gg, error);
+  }
+
+  // if there is a device, no bundle of feature has been run, and gg has at most 2^27
+  // multiply-adds
+  bool is_to_run(const std::string& feature, const Geometry& gg) const
+  {
+    return has_device() && features_run.count(feature) == 0 && gg.m * gg.n * gg.k <= (1 << 27);
+  }
+
+  void set_run(const std::string& feature, const Geometry& gg, const std::string& error)
+  {
+    check(error.empty(), feature + " kernels failed for " + gg.get_string() + " : " + error);
+    features_run.insert(feature);
+  }
+
+  static bool has_atomics(const std::vector<KernBlob>& kblobs)
+  {
+    for (auto& kblob : kblobs)
+    {
+      if (contains(kblob.kernstr, "cmpxchg") || contains(kblob.kernstr, "atomic_add"))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Inputs get_inputs(const Geometry& gg, const Offsets& toff, const MultiGemm& mg, bool saturating)
+  {
+    Inputs in;
+    char   type_ab = gg.derived.floattype_ab;
+    char   type_c  = gg.derived.floattype_c;
+    in.alpha       = std::complex<double>(0.75, gg.derived.is_complex() ? -0.5 : 0);
+    in.beta        = std::complex<double>(-0.5, gg.derived.is_complex() ? 0.25 : 0);
+    // integers, and a scale and zero point for a requantised C
+    if (gg.derived.floattype_acc == 'i')
+    {
+      in.alpha = gg.derived.is_requantised() ? 0.0625 : 3;
+      in.beta  = gg.derived.is_requantised() ? 3 : -2;
+    }
+    // beyond the range of half
+    if (saturating)
+    {
+      in.alpha = 16384;
+    }
+    size_t n_w_values = toff.offsets[Mem::E::W] + std::max<size_t>(gg.wSpaceSize, 1) +
+                        toff.tails[Mem::E::W];
+
+    in.mem[Mem::E::A] = detail::get_random(type_ab, get_mat_size(gg, toff, Mat::E::A), gen);
+    in.mem[Mem::E::B] = detail::get_random(
+      type_ab, get_mat_size(gg, toff, Mat::E::B) + (mg.n_products - 1) * mg.b_stride, gen);
+    in.mem[Mem::E::C] = detail::get_random(
+      type_c, get_mat_size(gg, toff, Mat::E::C) + (mg.n_products - 1) * mg.c_stride, gen);
+    in.mem[Mem::E::W] =
+      std::vector<char>(n_w_values * gg.derived.get_float_size_bytes(Mem::E::W), 0x5a);
+    // of the order of C, so that the tolerance of half does not hide a wrongly indexed bias
+    in.bias = detail::get_random(type_c, in.bias_offset + std::max(gg.m, gg.n), gen);
+    for (size_t i = 0; type_c != 'i' && i < in.bias.size() / detail::get_part_bytes(type_c); ++i)
+    {
+      detail::set_value(type_c, in.bias, i, 16 * detail::get_value(type_c, in.bias, i));
+    }
+    return in;
+  }
+
+  // "" if launch computes C of gg (with the epilogue ep, the products of mg) as cpugemm does,
+  // otherwise the error. With twice, a second launch should compute the same bytes.
+  std::string run_and_compare(const Geometry&  gg,
+                              const Epilogue&  ep,
+                              const MultiGemm& mg,
+                              bool             twice,
+                              const Launch&    launch)
+  {
+    Offsets toff       = get_padding_offsets();
+    char    type_ab    = gg.derived.floattype_ab;
+    char    type_c     = gg.derived.floattype_c;
+    bool    saturating = ep.conversion == Conversion::E::SATURATE && type_c == 'h' &&
+                      ep.activation != Activation::E::GELU;
+    Inputs in = get_inputs(gg, toff, mg, saturating);
+
+    // the reference, and alpha abs(A)abs(B) + beta abs(C) (+ abs(bias)) for the tolerance, of
+    // each product
+    std::vector<char> a_abs   = detail::get_abs(type_ab, in.mem[Mem::E::A]);
+    std::vector<char> b_abs   = detail::get_abs(type_ab, in.mem[Mem::E::B]);
+    std::vector<char> c_cpu   = in.mem[Mem::E::C];
+    std::vector<char> c_abs   = detail::get_abs(type_c, in.mem[Mem::E::C]);
+    size_t            b_bytes = get_mat_memsize(gg, toff, Mat::E::B);
+    size_t            c_bytes = get_mat_memsize(gg, toff, Mat::E::C);
+    size_t            b_size  = get_mat_size(gg, toff, Mat::E::B);
+    size_t            c_size  = get_mat_size(gg, toff, Mat::E::C);
+    for (size_t p = 0; p < mg.n_products; ++p)
+    {
+      size_t b_first = p * mg.b_stride * gg.derived.float_size_bytes_ab;
+      size_t c_first = p * mg.c_stride * gg.derived.float_size_bytes;
+      auto   b_p     = detail::get_slice(in.mem[Mem::E::B], b_first, b_bytes);
+      auto   c_p     = detail::get_slice(c_cpu, c_first, c_bytes);
+      detail::cpu_gemm(gg, toff, in.mem[Mem::E::A], b_p, c_p, in.alpha, in.beta, silent);
+
+      auto b_abs_p = detail::get_slice(b_abs, p * mg.b_stride * 8, b_size * 8);
+      auto c_abs_p = detail::get_slice(c_abs, p * mg.c_stride * 8, c_size * 8);
+      detail::cpu_gemm(get_with_floattype(gg, 'd'),
+                       toff,
+                       a_abs,
+                       b_abs_p,
+                       c_abs_p,
+                       std::abs(in.alpha),
+                       std::abs(in.beta),
+                       silent);
+      if (!ep.is_identity())
+      {
+        std::string error = detail::apply_epilogue(
+          gg, toff, ep, in.bias, in.bias_offset, saturating, c_p, c_abs_p);
+        if (!error.empty())
+        {
+          return "the epilogue " + ep.get_string() + " is not exercised : " + error;
+        }
+      }
+      detail::set_slice(c_cpu, c_first, c_p);
+      detail::set_slice(c_abs, p * mg.c_stride * 8, c_abs_p);
+    }
+
+    std::vector<char> c_gpu = get_c_gpu(toff, in, launch);
+    if (twice && get_c_gpu(toff, in, launch) != c_gpu)
+    {
+      return "a second run, without atomics, computed another C";
+    }
+    return get_mismatch(gg, toff, mg, in.mem[Mem::E::C], c_cpu, c_abs, c_gpu);
+  }
+
+  // C after launch on (copies of) the inputs
+  std::vector<char> get_c_gpu(const Offsets& toff, const Inputs& in, const Launch& launch)
+  {
+    cl_command_queue queue = cqic->command_queue;
+
+    // A, B, C, W and the bias
+    std::vector<oclutil::SafeClMem> safe_mems;
+    safe_mems.reserve(Mem::E::N + 1);
+    std::array<cl_mem, Mem::E::N> cl_mems;
+    for (size_t i = 0; i <= Mem::E::N; ++i)
+    {
+      const std::vector<char>& mem = i < Mem::E::N ? in.mem[i] : in.bias;
+      safe_mems.emplace_back("KernelRunner");
+      oclutil::cl_set_buffer_from_command_queue(safe_mems.back().clmem,
+                                                queue,
+                                                CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                                                mem.size(),
+                                                const_cast<char*>(mem.data()),
+                                                "KernelRunner",
+                                                true);
+      if (i < Mem::E::N)
+      {
+        cl_mems[i] = safe_mems.back().clmem;
+      }
+    }
+
+    cl_event event;
+    launch(cl_mems, safe_mems.back().clmem, toff, in, &event);
+    oclutil::cl_wait_for_events(1, &event, "KernelRunner", true);
+    oclutil::cl_release_event(event, "KernelRunner", true);
+
+    std::vector<char> c_gpu(in.mem[Mem::E::C].size());
+    oclutil::cl_enqueue_read_buffer(queue,
+                                    cl_mems[Mem::E::C],
+                                    CL_TRUE,
+                                    0,
+                                    c_gpu.size(),
+                                    c_gpu.data(),
+                                    0,
+                                    nullptr,
+                                    nullptr,
+                                    "KernelRunner",
+                                    true);
+    return c_gpu;
+  }
+
+  // "" if c_gpu is within the threshold of c_cpu in the matrix (in its triangle, if any), and is
+  // c_before outside it
+  std::string get_mismatch(const Geometry&          gg,
+                           const Offsets&           toff,
+                           const MultiGemm&         mg,
+                           const std::vector<char>& c_before,
+                           const std::vector<char>& c_cpu,
+                           const std::vector<char>& c_abs,
+                           const std::vector<char>& c_gpu)
+  {
+    char   type_c    = gg.derived.floattype_c;
+    size_t n_parts   = detail::get_n_parts(type_c);
+    size_t n_bytes   = n_parts * detail::get_part_bytes(type_c);
+    double threshold = detail::get_threshold(gg);
+
+    std::vector<bool> in_matrix(c_before.size() / n_bytes, false);
+    for (size_t p = 0; p < mg.n_products; ++p)
+    {
+      for (size_t i = 0; i < gg.m; ++i)
+      {
+        for (size_t j = 0; j < gg.n; ++j)
+        {
+          if (!detail::is_in_c(gg, i, j))
+          {
+            continue;
+          }
+          size_t index     = p * mg.c_stride + detail::get_c_index(gg, toff, i, j);
+          in_matrix[index] = true;
+          double abs       = detail::get_value('d', c_abs, index);
+          for (size_t part = 0; part < n_parts; ++part)
+          {
+            double cpu = detail::get_value(type_c, c_cpu, index * n_parts + part);
+            double gpu = detail::get_value(type_c, c_gpu, index * n_parts + part);
+            if (!(cpu == gpu || std::abs(cpu - gpu) <= threshold * abs))
+            {
+              return (mg.is_single() ? "C" : "C_" + std::to_string(p)) + "(" +
+                     std::to_string(i) + ", " + std::to_string(j) + ")" +
+                     (n_parts == 2 ? (part == 0 ? ".x" : ".y") : "") +
+                     " is " + std::to_string(gpu) + ", cpugemm computes " + std::to_string(cpu) +
+                     " (alpha abs(A)abs(B) + beta abs(C) is " + std::to_string(abs) + ")";
+            }
+          }
+        }
+      }
+    }
+
+    for (size_t index = 0; index < in_matrix.size(); ++index)
+    {
+      if (!in_matrix[index] &&
+          std::memcmp(&c_gpu[index * n_bytes], &c_before[index * n_bytes], n_bytes) != 0)
+      {
+        return "element " + std::to_string(index) + " of the C buffer, not in C, was written";
+      }
+    }
+    return "";
+  }
+};
+}
+}
+
+#endif